@@ -0,0 +1,1909 @@
+// ==================================================================================
+// = ColonySimulation contains the turn logic that used to live in MapViewState. It
+// = must never touch the Renderer or any UI control so that turns can be processed
+// = headless. Anything the player needs to know about is emitted as a signal.
+// ==================================================================================
+
+#include "ColonySimulation.h"
+
+#include "Common.h"
+#include "DirectionOffset.h"
+#include "Savegame.h"
+#include "SavegameRecords.h"
+#include "StructureCatalogue.h"
+#include "StructureManager.h"
+
+#include "Constants/Strings.h"
+
+#include "Map/TileMap.h"
+#include "MapObjects/Mine.h"
+#include "MapObjects/Robots.h"
+
+#include "States/MapViewStateHelper.h"
+#include "States/RouteCache.h"
+#include "States/TruckRoutePlanner.h"
+
+#include <libOPHD/Profiler.h>
+#include <libOPHD/RandomNumberGenerator.h>
+#include <libOPHD/SlabArena.h>
+#include <libOPHD/XmlSerializer.h>
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Xml/XmlElement.h>
+#include <NAS2D/Dictionary.h>
+#include <NAS2D/ParserHelper.h>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace
+{
+	// Relative proportion of mines with yields {low, med, high}
+	const std::map<Planet::Hostility, std::array<int, 3>> HostilityMineYields =
+	{
+		{Planet::Hostility::Low, {30, 50, 20}},
+		{Planet::Hostility::Medium, {45, 35, 20}},
+		{Planet::Hostility::High, {35, 20, 45}},
+	};
+
+
+	template <typename StructureType>
+	void addCoverageSources(ColonySimulation::CoverageSources& sources, const std::vector<StructureType*>& structures)
+	{
+		auto& structureManager = NAS2D::Utility<StructureManager>::get();
+		for (const auto* structure : structures)
+		{
+			if (!structure->operational()) { continue; }
+			const auto& tile = structureManager.tileFromStructure(structure);
+			sources[structure] = {tile.xy(), tile.depth(), structure->getRange()};
+		}
+	}
+
+
+	/**
+	 * Brings a coverage layer from the areas in \c current to the areas in
+	 * \c desired, touching only the areas of structures that were added,
+	 * removed or changed operational state since the last update.
+	 *
+	 * \return	True if the layer changed.
+	 */
+	bool applyCoverageSources(CoverageLayer& layer, ColonySimulation::CoverageSources& current, ColonySimulation::CoverageSources&& desired)
+	{
+		bool changed = false;
+
+		for (const auto& [structure, area] : current)
+		{
+			const auto it = desired.find(structure);
+			if (it == desired.end() || it->second != area)
+			{
+				layer.removeCircle(area.center, area.depth, area.radius);
+				changed = true;
+			}
+		}
+
+		for (const auto& [structure, area] : desired)
+		{
+			const auto it = current.find(structure);
+			if (it == current.end() || it->second != area)
+			{
+				layer.addCircle(area.center, area.depth, area.radius);
+				changed = true;
+			}
+		}
+
+		current = std::move(desired);
+		return changed;
+	}
+
+
+	/**
+	 * Rebuilds the tile list used to display a coverage layer, clearing the
+	 * overlay from tiles that are no longer covered.
+	 *
+	 * Tiles in TileStore chunks that were never allocated are left out, as
+	 * nothing in them is excavated and so nothing shows the overlay.
+	 */
+	void fillOverlay(TileMap& tileMap, std::vector<Tile*>& overlay, const CoverageLayer& layer, int depth, Tile::Overlay overlayType)
+	{
+		for (auto* tile : overlay)
+		{
+			if (tile->overlay() == overlayType && !layer.covered(tile->xy(), depth)) { tile->overlay(Tile::Overlay::None); }
+		}
+
+		const auto& tileStore = tileMap.tileStore();
+
+		overlay.clear();
+		for (const auto point : layer.coveredPoints(depth))
+		{
+			if (!tileStore.isMaterialized(TileStore::chunkOf(tileStore.linearIndex({point, depth})))) { continue; }
+			overlay.push_back(&tileMap.getTile({point, depth}));
+		}
+	}
+
+
+	void pushAgingRobotMessage(const Robot* robot, const MapCoordinate& position, ColonySimulation::NotificationSignal& notify)
+	{
+		const auto robotLocationText = "(" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
+
+		if (robot->fuelCellAge() == 190) // FIXME: magic number
+		{
+			notify({
+				"Aging Robot",
+				"Robot '" + robot->name() + "' at location " + robotLocationText + " is approaching its maximum age.",
+				position,
+				NotificationType::Warning});
+		}
+		else if (robot->fuelCellAge() == 195) // FIXME: magic number
+		{
+			notify({
+				"Aging Robot",
+				"Robot '" + robot->name() + "' at location " + robotLocationText + " will fail in a few turns. Replace immediately.",
+				position,
+				NotificationType::Critical});
+		}
+	}
+
+
+	int consumeFood(FoodProduction& producer, int amountToConsume)
+	{
+		const auto foodLevel = producer.foodLevel();
+		const auto toTransfer = std::min(foodLevel, amountToConsume);
+
+		producer.foodLevel(foodLevel - toTransfer);
+		return toTransfer;
+	}
+
+
+	void consumeFood(const std::vector<FoodProduction*>& foodProducers, int amountToConsume)
+	{
+		for (auto* foodProducer : foodProducers)
+		{
+			if (amountToConsume <= 0) { break; }
+			amountToConsume -= consumeFood(*foodProducer, amountToConsume);
+		}
+	}
+
+
+	std::vector<RobotRecord> robotRecords(const RobotPool& robotPool, const RobotTileTable& robotTileTable)
+	{
+		std::vector<RobotRecord> records;
+
+		for (auto* robot : robotPool.robots())
+		{
+			RobotRecord record{static_cast<int>(robot->type()), robot->fuelCellAge(), robot->turnsToCompleteTask(), std::nullopt, std::nullopt};
+
+			if (robot->type() == Robot::Type::Digger)
+			{
+				record.direction = static_cast<int>(static_cast<const Robodigger*>(robot)->direction());
+			}
+
+			const auto it = robotTileTable.find(robot);
+			if (it != robotTileTable.end())
+			{
+				record.position = it->second->xyz();
+			}
+
+			records.push_back(record);
+		}
+
+		return records;
+	}
+
+
+	ResearchRecord researchRecord(const ResearchTracker& tracker)
+	{
+		ResearchRecord record;
+		record.completed = tracker.completedResearch();
+
+		for (const auto& [techId, values] : tracker.currentResearch())
+		{
+			record.current.push_back({techId, values.progress, values.scientistsAssigned});
+		}
+
+		return record;
+	}
+
+
+	NAS2D::Xml::XmlElement* writeRandomStreams()
+	{
+		auto* random = new NAS2D::Xml::XmlElement("random");
+		random->attribute("seed", std::to_string(randomNumber.seed()));
+
+		const auto draws = randomNumber.draws();
+		for (std::size_t i = 0; i < draws.size(); ++i)
+		{
+			random->attribute(RandomStreams::streamName(static_cast<RandomStream>(i)), std::to_string(draws[i]));
+		}
+
+		return random;
+	}
+
+
+	/**
+	 * Puts every random number stream back where it was when the game was
+	 * saved. Savegames from before streams were saved get a new seed.
+	 */
+	void readRandomStreams(NAS2D::Xml::XmlElement* element)
+	{
+		if (!element)
+		{
+			randomNumber.seed(generateRandomSeed());
+			return;
+		}
+
+		RandomStreams::DrawCounts draws{};
+		for (std::size_t i = 0; i < draws.size(); ++i)
+		{
+			const auto count = element->attribute(RandomStreams::streamName(static_cast<RandomStream>(i)));
+			draws[i] = count.empty() ? 0 : std::stoull(count);
+		}
+
+		randomNumber.restore(std::stoull(element->attribute("seed")), draws);
+	}
+
+
+	std::unique_ptr<TileMap> generateTileMap(const Planet::Attributes& planetAttributes, std::uint64_t randomSeed)
+	{
+		// Mine placement is the first use of the new game's random numbers
+		randomNumber.seed(randomSeed);
+		return std::make_unique<TileMap>(planetAttributes.mapImagePath, planetAttributes.mapSize, planetAttributes.maxDepth, planetAttributes.maxMines, HostilityMineYields.at(planetAttributes.hostility));
+	}
+
+
+	ResearchTracker readResearch(const ResearchRecord& record)
+	{
+		ResearchTracker tracker;
+
+		for (const auto techId : record.completed)
+		{
+			tracker.addCompletedResearch(techId);
+		}
+
+		for (const auto& current : record.current)
+		{
+			tracker.startResearch(current.techId, current.progress, current.assigned);
+		}
+
+		return tracker;
+	}
+}
+
+
+const std::map<Difficulty, int> ColonySimulation::GracePeriod
+{
+	{Difficulty::Beginner, 30},
+	{Difficulty::Easy, 25},
+	{Difficulty::Medium, 20},
+	{Difficulty::Hard, 15}
+};
+
+const std::map<Difficulty, int> ColonySimulation::ColonyShipDeorbitMoraleLossMultiplier
+{
+	{Difficulty::Beginner, 1},
+	{Difficulty::Easy, 3},
+	{Difficulty::Medium, 6},
+	{Difficulty::Hard, 10}
+};
+
+
+/**
+ * Constructs an empty simulation. A TileMap is not available until load()
+ * has been called.
+ */
+ColonySimulation::ColonySimulation() :
+	mCrimeExecution(mNotificationSignal)
+{
+	mPopulationPool.population(&mPopulation);
+	ccLocation() = CcNotPlaced;
+
+	connectSignals();
+}
+
+
+ColonySimulation::ColonySimulation(const Planet::Attributes& planetAttributes, Difficulty selectedDifficulty, std::uint64_t randomSeed) :
+	mTileMap(generateTileMap(planetAttributes, randomSeed)),
+	mCrimeExecution(mNotificationSignal),
+	mPlanetAttributes(planetAttributes),
+	mTruckRoutePlanner(std::make_unique<TruckRoutePlanner>(*mTileMap)),
+	mCommRangeCoverage(mTileMap->size(), mTileMap->maxDepth() + 1),
+	mPoliceCoverage(mTileMap->size(), mTileMap->maxDepth() + 1),
+	mPoliceOverlays(static_cast<std::vector<Tile*>::size_type>(mTileMap->maxDepth() + 1))
+{
+	mPopulationPool.population(&mPopulation);
+	setMeanSolarDistance(mPlanetAttributes.meanSolarDistance);
+	difficulty(selectedDifficulty);
+	ccLocation() = CcNotPlaced;
+
+	connectSignals();
+	connectTileMapSignals();
+}
+
+
+ColonySimulation::~ColonySimulation()
+{
+	disconnectSignals();
+	scrubRobotList();
+	NAS2D::Utility<RouteCache>::get().clear();
+	destroyTileMap();
+}
+
+
+/**
+ * Connects the simulation and the colony-wide caches to StructureManager.
+ * Every constructor calls this; disconnectSignals() must undo all of it.
+ */
+void ColonySimulation::connectSignals()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	auto& routeCache = NAS2D::Utility<RouteCache>::get();
+	structureManager.connectivityChanged().connect({this, &ColonySimulation::onConnectivityChanged});
+	structureManager.structureAdded().connect({&routeCache, &RouteCache::onStructureChanged});
+	structureManager.structureRemoved().connect({&routeCache, &RouteCache::onStructureChanged});
+	structureManager.structureRemoved().connect({&mRepairScheduler, &RepairScheduler::onStructureRemoved});
+	structureManager.integrityChanged().connect({&mRepairScheduler, &RepairScheduler::onIntegrityChanged});
+}
+
+
+/**
+ * Connects the colony-wide caches to the tile map. The tile map owns its
+ * signals, so this is done again whenever the tile map is replaced.
+ */
+void ColonySimulation::connectTileMapSignals()
+{
+	mTileMap->tileChanged().connect({&NAS2D::Utility<RouteCache>::get(), &RouteCache::onTileChanged});
+}
+
+
+void ColonySimulation::disconnectSignals()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	auto& routeCache = NAS2D::Utility<RouteCache>::get();
+	structureManager.connectivityChanged().disconnect({this, &ColonySimulation::onConnectivityChanged});
+	structureManager.structureAdded().disconnect({&routeCache, &RouteCache::onStructureChanged});
+	structureManager.structureRemoved().disconnect({&routeCache, &RouteCache::onStructureChanged});
+	structureManager.structureRemoved().disconnect({&mRepairScheduler, &RepairScheduler::onStructureRemoved});
+	structureManager.integrityChanged().disconnect({&mRepairScheduler, &RepairScheduler::onIntegrityChanged});
+}
+
+
+void ColonySimulation::setPopulationLevel(PopulationLevel popLevel)
+{
+	mLandersColonist = static_cast<int>(popLevel);
+	mLandersCargo = 2; ///\todo This should be set based on difficulty level.
+}
+
+
+void ColonySimulation::difficulty(Difficulty difficulty)
+{
+	mDifficulty = difficulty;
+	mCrimeRateUpdate.difficulty(difficulty);
+	mCrimeExecution.difficulty(difficulty);
+}
+
+
+bool ColonySimulation::isGameOver() const
+{
+	return mPopulation.getPopulations().size() <= 0 && mLandersColonist == 0;
+}
+
+
+template <typename Phase>
+void ColonySimulation::runPhase(const char* name, Phase phase)
+{
+	mTurnPhase = name;
+	{
+		OPHD_PROFILE_SCOPE(name);
+		phase();
+	}
+	++mTurnPhasesDone;
+}
+
+
+/**
+ * Advances the colony by one turn.
+ *
+ * Each step of the turn is recorded as a scope of the global profiler.
+ * Progress through the steps can be read from another thread with
+ * turnPhasesDone() and turnPhase().
+ */
+void ColonySimulation::nextTurn()
+{
+	mTurnPhasesDone = 0;
+	mPopulationPool.clear();
+
+	runPhase("Connectedness", [this]() { updateConnectedness(); });
+	runPhase("Structures", [this]() { NAS2D::Utility<StructureManager>::get().update(mPopulationPool); });
+
+	runPhase("Structure Notifications", [this]() {
+		checkAgingStructures();
+		checkNewlyBuiltStructures();
+	});
+
+	runPhase("Food Transfer", [this]() { transferFoodToCommandCenter(); });
+	runPhase("Residential Capacity", [this]() { updateResidentialCapacity(); });
+
+	// Colony will not have morale or crime effects until at least n turns from landing, depending on difficulty
+	const bool isMoraleEnabled = mTurnCount > mTurnNumberOfLanding + GracePeriod.at(mDifficulty);
+
+	if (isMoraleEnabled)
+	{
+		runPhase("Crime", [this]() { updateCrime(); });
+	}
+	else
+	{
+		++mTurnPhasesDone;
+	}
+
+	runPhase("Food", [this]() { updateFood(); });
+	runPhase("Population", [this]() { updatePopulation(); });
+
+	runPhase("Maintenance", [this]() { updateMaintenance(); });
+	runPhase("Commercial", [this]() { updateCommercial(); });
+	runPhase("Biowaste Recycling", [this]() { updateBiowasteRecycling(); });
+
+	if (isMoraleEnabled)
+	{
+		runPhase("Morale", [this]() { updateMorale(); });
+	}
+	else
+	{
+		++mTurnPhasesDone;
+	}
+
+	runPhase("Birth and Death Notifications", [this]() { notifyBirthsAndDeaths(); });
+
+	runPhase("Robots", [this]() { updateRobots(); });
+	runPhase("Resources", [this]() { updateResources(); });
+	runPhase("Roads", [this]() { updateRoads(); });
+
+	runPhase("Overlays", [this]() {
+		updateCommRangeOverlay();
+		updatePoliceOverlay();
+	});
+
+	runPhase("Factories", [this]() { updateFactories(); });
+
+	runPhase("Colony Ship", [this]() { checkColonyShip(); });
+	runPhase("Warehouse Capacity", [this]() { checkWarehouseCapacity(); });
+
+	runPhase("Morale Commit", [this]() { mMorale.commitMoraleChanges(); });
+
+	mTurnCount++;
+}
+
+
+void ColonySimulation::updateCrime()
+{
+	mCrimeRateUpdate.update(mPoliceCoverage);
+	auto structuresCommittingCrimes = mCrimeRateUpdate.structuresCommittingCrimes();
+	mCrimeExecution.executeCrimes(structuresCommittingCrimes);
+}
+
+
+void ColonySimulation::updatePopulation()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	int residences = structureManager.getCountInState(Structure::StructureClass::Residence, StructureState::Operational);
+	int universities = structureManager.getCountInState(Structure::StructureClass::University, StructureState::Operational);
+	int nurseries = structureManager.getCountInState(Structure::StructureClass::Nursery, StructureState::Operational);
+	int hospitals = structureManager.getCountInState(Structure::StructureClass::MedicalCenter, StructureState::Operational);
+
+	auto foodProducers = structureManager.getStructures<FoodProduction>();
+	const auto& commandCenters = structureManager.getStructures<CommandCenter>();
+	foodProducers.insert(foodProducers.end(), commandCenters.begin(), commandCenters.end());
+
+	int amountToConsume = mPopulation.update(mMorale.currentMorale(), mFood, residences, universities, nurseries, hospitals);
+	consumeFood(foodProducers, amountToConsume);
+}
+
+
+void ColonySimulation::updateCommercial()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	const auto& commercial = structureManager.getStructures<Commercial>();
+
+	// No need to do anything if there are no commercial structures.
+	if (commercial.empty()) { return; }
+
+	int luxuryCount = structureManager.getCountInState(Structure::StructureClass::Commercial, StructureState::Operational);
+	int commercialCount = luxuryCount;
+
+	/**
+	 * Consume luxury products.
+	 *
+	 * FIXME: I feel like this could be done better. At the moment there
+	 * is only one luxury item, clothing, but as this changes more
+	 * items may be seen as luxury.
+	 */
+	luxuryCount -= structureManager.productInventory().pull(ProductType::PRODUCT_CLOTHING, luxuryCount);
+
+	auto commercialReverseIterator = commercial.rbegin();
+	for (std::size_t i = 0; i < static_cast<std::size_t>(luxuryCount) && commercialReverseIterator != commercial.rend(); ++i, ++commercialReverseIterator)
+	{
+		if ((*commercialReverseIterator)->operational())
+		{
+			(*commercialReverseIterator)->idle(IdleReason::InsufficientLuxuryProduct);
+		}
+	}
+
+	mMorale.adjustMorale(commercialCount - luxuryCount);
+}
+
+
+void ColonySimulation::updateMorale()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	// POSITIVE MORALE EFFECTS
+	// =========================================
+	const int birthCount = mPopulation.birthCount();
+	const int parkCount = structureManager.getCountInState(Structure::StructureClass::Park, StructureState::Operational);
+	const int recreationCount = structureManager.getCountInState(Structure::StructureClass::RecreationCenter, StructureState::Operational);
+	const int foodProducingStructures = structureManager.getCountInState(Structure::StructureClass::FoodProduction, StructureState::Operational);
+	const int commercialCount = structureManager.getCountInState(Structure::StructureClass::Commercial, StructureState::Operational);
+
+	// NEGATIVE MORALE EFFECTS
+	// =========================================
+	const int deathCount = mPopulation.deathCount();
+	const int structuresDisabled = structureManager.disabled();
+	const int structuresDestroyed = structureManager.destroyed();
+	const int residentialOverCapacityHit = mPopulation.getPopulations().size() > mResidentialCapacity ? 2 : 0;
+	const int foodProductionHit = foodProducingStructures > 0 ? 0 : 5;
+
+	const auto& residences = structureManager.getStructures<Residence>();
+	int bioWasteAccumulation = 0;
+	for (const auto* residence : residences)
+	{
+		if (residence->wasteOverflow() > 0) { ++bioWasteAccumulation; }
+	}
+
+	// positive
+	mMorale.adjustMorale(birthCount);
+	mMorale.adjustMorale(parkCount);
+	mMorale.adjustMorale(recreationCount);
+	mMorale.adjustMorale(commercialCount);
+
+	// negative
+	mMorale.adjustMorale(-deathCount);
+	mMorale.adjustMorale(-residentialOverCapacityHit);
+	mMorale.adjustMorale(-bioWasteAccumulation * 2);
+	mMorale.adjustMorale(-structuresDisabled);
+	mMorale.adjustMorale(-structuresDestroyed);
+	mMorale.adjustMorale(-foodProductionHit);
+
+	mMoraleChangeReasons.clear();
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::Births), birthCount});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::Deaths), -deathCount});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::NoFoodProduction), -foodProductionHit});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::Parks), parkCount});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::Recreation), recreationCount});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::Commercial), commercialCount});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::ResidentialOverflow), -residentialOverCapacityHit});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::BiowasteOverflow), bioWasteAccumulation * -2});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::StructuresDisabled), -structuresDisabled});
+	mMoraleChangeReasons.push_back({moraleString(MoraleIndexs::StructuresDestroyed), -structuresDestroyed});
+
+	for (const auto& moraleReason : mCrimeRateUpdate.moraleChanges())
+	{
+		mMoraleChangeReasons.push_back(moraleReason);
+		mMorale.adjustMorale(moraleReason.second);
+	}
+
+	mMeanCrimeRate = mCrimeRateUpdate.meanCrimeRate();
+
+	for (const auto& moraleReason : mCrimeExecution.moraleChanges())
+	{
+		mMoraleChangeReasons.push_back(moraleReason);
+		mMorale.adjustMorale(moraleReason.second);
+	}
+}
+
+
+void ColonySimulation::notifyBirthsAndDeaths()
+{
+	const int birthCount = mPopulation.birthCount();
+	const int deathCount = mPopulation.deathCount();
+
+	// Push notifications
+	if (birthCount)
+	{
+		mNotificationSignal({
+			"Baby Born",
+			std::to_string(birthCount) + (birthCount > 1 ? " babies were born." : " baby was born."),
+			{{-1, -1}, 0},
+			NotificationType::Information});
+	}
+
+	if (deathCount)
+	{
+		mNotificationSignal({
+			"Colonist Died",
+			std::to_string(deathCount) + (birthCount > 1 ? " colonists met their demise." : " colonist met their demise."),
+			{{-1, -1}, 0},
+			NotificationType::Warning});
+	}
+}
+
+
+void ColonySimulation::findMineRoutes()
+{
+	const auto& smelterList = NAS2D::Utility<StructureManager>::get().getStructures<OreRefining>();
+	auto& routeCache = NAS2D::Utility<RouteCache>::get();
+
+	std::vector<MineFacility*> unroutedMines;
+
+	for (auto* mine : NAS2D::Utility<StructureManager>::get().getStructures<MineFacility>())
+	{
+		if (!mine->operational() && !mine->isIdle()) { continue; } // consider a different control path.
+
+		if (routeCache.contains(mine))
+		{
+			// A smelter going offline doesn't change its tile so the cache can't see it
+			const auto& smelter = *static_cast<Tile*>(routeCache.at(mine).path.back())->structure();
+			if (smelter.operational()) { continue; }
+
+			routeCache.erase(mine);
+		}
+
+		unroutedMines.push_back(mine);
+	}
+
+	OPHD_PROFILE_COUNT("Mine Routes Searched", unroutedMines.size());
+
+	// Mines with no reachable smelter are left out and retried next turn
+	for (auto& [mine, newRoute] : mTruckRoutePlanner->findRoutes(unroutedMines, smelterList))
+	{
+		routeCache.insert(mine, std::move(newRoute));
+	}
+
+	for (auto* tile : mTruckRouteOverlay)
+	{
+		if (tile->overlay() == Tile::Overlay::TruckingRoutes) { tile->overlay(Tile::Overlay::None); }
+	}
+
+	mTruckRouteOverlay.clear();
+	for (const auto& [mine, route] : routeCache.routes())
+	{
+		for (auto tile : route.path)
+		{
+			mTruckRouteOverlay.push_back(static_cast<Tile*>(tile));
+		}
+	}
+}
+
+
+void ColonySimulation::transportOreFromMines()
+{
+	const auto& routeCache = NAS2D::Utility<RouteCache>::get();
+	for (auto* mine : NAS2D::Utility<StructureManager>::get().getStructures<MineFacility>())
+	{
+		if (routeCache.contains(mine))
+		{
+			const auto& route = routeCache.at(mine);
+			auto& smelter = *static_cast<OreRefining*>(static_cast<Tile*>(route.path.back())->structure());
+			auto& mineFacility = *static_cast<MineFacility*>(static_cast<Tile*>(route.path.front())->structure());
+
+			if (!smelter.operational()) { break; }
+
+			/* clamp route cost to minimum of 1.0f for next computation to avoid
+			   unintended multiplication. */
+			const float routeCost = std::clamp(route.cost, 1.0f, FLT_MAX);
+
+			/* intentional truncation of fractional component*/
+			const int totalOreMovement = static_cast<int>(constants::ShortestPathTraversalCount / routeCost) * mineFacility.assignedTrucks();
+			const int oreMovementPart = totalOreMovement / 4;
+			const int oreMovementRemainder = totalOreMovement % 4;
+			const auto movementCap = StorableResources{oreMovementPart, oreMovementPart, oreMovementPart, oreMovementPart + oreMovementRemainder};
+
+			auto& mineStored = mineFacility.storage();
+			auto& smelterStored = smelter.production();
+
+			const auto oreAvailable = smelterStored + mineStored.cap(movementCap);
+			const auto newSmelterStored = oreAvailable.cap(250);
+			const auto movedOre = newSmelterStored - smelterStored;
+
+			mineStored -= movedOre;
+			smelterStored = newSmelterStored;
+		}
+	}
+}
+
+
+void ColonySimulation::transportResourcesToStorage()
+{
+	const auto& smelterList = NAS2D::Utility<StructureManager>::get().getStructures<OreRefining>();
+	for (auto* smelter : smelterList)
+	{
+		if (!smelter->operational() && !smelter->isIdle()) { continue; }
+
+		auto& stored = smelter->storage();
+		const auto toMove = stored.cap(25);
+
+		const auto unmoved = addRefinedResources(toMove);
+		stored -= (toMove - unmoved);
+	}
+}
+
+
+void ColonySimulation::updateResources()
+{
+	findMineRoutes();
+	transportOreFromMines();
+	transportResourcesToStorage();
+	updatePlayerResources();
+}
+
+
+void ColonySimulation::updatePlayerResources()
+{
+	mResourcesCount = NAS2D::Utility<StructureManager>::get().resourceLedger().total();
+}
+
+
+/**
+ * Check for colony ship deorbiting; if any colonists are remaining, kill
+ * them and reduce morale by an appropriate amount.
+ */
+void ColonySimulation::checkColonyShip()
+{
+	if (mTurnCount == constants::ColonyShipOrbitTime)
+	{
+		const bool landersRemaining = mLandersColonist > 0 || mLandersCargo > 0;
+
+		if (landersRemaining)
+		{
+			mMorale.adjustMorale(-(mLandersColonist * 50) * ColonyShipDeorbitMoraleLossMultiplier.at(mDifficulty));
+
+			mLandersColonist = 0;
+			mLandersCargo = 0;
+		}
+
+		mColonyShipDeorbitedSignal(landersRemaining);
+	}
+}
+
+
+void ColonySimulation::checkWarehouseCapacity()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+	const auto& productInventory = structureManager.productInventory();
+
+	if (productInventory.warehouseCount() == 0) { return; }
+
+	// Only operational warehouses can take products
+	const int capacity = productInventory.capacity();
+	const int availableStorage = (capacity == 0) ? 0 : productInventory.availableStorage() * 100 / capacity;
+
+	if (availableStorage == 0) // FIXME -- Magic Number
+	{
+		mNotificationSignal({
+			"No Warehouse Space",
+			"You are out of storage space at your warehouses! Your Factories will go idle until you build more Warehouses or reduce inventory.",
+			{{-1, -1}, 0},
+			NotificationType::Critical
+		});
+	}
+	else if (availableStorage < 5) // FIXME -- Ditto
+	{
+		mNotificationSignal({
+			"Warehouse Space Critically Low",
+			"Warehouse space is critically low! You only have " + std::to_string(availableStorage) + "% storage capacity remaining!",
+			{{-1, -1}, 0},
+			NotificationType::Critical
+		});
+	}
+	else if (availableStorage < 15) // FIXME -- Ditto
+	{
+		mNotificationSignal({
+			"Warehouse Space Low",
+			"Warehouse space is running low. Current available storage capacity is at " + std::to_string(availableStorage) + "%.",
+			{{-1, -1}, 0},
+			NotificationType::Warning
+		});
+	}
+}
+
+
+void ColonySimulation::updateResidentialCapacity()
+{
+	mResidentialCapacity = 0;
+	const auto& residences = NAS2D::Utility<StructureManager>::get().getStructures<Residence>();
+	for (const auto* residence : residences)
+	{
+		if (residence->operational()) { mResidentialCapacity += residence->capacity(); }
+	}
+
+	if (residences.empty()) { mResidentialCapacity = constants::CommandCenterPopulationCapacity; }
+}
+
+
+void ColonySimulation::updateBiowasteRecycling()
+{
+	const auto& residences = NAS2D::Utility<StructureManager>::get().getStructures<Residence>();
+	const auto& recyclingFacilities = NAS2D::Utility<StructureManager>::get().getStructures<Recycling>();
+
+	if (residences.empty() || recyclingFacilities.empty()) { return; }
+
+	auto residenceIterator = residences.begin();
+	for (const auto* recycling : recyclingFacilities)
+	{
+		if (!recycling->operational()) { continue; } // Consider a different control structure
+
+		for (int count = 0; count < recycling->residentialSupportCount(); ++count)
+		{
+			if (residenceIterator == residences.end())
+			{
+				return; // No more residences, so don't waste time iterating over remaining recycling facilities
+			}
+
+			Residence* residence = static_cast<Residence*>(*residenceIterator);
+			residence->pullWaste(recycling->wasteProcessingCapacity());
+			++residenceIterator;
+		}
+	}
+}
+
+
+void ColonySimulation::updateFood()
+{
+	mFood = 0;
+
+	const auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	const auto addFood = [this](const FoodProduction& foodProducer)
+	{
+		if (foodProducer.operational() || foodProducer.isIdle())
+		{
+			mFood += foodProducer.foodLevel();
+		}
+	};
+
+	for (const auto* commandCenter : structureManager.getStructures<CommandCenter>()) { addFood(*commandCenter); }
+	for (const auto* foodProducer : structureManager.getStructures<FoodProduction>()) { addFood(*foodProducer); }
+}
+
+
+void ColonySimulation::transferFoodToCommandCenter()
+{
+	const auto& foodProducers = NAS2D::Utility<StructureManager>::get().getStructures<FoodProduction>();
+	const auto& commandCenters = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
+
+	auto foodProducerIterator = foodProducers.begin();
+	for (auto* commandCenter : commandCenters)
+	{
+		if (!commandCenter->operational()) { continue; }
+
+		int foodToMove = commandCenter->foodCapacity() - commandCenter->foodLevel();
+
+		while (foodProducerIterator != foodProducers.end())
+		{
+			auto foodProducer = static_cast<FoodProduction*>(*foodProducerIterator);
+			const int foodMoved = std::clamp(foodToMove, 0, foodProducer->foodLevel());
+			foodProducer->foodLevel(foodProducer->foodLevel() - foodMoved);
+			commandCenter->foodLevel(commandCenter->foodLevel() + foodMoved);
+
+			foodToMove -= foodMoved;
+
+			if (foodToMove == 0) { break; }
+
+			++foodProducerIterator;
+		}
+	}
+}
+
+
+/**
+ * Update road intersection patterns
+ */
+void ColonySimulation::updateRoads()
+{
+	const auto& roads = NAS2D::Utility<StructureManager>::get().getStructures<Road>();
+
+	for (auto* road : roads)
+	{
+		if (!road->operational()) { continue; }
+
+		const auto tileLocation = NAS2D::Utility<StructureManager>::get().tileFromStructure(road).xy();
+
+		std::array<bool, 4> surroundingTiles{false, false, false, false};
+		for (size_t i = 0; i < 4; ++i)
+		{
+			const auto tileToInspect = tileLocation + DirectionClockwise4[i];
+			const auto surfacePosition = MapCoordinate{tileToInspect, 0};
+			if (!mTileMap->isValidPosition(surfacePosition)) { continue; }
+			const auto& tile = mTileMap->getTile(surfacePosition);
+			if (!tile.thingIsStructure()) { continue; }
+
+			surroundingTiles[i] = tile.structure()->structureId() == StructureID::SID_ROAD;
+		}
+
+		std::string tag = "";
+
+		if (road->integrity() < constants::RoadIntegrityChange) { tag = "-decayed"; }
+		else if (road->integrity() == 0) { tag = "-destroyed"; }
+
+		road->sprite().play(IntersectionPatternTable.at(surroundingTiles) + tag);
+	}
+}
+
+
+void ColonySimulation::updateFactories()
+{
+	const auto& factories = NAS2D::Utility<StructureManager>::get().getStructures<Factory>();
+	for (auto* factory : factories)
+	{
+		factory->updateProduction();
+	}
+}
+
+
+void ColonySimulation::checkAgingStructures()
+{
+	const auto& structures = NAS2D::Utility<StructureManager>::get().agingStructures();
+
+	for (const auto* structure : structures)
+	{
+		const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(structure);
+
+		if (structure->age() == structure->maxAge() - 10)
+		{
+			mNotificationSignal({
+				"Aging Structure",
+				structure->name() + " is getting old. You should replace it soon.",
+				structureTile.xyz(),
+				NotificationType::Warning});
+		}
+		else if (structure->age() == structure->maxAge() - 5)
+		{
+			mNotificationSignal({
+				"Aging Structure",
+				structure->name() + " is about to collapse. You should replace it right away or consider demolishing it.",
+				structureTile.xyz(),
+				NotificationType::Critical});
+		}
+	}
+}
+
+
+void ColonySimulation::checkNewlyBuiltStructures()
+{
+	const auto& structures = NAS2D::Utility<StructureManager>::get().newlyBuiltStructures();
+
+	for (const auto* structure : structures)
+	{
+		const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(structure);
+
+		mNotificationSignal({
+			"Construction Finished",
+			structure->name() + " completed construction.",
+			structureTile.xyz(),
+			NotificationType::Success});
+	}
+}
+
+
+void ColonySimulation::updateMaintenance()
+{
+	const auto& maintenanceFacilities = NAS2D::Utility<StructureManager>::get().getStructures<MaintenanceFacility>();
+	for (auto* maintenanceFacility : maintenanceFacilities)
+	{
+		maintenanceFacility->repairStructures(mRepairScheduler);
+	}
+
+	mRepairScheduler.finishTurn();
+}
+
+
+/**
+ * Updates all robots.
+ */
+void ColonySimulation::updateRobots()
+{
+	auto robot_it = mRobotList.begin();
+	while (robot_it != mRobotList.end())
+	{
+		auto robot = robot_it->first;
+		auto tile = robot_it->second;
+
+		robot->update();
+
+		const auto& position = tile->xyz();
+
+		pushAgingRobotMessage(robot, position, mNotificationSignal);
+
+		if (robot->isDead())
+		{
+			const auto robotLocationText = "(" +  std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
+
+			if (robot->selfDestruct())
+			{
+				mNotificationSignal({
+					"Robot Self-Destructed",
+					robot->name() + " at location " + robotLocationText + " self destructed.",
+					position,
+					NotificationType::Critical
+				});
+			}
+			else if (robot->type() != Robot::Type::Miner)
+			{
+				const auto text = "Your " + robot->name() + " at location " + robotLocationText + " has broken down. It will not be able to complete its task and will be removed from your inventory.";
+				mNotificationSignal({"Robot Broke Down", text, position, NotificationType::Critical});
+				robot->abortTask(*tile);
+				NAS2D::Utility<RouteCache>::get().invalidate(*tile);
+			}
+
+			if (tile->thing() == robot)
+			{
+				tile->removeMapObject();
+			}
+
+			mRobotRemovedSignal(robot);
+
+			mRobotPool.erase(robot);
+			robot_it = mRobotList.erase(robot_it);
+		}
+		else if (robot->idle())
+		{
+			if (tile->thing() == robot)
+			{
+				tile->removeMapObject();
+
+				mNotificationSignal({
+					"Robot Task Completed",
+					robot->name() + " completed its task at" + std::to_string(tile->xy().x) + ", " + std::to_string(tile->xy().y) + ").",
+					tile->xyz(),
+					NotificationType::Success
+				});
+			}
+			robot_it = mRobotList.erase(robot_it);
+
+			if (robot->taskCanceled())
+			{
+				robot->abortTask(*tile);
+				NAS2D::Utility<RouteCache>::get().invalidate(*tile);
+				mRobotsChangedSignal();
+				robot->reset();
+
+				mNotificationSignal({
+					"Robot Task Canceled",
+					robot->name() + " canceled its task at" + std::to_string(tile->xy().x) + ", " + std::to_string(tile->xy().y) + ").",
+					tile->xyz(),
+					NotificationType::Information
+				});
+			}
+		}
+		else
+		{
+			++robot_it;
+		}
+	}
+
+	mRobotPool.update();
+}
+
+
+/**
+ * Checks the connectedness of all tiles surrounding
+ * the Command Center.
+ */
+void ColonySimulation::updateConnectedness()
+{
+	NAS2D::Utility<StructureManager>::get().updateConnectedness(*mTileMap);
+}
+
+
+/**
+ * Rebuilds the connectedness overlay. Only called when a structure's
+ * 'connected' flag actually changed.
+ */
+void ColonySimulation::onConnectivityChanged()
+{
+	// Tiles that dropped out of the overlay shouldn't keep showing it
+	for (auto* tile : mConnectednessOverlay)
+	{
+		if (tile->overlay() == Tile::Overlay::Connectedness) { tile->overlay(Tile::Overlay::None); }
+	}
+
+	mConnectednessOverlay = NAS2D::Utility<StructureManager>::get().getConnectednessOverlay();
+	mConnectednessChangedSignal();
+}
+
+
+void ColonySimulation::updateCommRangeOverlay()
+{
+	CoverageSources sources;
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	addCoverageSources(sources, structureManager.getStructures<CommandCenter>());
+	addCoverageSources(sources, structureManager.getStructures<CommTower>());
+
+	if (applyCoverageSources(mCommRangeCoverage, mCommRangeSources, std::move(sources)))
+	{
+		fillOverlay(*mTileMap, mCommRangeOverlay, mCommRangeCoverage, 0, Tile::Overlay::Communications);
+	}
+}
+
+
+void ColonySimulation::updatePoliceOverlay()
+{
+	CoverageSources sources;
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	addCoverageSources(sources, structureManager.getStructures<SurfacePolice>());
+	addCoverageSources(sources, structureManager.getStructures<UndergroundPolice>());
+
+	// Newly allocated chunks may hold covered tiles the overlays left out
+	const auto materializedChunks = mTileMap->tileStore().materializedChunkCount();
+	if (applyCoverageSources(mPoliceCoverage, mPoliceSources, std::move(sources)) || materializedChunks != mPoliceOverlayChunks)
+	{
+		mPoliceOverlayChunks = materializedChunks;
+		for (std::size_t depth = 0; depth < mPoliceOverlays.size(); ++depth)
+		{
+			fillOverlay(*mTileMap, mPoliceOverlays[depth], mPoliceCoverage, static_cast<int>(depth), Tile::Overlay::Police);
+		}
+	}
+}
+
+
+/**
+ * Places a SEED Lander. Validating the landing site is the caller's
+ * responsibility.
+ */
+SeedLander& ColonySimulation::addSeedLander(NAS2D::Point<int> point)
+{
+	auto& seedLander = *new SeedLander(point);
+	seedLander.deploySignal().connect({this, &ColonySimulation::onDeploySeedLander});
+	NAS2D::Utility<StructureManager>::get().addStructure(seedLander, mTileMap->getTile({point, 0})); // Can only ever be placed on depth level 0
+	return seedLander;
+}
+
+
+ColonistLander& ColonySimulation::addColonistLander(Tile& tile)
+{
+	auto& colonistLander = *new ColonistLander(&tile);
+	colonistLander.deploySignal().connect({this, &ColonySimulation::onDeployColonistLander});
+	NAS2D::Utility<StructureManager>::get().addStructure(colonistLander, tile);
+
+	--mLandersColonist;
+	return colonistLander;
+}
+
+
+CargoLander& ColonySimulation::addCargoLander(Tile& tile)
+{
+	auto& cargoLander = *new CargoLander(&tile);
+	cargoLander.deploySignal().connect({this, &ColonySimulation::onDeployCargoLander});
+	NAS2D::Utility<StructureManager>::get().addStructure(cargoLander, tile);
+
+	--mLandersCargo;
+	return cargoLander;
+}
+
+
+/**
+ * Builds a structure from the catalogue and pays for it out of the colony's
+ * refined resources. Validating placement and cost is the caller's
+ * responsibility.
+ */
+Structure& ColonySimulation::addStructure(StructureID structureId, Tile& tile)
+{
+	auto& structure = *StructureCatalogue::get(structureId);
+	NAS2D::Utility<StructureManager>::get().addStructure(structure, tile);
+
+	if (structure.isFactory())
+	{
+		auto& factory = static_cast<Factory&>(structure);
+		factory.productionComplete().connect({this, &ColonySimulation::onFactoryProductionComplete});
+		factory.resourcePool(&mResourcesCount);
+	}
+
+	if (structure.structureId() == StructureID::SID_MAINTENANCE_FACILITY)
+	{
+		static_cast<MaintenanceFacility&>(structure).resources(mResourcesCount);
+	}
+
+	auto cost = StructureCatalogue::costToBuild(structureId);
+	removeRefinedResources(cost);
+	updatePlayerResources();
+
+	return structure;
+}
+
+
+void ColonySimulation::addTube(ConnectorDir dir, Tile& tile)
+{
+	if (dir == ConnectorDir::CONNECTOR_VERTICAL)
+	{
+		throw std::runtime_error("ColonySimulation::addTube() called with invalid ConnectorDir paramter.");
+	}
+
+	NAS2D::Utility<StructureManager>::get().addStructure(*new Tube(dir, tile.depth() != 0), tile);
+}
+
+
+Robot& ColonySimulation::addRobot(Robot::Type type)
+{
+	const std::map<Robot::Type, void (ColonySimulation::*)(Robot*)> RobotTypeToHandler
+	{
+		{Robot::Type::Digger, &ColonySimulation::onDiggerTaskComplete},
+		{Robot::Type::Dozer, &ColonySimulation::onDozerTaskComplete},
+		{Robot::Type::Miner, &ColonySimulation::onMinerTaskComplete},
+	};
+
+	if (RobotTypeToHandler.find(type) == RobotTypeToHandler.end())
+	{
+		throw std::runtime_error("Unknown Robot::Type: " + std::to_string(static_cast<int>(type)));
+	}
+
+	auto& robot = mRobotPool.addRobot(type);
+	robot.taskComplete().connect({this, RobotTypeToHandler.at(type)});
+	return robot;
+}
+
+
+void ColonySimulation::pullRobotFromFactory(ProductType productType, Factory& factory)
+{
+	const std::map<ProductType, Robot::Type> ProductTypeToRobotType
+	{
+		{ProductType::PRODUCT_DIGGER, Robot::Type::Digger},
+		{ProductType::PRODUCT_DOZER, Robot::Type::Dozer},
+		{ProductType::PRODUCT_MINER, Robot::Type::Miner},
+	};
+
+	if (ProductTypeToRobotType.find(productType) == ProductTypeToRobotType.end())
+	{
+		throw std::runtime_error("pullRobotFromFactory():: unsuitable ProductType: " + std::to_string(static_cast<int>(productType)));
+	}
+
+	if (mRobotPool.commandCapacityAvailable())
+	{
+		addRobot(ProductTypeToRobotType.at(productType));
+		factory.pullProduct();
+
+		mRobotsChangedSignal();
+	}
+	else
+	{
+		factory.idle(IdleReason::FactoryInsufficientRobotCommandCapacity);
+	}
+}
+
+
+/**
+ * Called whenever a Factory's production is complete.
+ */
+void ColonySimulation::onFactoryProductionComplete(Factory& factory)
+{
+	const auto productType = factory.productWaiting();
+	switch (productType)
+	{
+	case ProductType::PRODUCT_DIGGER:
+	case ProductType::PRODUCT_DOZER:
+	case ProductType::PRODUCT_MINER:
+		pullRobotFromFactory(productType, factory);
+		break;
+
+	case ProductType::PRODUCT_TRUCK:
+	case ProductType::PRODUCT_CLOTHING:
+	case ProductType::PRODUCT_MEDICINE:
+		{
+			Warehouse* warehouse = NAS2D::Utility<StructureManager>::get().productInventory().store(productType, 1);
+			if (warehouse) { factory.pullProduct(); }
+			else
+			{
+				factory.idle(IdleReason::FactoryInsufficientWarehouseSpace);
+				const auto& factoryPos = NAS2D::Utility<StructureManager>::get().tileFromStructure(&factory);
+				mNotificationSignal({
+					"Warehouses full",
+					"A factory has shut down due to lack of available warehouse space.",
+					factoryPos.xyz(),
+					NotificationType::Warning
+				});
+			}
+			break;
+		}
+
+	default:
+		throw std::runtime_error("Unknown product completed");
+	}
+}
+
+
+/**
+ * Lands colonists on the surfaces and adds them to the population pool.
+ */
+void ColonySimulation::onDeployColonistLander()
+{
+	if (mTurnNumberOfLanding > mTurnCount) {
+		mTurnNumberOfLanding = mTurnCount;
+	}
+	mPopulation.addPopulation({0, 10, 20, 20, 0});
+}
+
+
+/**
+ * Lands cargo on the surface and adds resources to the resource pool.
+ */
+void ColonySimulation::onDeployCargoLander()
+{
+	auto cc = static_cast<CommandCenter*>(mTileMap->getTile({ccLocation(), 0}).structure());
+	cc->foodLevel(cc->foodLevel() + 125);
+	NAS2D::Utility<StructureManager>::get().resourceLedger().addTo(*cc, StorableResources{25, 25, 15, 15});
+
+	mResourcesChangedSignal();
+}
+
+
+/**
+ * Sets up the initial colony deployment.
+ *
+ * \note	The deploy callback only gets called once so there is really no
+ *			need to disconnect the callback since it will automatically be
+ *			released when the seed lander is destroyed.
+ */
+void ColonySimulation::onDeploySeedLander(NAS2D::Point<int> point)
+{
+	// Bulldoze lander region
+	for (const auto& direction : DirectionScan3x3)
+	{
+		mTileMap->getTile({point + direction, 0}).index(TerrainType::Dozed);
+	}
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	// Place initial tubes
+	for (const auto& direction : DirectionClockwise4)
+	{
+		structureManager.addStructure(*new Tube(ConnectorDir::CONNECTOR_INTERSECTION, false), mTileMap->getTile({point + direction, 0}));
+	}
+
+	constexpr std::array initialStructures{
+		std::tuple{DirectionNorthWest, StructureID::SID_SEED_POWER},
+		std::tuple{DirectionNorthEast, StructureID::SID_COMMAND_CENTER},
+		std::tuple{DirectionSouthWest, StructureID::SID_SEED_FACTORY},
+		std::tuple{DirectionSouthEast, StructureID::SID_SEED_SMELTER},
+	};
+
+	std::vector<Structure*> structures;
+	for (const auto& [direction, structureId] : initialStructures)
+	{
+		auto* structure = StructureCatalogue::get(structureId);
+		structureManager.addStructure(*structure, mTileMap->getTile({point + direction, 0}));
+		structures.push_back(structure);
+	}
+
+	ccLocation() = point + DirectionNorthEast;
+
+	auto& seedFactory = *static_cast<SeedFactory*>(structures[2]);
+	seedFactory.resourcePool(&mResourcesCount);
+	seedFactory.productionComplete().connect({this, &ColonySimulation::onFactoryProductionComplete});
+
+	addRobot(Robot::Type::Dozer);
+	addRobot(Robot::Type::Digger);
+	addRobot(Robot::Type::Miner);
+
+	mRobotsChangedSignal();
+}
+
+
+/**
+ * Called whenever a RoboDozer completes its task.
+ */
+void ColonySimulation::onDozerTaskComplete(Robot* /*robot*/)
+{
+	mRobotsChangedSignal();
+}
+
+
+/**
+ * Called whenever a RoboDigger completes its task.
+ */
+void ColonySimulation::onDiggerTaskComplete(Robot* robot)
+{
+	if (mRobotList.find(robot) == mRobotList.end())
+	{
+		throw std::runtime_error("ColonySimulation::onDiggerTaskComplete() called with a Robot not in the Robot List!");
+	}
+
+	auto& tile = *mRobotList[robot];
+	const auto& position = tile.xyz();
+
+	if (position.z > mTileMap->maxDepth())
+	{
+		throw std::runtime_error("Digger defines a depth that exceeds the maximum digging depth!");
+	}
+
+	const auto dir = static_cast<Robodigger*>(robot)->direction(); // fugly
+	auto newPosition = position;
+
+	if (dir == Direction::Down)
+	{
+		++newPosition.z;
+
+		auto& as1 = *new AirShaft();
+		if (position.z > 0) { as1.ug(); }
+		NAS2D::Utility<StructureManager>::get().addStructure(as1, tile);
+
+		auto& as2 = *new AirShaft();
+		as2.ug();
+		NAS2D::Utility<StructureManager>::get().addStructure(as2, mTileMap->getTile(newPosition));
+
+		mTileMap->getTile(position).index(TerrainType::Dozed);
+		mTileMap->getTile(newPosition).index(TerrainType::Dozed);
+
+		updateConnectedness();
+	}
+	newPosition.xy += directionEnumToOffset(dir);
+
+	/**
+	 * \todo	Add checks for obstructions and things that explode if
+	 *			a digger gets in the way (or should diggers be smarter than
+	 *			puncturing a fusion reactor containment vessel?)
+	 */
+	for (const auto& offset : DirectionScan3x3)
+	{
+		mTileMap->getTile({newPosition.xy + offset, newPosition.z}).excavated(true);
+	}
+
+	mRobotsChangedSignal();
+}
+
+
+/**
+ * Called whenever a RoboMiner completes its task.
+ */
+void ColonySimulation::onMinerTaskComplete(Robot* robot)
+{
+	if (mRobotList.find(robot) == mRobotList.end()) { throw std::runtime_error("ColonySimulation::onMinerTaskComplete() called with a Robot not in the Robot List!"); }
+
+	auto& robotTile = *mRobotList[robot];
+	auto& miner = *static_cast<Robominer*>(robot);
+
+	auto& mineFacility = miner.buildMine(*mTileMap, robotTile.xyz());
+	mineFacility.extensionComplete().connect({this, &ColonySimulation::onMineFacilityExtend});
+}
+
+
+void ColonySimulation::onMineFacilityExtend(MineFacility* mineFacility)
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	auto& mineFacilityTile = structureManager.tileFromStructure(mineFacility);
+	auto& mineDepthTile = mTileMap->getTile({mineFacilityTile.xy(), mineFacility->mine()->depth()});
+	structureManager.addStructure(*new MineShaft(), mineDepthTile);
+	mineDepthTile.index(TerrainType::Dozed);
+	mineDepthTile.excavated(true);
+
+	mMineFacilityExtendedSignal(mineFacility);
+}
+
+
+/**
+ * Destroys the tile map along with the mines on it.
+ *
+ * \note	Mines only ever live on the colony's tile map, so once it is gone
+ *			the slabs of the Mine arena are released in one go.
+ */
+void ColonySimulation::destroyTileMap()
+{
+	mTileMap.reset();
+	Mine::arena().reset();
+}
+
+
+/**
+ * Writes the colony into a save game root element.
+ */
+void ColonySimulation::serialize(NAS2D::Xml::XmlElement* root)
+{
+	serializeSections(*root);
+	root->linkEndChild(structureRecordsToElement(NAS2D::Utility<StructureManager>::get().structureRecords()));
+	root->linkEndChild(robotRecordsToElement(robotRecords(mRobotPool, mRobotList)));
+	root->linkEndChild(researchRecordToElement(researchRecord(mResearchTracker)));
+	root->linkEndChild(tileLayerToElement(mTileMap->tileLayer()));
+}
+
+
+/**
+ * Writes the colony as binary savegame sections.
+ */
+void ColonySimulation::serialize(SavegameWriter& savegame)
+{
+	serializeSections(savegame);
+	savegame.writeStructures(NAS2D::Utility<StructureManager>::get().structureRecords());
+	savegame.writeRobots(robotRecords(mRobotPool, mRobotList));
+	savegame.writeResearch(researchRecord(mResearchTracker));
+	savegame.writeTileLayer(mTileMap->tileLayer());
+}
+
+
+/**
+ * Writes the sections that are stored as elements in both formats to either
+ * an XML root element or a SavegameWriter. Both take ownership of the
+ * elements passed to linkEndChild().
+ */
+template <typename Savegame>
+void ColonySimulation::serializeSections(Savegame& savegame)
+{
+	savegame.linkEndChild(serializeProperties());
+	savegame.linkEndChild(mTileMap->serializeMines());
+	savegame.linkEndChild(writeRandomStreams());
+	savegame.linkEndChild(NAS2D::dictionaryToAttributes("turns", {{{"count", mTurnCount}}}));
+
+	const auto& population = mPopulation.getPopulations();
+	savegame.linkEndChild(NAS2D::dictionaryToAttributes(
+		"population",
+		{{
+			{"morale", mMorale.currentMorale()},
+			{"prev_morale", mMorale.previousMorale()},
+			{"colonist_landers", mLandersColonist},
+			{"cargo_landers", mLandersCargo},
+			{"turn_number_of_landing", mTurnNumberOfLanding},
+			{"children", population.child},
+			{"students", population.student},
+			{"workers", population.worker},
+			{"scientists", population.scientist},
+			{"retired", population.retiree},
+			{"mean_crime", mMeanCrimeRate},
+		}}
+	));
+
+	auto moraleChangeReasons = new NAS2D::Xml::XmlElement("morale_change");
+	for (auto& [message, value] : mMoraleChangeReasons)
+	{
+		moraleChangeReasons->linkEndChild(NAS2D::dictionaryToAttributes(
+			"change", {{{"message", message}, {"val", value}}}
+		));
+	}
+	savegame.linkEndChild(moraleChangeReasons);
+}
+
+
+NAS2D::Xml::XmlElement* ColonySimulation::serializeProperties()
+{
+	return NAS2D::dictionaryToAttributes(
+		"properties",
+		{{
+			{"sitemap", mPlanetAttributes.mapImagePath},
+			{"mapwidth", mTileMap->size().x},
+			{"mapheight", mTileMap->size().y},
+			{"tset", mPlanetAttributes.tilesetPath},
+			{"diggingdepth", mPlanetAttributes.maxDepth},
+			{"meansolardistance", mPlanetAttributes.meanSolarDistance},
+			{"difficulty", difficultyString(mDifficulty)},
+		}}
+	);
+}
+
+
+/**
+ * Replaces the current colony with the one stored in a savegame.
+ */
+void ColonySimulation::load(SavegameReader& savegame)
+{
+	auto* root = savegame.root();
+
+	scrubRobotList();
+	NAS2D::Utility<StructureManager>::get().dropAllStructures();
+	ccLocation() = CcNotPlaced;
+
+	mConnectednessOverlay.clear();
+	destroyTileMap();
+	mMoraleChangeReasons.clear();
+
+	readRandomStreams(root->firstChildElement("random"));
+
+	NAS2D::Xml::XmlElement* map = root->firstChildElement("properties");
+	const auto dictionary = NAS2D::attributesToDictionary(*map);
+
+	mPlanetAttributes = Planet::Attributes();
+	mPlanetAttributes.maxDepth = dictionary.get<int>("diggingdepth");
+	mPlanetAttributes.mapImagePath = dictionary.get("sitemap");
+	mPlanetAttributes.mapSize = {dictionary.get<int>("mapwidth", 0), dictionary.get<int>("mapheight", 0)};
+	mPlanetAttributes.tilesetPath = dictionary.get("tset");
+	mPlanetAttributes.meanSolarDistance = dictionary.get<float>("meansolardistance");
+
+	setMeanSolarDistance(mPlanetAttributes.meanSolarDistance);
+
+	difficulty(stringToEnum(difficultyTable, dictionary.get("difficulty", std::string{"Medium"})));
+
+	mTileMap = std::make_unique<TileMap>(mPlanetAttributes.mapImagePath, mPlanetAttributes.mapSize, mPlanetAttributes.maxDepth);
+	mTileMap->deserialize(root->firstChildElement("mines"), savegame.tileLayer());
+	connectTileMapSignals();
+
+	mTruckRoutePlanner = std::make_unique<TruckRoutePlanner>(*mTileMap);
+	NAS2D::Utility<RouteCache>::get().clear();
+
+	readRobots(savegame.robots());
+	readStructures(savegame.structures());
+
+	mRepairScheduler.clear();
+	for (auto* structure : NAS2D::Utility<StructureManager>::get().allStructures())
+	{
+		mRepairScheduler.update(*structure);
+	}
+
+	mResearchTracker = readResearch(savegame.research());
+
+	readPopulation(root->firstChildElement("population"));
+	readTurns(root->firstChildElement("turns"));
+
+	readMoraleChanges(root->firstChildElement("morale_change"));
+
+	updateConnectedness();
+
+	NAS2D::Utility<StructureManager>::get().updateEnergyProduction();
+	NAS2D::Utility<StructureManager>::get().updateEnergyConsumed();
+	NAS2D::Utility<StructureManager>::get().assignColonistsToResidences(mPopulationPool);
+
+	mRobotPool.update();
+	updateResidentialCapacity();
+
+	updateRoads();
+	findMineRoutes();
+	updateFood();
+	NAS2D::Utility<StructureManager>::get().resourceLedger().recount();
+	NAS2D::Utility<StructureManager>::get().productInventory().recount();
+	updatePlayerResources();
+
+	if (mTurnCount == 0 && NAS2D::Utility<StructureManager>::get().count() != 0)
+	{
+		/**
+		 * There should only ever be one structure if the turn count is 0, the
+		 * SEED Lander which at this point should not have been deployed.
+		 */
+		const auto& list = NAS2D::Utility<StructureManager>::get().getStructures<SeedLander>();
+		if (list.size() != 1) { throw std::runtime_error("ColonySimulation::load(): Turn counter at 0 but more than one structure in list."); }
+
+		SeedLander* seedLander = list[0];
+		if (!seedLander) { throw std::runtime_error("ColonySimulation::load(): Structure in list is not a SeedLander."); }
+
+		seedLander->deploySignal().connect({this, &ColonySimulation::onDeploySeedLander});
+	}
+
+	mCommRangeCoverage = CoverageLayer{mTileMap->size(), mTileMap->maxDepth() + 1};
+	mPoliceCoverage = CoverageLayer{mTileMap->size(), mTileMap->maxDepth() + 1};
+	mCommRangeSources.clear();
+	mPoliceSources.clear();
+	mPoliceOverlayChunks = 0;
+	mCommRangeOverlay.clear();
+	mPoliceOverlays.clear();
+	mPoliceOverlays.resize(static_cast<std::vector<Tile*>::size_type>(mTileMap->maxDepth() + 1));
+	updateCommRangeOverlay();
+	updatePoliceOverlay();
+}
+
+
+void ColonySimulation::readRobots(const std::vector<RobotRecord>& records)
+{
+	mRobotPool.clear();
+	mRobotList.clear();
+
+	for (const auto& record : records)
+	{
+		const auto robotType = static_cast<Robot::Type>(record.type);
+		auto& robot = addRobot(robotType);
+		if (robotType == Robot::Type::Digger)
+		{
+			static_cast<Robodigger&>(robot).direction(static_cast<Direction>(record.direction.value_or(0)));
+		}
+
+		robot.fuelCellAge(record.age);
+
+		const auto position = record.position.value_or(MapCoordinate{{0, 0}, 0});
+
+		if (record.taskTurns > 0)
+		{
+			robot.startTask(record.taskTurns);
+			mRobotPool.insertRobotIntoTable(mRobotList, robot, mTileMap->getTile(position));
+			mRobotList[&robot]->index(TerrainType::Dozed);
+		}
+
+		if (position.z > 0)
+		{
+			mRobotList[&robot]->excavated(true);
+		}
+	}
+
+	mRobotsChangedSignal();
+}
+
+
+void ColonySimulation::readStructures(const std::vector<StructureRecord>& records)
+{
+	for (const auto& record : records)
+	{
+		const auto& mapCoordinate = record.position;
+		auto& tile = mTileMap->getTile(mapCoordinate);
+		tile.index(TerrainType::Dozed);
+		tile.excavated(true);
+
+		auto structureId = static_cast<StructureID>(record.type);
+		if (structureId == StructureID::SID_TUBE)
+		{
+			addTube(static_cast<ConnectorDir>(record.direction), tile);
+			continue; // FIXME: ugly
+		}
+
+		auto& structure = *StructureCatalogue::get(structureId);
+
+		if (structureId == StructureID::SID_COMMAND_CENTER)
+		{
+			ccLocation() = mapCoordinate.xy;
+		}
+
+		if (structureId == StructureID::SID_MINE_FACILITY)
+		{
+			auto* mine = mTileMap->getTile({mapCoordinate.xy, 0}).mine();
+			if (mine == nullptr)
+			{
+				throw std::runtime_error("Mine Facility is located on a Tile with no Mine.");
+			}
+
+			auto& mineFacility = *static_cast<MineFacility*>(&structure);
+			mineFacility.mine(mine);
+			mineFacility.maxDepth(mTileMap->maxDepth());
+			mineFacility.extensionComplete().connect({this, &ColonySimulation::onMineFacilityExtend});
+
+			if (record.assignedTrucks)
+			{
+				mineFacility.assignedTrucks(*record.assignedTrucks);
+			}
+
+			if (record.digTurnsRemaining)
+			{
+				mineFacility.digTimeRemaining(*record.digTurnsRemaining);
+			}
+		}
+
+		if (structureId == StructureID::SID_AIR_SHAFT && mapCoordinate.z != 0)
+		{
+			static_cast<AirShaft*>(&structure)->ug(); // force underground state
+		}
+
+		if (structureId == StructureID::SID_SEED_LANDER)
+		{
+			static_cast<SeedLander*>(&structure)->position(mapCoordinate.xy);
+		}
+
+		if (structureId == StructureID::SID_AGRIDOME ||
+			structureId == StructureID::SID_COMMAND_CENTER)
+		{
+			if (!record.foodLevel)
+			{
+				throw std::runtime_error("ColonySimulation::readStructures(): FoodProduction structure saved without a food level.");
+			}
+
+			static_cast<FoodProduction*>(&structure)->foodLevel(*record.foodLevel);
+		}
+
+		structure.age(record.age);
+		structure.forced_state_change(static_cast<StructureState>(record.state), static_cast<DisabledReason>(record.disabledReason), static_cast<IdleReason>(record.idleReason));
+		structure.connectorDirection(static_cast<ConnectorDir>(record.direction));
+		structure.integrity(record.integrity);
+
+		if (record.forcedIdle) { structure.forceIdle(true); }
+
+		structure.production() = record.production;
+		structure.storage() = record.storage;
+
+		if (structure.structureClass() == Structure::StructureClass::Residence && record.waste)
+		{
+			auto& residence = *static_cast<Residence*>(&structure);
+			residence.wasteAccumulated(record.waste->accumulated);
+			residence.wasteOverflow(record.waste->overflow);
+		}
+
+		if (structure.structureClass() == Structure::StructureClass::Maintenance && record.maintenancePersonnel)
+		{
+			auto& maintenanceFacility = *static_cast<MaintenanceFacility*>(&structure);
+			maintenanceFacility.personnel(*record.maintenancePersonnel);
+			maintenanceFacility.resources(mResourcesCount);
+		}
+
+		if (structure.isWarehouse())
+		{
+			if (!record.warehouseProducts)
+			{
+				throw std::runtime_error("ColonySimulation::readStructures(): Warehouse saved without its products.");
+			}
+
+			static_cast<Warehouse*>(&structure)->products().counts(*record.warehouseProducts);
+		}
+
+		if (structure.isFactory())
+		{
+			const auto production = record.factoryProduction.value_or(StructureRecord::FactoryProduction{0, 0});
+
+			auto& factory = *static_cast<Factory*>(&structure);
+			factory.productType(static_cast<ProductType>(production.productType));
+			factory.productionTurnsCompleted(production.turnsCompleted);
+			factory.resourcePool(&mResourcesCount);
+			factory.productionComplete().connect({this, &ColonySimulation::onFactoryProductionComplete});
+		}
+
+		if (structure.hasCrime())
+		{
+			structure.crimeRate(record.crimeRate.value_or(0));
+		}
+
+		structure.populationAvailable() = {record.workersAvailable, record.scientistsAvailable};
+
+		NAS2D::Utility<StructureManager>::get().addStructure(structure, tile);
+	}
+}
+
+
+void ColonySimulation::readTurns(NAS2D::Xml::XmlElement* element)
+{
+	if (element)
+	{
+		mTurnCount = NAS2D::attributesToDictionary(*element).get<int>("count");
+	}
+}
+
+
+/**
+ * Reads the population tag.
+ */
+void ColonySimulation::readPopulation(NAS2D::Xml::XmlElement* element)
+{
+	if (element)
+	{
+		mPopulation = {};
+
+		const auto dictionary = NAS2D::attributesToDictionary(*element);
+
+		mLandersColonist = dictionary.get<int>("colonist_landers");
+		mLandersCargo = dictionary.get<int>("cargo_landers");
+
+		mMorale = Morale(dictionary.get<int>("morale"), dictionary.get<int>("prev_morale"));
+
+		mTurnNumberOfLanding = dictionary.get<int>("turn_number_of_landing", constants::ColonyShipOrbitTime);
+
+		mMeanCrimeRate = dictionary.get<int>("mean_crime", 0);
+
+		const auto children = dictionary.get<int>("children");
+		const auto students = dictionary.get<int>("students");
+		const auto workers = dictionary.get<int>("workers");
+		const auto scientists = dictionary.get<int>("scientists");
+		const auto retired = dictionary.get<int>("retired");
+
+		mPopulation.addPopulation({children, students, workers, scientists, retired});
+	}
+}
+
+
+void ColonySimulation::readMoraleChanges(NAS2D::Xml::XmlElement* moraleChangeElement)
+{
+	if (!moraleChangeElement) { return; }
+
+	for (auto messageElement = moraleChangeElement->firstChildElement(); messageElement; messageElement = messageElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*messageElement);
+
+		const auto message = dictionary.get("message");
+		const auto val = dictionary.get<int>("val");
+
+		mMoraleChangeReasons.push_back({message, val});
+	}
+}
+
+
+/**
+ * Removes deployed robots from the TileMap to
+ * prevent dangling pointers. Yay for raw memory!
+ */
+void ColonySimulation::scrubRobotList()
+{
+	for (auto it : mRobotList)
+	{
+		it.second->removeMapObject();
+	}
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "Common.h"
+#include "DeferredSignal.h"
+#include "Notification.h"
+#include "StorableResources.h"
+#include "RepairScheduler.h"
+#include "RobotPool.h"
+
+#include "Constants/Numbers.h"
+
+#include "Map/MapCoordinate.h"
+
+#include "States/CrimeRateUpdate.h"
+#include "States/CrimeExecution.h"
+#include "States/Planet.h"
+
+#include <libOPHD/Map/CoverageLayer.h>
+
+#include <libOPHD/Population/PopulationPool.h>
+#include <libOPHD/Population/Population.h>
+#include <libOPHD/Population/Morale.h>
+
+#include <libOPHD/RandomNumberGenerator.h>
+
+#include <libOPHD/Technology/ResearchTracker.h>
+
+#include <NAS2D/Math/Point.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace NAS2D
+{
+	namespace Xml
+	{
+		class XmlElement;
+	}
+}
+
+class CargoLander;
+class ColonistLander;
+class Factory;
+class MineFacility;
+class SavegameReader;
+class SavegameWriter;
+class SeedLander;
+class Tile;
+class TileMap;
+class TruckRoutePlanner;
+struct RobotRecord;
+struct StructureRecord;
+
+
+using RobotTileTable = std::map<Robot*, Tile*>;
+
+
+/**
+ * Owns the state of a colony and advances it one turn at a time.
+ *
+ * ColonySimulation has no dependency on the Renderer or any other part of the
+ * user interface. Anything the player should be told about is reported through
+ * the signals below, which lets the simulation run headless (benchmarks, tests)
+ * as well as underneath MapViewState.
+ */
+class ColonySimulation
+{
+public:
+	enum class PopulationLevel
+	{
+		Small = 1,
+		Large = 2
+	};
+
+	/** Area a structure currently contributes to a CoverageLayer. */
+	struct CoverageArea
+	{
+		NAS2D::Point<int> center;
+		int depth;
+		int radius;
+
+		bool operator==(const CoverageArea&) const = default;
+	};
+
+	using CoverageSources = std::map<const Structure*, CoverageArea>;
+	using MoraleReasonList = std::vector<std::pair<std::string, int>>;
+
+	using NotificationSignal = DeferredSignal<const Notification&>;
+	using RobotsChangedSignal = DeferredSignal<>;
+	using RobotRemovedSignal = DeferredSignal<Robot*>;
+	using ResourcesChangedSignal = DeferredSignal<>;
+	using MineFacilityExtendedSignal = DeferredSignal<MineFacility*>;
+	using ColonyShipDeorbitedSignal = DeferredSignal<bool>;
+	using ConnectednessChangedSignal = DeferredSignal<>;
+
+public:
+	ColonySimulation();
+	ColonySimulation(const Planet::Attributes& planetAttributes, Difficulty selectedDifficulty, std::uint64_t randomSeed = generateRandomSeed());
+	~ColonySimulation();
+
+	void load(SavegameReader& savegame);
+	void serialize(NAS2D::Xml::XmlElement* root);
+	void serialize(SavegameWriter& savegame);
+
+	/**
+	 * Phases of nextTurn(), counting the ones only run once morale is
+	 * enabled.
+	 */
+	static constexpr int TurnPhaseCount = 21;
+
+	void nextTurn();
+
+	int turnPhasesDone() const { return mTurnPhasesDone; }
+	const char* turnPhase() const { return mTurnPhase; }
+
+	void setPopulationLevel(PopulationLevel popLevel);
+
+	Difficulty difficulty() const { return mDifficulty; }
+	void difficulty(Difficulty difficulty);
+
+	const Planet::Attributes& planetAttributes() const { return mPlanetAttributes; }
+
+	TileMap& tileMap() { return *mTileMap; }
+	const TileMap& tileMap() const { return *mTileMap; }
+
+	RobotPool& robotPool() { return mRobotPool; }
+	const RobotPool& robotPool() const { return mRobotPool; }
+	RobotTileTable& robotList() { return mRobotList; }
+	const RobotTileTable& robotList() const { return mRobotList; }
+
+	Population& population() { return mPopulation; }
+	const Population& population() const { return mPopulation; }
+	PopulationPool& populationPool() { return mPopulationPool; }
+	const PopulationPool& populationPool() const { return mPopulationPool; }
+	const Morale& morale() const { return mMorale; }
+
+	ResearchTracker& researchTracker() { return mResearchTracker; }
+
+	StorableResources& resources() { return mResourcesCount; }
+	const StorableResources& resources() const { return mResourcesCount; }
+
+	const int& food() const { return mFood; }
+	int residentialCapacity() const { return mResidentialCapacity; }
+	int meanCrimeRate() const { return mMeanCrimeRate; }
+	const MoraleReasonList& moraleReasons() const { return mMoraleChangeReasons; }
+
+	int turnCount() const { return mTurnCount; }
+	int colonistLanders() const { return mLandersColonist; }
+	int cargoLanders() const { return mLandersCargo; }
+
+	std::vector<Tile*>& connectednessOverlay() { return mConnectednessOverlay; }
+	std::vector<Tile*>& commRangeOverlay() { return mCommRangeOverlay; }
+	std::vector<Tile*>& policeOverlay(int depth) { return mPoliceOverlays[static_cast<std::size_t>(depth)]; }
+	const CoverageLayer& commRangeCoverage() const { return mCommRangeCoverage; }
+	const CoverageLayer& policeCoverage() const { return mPoliceCoverage; }
+	std::vector<Tile*>& truckRouteOverlay() { return mTruckRouteOverlay; }
+
+
+	bool isGameOver() const;
+
+	// STRUCTURE / ROBOT PLACEMENT
+	SeedLander& addSeedLander(NAS2D::Point<int> point);
+	ColonistLander& addColonistLander(Tile& tile);
+	CargoLander& addCargoLander(Tile& tile);
+	Structure& addStructure(StructureID structureId, Tile& tile);
+	void addTube(ConnectorDir dir, Tile& tile);
+	Robot& addRobot(Robot::Type type);
+
+	void updateConnectedness();
+	void updateCommRangeOverlay();
+	void updatePoliceOverlay();
+	void updatePlayerResources();
+	void updateFood();
+	void updatePopulation();
+	void updateRobots();
+
+	NotificationSignal::Source& notification() { return mNotificationSignal.source(); }
+	RobotsChangedSignal::Source& robotsChanged() { return mRobotsChangedSignal.source(); }
+	RobotRemovedSignal::Source& robotRemoved() { return mRobotRemovedSignal.source(); }
+	ResourcesChangedSignal::Source& resourcesChanged() { return mResourcesChangedSignal.source(); }
+	MineFacilityExtendedSignal::Source& mineFacilityExtended() { return mMineFacilityExtendedSignal.source(); }
+	ColonyShipDeorbitedSignal::Source& colonyShipDeorbited() { return mColonyShipDeorbitedSignal.source(); }
+	ConnectednessChangedSignal::Source& connectednessChanged() { return mConnectednessChangedSignal.source(); }
+
+	SignalQueue& signalQueue() { return mSignalQueue; }
+
+private:
+	template <typename Phase>
+	void runPhase(const char* name, Phase phase);
+
+	// ROBOT EVENT HANDLERS
+	void onDozerTaskComplete(Robot* robot);
+	void onDiggerTaskComplete(Robot* robot);
+	void onMinerTaskComplete(Robot* robot);
+
+	// STRUCTURE EVENT HANDLERS
+	void onDeployCargoLander();
+	void onDeployColonistLander();
+	void onDeploySeedLander(NAS2D::Point<int> point);
+	void onFactoryProductionComplete(Factory& factory);
+	void onMineFacilityExtend(MineFacility* mineFacility);
+	void onConnectivityChanged();
+
+	void pullRobotFromFactory(ProductType productType, Factory& factory);
+
+	// TURN LOGIC
+	void checkAgingStructures();
+	void checkNewlyBuiltStructures();
+	void transferFoodToCommandCenter();
+	void updateResidentialCapacity();
+	void updateCrime();
+	void updateMaintenance();
+	void updateCommercial();
+	void updateBiowasteRecycling();
+	void updateMorale();
+	void notifyBirthsAndDeaths();
+	void updateResources();
+	void updateRoads();
+	void updateFactories();
+	void checkColonyShip();
+	void checkWarehouseCapacity();
+
+	void findMineRoutes();
+	void transportOreFromMines();
+	void transportResourcesToStorage();
+
+	// SAVE GAME MANAGEMENT FUNCTIONS
+	void readRobots(const std::vector<RobotRecord>& records);
+	void readStructures(const std::vector<StructureRecord>& records);
+	void readTurns(NAS2D::Xml::XmlElement* element);
+	void readPopulation(NAS2D::Xml::XmlElement* element);
+	void readMoraleChanges(NAS2D::Xml::XmlElement* element);
+	template <typename Savegame>
+	void serializeSections(Savegame& savegame);
+	NAS2D::Xml::XmlElement* serializeProperties();
+
+	void connectSignals();
+	void connectTileMapSignals();
+	void disconnectSignals();
+
+	void scrubRobotList();
+	void destroyTileMap();
+
+private:
+	// SIGNALS
+	SignalQueue mSignalQueue;
+	NotificationSignal mNotificationSignal{mSignalQueue};
+	RobotsChangedSignal mRobotsChangedSignal{mSignalQueue};
+	RobotRemovedSignal mRobotRemovedSignal{mSignalQueue};
+	ResourcesChangedSignal mResourcesChangedSignal{mSignalQueue};
+	MineFacilityExtendedSignal mMineFacilityExtendedSignal{mSignalQueue};
+	ColonyShipDeorbitedSignal mColonyShipDeorbitedSignal{mSignalQueue};
+	ConnectednessChangedSignal mConnectednessChangedSignal{mSignalQueue};
+
+	std::unique_ptr<TileMap> mTileMap;
+	CrimeRateUpdate mCrimeRateUpdate;
+	CrimeExecution mCrimeExecution;
+
+	ResearchTracker mResearchTracker;
+
+	Planet::Attributes mPlanetAttributes;
+
+	int mFood{0};
+
+	// DIFFICULTY
+	Difficulty mDifficulty = Difficulty::Medium;
+
+	// Length of "honeymoon period" of no crime/morale updates after landing, in turns
+	static const std::map<Difficulty, int> GracePeriod;
+
+	// Morale loss multiplier on colonist death due to colony ship de-orbit
+	static const std::map<Difficulty, int> ColonyShipDeorbitMoraleLossMultiplier;
+
+	int mTurnCount = 0;
+
+	// Progress of the turn being run, read by the UI thread while it runs
+	std::atomic<int> mTurnPhasesDone{0};
+	std::atomic<const char*> mTurnPhase{nullptr};
+
+	int mTurnNumberOfLanding = constants::ColonyShipOrbitTime; /**< First turn that human colonists landed. */
+
+	Morale mMorale;
+	MoraleReasonList mMoraleChangeReasons;
+	int mMeanCrimeRate = 0;
+
+	int mLandersColonist = 0;
+	int mLandersCargo = 0;
+
+	int mResidentialCapacity = 0;
+
+	// POOLS
+	StorableResources mResourcesCount;
+	RobotPool mRobotPool; /**< Robots that are currently available for use. */
+	RepairScheduler mRepairScheduler;
+	PopulationPool mPopulationPool;
+
+	RobotTileTable mRobotList; /**< List of active robots and their positions on the map. */
+	Population mPopulation;
+
+	// ROUTING
+	std::unique_ptr<TruckRoutePlanner> mTruckRoutePlanner;
+
+	// OVERLAYS
+	CoverageLayer mCommRangeCoverage;
+	CoverageLayer mPoliceCoverage;
+	CoverageSources mCommRangeSources;
+	CoverageSources mPoliceSources;
+	std::size_t mPoliceOverlayChunks{0}; /**< Allocated TileStore chunks when the police overlays were filled. */
+
+	std::vector<Tile*> mConnectednessOverlay;
+	std::vector<Tile*> mCommRangeOverlay;
+	std::vector<std::vector<Tile*>> mPoliceOverlays;
+	std::vector<Tile*> mTruckRouteOverlay;
+
+};
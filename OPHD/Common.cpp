@@ -1,15 +1,12 @@
 #include "Common.h"
 #include "Constants/Numbers.h"
+#include "Savegame.h"
 #include "StructureManager.h"
 
 #include "MapObjects/Structure.h"
 #include "MapObjects/Structures/Warehouse.h"
 
-#include <libOPHD/XmlSerializer.h>
-
 #include <NAS2D/Utility.h>
-#include <NAS2D/Xml/XmlDocument.h>
-#include <NAS2D/Xml/XmlElement.h>
 
 #include <stdexcept>
 #include <algorithm>
@@ -233,28 +230,8 @@ Color structureTextColorFromIndex(StructureState structureState)
 
 void checkSavegameVersion(const std::string& filename)
 {
-	// openSavegame checks version number after opening file
-	openSavegame(filename);
-}
-
-
-/**
- * Open a saved game and validate version.
- *
- * \throws	Throws a std::runtime_error if there are any errors with a savegame version, formation or missing root nodes.
- */
-NAS2D::Xml::XmlDocument openSavegame(const std::string& filename)
-{
-	auto xmlDocument = openXmlFile(filename, constants::SaveGameRootNode);
-
-	auto savegameVersion = xmlDocument.firstChildElement(constants::SaveGameRootNode)->attribute("version");
-
-	if (savegameVersion != constants::SaveGameVersion)
-	{
-		throw std::runtime_error("Savegame version mismatch: '" + filename + "'. Expected " + constants::SaveGameVersion + ", found " + savegameVersion + ".");
-	}
-
-	return xmlDocument;
+	// loadSavegame checks version number after opening file
+	loadSavegame(filename);
 }
 
 
@@ -283,7 +260,7 @@ void drawProgressBar(int value, int max, NAS2D::Rectangle<int> rect, int padding
 	if (max > 0)
 	{
 		auto innerRect = rect.inset(padding);
-		innerRect.size.x *= clippedValue / max;
+		innerRect.size.x = innerRect.size.x * clippedValue / max;
 		renderer.drawBoxFilled(innerRect, NAS2D::Color{0, 100, 0});
 	}
 }
@@ -291,50 +268,17 @@ void drawProgressBar(int value, int max, NAS2D::Rectangle<int> rect, int padding
 
 int getTruckAvailability()
 {
-	int trucksAvailable = 0;
-
-	const auto& warehouseList = NAS2D::Utility<StructureManager>::get().getStructures<Warehouse>();
-	for (auto* warehouse : warehouseList)
-	{
-		trucksAvailable += warehouse->products().count(ProductType::PRODUCT_TRUCK);
-	}
-
-	return trucksAvailable;
+	return NAS2D::Utility<StructureManager>::get().productInventory().count(ProductType::PRODUCT_TRUCK);
 }
 
 
 int pullTruckFromInventory()
 {
-	int trucksAvailable = getTruckAvailability();
-
-	if (trucksAvailable == 0) { return 0; }
-
-	const auto& warehouseList = NAS2D::Utility<StructureManager>::get().getStructures<Warehouse>();
-	for (auto* warehouse : warehouseList)
-	{
-		if (warehouse->products().pull(ProductType::PRODUCT_TRUCK, 1) > 0)
-		{
-			return 1;
-		}
-	}
-
-	return 0;
+	return NAS2D::Utility<StructureManager>::get().productInventory().pull(ProductType::PRODUCT_TRUCK, 1);
 }
 
 
 int pushTruckIntoInventory()
 {
-	const int storageNeededForTruck = storageRequiredPerUnit(ProductType::PRODUCT_TRUCK);
-
-	const auto& warehouseList = NAS2D::Utility<StructureManager>::get().getStructures<Warehouse>();
-	for (auto* warehouse : warehouseList)
-	{
-		if (warehouse->products().availableStorage() >= storageNeededForTruck)
-		{
-			warehouse->products().store(ProductType::PRODUCT_TRUCK, 1);
-			return 1;
-		}
-	}
-
-	return 0;
+	return NAS2D::Utility<StructureManager>::get().productInventory().store(ProductType::PRODUCT_TRUCK, 1) ? 1 : 0;
 }
@@ -8,11 +8,6 @@
 #include <string>
 #include <vector>
 
-namespace NAS2D::Xml
-{
-	class XmlDocument;
-}
-
 enum class StructureState;
 
 enum class Difficulty
@@ -54,6 +49,17 @@ enum class Direction
 };
 
 
+/**
+ * Concrete kind of a MapObject, so code holding a MapObject* can tell what it
+ * is without a dynamic_cast.
+ */
+enum class MapObjectKind
+{
+	Structure,
+	Robot
+};
+
+
 /**
  * Terrain type enumeration
  */
@@ -314,7 +320,6 @@ extern const std::array<NAS2D::Rectangle<int>, 4> ResourceImageRectsOre;
 extern const std::map<std::array<bool, 4>, std::string> IntersectionPatternTable;
 
 void checkSavegameVersion(const std::string& filename);
-NAS2D::Xml::XmlDocument openSavegame(const std::string& filename);
 
 void setMeanSolarDistance(float newMeanSolarDistance);
 float getMeanSolarDistance();
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <NAS2D/Signal/Signal.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Holds back emissions of DeferredSignals so they can be delivered later.
+ *
+ * Not thread safe. Whichever thread is emitting owns the queue until it
+ * hands it back, such as by finishing a turn that the other thread joins.
+ */
+class SignalQueue
+{
+public:
+	bool holding() const { return mHolding; }
+	void hold() { mHolding = true; }
+
+	void push(std::function<void()> emission) { mEmissions.push_back(std::move(emission)); }
+
+	/**
+	 * Stops holding and emits everything held back, oldest first.
+	 */
+	void deliver()
+	{
+		mHolding = false;
+
+		auto emissions = std::move(mEmissions);
+		mEmissions.clear();
+		for (const auto& emission : emissions) { emission(); }
+	}
+
+private:
+	bool mHolding{false};
+	std::vector<std::function<void()>> mEmissions;
+};
+
+
+/**
+ * Signal that is queued instead of emitted while its SignalQueue is holding.
+ * Arguments are copied into the queue.
+ *
+ * The wrapped signal is not exposed, so the only way to emit is through the
+ * queue. Listeners connect through source().
+ */
+template <typename... Params>
+class DeferredSignal
+{
+public:
+	using Signal = NAS2D::Signal<Params...>;
+	using Source = typename Signal::Source;
+
+	explicit DeferredSignal(SignalQueue& queue) : mQueue{queue} {}
+
+	Source& source() { return mSignal; }
+
+	void operator()(Params... params)
+	{
+		if (mQueue.holding())
+		{
+			mQueue.push([this, params...]() { mSignal(params...); });
+			return;
+		}
+
+		mSignal(params...);
+	}
+
+private:
+	SignalQueue& mQueue;
+	Signal mSignal;
+};
@@ -5,6 +5,9 @@
 #include "Map/TileMap.h"
 #include "MapObjects/Structure.h"
 
+#include <array>
+#include <stdexcept>
+
 
 using namespace NAS2D;
 
@@ -71,20 +74,8 @@ static bool validConnection(Structure* src, Structure* dst, Direction direction)
 }
 
 
-void walkGraph(const std::vector<MapCoordinate>& positions, TileMap& tileMap)
+namespace
 {
-	for (const auto& position : positions)
-	{
-		walkGraph(position, tileMap);
-	}
-}
-
-
-void walkGraph(const MapCoordinate& position, TileMap& tileMap)
-{
-	Tile& thisTile = tileMap.getTile(position);
-	thisTile.structure()->connected(true);
-
 	const auto directions = std::array{
 		Direction::Up,
 		Direction::Down,
@@ -94,17 +85,96 @@ void walkGraph(const MapCoordinate& position, TileMap& tileMap)
 		Direction::West,
 	};
 
-	for (const auto direction : directions)
+
+	/**
+	 * Depth first traversal from every position on the stack, connecting every
+	 * structure reachable from them. Uses an explicit stack so a long tube
+	 * network can't overflow the call stack.
+	 *
+	 * \return	Number of structures that were newly connected.
+	 */
+	std::size_t connectReachable(std::vector<MapCoordinate>& stack, const TileMap& tileMap)
 	{
-		const auto nextPosition = position.translate(direction);
-		if (!tileMap.isValidPosition(nextPosition)) { continue; }
+		std::size_t newlyConnected = 0;
 
-		auto& tile = tileMap.getTile(nextPosition);
-		if (!tile.thingIsStructure() || tile.structure()->connected()) { continue; }
+		while (!stack.empty())
+		{
+			const auto position = stack.back();
+			stack.pop_back();
+
+			auto* thisStructure = tileMap.getTile(position).structure();
+
+			for (const auto direction : directions)
+			{
+				const auto nextPosition = position.translate(direction);
+				if (!tileMap.isValidPosition(nextPosition)) { continue; }
+
+				const auto& tile = tileMap.getTile(nextPosition);
+				if (!tile.thingIsStructure() || tile.structure()->connected()) { continue; }
+
+				if (validConnection(thisStructure, tile.structure(), direction))
+				{
+					tile.structure()->connected(true);
+					++newlyConnected;
+					stack.push_back(nextPosition);
+				}
+			}
+		}
 
-		if (validConnection(thisTile.structure(), tile.structure(), direction))
+		return newlyConnected;
+	}
+}
+
+
+/**
+ * Connects the structures at the given positions and everything reachable from them.
+ *
+ * \return	Number of structures that were newly connected.
+ */
+std::size_t walkGraph(const std::vector<MapCoordinate>& positions, const TileMap& tileMap)
+{
+	std::size_t newlyConnected = 0;
+
+	std::vector<MapCoordinate> stack;
+	for (const auto& position : positions)
+	{
+		auto* structure = tileMap.getTile(position).structure();
+		if (!structure->connected())
 		{
-			walkGraph(nextPosition, tileMap);
+			structure->connected(true);
+			++newlyConnected;
 		}
+		stack.push_back(position);
 	}
+
+	return newlyConnected + connectReachable(stack, tileMap);
+}
+
+
+/**
+ * Connects newly placed structures, and anything reachable from them, if they
+ * are adjacent to an already connected structure. Existing connections are
+ * never removed, so this is only valid when structures have been added.
+ *
+ * \return	Number of structures that were newly connected.
+ */
+std::size_t extendGraph(const std::vector<MapCoordinate>& positions, const TileMap& tileMap)
+{
+	std::vector<MapCoordinate> stack;
+	for (const auto& position : positions)
+	{
+		for (const auto direction : directions)
+		{
+			const auto neighborPosition = position.translate(direction);
+			if (!tileMap.isValidPosition(neighborPosition)) { continue; }
+
+			const auto& tile = tileMap.getTile(neighborPosition);
+			if (tile.thingIsStructure() && tile.structure()->connected())
+			{
+				stack.push_back(neighborPosition);
+			}
+		}
+	}
+
+	return connectReachable(stack, tileMap);
 }
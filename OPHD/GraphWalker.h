@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 
@@ -7,5 +8,5 @@ struct MapCoordinate;
 class TileMap;
 
 
-void walkGraph(const std::vector<MapCoordinate>& positions, TileMap& tileMap);
-void walkGraph(const MapCoordinate& position, TileMap& tileMap);
+std::size_t walkGraph(const std::vector<MapCoordinate>& positions, const TileMap& tileMap);
+std::size_t extendGraph(const std::vector<MapCoordinate>& positions, const TileMap& tileMap);
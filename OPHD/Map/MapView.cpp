@@ -29,9 +29,11 @@ NAS2D::Rectangle<int> MapView::viewTileRect() const
 void MapView::mapViewLocation(const MapCoordinate& position)
 {
 	const auto sizeInTiles = mTileMap.size();
+	// When the view is bigger than the map along an axis, keep the whole map in view instead
+	const auto slack = sizeInTiles - NAS2D::Vector{mEdgeLength, mEdgeLength};
 	mOriginTilePosition.xy = {
-		std::clamp(position.xy.x, 0, sizeInTiles.x - mEdgeLength),
-		std::clamp(position.xy.y, 0, sizeInTiles.y - mEdgeLength)
+		std::clamp(position.xy.x, std::min(0, slack.x), std::max(0, slack.x)),
+		std::clamp(position.xy.y, std::min(0, slack.y), std::max(0, slack.y))
 	};
 	currentDepth(position.z);
 }
@@ -75,10 +77,11 @@ int MapView::viewSize() const
 
 void MapView::viewSize(int edgeSizeInTiles)
 {
-	// Set a cap on view size at the smallest map dimension
-	// The view diamond needs to be square, and we don't want to overflow map bounds when drawing the sqaure
+	// The view diamond needs to be square, so when zoomed out far enough to
+	// show the whole map it overhangs the shorter side. Tiles off the map are
+	// skipped when drawing.
 	const auto sizeInTiles = mTileMap.size();
-	const auto maxViewSize = std::min(sizeInTiles.x, sizeInTiles.y);
+	const auto maxViewSize = std::max(sizeInTiles.x, sizeInTiles.y);
 	mEdgeLength = std::clamp(edgeSizeInTiles, 3, maxViewSize);
 	// Re-clamp view location based on new edge length
 	mapViewLocation(mOriginTilePosition);
@@ -87,23 +90,20 @@ void MapView::viewSize(int edgeSizeInTiles)
 
 bool MapView::isVisibleTile(const MapCoordinate& position) const
 {
-	return viewTileRect().contains(position.xy) && position.z == mOriginTilePosition.z;
+	return viewTileRect().contains(position.xy) && position.z == mOriginTilePosition.z && mTileMap.isValidPosition(position);
 }
 
 
-void MapView::serialize(NAS2D::Xml::XmlElement* element)
+NAS2D::Xml::XmlElement* MapView::serialize()
 {
-	// ==========================================
-	// VIEW PARAMETERS
-	// ==========================================
-	element->linkEndChild(NAS2D::dictionaryToAttributes(
+	return NAS2D::dictionaryToAttributes(
 		"view_parameters",
 		{{
 			{"currentdepth", mOriginTilePosition.z},
 			{"viewlocation_x", mOriginTilePosition.xy.x},
 			{"viewlocation_y", mOriginTilePosition.xy.y},
 		}}
-	));
+	);
 }
 
 
@@ -41,7 +41,7 @@ public:
 
 	bool isVisibleTile(const MapCoordinate& position) const;
 
-	void serialize(NAS2D::Xml::XmlElement* element);
+	NAS2D::Xml::XmlElement* serialize();
 	void deserialize(NAS2D::Xml::XmlElement* element);
 
 private:
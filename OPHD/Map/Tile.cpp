@@ -7,50 +7,15 @@
 #include "../Constants/Numbers.h"
 
 #include <cfloat>
+#include <stdexcept>
 
 
-Tile::Tile(const MapCoordinate& position, TerrainType index) :
-	mIndex{index},
-	mPosition{position}
+Tile::Tile(TileStore& store, std::size_t index) :
+	mStore{&store},
+	mIndex{static_cast<std::uint32_t>(index)}
 {}
 
 
-Tile::Tile(Tile&& other) noexcept :
-	mIndex{other.mIndex},
-	mPosition{other.mPosition},
-	mMapObject{other.mMapObject},
-	mMine{other.mMine},
-	mOverlay{other.mOverlay},
-	mExcavated{other.mExcavated}
-{
-	other.mMapObject = nullptr;
-	other.mMine = nullptr;
-}
-
-
-Tile& Tile::operator=(Tile&& other) noexcept
-{
-	mIndex = other.mIndex;
-	mPosition = other.mPosition;
-	mMapObject = other.mMapObject;
-	mMine = other.mMine;
-	mOverlay = other.mOverlay;
-	mExcavated = other.mExcavated;
-
-	other.mMapObject = nullptr;
-	other.mMine = nullptr;
-
-	return *this;
-}
-
-
-Tile::~Tile()
-{
-	delete mMine;
-	delete mMapObject;
-}
-
-
 /**
  * Adds a new MapObject to the tile.
  *
@@ -58,16 +23,22 @@ Tile::~Tile()
  */
 void Tile::pushMapObject(MapObject* mapObject)
 {
-	if (mMapObject)
+	if (thing())
 	{
-		if (mMapObject == mapObject)
+		if (thing() == mapObject)
 		{
 			throw std::runtime_error("Attempting to pushMapObject on a tile where it's already set");
 		}
 		deleteMapObject();
 	}
 
-	mMapObject = mapObject;
+	if (!mapObject) { return; }
+
+	auto& current = mStore->occupant(mIndex);
+	current.mapObject = mapObject;
+	current.kind = mapObject->kind();
+	mStore->touch(mIndex);
+	mStore->changed(mIndex);
 }
 
 
@@ -78,7 +49,7 @@ void Tile::pushMapObject(MapObject* mapObject)
  */
 void Tile::deleteMapObject()
 {
-	delete mMapObject;
+	delete thing();
 	removeMapObject();
 }
 
@@ -90,39 +61,93 @@ void Tile::deleteMapObject()
  */
 void Tile::removeMapObject()
 {
-	mMapObject = nullptr;
+	if (!thing()) { return; }
+
+	mStore->occupant(mIndex).mapObject = nullptr;
+	mStore->releaseOccupantIfEmpty(mIndex);
+	mStore->touch(mIndex);
+	mStore->changed(mIndex);
 }
 
 
 void Tile::pushMine(Mine* mine)
 {
-	delete mMine;
-	mMine = mine;
+	delete this->mine();
+
+	if (!mine && !mStore->findOccupant(mIndex)) { return; }
+
+	mStore->occupant(mIndex).mine = mine;
+	mStore->releaseOccupantIfEmpty(mIndex);
+	mStore->touch(mIndex);
+	mStore->changed(mIndex);
 }
 
 
 Structure* Tile::structure() const
 {
-	return dynamic_cast<Structure*>(thing());
+	return thingIsStructure() ? static_cast<Structure*>(thing()) : nullptr;
 }
 
 
 Robot* Tile::robot() const
 {
-	return dynamic_cast<Robot*>(thing());
+	return thingIsRobot() ? static_cast<Robot*>(thing()) : nullptr;
+}
+
+
+namespace
+{
+	int chunksAlong(int tiles)
+	{
+		return (tiles + TileStore::ChunkSize - 1) / TileStore::ChunkSize;
+	}
+}
+
+
+TileStore::TileStore(NAS2D::Vector<int> size, int levels, const std::vector<TerrainType>& baseTerrain) :
+	mSize{size},
+	mLevels{levels},
+	mChunkCounts{chunksAlong(size.x), chunksAlong(size.y)},
+	mBaseTerrain{baseTerrain},
+	mChunkCount{static_cast<std::size_t>(mChunkCounts.x) * static_cast<std::size_t>(mChunkCounts.y) * static_cast<std::size_t>(levels)},
+	mChunks(mChunkCount),
+	mChunkRevisions(mChunkCount)
+{
+	if (mBaseTerrain.size() != static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y))
+	{
+		throw std::runtime_error("TileStore base terrain does not match the map size");
+	}
+
+	// Everything on the surface is in use from the start
+	const auto surfaceChunks = static_cast<std::size_t>(mChunkCounts.x) * static_cast<std::size_t>(mChunkCounts.y);
+	for (std::size_t chunk = 0; chunk < surfaceChunks; ++chunk)
+	{
+		materialize(chunk);
+	}
+}
+
+
+TileStore::~TileStore()
+{
+	for (const auto& [index, occupant] : mOccupants)
+	{
+		delete occupant.mine;
+		delete occupant.mapObject;
+	}
 }
 
 
-float Tile::movementCost() const
+float TileStore::movementCost(std::size_t index) const
 {
-	if (index() == TerrainType::Impassable)
+	if (terrain(index) == TerrainType::Impassable)
 	{
 		return FLT_MAX;
 	}
 
-	if (!empty() && thingIsStructure() && structure()->isRoad())
+	auto* thing = mapObject(index);
+	if (thing && holds(index, MapObjectKind::Structure) && static_cast<Structure*>(thing)->isRoad())
 	{
-		Structure& road = *structure();
+		Structure& road = *static_cast<Structure*>(thing);
 
 		if (road.state() != StructureState::Operational)
 		{
@@ -138,10 +163,160 @@ float Tile::movementCost() const
 		}
 	}
 
-	if (!empty() && (!thingIsStructure() || (!structure()->isMineFacility() && !structure()->isSmelter())))
+	if (thing && (!holds(index, MapObjectKind::Structure) || (!static_cast<Structure*>(thing)->isMineFacility() && !static_cast<Structure*>(thing)->isSmelter())))
 	{
 		return FLT_MAX;
 	}
 
-	return constants::RouteBaseCost * static_cast<float>(index()) + 1.0f;
+	return constants::RouteBaseCost * static_cast<float>(terrain(index)) + 1.0f;
+}
+
+
+std::size_t TileStore::linearIndex(const MapCoordinate& position) const
+{
+	const auto convertedPosition = position.xy.to<std::size_t>();
+	const auto convertedZ = static_cast<std::size_t>(position.z);
+	const auto chunkCountX = static_cast<std::size_t>(mChunkCounts.x);
+	const auto chunkCountY = static_cast<std::size_t>(mChunkCounts.y);
+	const auto localMask = static_cast<std::size_t>(ChunkSize - 1);
+
+	const auto chunk = (convertedZ * chunkCountY + (convertedPosition.y >> ChunkShift)) * chunkCountX + (convertedPosition.x >> ChunkShift);
+	const auto local = ((convertedPosition.y & localMask) << ChunkShift) | (convertedPosition.x & localMask);
+	return (chunk << ChunkBits) | local;
+}
+
+
+MapCoordinate TileStore::position(std::size_t index) const
+{
+	const auto chunkCountX = static_cast<std::size_t>(mChunkCounts.x);
+	const auto chunkCountY = static_cast<std::size_t>(mChunkCounts.y);
+	const auto localMask = static_cast<std::size_t>(ChunkSize - 1);
+
+	const auto chunk = index >> ChunkBits;
+	const auto local = index & ChunkMask;
+	const auto chunkRow = chunk / chunkCountX;
+
+	const auto x = ((chunk - chunkRow * chunkCountX) << ChunkShift) | (local & localMask);
+	const auto y = ((chunkRow % chunkCountY) << ChunkShift) | (local >> ChunkShift);
+	return {{static_cast<int>(x), static_cast<int>(y)}, static_cast<int>(chunkRow / chunkCountY)};
+}
+
+
+void TileStore::terrain(std::size_t index, TerrainType terrain)
+{
+	if (write(index, static_cast<std::uint8_t>((cell(index) & ~TerrainMask) | static_cast<std::uint8_t>(terrain))))
+	{
+		changed(index);
+	}
+}
+
+
+void TileStore::excavated(std::size_t index, bool value)
+{
+	const auto packed = cell(index);
+	if (write(index, static_cast<std::uint8_t>(value ? (packed | ExcavatedBit) : (packed & ~ExcavatedBit))))
+	{
+		changed(index);
+	}
+}
+
+
+void TileStore::overlay(std::size_t index, Tile::Overlay overlay)
+{
+	write(index, static_cast<std::uint8_t>((cell(index) & ~OverlayMask) | (static_cast<int>(overlay) << OverlayShift)));
+}
+
+
+/**
+ * Stores a packed value, counting it as a new revision only if it differs
+ * from what was there.
+ *
+ * eturn	True if the value changed.
+ */
+bool TileStore::write(std::size_t index, std::uint8_t packed)
+{
+	auto& current = cell(index);
+	if (current == packed) { return false; }
+
+	current = packed;
+	touch(index);
+	return true;
+}
+
+
+void TileStore::touch(std::size_t index)
+{
+	mChunkRevisions[chunkOf(index)] = ++mRevision;
+}
+
+
+/**
+ * Reports a change to a tile's terrain or contents to anything that may be
+ * holding on to it. Overlays are only drawn, so they don't count.
+ */
+void TileStore::changed(std::size_t index)
+{
+	const auto tileIt = mTiles.find(static_cast<std::uint32_t>(index));
+	if (tileIt == mTiles.end()) { return; }
+
+	mTileChangedSignal(tileIt->second);
+}
+
+
+/**
+ * Gets the packed value of a tile in a chunk that has not been allocated.
+ *
+ * \note	Surface chunks are always allocated, so the tile is underground
+ *			and has not been excavated.
+ */
+std::uint8_t TileStore::defaultCell(std::size_t index) const
+{
+	const auto point = position(index).xy;
+	const auto terrain = mBaseTerrain[static_cast<std::size_t>(point.y) * static_cast<std::size_t>(mSize.x) + static_cast<std::size_t>(point.x)];
+	return static_cast<std::uint8_t>(static_cast<int>(terrain) | (static_cast<int>(Tile::Overlay::None) << OverlayShift));
+}
+
+
+TileStore::Chunk& TileStore::materialize(std::size_t chunkIndex)
+{
+	auto& chunk = mChunks[chunkIndex];
+	if (chunk) { return *chunk; }
+
+	chunk = std::make_unique<Chunk>();
+	++mMaterializedChunkCount;
+
+	// Tiles that fall past the edge of the map in partial chunks keep a
+	// zeroed cell and are never handed out
+	chunk->cells.fill(0);
+
+	const auto firstIndex = chunkIndex << ChunkBits;
+	for (std::size_t local = 0; local < ChunkArea; ++local)
+	{
+		const auto index = firstIndex + local;
+		const auto tilePosition = position(index);
+		if (tilePosition.xy.x >= mSize.x || tilePosition.xy.y >= mSize.y) { continue; }
+
+		chunk->cells[local] = defaultCell(index);
+		if (tilePosition.z == 0) { chunk->cells[local] |= ExcavatedBit; }
+	}
+
+	return *chunk;
+}
+
+
+Tile::Occupant& TileStore::occupant(std::size_t index)
+{
+	return mOccupants[static_cast<std::uint32_t>(index)];
+}
+
+
+void TileStore::releaseOccupantIfEmpty(std::size_t index)
+{
+	const auto occupantIt = mOccupants.find(static_cast<std::uint32_t>(index));
+	if (occupantIt == mOccupants.end()) { return; }
+
+	const auto& current = occupantIt->second;
+	if (current.mapObject || current.mine) { return; }
+
+	mOccupants.erase(occupantIt);
 }
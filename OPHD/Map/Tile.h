@@ -6,14 +6,34 @@
 
 #include <NAS2D/Math/Point.h>
 #include <NAS2D/Math/Vector.h>
+#include <NAS2D/Signal/Signal.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 
 class Mine;
 class MapObject;
 class Robot;
 class Structure;
+class TileStore;
 
 
+/**
+ * Handle to a single tile of a TileMap.
+ *
+ * The tile's data lives in its TileMap's TileStore; a Tile only knows where
+ * it is in the store. Tiles are not copyable and stay at the same address for
+ * the lifetime of the store, so references and pointers to them can be kept.
+ *
+ * Structures, robots, routes and the UI all hold on to tiles by address, so
+ * the store creates a tile's handle the first time the tile is asked for and
+ * keeps it from then on. Tiles nothing has asked for have no handle and cost
+ * only their packed byte.
+ */
 class Tile
 {
 public:
@@ -28,62 +48,290 @@ public:
 	};
 
 public:
-	Tile() = default;
-	Tile(const MapCoordinate& position, TerrainType);
+	Tile(TileStore& store, std::size_t index);
 	Tile(const Tile&) = delete;
 	Tile& operator=(const Tile&) = delete;
-	Tile(Tile&&) noexcept;
-	Tile& operator=(Tile&&) noexcept;
-	~Tile();
+	Tile(Tile&&) noexcept = default;
+	Tile& operator=(Tile&&) noexcept = default;
 
-	TerrainType index() const { return mIndex; }
-	void index(TerrainType index) { mIndex = index; }
+	TerrainType index() const;
+	void index(TerrainType index);
 
-	const MapCoordinate& xyz() const { return mPosition; }
-	NAS2D::Point<int> xy() const { return mPosition.xy; }
-	int depth() const { return mPosition.z; }
-	void depth(int i) { mPosition.z = i; }
+	MapCoordinate xyz() const;
+	NAS2D::Point<int> xy() const { return xyz().xy; }
+	int depth() const { return xyz().z; }
 
 	bool bulldozed() const { return index() == TerrainType::Dozed; }
 
-	bool excavated() const { return mExcavated; }
-	void excavated(bool value) { mExcavated = value; }
+	bool excavated() const;
+	void excavated(bool value);
 
-	MapObject* thing() const { return mMapObject; }
+	MapObject* thing() const;
 
-	bool empty() const { return mMapObject == nullptr; }
+	bool empty() const { return thing() == nullptr; }
 
-	bool hasMine() const { return mMine != nullptr; }
+	bool hasMine() const { return mine() != nullptr; }
 
 	Structure* structure() const;
 	Robot* robot() const;
 
-	bool thingIsStructure() const { return structure() != nullptr; }
-	bool thingIsRobot() const { return robot() != nullptr; }
+	bool thingIsStructure() const { return thingIs(MapObjectKind::Structure); }
+	bool thingIsRobot() const { return thingIs(MapObjectKind::Robot); }
 
 	void pushMapObject(MapObject*);
 	void deleteMapObject();
 
 	void removeMapObject();
 
-	const Mine* mine() const { return mMine; }
-	Mine* mine() { return mMine; }
+	const Mine* mine() const;
+	Mine* mine();
 	void pushMine(Mine*);
 
-	void overlay(Overlay overlay) { mOverlay = overlay; }
-	Overlay overlay() const { return mOverlay; }
+	void overlay(Overlay overlay);
+	Overlay overlay() const;
 
 	float movementCost() const;
 
 private:
-	TerrainType mIndex = TerrainType::Dozed;
+	friend class TileStore;
+
+	struct Occupant;
 
-	MapCoordinate mPosition;
+	bool thingIs(MapObjectKind kind) const;
 
-	MapObject* mMapObject = nullptr;
-	Mine* mMine = nullptr;
+	TileStore* mStore;
+	std::uint32_t mIndex; /**< Position in the store's layers. */
+};
 
-	Overlay mOverlay{Overlay::None};
 
-	bool mExcavated = true; /**< Used when a Digger uncovers underground tiles. */
+struct Tile::Occupant
+{
+	MapObject* mapObject{nullptr};
+	Mine* mine{nullptr};
+	MapObjectKind kind{MapObjectKind::Structure}; /**< Copy of mapObject's kind, only meaningful while it is set. */
 };
+
+
+/**
+ * Structure-of-arrays storage for the tiles of a TileMap.
+ *
+ * Terrain, the excavated flag and the overlay of every tile are packed into a
+ * single byte. MapObjects and Mines only occupy a small fraction of tiles, so
+ * they are kept in a separate table keyed by tile index, as are the Tile
+ * handles that have been handed out. A tile's position is derived from its
+ * index rather than stored.
+ *
+ * Code that walks over many tiles, such as rendering and saving, should read
+ * them by index rather than through tile() so that it doesn't leave a handle
+ * behind for every tile it looks at.
+ *
+ * Each level is split into square chunks. Surface chunks are allocated up
+ * front. Underground chunks are only allocated the first time one of their
+ * tiles is written to; until then every tile in them reads as the base
+ * terrain, unexcavated, with no overlay.
+ *
+ * Tile indices are laid out chunk by chunk, and row by row within a chunk.
+ *
+ * tileChanged() reports changes to a tile's terrain, excavated flag or what
+ * sits on it, but only for tiles that have a handle: anything that could be
+ * holding on to a tile must have asked for it first.
+ *
+ * \note	Owns the MapObjects and Mines placed on its tiles and deletes any
+ *			that remain when it is destroyed.
+ */
+class TileStore
+{
+public:
+	static constexpr int ChunkShift = 5;
+	static constexpr int ChunkSize = 1 << ChunkShift;
+	static constexpr std::size_t ChunkArea = ChunkSize * ChunkSize;
+
+	using TileSignal = NAS2D::Signal<const Tile&>;
+
+public:
+	TileStore(NAS2D::Vector<int> size, int levels, const std::vector<TerrainType>& baseTerrain);
+	TileStore(const TileStore&) = delete;
+	TileStore& operator=(const TileStore&) = delete;
+	~TileStore();
+
+	NAS2D::Vector<int> size() const { return mSize; }
+	int levels() const { return mLevels; }
+
+	std::size_t chunkCount() const { return mChunkCount; }
+	std::size_t materializedChunkCount() const { return mMaterializedChunkCount; }
+	bool isMaterialized(std::size_t chunk) const { return mChunks[chunk] != nullptr; }
+	std::size_t handleCount() const { return mTiles.size(); }
+
+	std::size_t linearIndex(const MapCoordinate& position) const;
+	MapCoordinate position(std::size_t index) const;
+	static std::size_t chunkOf(std::size_t index) { return index >> ChunkBits; }
+
+	const Tile& tile(std::size_t index) const;
+	Tile& tile(std::size_t index);
+
+	TerrainType terrain(std::size_t index) const { return static_cast<TerrainType>(cell(index) & TerrainMask); }
+	void terrain(std::size_t index, TerrainType terrain);
+
+	bool excavated(std::size_t index) const { return (cell(index) & ExcavatedBit) != 0; }
+	void excavated(std::size_t index, bool value);
+
+	Tile::Overlay overlay(std::size_t index) const { return static_cast<Tile::Overlay>((cell(index) & OverlayMask) >> OverlayShift); }
+	void overlay(std::size_t index, Tile::Overlay overlay);
+
+	MapObject* mapObject(std::size_t index) const;
+	bool holds(std::size_t index, MapObjectKind kind) const;
+	Mine* mine(std::size_t index) const;
+
+	float movementCost(std::size_t index) const;
+
+	/**
+	 * Count of changes to terrain, excavated flags, overlays and what sits on
+	 * tiles. Anything derived from those can compare it to tell whether it is
+	 * out of date.
+	 */
+	std::uint64_t revision() const { return mRevision; }
+
+	/**
+	 * Revision of the most recent change to a tile in the chunk, or 0 if
+	 * none of them have changed.
+	 */
+	std::uint64_t chunkRevision(std::size_t chunk) const { return mChunkRevisions[chunk]; }
+
+	TileSignal::Source& tileChanged() { return mTileChangedSignal; }
+
+private:
+	friend class Tile;
+
+	struct Chunk;
+
+	static constexpr std::uint8_t TerrainMask = 0x07;
+	static constexpr std::uint8_t ExcavatedBit = 0x08;
+	static constexpr std::uint8_t OverlayMask = 0x70;
+	static constexpr int OverlayShift = 4;
+
+	static constexpr int ChunkBits = 2 * ChunkShift;
+	static constexpr std::size_t ChunkMask = ChunkArea - 1;
+
+	std::uint8_t cell(std::size_t index) const;
+	std::uint8_t& cell(std::size_t index);
+	std::uint8_t defaultCell(std::size_t index) const;
+	bool write(std::size_t index, std::uint8_t packed);
+	void touch(std::size_t index);
+	void changed(std::size_t index);
+
+	Chunk& materialize(std::size_t chunk);
+
+	Tile& handle(std::size_t index) const;
+
+	const Tile::Occupant* findOccupant(std::size_t index) const;
+	Tile::Occupant& occupant(std::size_t index);
+	void releaseOccupantIfEmpty(std::size_t index);
+
+	const NAS2D::Vector<int> mSize;
+	const int mLevels;
+	const NAS2D::Vector<int> mChunkCounts; /**< Chunks per level along each axis. */
+
+	std::vector<TerrainType> mBaseTerrain; /**< Terrain of one level, row by row, shared by all unmaterialized chunks. */
+
+	const std::size_t mChunkCount;
+	std::size_t mMaterializedChunkCount{0};
+
+	std::vector<std::unique_ptr<Chunk>> mChunks;
+
+	std::unordered_map<std::uint32_t, Tile> mTiles; /**< Handles handed out so far, keyed by tile index. Nodes never move. */
+	std::unordered_map<std::uint32_t, Tile::Occupant> mOccupants; /**< Keyed by tile index. */
+
+	std::uint64_t mRevision{0};
+	std::vector<std::uint64_t> mChunkRevisions;
+
+	TileSignal mTileChangedSignal;
+};
+
+
+struct TileStore::Chunk
+{
+	std::array<std::uint8_t, ChunkArea> cells; /**< Packed terrain, excavated flag and overlay. */
+};
+
+
+inline std::uint8_t TileStore::cell(std::size_t index) const
+{
+	const auto& chunk = mChunks[index >> ChunkBits];
+	return chunk ? chunk->cells[index & ChunkMask] : defaultCell(index);
+}
+
+
+inline std::uint8_t& TileStore::cell(std::size_t index)
+{
+	return materialize(index >> ChunkBits).cells[index & ChunkMask];
+}
+
+
+/**
+ * Gets the handle of a tile, creating it the first time the tile is asked
+ * for. Creating a handle doesn't allocate the tile's chunk.
+ *
+ * 
+ote	Handles are bookkeeping rather than tile data, so even reading a
+ *			tile may create one.
+ */
+inline Tile& TileStore::handle(std::size_t index) const
+{
+	auto& store = const_cast<TileStore&>(*this);
+	return store.mTiles.try_emplace(static_cast<std::uint32_t>(index), store, index).first->second;
+}
+
+
+inline const Tile& TileStore::tile(std::size_t index) const { return handle(index); }
+inline Tile& TileStore::tile(std::size_t index) { return handle(index); }
+
+
+inline const Tile::Occupant* TileStore::findOccupant(std::size_t index) const
+{
+	if (mOccupants.empty()) { return nullptr; }
+
+	const auto occupantIt = mOccupants.find(static_cast<std::uint32_t>(index));
+	return occupantIt != mOccupants.end() ? &occupantIt->second : nullptr;
+}
+
+
+inline MapObject* TileStore::mapObject(std::size_t index) const
+{
+	const auto* current = findOccupant(index);
+	return current ? current->mapObject : nullptr;
+}
+
+
+inline bool TileStore::holds(std::size_t index, MapObjectKind kind) const
+{
+	const auto* current = findOccupant(index);
+	return current && current->mapObject && current->kind == kind;
+}
+
+
+inline Mine* TileStore::mine(std::size_t index) const
+{
+	const auto* current = findOccupant(index);
+	return current ? current->mine : nullptr;
+}
+
+
+inline TerrainType Tile::index() const { return mStore->terrain(mIndex); }
+inline void Tile::index(TerrainType index) { mStore->terrain(mIndex, index); }
+
+inline MapCoordinate Tile::xyz() const { return mStore->position(mIndex); }
+
+inline bool Tile::excavated() const { return mStore->excavated(mIndex); }
+inline void Tile::excavated(bool value) { mStore->excavated(mIndex, value); }
+
+inline MapObject* Tile::thing() const { return mStore->mapObject(mIndex); }
+
+inline bool Tile::thingIs(MapObjectKind kind) const { return mStore->holds(mIndex, kind); }
+
+inline const Mine* Tile::mine() const { return mStore->mine(mIndex); }
+inline Mine* Tile::mine() { return mStore->mine(mIndex); }
+
+inline float Tile::movementCost() const { return mStore->movementCost(mIndex); }
+
+inline void Tile::overlay(Overlay overlay) { mStore->overlay(mIndex, overlay); }
+inline Tile::Overlay Tile::overlay() const { return mStore->overlay(mIndex); }
@@ -21,7 +21,6 @@ using namespace NAS2D;
 
 namespace {
 	const std::string MapTerrainExtension = "_a.png";
-	const auto MapSize = NAS2D::Vector{300, 150};
 
 
 	constexpr std::size_t linearSize(NAS2D::Vector<int> size)
@@ -38,12 +37,46 @@ namespace {
 	}
 
 
+	/**
+	 * Builds a terrain map based on the pixel color values in
+	 * a maps height map.
+	 *
+	 * Height maps by default are in grey-scale. This method assumes
+	 * that all channels are the same value so it only looks at the red.
+	 * Color values are divided by 50 to get a height value from 1 - 4.
+	 *
+	 * The height map is sampled to the size of the map, so the same image
+	 * can be used for sites of any size.
+	 */
+	std::vector<TerrainType> loadTerrain(const Image& heightmap, NAS2D::Vector<int> size)
+	{
+		const auto imageSize = heightmap.size();
+
+		std::vector<TerrainType> terrain;
+		terrain.reserve(linearSize(size));
+		for (const auto point : PointInRectangleRange{Rectangle{{0, 0}, size}})
+		{
+			const auto imagePoint = NAS2D::Point{point.x * imageSize.x / size.x, point.y * imageSize.y / size.y};
+			terrain.push_back(static_cast<TerrainType>(heightmap.pixelColor(imagePoint).red / 50));
+		}
+
+		return terrain;
+	}
+
+
+	NAS2D::Vector<int> sizeOrImageSize(const Image& heightmap, NAS2D::Vector<int> size)
+	{
+		return (size.x > 0 && size.y > 0) ? size : heightmap.size();
+	}
+
+
 	std::vector<NAS2D::Point<int>> generateMineLocations(NAS2D::Vector<int> mapSize, std::size_t mineCount)
 	{
-		auto randPoint = [mapSize]() {
+		auto& random = randomNumber.stream(RandomStream::MapGeneration);
+		auto randPoint = [mapSize, &random]() {
 			return NAS2D::Point{
-				randomNumber.generate<int>(5, mapSize.x - 5),
-				randomNumber.generate<int>(5, mapSize.y - 5)
+				random.generate<int>(5, mapSize.x - 5),
+				random.generate<int>(5, mapSize.y - 5)
 			};
 		};
 
@@ -78,7 +111,7 @@ namespace {
 		const auto total = std::accumulate(mineYields.begin(), mineYields.end(), 0);
 
 		const auto randYield = [mineYields, total]() {
-			const auto randValue = randomNumber.generate<int>(1, total);
+			const auto randValue = randomNumber.stream(RandomStream::MapGeneration).generate<int>(1, total);
 			return (randValue <= mineYields[0]) ? MineProductionRate::Low :
 				(randValue <= mineYields[0] + mineYields[1]) ? MineProductionRate::Medium :
 				MineProductionRate::High;
@@ -94,19 +127,39 @@ namespace {
 }
 
 
-TileMap::TileMap(const std::string& mapPath, int maxDepth, std::size_t mineCount, const MineYields& mineYields) :
-	TileMap{mapPath, maxDepth}
+TileMap::TileMap(const std::string& mapPath, NAS2D::Vector<int> size, int maxDepth, std::size_t mineCount, const MineYields& mineYields) :
+	TileMap{mapPath, size, maxDepth}
 {
 	mMineLocations = generateMineLocations(mSizeInTiles, mineCount);
 	placeMines(*this, mMineLocations, mineYields);
 }
 
 
-TileMap::TileMap(const std::string& mapPath, int maxDepth) :
-	mSizeInTiles{MapSize},
-	mMaxDepth{maxDepth}
+/**
+ * \param	size	Size of the map in tiles. The map image is stretched to
+ *					fit. A zero size uses the size of the map image.
+ */
+TileMap::TileMap(const std::string& mapPath, NAS2D::Vector<int> size, int maxDepth) :
+	TileMap{Image{mapPath + MapTerrainExtension}, size, maxDepth}
+{
+}
+
+
+/**
+ * \param	terrain	Terrain of each tile of a level, row by row. Every level
+ *					starts out with the same terrain.
+ */
+TileMap::TileMap(NAS2D::Vector<int> size, int maxDepth, const std::vector<TerrainType>& terrain) :
+	mSizeInTiles{size},
+	mMaxDepth{maxDepth},
+	mTiles{mSizeInTiles, mMaxDepth + 1, terrain}
+{
+}
+
+
+TileMap::TileMap(const NAS2D::Image& heightmap, NAS2D::Vector<int> size, int maxDepth) :
+	TileMap{sizeOrImageSize(heightmap, size), maxDepth, loadTerrain(heightmap, sizeOrImageSize(heightmap, size))}
 {
-	buildTerrainMap(mapPath);
 }
 
 
@@ -131,55 +184,33 @@ bool TileMap::isValidPosition(const MapCoordinate& position) const
 
 const Tile& TileMap::getTile(const MapCoordinate& position) const
 {
-	if (!isValidPosition(position))
-	{
-		throw std::runtime_error("Tile coordinates out of bounds: {" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ", " + std::to_string(position.z) + "}");
-	}
-	return mTileMap[linearIndex(position)];
+	return mTiles.tile(tileIndex(position));
 }
 
 
+/**
+ * Gets a tile for writing. An underground tile's chunk is allocated when the
+ * tile is first written to.
+ */
 Tile& TileMap::getTile(const MapCoordinate& position)
 {
-	const auto& constThis = *this;
-	return const_cast<Tile&>(constThis.getTile(position));
+	return mTiles.tile(tileIndex(position));
 }
 
 
-void TileMap::buildTerrainMap(const std::string& path)
+std::size_t TileMap::tileIndex(const MapCoordinate& position) const
 {
-	const Image heightmap(path + MapTerrainExtension);
-
-	mTileMap.resize(linearSize());
-
-	/**
-	 * Builds a terrain map based on the pixel color values in
-	 * a maps height map.
-	 *
-	 * Height maps by default are in grey-scale. This method assumes
-	 * that all channels are the same value so it only looks at the red.
-	 * Color values are divided by 50 to get a height value from 1 - 4.
-	 */
-	for (int depth = 0; depth <= mMaxDepth; depth++)
+	if (!isValidPosition(position))
 	{
-		for (const auto point : PointInRectangleRange{Rectangle{{0, 0}, mSizeInTiles}})
-		{
-			auto color = heightmap.pixelColor(point);
-			auto& tile = getTile({point, depth});
-			tile = {{point, depth}, static_cast<TerrainType>(color.red / 50)};
-			if (depth > 0) { tile.excavated(false); }
-		}
+		throw std::runtime_error("Tile coordinates out of bounds: {" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ", " + std::to_string(position.z) + "}");
 	}
+	return mTiles.linearIndex(position);
 }
 
 
-void TileMap::serialize(NAS2D::Xml::XmlElement* element)
+NAS2D::Xml::XmlElement* TileMap::serializeMines()
 {
-	// ==========================================
-	// MINES
-	// ==========================================
 	auto* mines = new NAS2D::Xml::XmlElement("mines");
-	element->linkEndChild(mines);
 
 	for (const auto& location : mMineLocations)
 	{
@@ -187,45 +218,49 @@ void TileMap::serialize(NAS2D::Xml::XmlElement* element)
 		mines->linkEndChild(mine.serialize(location));
 	}
 
+	return mines;
+}
+
 
-	// ==========================================
-	// TILES
-	// ==========================================
-	auto* tiles = new NAS2D::Xml::XmlElement("tiles");
-	element->linkEndChild(tiles);
+/**
+ * Gets the terrain of tiles that need to be saved.
+ *
+ * We're only saving tiles that don't have structures or robots in them that are
+ * underground and excavated or surface and bulldozed. Underground chunks that
+ * were never allocated can't hold any excavated tiles and are skipped.
+ */
+TileLayer TileMap::tileLayer() const
+{
+	TileLayer tileLayer{mSizeInTiles.x, mSizeInTiles.y, mMaxDepth + 1};
 
-	// We're only writing out tiles that don't have structures or robots in them that are
-	// underground and excavated or surface and bulldozed.
-	for (int depth = 0; depth <= maxDepth(); ++depth)
+	for (std::size_t chunk = 0; chunk < mTiles.chunkCount(); ++chunk)
 	{
-		for (const auto point : PointInRectangleRange{Rectangle{{0, 0}, mSizeInTiles}})
+		if (!mTiles.isMaterialized(chunk)) { continue; }
+
+		const auto firstIndex = chunk * TileStore::ChunkArea;
+		for (auto index = firstIndex; index < firstIndex + TileStore::ChunkArea; ++index)
 		{
-			auto& tile = getTile({point, depth});
-			if (
-				((depth > 0 && tile.excavated()) || (tile.index() == TerrainType::Dozed)) &&
-				(tile.empty() && tile.mine() == nullptr)
-			)
+			const auto position = mTiles.position(index);
+			if (position.xy.x >= mSizeInTiles.x || position.xy.y >= mSizeInTiles.y) { continue; }
+
+			const auto terrain = mTiles.terrain(index);
+			const bool saved = (position.z > 0) ? mTiles.excavated(index) : (terrain == TerrainType::Dozed);
+			if (!saved) { continue; }
+
+			if (!mTiles.mapObject(index) && !mTiles.mine(index))
 			{
-				tiles->linkEndChild(
-					NAS2D::dictionaryToAttributes(
-						"tile",
-						{{
-							{"x", point.x},
-							{"y", point.y},
-							{"depth", depth},
-							{"index", static_cast<int>(tile.index())},
-						}}
-					)
-				);
+				tileLayer.at(position.xy.x, position.xy.y, position.z) = static_cast<std::uint8_t>(terrain);
 			}
 		}
 	}
+
+	return tileLayer;
 }
 
 
-void TileMap::deserialize(NAS2D::Xml::XmlElement* element)
+void TileMap::deserialize(NAS2D::Xml::XmlElement* mines, const TileLayer& tileLayer)
 {
-	for (auto* mineElement = element->firstChildElement("mines")->firstChildElement("mine"); mineElement; mineElement = mineElement->nextSiblingElement())
+	for (auto* mineElement = mines->firstChildElement("mine"); mineElement; mineElement = mineElement->nextSiblingElement())
 	{
 		const auto mineDictionary = NAS2D::attributesToDictionary(*mineElement);
 
@@ -242,70 +277,29 @@ void TileMap::deserialize(NAS2D::Xml::XmlElement* element)
 		mMineLocations.push_back(Point{x, y});
 	}
 
-	// TILES AT INDEX 0 WITH NO THINGS
-	for (auto* tileElement = element->firstChildElement("tiles")->firstChildElement("tile"); tileElement; tileElement = tileElement->nextSiblingElement())
+	// TILES WITH NO THINGS
+	for (const auto& cell : tileLayer.filledCells())
 	{
-		const auto tileDictionary = NAS2D::attributesToDictionary(*tileElement);
+		auto& tile = getTile({{cell.x, cell.y}, cell.depth});
+		tile.index(static_cast<TerrainType>(cell.value));
 
-		const auto x = tileDictionary.get<int>("x");
-		const auto y = tileDictionary.get<int>("y");
-		const auto depth = tileDictionary.get<int>("depth");
-		const auto index = tileDictionary.get<int>("index");
-
-		auto& tile = getTile({{x, y}, depth});
-		tile.index(static_cast<TerrainType>(index));
-
-		if (depth > 0) { tile.excavated(true); }
+		if (cell.depth > 0) { tile.excavated(true); }
 	}
 }
 
 
 /**
- * Implements MicroPather interface.
- *
- * \warning	Assumes stateStart and stateEnd are never nullptr.
+ * Gets the movement cost of every surface tile, row by row, for use with
+ * GridPathFinder.
  */
-float TileMap::LeastCostEstimate(void* stateStart, void* stateEnd)
-{
-	return sqrtf(static_cast<float>((static_cast<Tile*>(stateEnd)->xy() - static_cast<Tile*>(stateStart)->xy()).lengthSquared()));
-}
-
-
-void TileMap::AdjacentCost(void* state, std::vector<micropather::StateCost>* adjacent)
+std::vector<float> TileMap::movementCosts() const
 {
-	auto& tile = *static_cast<Tile*>(state);
-	const auto tilePosition = tile.xy();
-
-	for (const auto& offset : DirectionClockwise4)
+	std::vector<float> costs;
+	costs.reserve(::linearSize(mSizeInTiles));
+	for (const auto point : PointInRectangleRange{Rectangle{{0, 0}, mSizeInTiles}})
 	{
-		const auto position = tilePosition + offset;
-		if (!NAS2D::Rectangle{{0, 0}, mSizeInTiles}.contains(position))
-		{
-			continue;
-		}
-
-		auto& adjacentTile = getTile({position, 0});
-		float cost = adjacentTile.movementCost();
-
-		micropather::StateCost nodeCost = {&adjacentTile, cost};
-		adjacent->push_back(nodeCost);
+		costs.push_back(mTiles.movementCost(mTiles.linearIndex({point, 0})));
 	}
-}
-
-
-std::size_t TileMap::linearSize() const
-{
-	const auto convertedSize = mSizeInTiles.to<std::size_t>();
-	const auto adjustedZ = mMaxDepth + 1;
-	return convertedSize.x * convertedSize.y * static_cast<std::size_t>(adjustedZ);
-}
-
 
-
-std::size_t TileMap::linearIndex(const MapCoordinate& position) const
-{
-	const auto convertedSize = mSizeInTiles.to<std::size_t>();
-	const auto convertedPosition = position.xy.to<std::size_t>();
-	const auto convertedZ = static_cast<std::size_t>(position.z);
-	return ((convertedZ * convertedSize.y) + convertedPosition.y) * convertedSize.x + convertedPosition.x;
+	return costs;
 }
@@ -2,7 +2,7 @@
 
 #include "Tile.h"
 
-#include "../MicroPather/micropather.h"
+#include <libOPHD/Map/TileLayer.h>
 
 #include <NAS2D/Math/Point.h>
 #include <NAS2D/Math/Vector.h>
@@ -26,13 +26,14 @@ namespace NAS2D
 enum class Direction;
 
 
-class TileMap : public micropather::Graph
+class TileMap
 {
 public:
 	using MineYields = std::array<int, 3>; // {low, med, high}
 
-	TileMap(const std::string& mapPath, int maxDepth, std::size_t mineCount, const MineYields& mineYields);
-	TileMap(const std::string& mapPath, int maxDepth);
+	TileMap(const std::string& mapPath, NAS2D::Vector<int> size, int maxDepth, std::size_t mineCount, const MineYields& mineYields);
+	TileMap(const std::string& mapPath, NAS2D::Vector<int> size, int maxDepth);
+	TileMap(NAS2D::Vector<int> size, int maxDepth, const std::vector<TerrainType>& terrain);
 	TileMap(const TileMap&) = delete;
 	TileMap& operator=(const TileMap&) = delete;
 
@@ -41,31 +42,30 @@ public:
 
 	bool isValidPosition(const MapCoordinate& position) const;
 
+	std::uint64_t revision() const { return mTiles.revision(); }
+	const TileStore& tileStore() const { return mTiles; }
+	TileStore::TileSignal::Source& tileChanged() { return mTiles.tileChanged(); }
+
 	const Tile& getTile(const MapCoordinate& position) const;
 	Tile& getTile(const MapCoordinate& position);
 
 	const std::vector<NAS2D::Point<int>>& mineLocations() const { return mMineLocations; }
 	void removeMineLocation(const NAS2D::Point<int>& pt);
 
-	void serialize(NAS2D::Xml::XmlElement* element);
-	void deserialize(NAS2D::Xml::XmlElement* element);
-
+	NAS2D::Xml::XmlElement* serializeMines();
+	TileLayer tileLayer() const;
+	void deserialize(NAS2D::Xml::XmlElement* mines, const TileLayer& tileLayer);
 
-	/** MicroPather public interface implementation. */
-	float LeastCostEstimate(void* stateStart, void* stateEnd) override;
-	void AdjacentCost(void* state, std::vector<micropather::StateCost>* adjacent) override;
-	void PrintStateInfo(void* /*state*/) override {}
+	std::vector<float> movementCosts() const;
 
 private:
-	std::size_t linearSize() const;
-	std::size_t linearIndex(const MapCoordinate& position) const;
-
-	void buildTerrainMap(const std::string& path);
+	TileMap(const NAS2D::Image& heightmap, NAS2D::Vector<int> size, int maxDepth);
 
+	std::size_t tileIndex(const MapCoordinate& position) const;
 
 	const NAS2D::Vector<int> mSizeInTiles;
 	const int mMaxDepth = 0;
-	std::vector<Tile> mTileMap;
+	TileStore mTiles;
 	std::vector<NAS2D::Point<int>> mMineLocations;
 
 	std::string mMapPath;
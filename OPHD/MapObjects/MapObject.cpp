@@ -1,7 +1,8 @@
 #include "MapObject.h"
 
 
-MapObject::MapObject(const std::string& name, const std::string& spritePath, const std::string& initialAction) :
+MapObject::MapObject(MapObjectKind kind, const std::string& name, const std::string& spritePath, const std::string& initialAction) :
+	mKind(kind),
 	mName(name),
 	mSprite(spritePath, initialAction)
 {}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Common.h"
+
 #include <NAS2D/Signal/Signal.h>
 #include <NAS2D/Resource/Sprite.h>
 
@@ -18,11 +20,13 @@ public:
 	using DieSignal = NAS2D::Signal<MapObject*>;
 
 public:
-	MapObject(const std::string& name, const std::string& spritePath, const std::string& initialAction);
+	MapObject(MapObjectKind kind, const std::string& name, const std::string& spritePath, const std::string& initialAction);
 	MapObject(const MapObject& thing) = delete;
 	MapObject& operator=(const MapObject& thing) = delete;
 	virtual ~MapObject() = default;
 
+	MapObjectKind kind() const { return mKind; }
+
 	virtual void update() = 0;
 	NAS2D::Sprite& sprite();
 	const std::string& name() const;
@@ -32,6 +36,7 @@ public:
 	DieSignal::Source& onDie();
 
 private:
+	const MapObjectKind mKind;
 	std::string mName;
 	NAS2D::Sprite mSprite;
 	DieSignal mDieSignal;
@@ -1,5 +1,7 @@
 #include "Mine.h"
 
+#include <libOPHD/SlabArena.h>
+
 #include <NAS2D/ParserHelper.h>
 #include <NAS2D/Xml/XmlElement.h>
 
@@ -39,6 +41,25 @@ namespace
 }
 
 
+void* Mine::operator new(std::size_t size)
+{
+	return arena().allocate(size);
+}
+
+
+void Mine::operator delete(void* pointer, std::size_t size)
+{
+	arena().deallocate(pointer, size);
+}
+
+
+SlabArena& Mine::arena()
+{
+	static SlabArena mineArena;
+	return mineArena;
+}
+
+
 Mine::Mine() :
 	mFlags{DefaultFlags}
 {
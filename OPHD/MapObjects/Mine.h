@@ -17,6 +17,9 @@ namespace NAS2D
 }
 
 
+class SlabArena;
+
+
 class Mine
 {
 public:
@@ -32,6 +35,11 @@ public:
 	Mine();
 	Mine(MineProductionRate rate);
 
+	// Mines are allocated from a SlabArena so they are packed together
+	static void* operator new(std::size_t size);
+	static void operator delete(void* pointer, std::size_t size);
+	static SlabArena& arena();
+
 	bool active() const;
 	void active(bool newActive);
 
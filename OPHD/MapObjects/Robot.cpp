@@ -20,13 +20,13 @@ namespace
 
 
 Robot::Robot(const std::string& name, const std::string& spritePath, Type type) :
-	MapObject(name, spritePath, "running"),
+	MapObject(MapObjectKind::Robot, name, spritePath, "running"),
 	mType{type}
 {}
 
 
 Robot::Robot(const std::string& name, const std::string& spritePath, const std::string& initialAction, Type type) :
-	MapObject(name, spritePath, initialAction),
+	MapObject(MapObjectKind::Robot, name, spritePath, initialAction),
 	mType{type}
 {}
 
@@ -44,16 +44,6 @@ void Robot::startTask(int turns)
 }
 
 
-NAS2D::Dictionary Robot::getDataDict() const
-{
-	return {{
-		{"type", static_cast<int>(mType)},
-		{"age", mFuelCellAge},
-		{"production", mTurnsToCompleteTask},
-	}};
-}
-
-
 void Robot::update()
 {
 	if (mSelfDestruct)
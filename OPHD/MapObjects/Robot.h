@@ -2,8 +2,6 @@
 
 #include "MapObject.h"
 
-#include <NAS2D/Dictionary.h>
-
 
 class Tile;
 
@@ -49,8 +47,6 @@ public:
 
 	TaskSignal::Source& taskComplete() { return mTaskCompleteSignal; }
 
-	virtual NAS2D::Dictionary getDataDict() const;
-
 protected:
 	void incrementFuelCellAge() { mFuelCellAge++; }
 
@@ -5,7 +5,7 @@
 
 
 Robodigger::Robodigger() :
-	Robot(constants::Robodigger, "robots/robodigger.sprite", Robot::Type::Digger),
+	Robot(constants::Robodigger, SpritePath, Robot::Type::Digger),
 	mDirection(Direction::Down)
 {
 }
@@ -21,11 +21,3 @@ Direction Robodigger::direction() const
 {
 	return mDirection;
 }
-
-
-NAS2D::Dictionary Robodigger::getDataDict() const
-{
-	auto dictionary = Robot::getDataDict();
-	dictionary.set("direction", static_cast<int>(mDirection));
-	return dictionary;
-}
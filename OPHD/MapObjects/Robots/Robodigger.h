@@ -9,13 +9,13 @@ enum class Direction;
 class Robodigger : public Robot
 {
 public:
+	static constexpr auto SpritePath = "robots/robodigger.sprite";
+
 	Robodigger();
 
 	void direction(Direction dir);
 	Direction direction() const;
 
-	NAS2D::Dictionary getDataDict() const override;
-
 private:
 	Direction mDirection;
 };
@@ -5,7 +5,7 @@
 
 
 Robodozer::Robodozer() :
-	Robot(constants::Robodozer, "robots/robodozer.sprite", Robot::Type::Dozer)
+	Robot(constants::Robodozer, SpritePath, Robot::Type::Dozer)
 {
 }
 
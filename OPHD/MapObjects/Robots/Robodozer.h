@@ -8,6 +8,8 @@ class Tile;
 class Robodozer : public Robot
 {
 public:
+	static constexpr auto SpritePath = "robots/robodozer.sprite";
+
 	Robodozer();
 
 	void startTask(Tile& tile) override;
@@ -12,7 +12,7 @@
 
 
 Robominer::Robominer() :
-	Robot(constants::Robominer, "robots/robominer.sprite", Robot::Type::Miner)
+	Robot(constants::Robominer, SpritePath, Robot::Type::Miner)
 {
 }
 
@@ -11,6 +11,8 @@ class MineFacility;
 class Robominer : public Robot
 {
 public:
+	static constexpr auto SpritePath = "robots/robominer.sprite";
+
 	Robominer();
 
 	MineFacility& buildMine(TileMap& tileMap, const MapCoordinate& position);
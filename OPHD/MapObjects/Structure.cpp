@@ -6,6 +6,7 @@
 #include "../Constants/Strings.h"
 
 #include <libOPHD/RandomNumberGenerator.h>
+#include <libOPHD/SlabArena.h>
 
 #include <algorithm>
 
@@ -119,8 +120,27 @@ std::vector<Structure::StructureClass> allStructureClasses()
 }
 
 
+void* Structure::operator new(std::size_t size)
+{
+	return arena().allocate(size);
+}
+
+
+void Structure::operator delete(void* pointer, std::size_t size)
+{
+	arena().deallocate(pointer, size);
+}
+
+
+SlabArena& Structure::arena()
+{
+	static SlabArena structureArena;
+	return structureArena;
+}
+
+
 Structure::Structure(StructureClass structureClass, StructureID id) :
-	MapObject(StructureName(id), StructureCatalogue::getType(id).spritePath, constants::StructureStateConstruction),
+	MapObject(MapObjectKind::Structure, StructureName(id), StructureCatalogue::getType(id).spritePath, constants::StructureStateConstruction),
 	mStructureType(StructureCatalogue::getType(id)),
 	mStructureId(id),
 	mStructureClass(structureClass)
@@ -129,7 +149,7 @@ Structure::Structure(StructureClass structureClass, StructureID id) :
 
 
 Structure::Structure(const std::string& initialAction, StructureClass structureClass, StructureID id) :
-	MapObject(StructureName(id), StructureCatalogue::getType(id).spritePath, initialAction),
+	MapObject(MapObjectKind::Structure, StructureName(id), StructureCatalogue::getType(id).spritePath, initialAction),
 	mStructureType(StructureCatalogue::getType(id)),
 	mStructureId(id),
 	mStructureClass(structureClass)
@@ -358,7 +378,7 @@ void Structure::updateIntegrityDecay()
 	else if (mIntegrity <= 20 && !destroyed())
 	{
 		/* range is 0 - 1000, 0 - 100 for 10% chance */
-		if (randomNumber.generate(0, 1000) < 100)
+		if (randomNumber.stream(RandomStream::StructureDecay).generate(0, 1000) < 100)
 		{
 			destroy();
 		}
@@ -398,7 +418,21 @@ void Structure::forced_state_change(StructureState structureState, DisabledReaso
 	else if (structureState == StructureState::Idle) { idle(idleReason); }
 	else if (structureState == StructureState::Disabled) { disable(disabledReason); }
 	else if (structureState == StructureState::Destroyed) { destroy(); }
-	else if (structureState == StructureState::UnderConstruction) { mStructureState = StructureState::UnderConstruction; } // Kludge
+	else if (structureState == StructureState::UnderConstruction) { state(StructureState::UnderConstruction); } // Kludge
+}
+
+
+/**
+ * Sets the Structure's state and notifies stateChanged() listeners if
+ * the state actually changed.
+ */
+void Structure::state(StructureState newState)
+{
+	if (newState == mStructureState) { return; }
+
+	const auto oldState = mStructureState;
+	mStructureState = newState;
+	mStateChangedSignal(*this, oldState);
 }
 
 
@@ -441,28 +475,3 @@ void Structure::integrity(int integrity)
 {
 	mIntegrity = integrity;
 }
-
-
-NAS2D::Dictionary Structure::getDataDict() const
-{
-	NAS2D::Dictionary dictionary =
-	{{
-		{"age", mAge},
-		{"state", static_cast<int>(mStructureState)},
-		{"forced_idle", mForcedIdle},
-		{"disabled_reason", static_cast<int>(mDisabledReason)},
-		{"idle_reason", static_cast<int>(mIdleReason)},
-		{"type", mStructureId},
-		{"direction", mConnectorDirection},
-		{"integrity", mIntegrity},
-		{"pop0", mPopulationAvailable.workers},
-		{"pop1", mPopulationAvailable.scientists},
-	}};
-
-	if (hasCrime())
-	{
-		dictionary.set("crime_rate", mCrimeRate);
-	}
-
-	return dictionary;
-}
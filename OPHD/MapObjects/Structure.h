@@ -8,7 +8,7 @@
 
 #include <libOPHD/Population/PopulationPool.h>
 
-#include <NAS2D/Dictionary.h>
+#include <NAS2D/Signal/Signal.h>
 
 
 struct StructureType;
@@ -26,9 +26,15 @@ enum class StructureState
 	Destroyed
 };
 
+class SlabArena;
+
+
 class Structure : public MapObject
 {
 public:
+	// Signal providing the Structure and the state it changed from.
+	using StateChangedSignal = NAS2D::Signal<Structure&, StructureState>;
+
 	/**
 	 * Class of a Structure.
 	 *
@@ -76,6 +82,11 @@ public:
 
 	~Structure() override = default;
 
+	// Structures of every class are allocated from a shared SlabArena
+	static void* operator new(std::size_t size);
+	static void operator delete(void* pointer, std::size_t size);
+	static SlabArena& arena();
+
 	// STATES & STATE MANAGEMENT
 	StructureState state() const { return mStructureState; }
 
@@ -161,6 +172,8 @@ public:
 
 	virtual void forced_state_change(StructureState, DisabledReason, IdleReason);
 
+	StateChangedSignal::Source& stateChanged() { return mStateChangedSignal; }
+
 	void rebuild();
 
 	void update() override;
@@ -171,8 +184,6 @@ public:
 	*/
 	virtual StringTable createInspectorViewTable() { return StringTable(0, 0); }
 
-	virtual NAS2D::Dictionary getDataDict() const;
-
 protected:
 	friend class StructureCatalogue;
 
@@ -180,7 +191,7 @@ protected:
 
 	virtual void disabledStateSet() {}
 
-	void state(StructureState newState) { mStructureState = newState; }
+	void state(StructureState newState);
 
 private:
 	Structure() = delete;
@@ -205,6 +216,7 @@ private:
 	int mIntegrity{100};
 
 	StructureState mStructureState{StructureState::UnderConstruction};
+	StateChangedSignal mStateChangedSignal;
 	StructureClass mStructureClass{StructureClass::Undefined};
 	ConnectorDir mConnectorDirection{ConnectorDir::CONNECTOR_INTERSECTION};
 
@@ -140,15 +140,6 @@ void Factory::updateProduction()
 }
 
 
-NAS2D::Dictionary Factory::getDataDict() const
-{
-	auto dictionary = Structure::getDataDict();
-	dictionary.set("production_completed", mTurnsCompleted);
-	dictionary.set("production_type", mProduct);
-	return dictionary;
-}
-
-
 bool Factory::enoughResourcesAvailable()
 {
 	if (mResources == nullptr) { throw std::runtime_error("Factory::enoughResourcesAvailable() called with a null Resource Pool set"); }
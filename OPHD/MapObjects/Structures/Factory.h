@@ -56,8 +56,6 @@ public:
 
 	ProductionSignal::Source& productionComplete() { return mProductionComplete; }
 
-	NAS2D::Dictionary getDataDict() const override;
-
 protected:
 	void clearProduction();
 
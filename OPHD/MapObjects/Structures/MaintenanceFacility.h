@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "../../Constants/Strings.h"
+#include "../../RepairScheduler.h"
 #include "../../StorableResources.h"
 
 #include "../../States/MapViewStateHelper.h" // yuck
@@ -73,41 +74,20 @@ public:
 	}
 
 
-	void addPriorityStructure(Structure* structure)
-	{
-		mPriorityList.push_back(structure);
-	}
-
-
-	void removePriorityStructure(Structure* structure)
-	{
-		auto it = std::find(mPriorityList.begin(), mPriorityList.end(), structure);
-		if (it != mPriorityList.end())
-		{
-			mPriorityList.erase(it);
-		}
-	}
-
-
-	bool hasPriorityStructures() const
-	{
-		return !mPriorityList.empty();
-	}
-
-
-	void repairStructures(StructureList& structures)
+	/**
+	 * Repairs the structures most in need of it until this facility runs
+	 * out of personnel or supplies for the turn.
+	 */
+	void repairStructures(RepairScheduler& repairScheduler)
 	{
 		if (!operational()) { return; }
 
-		if (hasPriorityStructures())
+		while (canMakeRepairs())
 		{
-			repairPriorityStructures(structures);
-		}
+			auto* structure = repairScheduler.next();
+			if (!structure) { return; }
 
-		for (auto* structure : structures)
-		{
 			repairStructure(structure);
-			std::rotate(structures.begin(), structures.begin() + 1, structures.end());
 		}
 	}
 
@@ -119,35 +99,6 @@ protected:
 	}
 
 
-	void moveStructureToBack(StructureList& structures, Structure* structure)
-	{
-		auto it = std::find(structures.begin(), structures.end(), structure);
-		if (it != structures.end())
-		{
-			structures.erase(it);
-			structures.push_back(structure);
-		}
-	}
-
-
-	void repairPriorityStructures(StructureList& structures)
-	{
-		for (auto* structure : mPriorityList)
-		{
-			if (!canMakeRepairs()) { return; }
-
-			repairStructure(structure);
-
-			moveStructureToBack(structures, structure);
-
-			if (structure->operational())
-			{
-				removePriorityStructure(structure);
-			}
-		}
-	}
-
-
 	void repairStructure(Structure* structure)
 	{
 		if (structure->destroyed() || structure->underConstruction()) { return; }
@@ -165,8 +116,7 @@ protected:
 			}
 			else
 			{
-				structure->integrity(50);
-				addPriorityStructure(structure);
+				structure->integrity(50); // Finished first next turn; see RepairScheduler
 			}
 		}
 		else if (structure->operational() || structure->isIdle())
@@ -206,7 +156,5 @@ private:
 	int mMaintenancePersonnel{MinimumPersonnel};
 	int mAssignedPersonnel{0};
 
-	StructureList mPriorityList;
-
 	const StorableResources* mResources{nullptr};
 };
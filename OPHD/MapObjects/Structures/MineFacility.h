@@ -40,7 +40,7 @@ public:
 	ExtensionCompleteSignal::Source& extensionComplete() { return mExtensionComplete; }
 
 protected:
-	friend class MapViewState;
+	friend class ColonySimulation;
 
 	StorableResources maxTransferAmounts();
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Map/MapCoordinate.h"
+
+#include <string>
+
+
+enum class NotificationType
+{
+	Critical,
+	Information,
+	Success,
+	Warning
+};
+
+
+/**
+ * Something the player should be told about, such as a structure breaking
+ * down. Raised by the simulation and shown by the NotificationArea.
+ */
+struct Notification
+{
+	std::string brief{""};
+	std::string message{""};
+	MapCoordinate position{{-1, -1}, 0};
+	NotificationType type{NotificationType::Information};
+};
@@ -0,0 +1,203 @@
+#include "ProductInventory.h"
+
+#include "MapObjects/Structures/Warehouse.h"
+
+#include <algorithm>
+
+
+void ProductInventory::addWarehouse(Warehouse& warehouse)
+{
+	mWarehouses.push_back(&warehouse);
+	track(warehouse);
+}
+
+
+void ProductInventory::removeWarehouse(Warehouse& warehouse)
+{
+	untrack(warehouse);
+	mWarehouses.erase(std::remove(mWarehouses.begin(), mWarehouses.end(), &warehouse), mWarehouses.end());
+}
+
+
+/**
+ * Brings a warehouse's entry up to date after its state changed.
+ */
+void ProductInventory::updateWarehouse(Warehouse& warehouse)
+{
+	// untrack() subtracts what the warehouse contributed when it was tracked
+	untrack(warehouse);
+	track(warehouse);
+}
+
+
+void ProductInventory::clear()
+{
+	mWarehouses.clear();
+	mFreeSpace.clear();
+	mProductCounts = {};
+	mOperationalCapacity = 0;
+	mOperationalStored = 0;
+}
+
+
+/**
+ * Rebuilds the index from the warehouses' product pools, after they have
+ * been set directly, e.g., when loading a saved game.
+ */
+void ProductInventory::recount()
+{
+	mFreeSpace.clear();
+	mProductCounts = {};
+	mOperationalCapacity = 0;
+	mOperationalStored = 0;
+
+	for (auto* warehouse : mWarehouses) { track(*warehouse); }
+}
+
+
+/**
+ * Gets an operational warehouse that can store the given number of products.
+ *
+ * \return	The warehouse with the most free space, or \c nullptr if even
+ *			that one can't store the products.
+ */
+Warehouse* ProductInventory::findStorage(ProductType productType, int count) const
+{
+	if (mFreeSpace.empty()) { return nullptr; }
+
+	auto* warehouse = mFreeSpace.top();
+	return warehouse->products().canStore(productType, count) ? warehouse : nullptr;
+}
+
+
+/**
+ * Stores products in the operational warehouse with the most free space.
+ *
+ * \return	The warehouse the products were stored in, or \c nullptr if no
+ *			warehouse had room for all of them.
+ */
+Warehouse* ProductInventory::store(ProductType productType, int count)
+{
+	auto* warehouse = findStorage(productType, count);
+	if (!warehouse) { return nullptr; }
+
+	untrack(*warehouse);
+	warehouse->products().store(productType, count);
+	track(*warehouse);
+
+	return warehouse;
+}
+
+
+/**
+ * Pulls up to \c count products from any warehouses holding them.
+ *
+ * \return	Number of products pulled.
+ */
+int ProductInventory::pull(ProductType productType, int count)
+{
+	const int requested = std::min(count, this->count(productType));
+	int remaining = requested;
+
+	for (auto* warehouse : mWarehouses)
+	{
+		if (remaining <= 0) { break; }
+		if (warehouse->products().count(productType) == 0) { continue; }
+
+		untrack(*warehouse);
+		remaining -= warehouse->products().pull(productType, remaining);
+		track(*warehouse);
+	}
+
+	return requested - remaining;
+}
+
+
+/**
+ * Works out where the products in a warehouse would go if it were removed,
+ * without moving anything.
+ */
+ProductInventory::TransferPlan ProductInventory::planTransfer(Warehouse& source) const
+{
+	TransferPlan plan;
+
+	ProductCounts remaining{};
+	for (std::size_t i = 0; i < remaining.size(); ++i)
+	{
+		remaining[i] = source.products().count(static_cast<ProductType>(i));
+	}
+
+	for (auto* destination : mWarehouses)
+	{
+		if (destination == &source || !mFreeSpace.contains(destination)) { continue; }
+
+		int freeSpace = destination->products().availableStorage();
+		for (std::size_t i = 0; i < remaining.size() && freeSpace > 0; ++i)
+		{
+			if (remaining[i] == 0) { continue; }
+
+			const auto productType = static_cast<ProductType>(i);
+			const auto unitSize = storageRequiredPerUnit(productType);
+			const auto units = (unitSize == 0) ? remaining[i] : std::min(remaining[i], freeSpace / unitSize);
+			if (units == 0) { continue; }
+
+			plan.transfers.push_back({destination, productType, units});
+			remaining[i] -= units;
+			freeSpace -= units * unitSize;
+		}
+	}
+
+	plan.complete = std::all_of(remaining.begin(), remaining.end(), [](int count) { return count == 0; });
+	return plan;
+}
+
+
+void ProductInventory::transfer(Warehouse& source, const TransferPlan& plan)
+{
+	untrack(source);
+
+	for (const auto& transfer : plan.transfers)
+	{
+		untrack(*transfer.destination);
+		transfer.destination->products().store(transfer.productType, transfer.count);
+		track(*transfer.destination);
+
+		source.products().pull(transfer.productType, transfer.count);
+	}
+
+	track(source);
+}
+
+
+void ProductInventory::track(Warehouse& warehouse)
+{
+	auto& products = warehouse.products();
+	for (std::size_t i = 0; i < mProductCounts.size(); ++i)
+	{
+		mProductCounts[i] += products.count(static_cast<ProductType>(i));
+	}
+
+	if (warehouse.operational())
+	{
+		mFreeSpace.push(&warehouse, -products.availableStorage());
+		mOperationalCapacity += products.capacity();
+		mOperationalStored += products.capacity() - products.availableStorage();
+	}
+}
+
+
+void ProductInventory::untrack(Warehouse& warehouse)
+{
+	auto& products = warehouse.products();
+	for (std::size_t i = 0; i < mProductCounts.size(); ++i)
+	{
+		mProductCounts[i] -= products.count(static_cast<ProductType>(i));
+	}
+
+	if (mFreeSpace.contains(&warehouse))
+	{
+		mFreeSpace.erase(&warehouse);
+		mOperationalCapacity -= products.capacity();
+		mOperationalStored -= products.capacity() - products.availableStorage();
+	}
+}
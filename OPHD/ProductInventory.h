@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Common.h"
+
+#include <libOPHD/IndexedMinHeap.h>
+
+#include <array>
+#include <vector>
+
+
+class Warehouse;
+
+
+/**
+ * Colony wide index of the products held in Warehouses.
+ *
+ * Keeps per-product totals across every warehouse and the storage capacity
+ * of operational warehouses. Operational warehouses are also kept in a heap
+ * ordered by free space, so finding somewhere to store a product only needs
+ * to look at the warehouse with the most room.
+ *
+ * \note	Changes made directly to a warehouse's ProductPool are not seen by
+ *			the index. Use the store() and pull() functions here, or call
+ *			recount() afterward.
+ */
+class ProductInventory
+{
+public:
+	using ProductCounts = std::array<int, ProductType::PRODUCT_COUNT>;
+
+	/**
+	 * Product movement from a warehouse that is about to be removed.
+	 */
+	struct TransferPlan
+	{
+		struct Transfer
+		{
+			Warehouse* destination;
+			ProductType productType;
+			int count;
+		};
+
+		std::vector<Transfer> transfers;
+		bool complete{true}; /**< False if some products have nowhere to go. */
+	};
+
+public:
+	void addWarehouse(Warehouse& warehouse);
+	void removeWarehouse(Warehouse& warehouse);
+	void updateWarehouse(Warehouse& warehouse);
+	void clear();
+	void recount();
+
+	std::size_t warehouseCount() const { return mWarehouses.size(); }
+
+	int count(ProductType productType) const { return mProductCounts[static_cast<std::size_t>(productType)]; }
+	int capacity() const { return mOperationalCapacity; }
+	int availableStorage() const { return mOperationalCapacity - mOperationalStored; }
+
+	Warehouse* findStorage(ProductType productType, int count) const;
+
+	Warehouse* store(ProductType productType, int count);
+	int pull(ProductType productType, int count);
+
+	TransferPlan planTransfer(Warehouse& source) const;
+	void transfer(Warehouse& source, const TransferPlan& plan);
+
+private:
+	void track(Warehouse& warehouse);
+	void untrack(Warehouse& warehouse);
+
+	std::vector<Warehouse*> mWarehouses;
+	IndexedMinHeap<Warehouse*, int> mFreeSpace; /**< Operational warehouses keyed by negated free space. */
+
+	ProductCounts mProductCounts{}; /**< Products held across every warehouse. */
+	int mOperationalCapacity{0};
+	int mOperationalStored{0};
+};
@@ -1,11 +1,9 @@
 #include "ProductPool.h"
 
 #include "Constants/Numbers.h"
-#include "Constants/Strings.h"
-
-#include <NAS2D/ParserHelper.h>
 
 #include <algorithm>
+#include <map>
 
 
 namespace
@@ -228,34 +226,8 @@ void ProductPool::verifyCount()
 }
 
 
-NAS2D::Dictionary ProductPool::serialize()
-{
-	return NAS2D::Dictionary{{
-		{constants::SaveGameProductDigger, count(ProductType::PRODUCT_DIGGER)},
-		{constants::SaveGameProductDozer, count(ProductType::PRODUCT_DOZER)},
-		{constants::SaveGameProductMiner, count(ProductType::PRODUCT_MINER)},
-		{constants::SaveGameProductExplorer, count(ProductType::PRODUCT_EXPLORER)},
-		{constants::SaveGameProductTruck, count(ProductType::PRODUCT_TRUCK)},
-		{constants::SaveGameProductMaintenanceParts, count(ProductType::PRODUCT_MAINTENANCE_PARTS)},
-		{constants::SaveGameProductClothing, count(ProductType::PRODUCT_CLOTHING)},
-		{constants::SaveGameProductMedicine, count(ProductType::PRODUCT_MEDICINE)},
-	}};
-}
-
-
-void ProductPool::deserialize(const NAS2D::Dictionary& dictionary)
+void ProductPool::counts(const ProductTypeCount& products)
 {
-	const auto required = std::vector<std::string>{constants::SaveGameProductDigger, constants::SaveGameProductDozer, constants::SaveGameProductMiner, constants::SaveGameProductExplorer, constants::SaveGameProductTruck, constants::SaveGameProductMaintenanceParts, constants::SaveGameProductClothing, constants::SaveGameProductMedicine};
-	NAS2D::reportMissingOrUnexpected(dictionary.keys(), required, {});
-
-	mProducts[ProductType::PRODUCT_DIGGER] = dictionary.get<int>(constants::SaveGameProductDigger);
-	mProducts[ProductType::PRODUCT_DOZER] = dictionary.get<int>(constants::SaveGameProductDozer);
-	mProducts[ProductType::PRODUCT_MINER] = dictionary.get<int>(constants::SaveGameProductMiner);
-	mProducts[ProductType::PRODUCT_EXPLORER] = dictionary.get<int>(constants::SaveGameProductExplorer);
-	mProducts[ProductType::PRODUCT_TRUCK] = dictionary.get<int>(constants::SaveGameProductTruck);
-	mProducts[ProductType::PRODUCT_MAINTENANCE_PARTS] = dictionary.get<int>(constants::SaveGameProductMaintenanceParts);
-	mProducts[ProductType::PRODUCT_CLOTHING] = dictionary.get<int>(constants::SaveGameProductClothing);
-	mProducts[ProductType::PRODUCT_MEDICINE] = dictionary.get<int>(constants::SaveGameProductMedicine);
-
+	mProducts = products;
 	mCurrentStorageCount = computeCurrentStorage(mProducts);
 }
@@ -2,8 +2,6 @@
 
 #include "Common.h"
 
-#include <NAS2D/Dictionary.h>
-
 #include <array>
 
 
@@ -37,8 +35,8 @@ public:
 	int availableStorage() const;
 	int availableStoragePercent() const;
 
-	NAS2D::Dictionary serialize();
-	void deserialize(const NAS2D::Dictionary& dictionary);
+	const ProductTypeCount& counts() const { return mProducts; }
+	void counts(const ProductTypeCount& products);
 
 	void verifyCount();
 
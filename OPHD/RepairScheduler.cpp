@@ -0,0 +1,120 @@
+#include "RepairScheduler.h"
+
+#include "MapObjects/Structure.h"
+
+#include <algorithm>
+
+
+namespace
+{
+	constexpr int FullIntegrity{100};
+
+
+	/**
+	 * A structure that has been partially repaired after failing is finished
+	 * before anything else is started.
+	 */
+	bool needsPriorityRepair(const Structure& structure)
+	{
+		return structure.disabled() && structure.disabledReason() == DisabledReason::StructuralIntegrity && structure.integrity() > 35; // \fixme magic number
+	}
+
+
+	template <typename Container>
+	void eraseValue(Container& container, Structure* structure)
+	{
+		container.erase(std::remove(container.begin(), container.end(), structure), container.end());
+	}
+}
+
+
+void RepairScheduler::clear()
+{
+	mQueue.clear();
+	mPriorityLane.clear();
+	mTaken.clear();
+}
+
+
+/**
+ * Queues, requeues or drops a structure to match its current integrity.
+ */
+void RepairScheduler::update(Structure& structure)
+{
+	auto* entry = &structure;
+
+	if (std::find(mPriorityLane.begin(), mPriorityLane.end(), entry) != mPriorityLane.end())
+	{
+		if (needsPriorityRepair(structure)) { return; }
+		eraseValue(mPriorityLane, entry);
+	}
+
+	if (structure.destroyed() || structure.integrity() >= FullIntegrity)
+	{
+		mQueue.erase(entry);
+		return;
+	}
+
+	if (needsPriorityRepair(structure))
+	{
+		mQueue.erase(entry);
+		mPriorityLane.push_back(entry);
+		return;
+	}
+
+	mQueue.push(entry, structure.integrity());
+}
+
+
+void RepairScheduler::remove(Structure& structure)
+{
+	mQueue.erase(&structure);
+	eraseValue(mPriorityLane, &structure);
+	eraseValue(mTaken, &structure);
+}
+
+
+/**
+ * Takes the structure most in need of repair out of the queue, or nullptr
+ * if nothing is waiting. The caller is not obliged to repair it; whatever
+ * state it is left in is picked up by finishTurn().
+ */
+Structure* RepairScheduler::next()
+{
+	Structure* structure = nullptr;
+
+	if (!mPriorityLane.empty())
+	{
+		structure = mPriorityLane.front();
+		mPriorityLane.pop_front();
+	}
+	else if (!mQueue.empty())
+	{
+		structure = mQueue.pop();
+	}
+
+	if (structure) { mTaken.push_back(structure); }
+	return structure;
+}
+
+
+/**
+ * Returns every structure handed out since the last call to the queue,
+ * according to the integrity it was left with.
+ */
+void RepairScheduler::finishTurn()
+{
+	const auto taken = std::move(mTaken);
+	mTaken.clear();
+
+	for (auto* structure : taken)
+	{
+		update(*structure);
+	}
+}
+
+
+void RepairScheduler::onStructureRemoved(Structure& structure, Tile& /*tile*/)
+{
+	remove(structure);
+}
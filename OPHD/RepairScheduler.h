@@ -0,0 +1,47 @@
+#pragma once
+
+#include <libOPHD/IndexedMinHeap.h>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+
+class Structure;
+class Tile;
+
+
+/**
+ * Colony wide queue of structures waiting for repairs, shared by every
+ * MaintenanceFacility.
+ *
+ * Damaged structures are kept in a min-heap keyed by integrity, so the most
+ * damaged structure is always next. Structures that were brought back from
+ * a structural integrity failure but not yet fully repaired skip the heap
+ * and wait in a priority lane instead.
+ *
+ * Structures handed out by next() stay out of the queue until finishTurn(),
+ * so no structure is repaired twice in one turn. The queue must be told
+ * about integrity changes made outside of repairs through update().
+ */
+class RepairScheduler
+{
+public:
+	void clear();
+
+	void update(Structure& structure);
+	void remove(Structure& structure);
+
+	Structure* next();
+	void finishTurn();
+
+	std::size_t size() const { return mQueue.size() + mPriorityLane.size(); }
+
+	void onIntegrityChanged(Structure& structure) { update(structure); }
+	void onStructureRemoved(Structure& structure, Tile& tile);
+
+private:
+	IndexedMinHeap<Structure*, int> mQueue;
+	std::deque<Structure*> mPriorityLane;
+	std::vector<Structure*> mTaken;
+};
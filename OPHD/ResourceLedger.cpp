@@ -0,0 +1,161 @@
+#include "ResourceLedger.h"
+
+#include "MapObjects/Structure.h"
+
+#include <algorithm>
+
+
+namespace
+{
+	void eraseContainer(std::vector<Structure*>& containers, Structure& structure)
+	{
+		containers.erase(std::remove(containers.begin(), containers.end(), &structure), containers.end());
+	}
+
+
+	StorableResources depositInto(const std::vector<Structure*>& containers, StorableResources resources)
+	{
+		for (auto* structure : containers)
+		{
+			if (resources.isEmpty()) { break; }
+
+			auto& stored = structure->storage();
+
+			const auto newResources = stored + resources;
+			const auto capped = newResources.cap(structure->storageCapacity() / 4);
+
+			stored = capped;
+			resources = newResources - capped;
+		}
+
+		return resources;
+	}
+
+
+	void withdrawFrom(const std::vector<Structure*>& containers, StorableResources& resources)
+	{
+		for (auto* structure : containers)
+		{
+			if (resources.isEmpty()) { break; }
+
+			auto& stored = structure->storage();
+			const auto toTransfer = resources.cap(stored);
+			stored -= toTransfer;
+			resources -= toTransfer;
+		}
+	}
+}
+
+
+bool ResourceLedger::isContainer(const Structure& structure)
+{
+	return structure.structureId() == StructureID::SID_COMMAND_CENTER || structure.structureId() == StructureID::SID_STORAGE_TANKS;
+}
+
+
+void ResourceLedger::addContainer(Structure& structure)
+{
+	auto& containers = structure.structureId() == StructureID::SID_COMMAND_CENTER ? mCommandCenters : mStorageTanks;
+	containers.push_back(&structure);
+	mTotal += structure.storage();
+}
+
+
+/**
+ * Stops tracking a container. Whatever it held leaves the colony's total.
+ */
+void ResourceLedger::removeContainer(Structure& structure)
+{
+	eraseContainer(mCommandCenters, structure);
+	eraseContainer(mStorageTanks, structure);
+	mTotal -= structure.storage();
+}
+
+
+void ResourceLedger::clear()
+{
+	mCommandCenters.clear();
+	mStorageTanks.clear();
+	mTotal = {};
+	mCharged = {};
+}
+
+
+/**
+ * Adds refined resources to the colony's storage structures.
+ *
+ * The Command Center acts as backup storage, especially during the beginning
+ * of the game before storage tanks are built, so it is filled first.
+ *
+ * \return	Resources that could not be stored.
+ */
+StorableResources ResourceLedger::deposit(StorableResources resources)
+{
+	const auto requested = resources;
+
+	resources = depositInto(mCommandCenters, resources);
+	resources = depositInto(mStorageTanks, resources);
+
+	mTotal += requested - resources;
+	return resources;
+}
+
+
+/**
+ * Removes refined resources from the colony's storage structures.
+ *
+ * The Command Center is backup storage so it is drawn from last. On return
+ * \c resources holds whatever could not be removed.
+ */
+void ResourceLedger::withdraw(StorableResources& resources)
+{
+	const auto requested = resources;
+
+	withdrawFrom(mStorageTanks, resources);
+	withdrawFrom(mCommandCenters, resources);
+
+	mTotal -= requested - resources;
+}
+
+
+/**
+ * Commits resources to be removed at the next settle(). Charged resources
+ * are no longer available() but remain in total() until then.
+ */
+void ResourceLedger::charge(const StorableResources& resources)
+{
+	mCharged += resources;
+}
+
+
+void ResourceLedger::settle()
+{
+	withdraw(mCharged);
+	mCharged = {};
+}
+
+
+void ResourceLedger::addTo(Structure& container, const StorableResources& resources)
+{
+	container.storage() += resources;
+	mTotal += resources;
+}
+
+
+void ResourceLedger::removeFrom(Structure& container, const StorableResources& resources)
+{
+	container.storage() -= resources;
+	mTotal -= resources;
+}
+
+
+/**
+ * Rebuilds the total from the containers' storage pools, after they have
+ * been set directly, e.g., when loading a saved game.
+ */
+void ResourceLedger::recount()
+{
+	mTotal = {};
+	for (auto* structure : mCommandCenters) { mTotal += structure->storage(); }
+	for (auto* structure : mStorageTanks) { mTotal += structure->storage(); }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "StorableResources.h"
+
+#include <vector>
+
+
+class Structure;
+
+
+/**
+ * Tracks the refined resources held by the colony's storage structures.
+ *
+ * Command Centers and Storage Tanks are registered as containers. Their
+ * storage pools remain the per-container balances; the ledger keeps the
+ * aggregate total in step with every deposit and withdrawal so checking
+ * what the colony can afford doesn't need to visit any structure.
+ *
+ * Resources consumed by operating structures during a turn are charged
+ * against the ledger as they are committed and taken out of the containers
+ * in a single settle() pass afterward.
+ *
+ * \note	Changes made directly to a container's storage pool are not seen
+ *			by the ledger. Use addTo() and removeFrom(), or recount().
+ */
+class ResourceLedger
+{
+public:
+	static bool isContainer(const Structure& structure);
+
+	void addContainer(Structure& structure);
+	void removeContainer(Structure& structure);
+	void clear();
+
+	const StorableResources& total() const { return mTotal; }
+	StorableResources available() const { return mTotal - mCharged; }
+	bool canAfford(const StorableResources& cost) const { return available() >= cost; }
+
+	StorableResources deposit(StorableResources resources);
+	void withdraw(StorableResources& resources);
+
+	void charge(const StorableResources& resources);
+	void settle();
+
+	void addTo(Structure& container, const StorableResources& resources);
+	void removeFrom(Structure& container, const StorableResources& resources);
+
+	void recount();
+
+private:
+	std::vector<Structure*> mCommandCenters;
+	std::vector<Structure*> mStorageTanks;
+
+	StorableResources mTotal; /**< Sum of every container's storage pool. */
+	StorableResources mCharged; /**< Committed this turn but not yet taken out of the containers. */
+};
@@ -13,20 +13,6 @@
 
 namespace
 {
-	template <class T>
-	void eraseRobot(T& list, Robot* robot)
-	{
-		for (auto it = list.begin(); it != list.end(); ++it)
-		{
-			if (&*it == robot)
-			{
-				list.erase(it);
-				return;
-			}
-		}
-	}
-
-
 	template <class T>
 	bool hasIdleRobot(const T& list)
 	{
@@ -106,9 +92,20 @@ void RobotPool::erase(Robot* robot)
 {
 	mRobots.erase(find(mRobots.begin(), mRobots.end(), robot));
 
-	eraseRobot(mDiggers, robot);
-	eraseRobot(mDozers, robot);
-	eraseRobot(mMiners, robot);
+	switch (robot->type())
+	{
+	case Robot::Type::Digger:
+		mDiggers.erase(static_cast<Robodigger*>(robot));
+		break;
+	case Robot::Type::Dozer:
+		mDozers.erase(static_cast<Robodozer*>(robot));
+		break;
+	case Robot::Type::Miner:
+		mMiners.erase(static_cast<Robominer*>(robot));
+		break;
+	default:
+		throw std::runtime_error("Unknown Robot::Type: " + std::to_string(static_cast<int>(robot->type())));
+	}
 }
 
 
@@ -122,16 +119,13 @@ Robot& RobotPool::addRobot(Robot::Type type)
 	switch (type)
 	{
 	case Robot::Type::Dozer:
-		mDozers.emplace_back();
-		mRobots.push_back(&mDozers.back());
+		mRobots.push_back(&mDozers.emplace());
 		break;
 	case Robot::Type::Digger:
-		mDiggers.emplace_back();
-		mRobots.push_back(&mDiggers.back());
+		mRobots.push_back(&mDiggers.emplace());
 		break;
 	case Robot::Type::Miner:
-		mMiners.emplace_back();
-		mRobots.push_back(&mMiners.back());
+		mRobots.push_back(&mMiners.emplace());
 		break;
 	default:
 		throw std::runtime_error("Unknown Robot::Type: " + std::to_string(static_cast<int>(type)));
@@ -3,8 +3,9 @@
 
 #include "MapObjects/Robots.h"
 
+#include <libOPHD/ObjectPool.h>
+
 #include <cstddef>
-#include <list>
 #include <map>
 
 
@@ -15,9 +16,9 @@ using RobotList = std::vector<Robot*>;
 class RobotPool
 {
 public:
-	using DiggerList = std::list<Robodigger>;
-	using DozerList = std::list<Robodozer>;
-	using MinerList = std::list<Robominer>;
+	using DiggerList = ObjectPool<Robodigger>;
+	using DozerList = ObjectPool<Robodozer>;
+	using MinerList = ObjectPool<Robominer>;
 	using RobotTileTable = std::map<Robot*, Tile*>;
 
 public:
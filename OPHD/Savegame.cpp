@@ -0,0 +1,503 @@
+#include "Savegame.h"
+
+#include "Constants/Strings.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+#include <NAS2D/ParserHelper.h>
+#include <NAS2D/Xml/XmlElement.h>
+#include <NAS2D/Xml/XmlMemoryBuffer.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace
+{
+	const std::string BinaryMagic = "OPHDSAVE";
+	constexpr std::uint16_t BinaryFormatVersion = 3;
+	// Format 1 stored structures, robots and research as element sections
+	constexpr std::uint16_t OldestBinaryFormatVersion = 1;
+	// Formats before this stored every cell of the tile layer
+	constexpr std::uint16_t ChunkedTilesFormatVersion = 3;
+
+	// Map size of every site before sizes came from the planet definition
+	const auto LegacyMapSize = NAS2D::Vector{300, 150};
+
+	const std::string BinaryExtension = ".sav";
+	const std::string XmlExtension = ".xml";
+
+	// Savegames are only a few levels deep; anything beyond this is corrupt data
+	constexpr int MaxElementDepth = 32;
+
+	enum SectionType : std::uint8_t
+	{
+		End = 0,
+		Element = 1,
+		Tiles = 2,
+		Structures = 3,
+		Robots = 4,
+		Research = 5
+	};
+
+
+	// Top level elements of the XML format that binary savegames store as typed sections
+	bool isRecordElement(const NAS2D::Xml::XmlElement& element)
+	{
+		const auto& name = element.value();
+		return name == "tiles" || name == "structures" || name == "robots" || name == "research";
+	}
+
+
+	void writeElementRecord(BinaryWriter& writer, const NAS2D::Xml::XmlElement& element)
+	{
+		writer.writeString(element.value());
+
+		std::size_t attributeCount = 0;
+		for (const auto* attribute = element.firstAttribute(); attribute; attribute = attribute->next()) { ++attributeCount; }
+
+		writer.writeVarUint(attributeCount);
+		for (const auto* attribute = element.firstAttribute(); attribute; attribute = attribute->next())
+		{
+			writer.writeString(attribute->name());
+			writer.writeString(attribute->value());
+		}
+
+		std::size_t childCount = 0;
+		for (const auto* child = element.firstChildElement(); child; child = child->nextSiblingElement()) { ++childCount; }
+
+		writer.writeVarUint(childCount);
+		for (const auto* child = element.firstChildElement(); child; child = child->nextSiblingElement())
+		{
+			writeElementRecord(writer, *child);
+		}
+	}
+
+
+	NAS2D::Xml::XmlElement* readElementRecord(BinaryReader& reader, int depth)
+	{
+		if (depth > MaxElementDepth)
+		{
+			throw std::runtime_error("Savegame element nesting is too deep");
+		}
+
+		auto* element = new NAS2D::Xml::XmlElement(reader.readString());
+
+		try
+		{
+			const auto attributeCount = reader.readVarUint();
+			for (std::uint64_t i = 0; i < attributeCount; ++i)
+			{
+				const auto name = reader.readString();
+				element->attribute(name, reader.readString());
+			}
+
+			const auto childCount = reader.readVarUint();
+			for (std::uint64_t i = 0; i < childCount; ++i)
+			{
+				element->linkEndChild(readElementRecord(reader, depth + 1));
+			}
+		}
+		catch (...)
+		{
+			delete element;
+			throw;
+		}
+
+		return element;
+	}
+
+
+	void checkVersion(const std::string& version, const std::string& name)
+	{
+		if (version != constants::SaveGameVersion)
+		{
+			throw std::runtime_error("Savegame version mismatch: '" + name + "'. Expected " + constants::SaveGameVersion + ", found " + version + ".");
+		}
+	}
+
+
+	bool exists(const std::string& filePath)
+	{
+		return NAS2D::Utility<NAS2D::Filesystem>::get().exists(filePath);
+	}
+}
+
+
+SavegameWriter::SavegameWriter()
+{
+	mWriter.writeBytes(BinaryMagic);
+	mWriter.writeU16(BinaryFormatVersion);
+	mWriter.writeString(constants::SaveGameVersion);
+}
+
+
+void SavegameWriter::writeElement(const NAS2D::Xml::XmlElement& element)
+{
+	const auto lengthOffset = beginSection(SectionType::Element);
+	writeElementRecord(mWriter, element);
+	endSection(lengthOffset);
+}
+
+
+/**
+ * Writes an element section and deletes the element.
+ *
+ * Mirrors XmlNode::linkEndChild() taking ownership, so serializers that return
+ * a newly allocated element can be written without leaking it.
+ */
+void SavegameWriter::linkEndChild(NAS2D::Xml::XmlElement* element)
+{
+	writeElement(*element);
+	delete element;
+}
+
+
+void SavegameWriter::writeTileLayer(const TileLayer& tileLayer)
+{
+	const auto lengthOffset = beginSection(SectionType::Tiles);
+	::writeTileLayer(mWriter, tileLayer);
+	endSection(lengthOffset);
+}
+
+
+void SavegameWriter::writeStructures(const std::vector<StructureRecord>& records)
+{
+	const auto lengthOffset = beginSection(SectionType::Structures);
+	writeStructureRecords(mWriter, records);
+	endSection(lengthOffset);
+}
+
+
+void SavegameWriter::writeRobots(const std::vector<RobotRecord>& records)
+{
+	const auto lengthOffset = beginSection(SectionType::Robots);
+	writeRobotRecords(mWriter, records);
+	endSection(lengthOffset);
+}
+
+
+void SavegameWriter::writeResearch(const ResearchRecord& record)
+{
+	const auto lengthOffset = beginSection(SectionType::Research);
+	writeResearchRecord(mWriter, record);
+	endSection(lengthOffset);
+}
+
+
+void SavegameWriter::finish()
+{
+	if (mFinished) { return; }
+
+	mWriter.writeU8(SectionType::End);
+	mFinished = true;
+}
+
+
+void SavegameWriter::save(const std::string& filePath)
+{
+	finish();
+	NAS2D::Utility<NAS2D::Filesystem>::get().writeFile(filePath, mWriter.buffer());
+}
+
+
+std::size_t SavegameWriter::beginSection(std::uint8_t sectionType)
+{
+	if (mFinished)
+	{
+		throw std::runtime_error("SavegameWriter: Cannot add a section after finish()");
+	}
+
+	mWriter.writeU8(sectionType);
+	const auto lengthOffset = mWriter.size();
+	mWriter.writeU32(0);
+	return lengthOffset;
+}
+
+
+void SavegameWriter::endSection(std::size_t lengthOffset)
+{
+	mWriter.patchU32(lengthOffset, static_cast<std::uint32_t>(mWriter.size() - lengthOffset - 4));
+}
+
+
+SavegameReader::SavegameReader(const std::string& data, const std::string& name)
+{
+	if (isBinarySavegame(data))
+	{
+		readBinary(data, name);
+	}
+	else
+	{
+		readXml(data, name);
+	}
+}
+
+
+void SavegameReader::readBinary(const std::string& data, const std::string& name)
+{
+	mFormat = SavegameFormat::Binary;
+
+	BinaryReader reader{data};
+	reader.readBytes(BinaryMagic.size());
+
+	const auto formatVersion = reader.readU16();
+	if (formatVersion < OldestBinaryFormatVersion || formatVersion > BinaryFormatVersion)
+	{
+		throw std::runtime_error("Unsupported binary savegame format " + std::to_string(formatVersion) + ": '" + name + "'");
+	}
+
+	checkVersion(reader.readString(), name);
+
+	mRoot = NAS2D::dictionaryToAttributes(constants::SaveGameRootNode, {{{"version", constants::SaveGameVersion}}});
+	mDocument.linkEndChild(mRoot);
+
+	try
+	{
+		for (auto sectionType = reader.readU8(); sectionType != SectionType::End; sectionType = reader.readU8())
+		{
+			BinaryReader section{reader.readBytes(reader.readU32())};
+
+			switch (sectionType)
+			{
+			case SectionType::Element:
+				mRoot->linkEndChild(readElementRecord(section, 0));
+				break;
+			case SectionType::Tiles:
+				mTileLayer = (formatVersion < ChunkedTilesFormatVersion) ? readDenseTileLayer(section) : readTileLayer(section);
+				break;
+			case SectionType::Structures:
+				mStructures = readStructureRecords(section);
+				break;
+			case SectionType::Robots:
+				mRobots = readRobotRecords(section);
+				break;
+			case SectionType::Research:
+				mResearch = readResearchRecord(section);
+				break;
+			default:
+				// Unknown section from a newer writer; its length lets us skip it
+				break;
+			}
+		}
+
+		readRecordElements();
+	}
+	catch (const std::runtime_error& error)
+	{
+		throw std::runtime_error("Savegame '" + name + "' is corrupt: " + error.what());
+	}
+}
+
+
+void SavegameReader::readXml(const std::string& data, const std::string& name)
+{
+	mFormat = SavegameFormat::Xml;
+
+	mDocument.parse(data.c_str());
+	if (mDocument.error())
+	{
+		throw std::runtime_error(name + " has malformed XML: Row: " + std::to_string(mDocument.errorRow()) +
+			" Column: " + std::to_string(mDocument.errorCol()) + " : " + mDocument.errorDesc());
+	}
+
+	mRoot = mDocument.firstChildElement(constants::SaveGameRootNode);
+	if (!mRoot)
+	{
+		throw std::runtime_error(name + " does not contain required root tag of <" + constants::SaveGameRootNode + ">");
+	}
+
+	checkVersion(mRoot->attribute("version"), name);
+
+	const auto* tiles = mRoot->firstChildElement("tiles");
+	if (tiles)
+	{
+		mTileLayer = elementToTileLayer(*tiles, mRoot->firstChildElement("properties"));
+	}
+
+	readRecordElements();
+}
+
+
+/**
+ * Builds the records of any structures, robots and research stored as
+ * elements. The elements are left in place.
+ */
+void SavegameReader::readRecordElements()
+{
+	const auto* structures = mRoot->firstChildElement("structures");
+	if (structures) { mStructures = elementToStructureRecords(*structures); }
+
+	const auto* robots = mRoot->firstChildElement("robots");
+	if (robots) { mRobots = elementToRobotRecords(*robots); }
+
+	const auto* research = mRoot->firstChildElement("research");
+	if (research) { mResearch = elementToResearchRecord(*research); }
+}
+
+
+bool isBinarySavegame(const std::string& data)
+{
+	return data.compare(0, BinaryMagic.size(), BinaryMagic) == 0;
+}
+
+
+SavegameReader loadSavegame(const std::string& filePath)
+{
+	return SavegameReader{NAS2D::Utility<NAS2D::Filesystem>::get().readFile(filePath), filePath};
+}
+
+
+std::string savegamePath(const std::string& name, SavegameFormat format)
+{
+	return constants::SaveGamePath + name + (format == SavegameFormat::Binary ? BinaryExtension : XmlExtension);
+}
+
+
+/**
+ * Gets the path of an existing savegame, preferring the binary format if
+ * both exist. Returns the binary path if neither exists.
+ */
+std::string findSavegame(const std::string& name)
+{
+	const auto xmlPath = savegamePath(name, SavegameFormat::Xml);
+	const auto binaryPath = savegamePath(name, SavegameFormat::Binary);
+	return (!exists(binaryPath) && exists(xmlPath)) ? xmlPath : binaryPath;
+}
+
+
+void deleteSavegame(const std::string& name)
+{
+	auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::get();
+	for (const auto format : {SavegameFormat::Binary, SavegameFormat::Xml})
+	{
+		const auto filePath = savegamePath(name, format);
+		if (filesystem.exists(filePath)) { filesystem.del(filePath); }
+	}
+}
+
+
+NAS2D::Xml::XmlElement* tileLayerToElement(const TileLayer& tileLayer)
+{
+	auto* tiles = NAS2D::dictionaryToAttributes(
+		"tiles",
+		{{
+			{"width", tileLayer.width},
+			{"height", tileLayer.height},
+			{"levels", tileLayer.levels},
+		}}
+	);
+
+	for (const auto& cell : tileLayer.filledCells())
+	{
+		tiles->linkEndChild(
+			NAS2D::dictionaryToAttributes(
+				"tile",
+				{{
+					{"x", cell.x},
+					{"y", cell.y},
+					{"depth", cell.depth},
+					{"index", static_cast<int>(cell.value)},
+				}}
+			)
+		);
+	}
+
+	return tiles;
+}
+
+
+/**
+ * Reads a <tiles> element into a TileLayer the size of the saved map.
+ *
+ * \param	properties	The savegame's <properties> element. Savegames from
+ *						before <tiles> stored the layer's size take it from
+ *						the map size and digging depth stored there.
+ *
+ * 	hrows	std::runtime_error if the size can't be found or a tile is
+ *			outside of it.
+ */
+TileLayer elementToTileLayer(const NAS2D::Xml::XmlElement& element, const NAS2D::Xml::XmlElement* properties)
+{
+	const auto tilesDictionary = NAS2D::attributesToDictionary(element);
+
+	TileLayer tileLayer;
+	if (tilesDictionary.has("width"))
+	{
+		tileLayer = TileLayer{tilesDictionary.get<int>("width"), tilesDictionary.get<int>("height"), tilesDictionary.get<int>("levels")};
+	}
+	else
+	{
+		if (!properties)
+		{
+			throw std::runtime_error("Savegame does not store the size of its map");
+		}
+
+		const auto propertiesDictionary = NAS2D::attributesToDictionary(*properties);
+		const auto width = propertiesDictionary.get<int>("mapwidth", 0);
+		const auto height = propertiesDictionary.get<int>("mapheight", 0);
+		const auto mapSize = (width > 0 && height > 0) ? NAS2D::Vector{width, height} : LegacyMapSize;
+		tileLayer = TileLayer{mapSize.x, mapSize.y, propertiesDictionary.get<int>("diggingdepth") + 1};
+	}
+
+	for (const auto* tileElement = element.firstChildElement("tile"); tileElement; tileElement = tileElement->nextSiblingElement("tile"))
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*tileElement);
+		const auto x = dictionary.get<int>("x");
+		const auto y = dictionary.get<int>("y");
+		const auto depth = dictionary.get<int>("depth");
+		const auto index = dictionary.get<int>("index");
+
+		if (index < 0 || index >= TileLayer::Empty)
+		{
+			throw std::runtime_error("Savegame tile has invalid index: " + std::to_string(index));
+		}
+
+		tileLayer.at(x, y, depth) = static_cast<std::uint8_t>(index);
+	}
+
+	return tileLayer;
+}
+
+
+/**
+ * Re-encodes a savegame in the binary format.
+ */
+std::string savegameToBinary(SavegameReader& savegame)
+{
+	SavegameWriter writer;
+
+	for (const auto* element = savegame.root()->firstChildElement(); element; element = element->nextSiblingElement())
+	{
+		if (isRecordElement(*element)) { continue; }
+		writer.writeElement(*element);
+	}
+	writer.writeStructures(savegame.structures());
+	writer.writeRobots(savegame.robots());
+	writer.writeResearch(savegame.research());
+	writer.writeTileLayer(savegame.tileLayer());
+
+	writer.finish();
+	return writer.buffer();
+}
+
+
+/**
+ * Re-encodes a savegame in the XML format.
+ *
+ * \note	Adds the <structures>, <robots>, <research> and <tiles> elements
+ *			to the savegame's root if it doesn't already have them.
+ */
+std::string savegameToXml(SavegameReader& savegame)
+{
+	auto& root = *savegame.root();
+
+	if (!root.firstChildElement("structures")) { root.linkEndChild(structureRecordsToElement(savegame.structures())); }
+	if (!root.firstChildElement("robots")) { root.linkEndChild(robotRecordsToElement(savegame.robots())); }
+	if (!root.firstChildElement("research")) { root.linkEndChild(researchRecordToElement(savegame.research())); }
+	if (!root.firstChildElement("tiles")) { root.linkEndChild(tileLayerToElement(savegame.tileLayer())); }
+
+	NAS2D::Xml::XmlMemoryBuffer buff;
+	savegame.document().accept(&buff);
+	return buff.buffer();
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "SavegameRecords.h"
+
+#include <libOPHD/BinarySerializer.h>
+#include <libOPHD/Map/TileLayer.h>
+
+#include <NAS2D/Xml/XmlDocument.h>
+
+#include <string>
+
+
+namespace NAS2D
+{
+	namespace Xml
+	{
+		class XmlElement;
+	}
+}
+
+
+enum class SavegameFormat
+{
+	Binary,
+	Xml
+};
+
+
+/**
+ * Writes a savegame in the binary format.
+ *
+ * A binary savegame is a short header (magic, binary format version and the
+ * regular SaveGameVersion string) followed by a list of sections, each tagged
+ * with its type and byte length:
+ *
+ *	- Structure, robot and research sections hold typed records that are read
+ *	  straight back into the simulation. These are the bulk of a savegame.
+ *	- The tile layer section replaces the XML format's <tiles> element, which
+ *	  stores every dozed or excavated tile as its own element, with the
+ *	  TileLayer's allocated chunks, each run-length encoded.
+ *	- Element sections hold the remaining small top level elements of the XML
+ *	  format, stored as name, attribute and child records. Readers hand these
+ *	  to the same deserialization code the XML format uses.
+ *
+ * Sections are written as they are produced; no document tree is built.
+ */
+class SavegameWriter
+{
+public:
+	SavegameWriter();
+
+	void writeElement(const NAS2D::Xml::XmlElement& element);
+	void linkEndChild(NAS2D::Xml::XmlElement* element);
+	void writeTileLayer(const TileLayer& tileLayer);
+	void writeStructures(const std::vector<StructureRecord>& records);
+	void writeRobots(const std::vector<RobotRecord>& records);
+	void writeResearch(const ResearchRecord& record);
+
+	void finish();
+	const std::string& buffer() const { return mWriter.buffer(); }
+
+	void save(const std::string& filePath);
+
+private:
+	std::size_t beginSection(std::uint8_t sectionType);
+	void endSection(std::size_t lengthOffset);
+
+	BinaryWriter mWriter;
+	bool mFinished{false};
+};
+
+
+/**
+ * Reads a savegame in either format.
+ *
+ * Whichever format the data is in, the result is presented the same way: a
+ * TileLayer holding the dozed and excavated tiles, records of the
+ * structures, robots and research, and a root element holding the remaining
+ * sections.
+ *
+ * XML savegames and binary savegames from before the typed sections keep the
+ * structures, robots and research as elements; their records are built from
+ * those elements.
+ *
+ * \throws	std::runtime_error if the data is malformed or the savegame
+ *			version does not match SaveGameVersion.
+ */
+class SavegameReader
+{
+public:
+	SavegameReader(const std::string& data, const std::string& name);
+
+	SavegameFormat format() const { return mFormat; }
+
+	NAS2D::Xml::XmlElement* root() { return mRoot; }
+	const NAS2D::Xml::XmlDocument& document() const { return mDocument; }
+
+	const TileLayer& tileLayer() const { return mTileLayer; }
+	const std::vector<StructureRecord>& structures() const { return mStructures; }
+	const std::vector<RobotRecord>& robots() const { return mRobots; }
+	const ResearchRecord& research() const { return mResearch; }
+
+private:
+	void readBinary(const std::string& data, const std::string& name);
+	void readXml(const std::string& data, const std::string& name);
+	void readRecordElements();
+
+	SavegameFormat mFormat{SavegameFormat::Binary};
+	NAS2D::Xml::XmlDocument mDocument;
+	NAS2D::Xml::XmlElement* mRoot{nullptr};
+	TileLayer mTileLayer;
+	std::vector<StructureRecord> mStructures;
+	std::vector<RobotRecord> mRobots;
+	ResearchRecord mResearch;
+};
+
+
+bool isBinarySavegame(const std::string& data);
+
+SavegameReader loadSavegame(const std::string& filePath);
+
+std::string savegamePath(const std::string& name, SavegameFormat format);
+std::string findSavegame(const std::string& name);
+void deleteSavegame(const std::string& name);
+
+NAS2D::Xml::XmlElement* tileLayerToElement(const TileLayer& tileLayer);
+TileLayer elementToTileLayer(const NAS2D::Xml::XmlElement& element, const NAS2D::Xml::XmlElement* properties);
+
+std::string savegameToBinary(SavegameReader& savegame);
+std::string savegameToXml(SavegameReader& savegame);
@@ -0,0 +1,551 @@
+#include "SavegameRecords.h"
+
+#include "IOHelper.h"
+
+#include "Constants/Strings.h"
+
+#include <libOPHD/BinarySerializer.h>
+
+#include <NAS2D/Dictionary.h>
+#include <NAS2D/ParserHelper.h>
+#include <NAS2D/StringUtils.h>
+#include <NAS2D/Xml/XmlElement.h>
+
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	// Which optional parts follow a structure record's fixed fields
+	enum StructurePart : std::uint16_t
+	{
+		HasCrimeRate = 1 << 0,
+		HasFactoryProduction = 1 << 1,
+		HasWarehouseProducts = 1 << 2,
+		HasFoodLevel = 1 << 3,
+		HasWaste = 1 << 4,
+		HasAssignedTrucks = 1 << 5,
+		HasDigTurnsRemaining = 1 << 6,
+		HasMaintenancePersonnel = 1 << 7,
+	};
+
+	enum RobotPart : std::uint8_t
+	{
+		HasDirection = 1 << 0,
+		HasPosition = 1 << 1,
+	};
+
+	// Smallest encoded size of each record, used to reject counts that can't fit in a section
+	constexpr std::size_t MinStructureRecordSize = 11 * 4 + 1 + 2 + 8 * 4;
+	constexpr std::size_t MinRobotRecordSize = 3 * 4 + 1;
+	constexpr std::size_t MinResearchEntrySize = 4;
+
+	const std::array<std::string, SavedProducts.size()> SavedProductNames{
+		constants::SaveGameProductDigger,
+		constants::SaveGameProductDozer,
+		constants::SaveGameProductMiner,
+		constants::SaveGameProductExplorer,
+		constants::SaveGameProductTruck,
+		constants::SaveGameProductMaintenanceParts,
+		constants::SaveGameProductClothing,
+		constants::SaveGameProductMedicine,
+	};
+
+
+	std::size_t readCount(BinaryReader& reader, std::size_t minRecordSize)
+	{
+		const auto count = reader.readVarUint();
+		if (count > reader.remaining() / minRecordSize)
+		{
+			throw std::runtime_error("Savegame record count is larger than its section: " + std::to_string(count));
+		}
+		return static_cast<std::size_t>(count);
+	}
+
+
+	void writeMapCoordinate(BinaryWriter& writer, const MapCoordinate& position)
+	{
+		writer.writeI32(position.xy.x);
+		writer.writeI32(position.xy.y);
+		writer.writeI32(position.z);
+	}
+
+
+	MapCoordinate readMapCoordinate(BinaryReader& reader)
+	{
+		const auto x = reader.readI32();
+		const auto y = reader.readI32();
+		const auto z = reader.readI32();
+		return {{x, y}, z};
+	}
+
+
+	void writeResources(BinaryWriter& writer, const StorableResources& resources)
+	{
+		for (const auto value : resources.resources) { writer.writeI32(value); }
+	}
+
+
+	StorableResources readResources(BinaryReader& reader)
+	{
+		StorableResources resources;
+		for (auto& value : resources.resources) { value = reader.readI32(); }
+		return resources;
+	}
+
+
+	MapCoordinate loadMapCoordinate(const NAS2D::Dictionary& dictionary)
+	{
+		const auto x = dictionary.get<int>("x");
+		const auto y = dictionary.get<int>("y");
+		const auto depth = dictionary.get<int>("depth");
+		return MapCoordinate{{x, y}, depth};
+	}
+
+
+	std::uint16_t structureParts(const StructureRecord& record)
+	{
+		std::uint16_t parts = 0;
+		if (record.crimeRate) { parts |= HasCrimeRate; }
+		if (record.factoryProduction) { parts |= HasFactoryProduction; }
+		if (record.warehouseProducts) { parts |= HasWarehouseProducts; }
+		if (record.foodLevel) { parts |= HasFoodLevel; }
+		if (record.waste) { parts |= HasWaste; }
+		if (record.assignedTrucks) { parts |= HasAssignedTrucks; }
+		if (record.digTurnsRemaining) { parts |= HasDigTurnsRemaining; }
+		if (record.maintenancePersonnel) { parts |= HasMaintenancePersonnel; }
+		return parts;
+	}
+
+
+	NAS2D::Dictionary productsToDictionary(const ProductPool::ProductTypeCount& products)
+	{
+		NAS2D::Dictionary dictionary;
+		for (std::size_t i = 0; i < SavedProducts.size(); ++i)
+		{
+			dictionary.set(SavedProductNames[i], products[static_cast<std::size_t>(SavedProducts[i])]);
+		}
+		return dictionary;
+	}
+
+
+	ProductPool::ProductTypeCount dictionaryToProducts(const NAS2D::Dictionary& dictionary)
+	{
+		NAS2D::reportMissingOrUnexpected(dictionary.keys(), {SavedProductNames.begin(), SavedProductNames.end()}, {});
+
+		ProductPool::ProductTypeCount products{};
+		for (std::size_t i = 0; i < SavedProducts.size(); ++i)
+		{
+			products[static_cast<std::size_t>(SavedProducts[i])] = dictionary.get<int>(SavedProductNames[i]);
+		}
+		return products;
+	}
+
+
+	template <typename Value>
+	std::optional<Value> optionalAttribute(const NAS2D::Xml::XmlElement& parentElement, const std::string& subElementName, const std::string& attributeName)
+	{
+		const auto* element = parentElement.firstChildElement(subElementName);
+		if (!element) { return std::nullopt; }
+		return NAS2D::attributesToDictionary(*element).get<Value>(attributeName);
+	}
+}
+
+
+/**
+ * Writes structure records as a count followed by each record's fixed
+ * fields, a mask of the optional parts it has, and those parts.
+ */
+void writeStructureRecords(BinaryWriter& writer, const std::vector<StructureRecord>& records)
+{
+	writer.writeVarUint(records.size());
+
+	for (const auto& record : records)
+	{
+		writeMapCoordinate(writer, record.position);
+		writer.writeI32(record.type);
+		writer.writeI32(record.age);
+		writer.writeI32(record.state);
+		writer.writeU8(record.forcedIdle ? 1 : 0);
+		writer.writeI32(record.disabledReason);
+		writer.writeI32(record.idleReason);
+		writer.writeI32(record.direction);
+		writer.writeI32(record.integrity);
+		writer.writeI32(record.workersAvailable);
+		writer.writeI32(record.scientistsAvailable);
+		writeResources(writer, record.production);
+		writeResources(writer, record.storage);
+
+		writer.writeU16(structureParts(record));
+
+		if (record.crimeRate) { writer.writeI32(*record.crimeRate); }
+		if (record.factoryProduction)
+		{
+			writer.writeI32(record.factoryProduction->turnsCompleted);
+			writer.writeI32(record.factoryProduction->productType);
+		}
+		if (record.warehouseProducts)
+		{
+			for (const auto product : SavedProducts) { writer.writeI32((*record.warehouseProducts)[static_cast<std::size_t>(product)]); }
+		}
+		if (record.foodLevel) { writer.writeI32(*record.foodLevel); }
+		if (record.waste)
+		{
+			writer.writeI32(record.waste->accumulated);
+			writer.writeI32(record.waste->overflow);
+		}
+		if (record.assignedTrucks) { writer.writeI32(*record.assignedTrucks); }
+		if (record.digTurnsRemaining) { writer.writeI32(*record.digTurnsRemaining); }
+		if (record.maintenancePersonnel) { writer.writeI32(*record.maintenancePersonnel); }
+	}
+}
+
+
+std::vector<StructureRecord> readStructureRecords(BinaryReader& reader)
+{
+	std::vector<StructureRecord> records(readCount(reader, MinStructureRecordSize));
+
+	for (auto& record : records)
+	{
+		record.position = readMapCoordinate(reader);
+		record.type = reader.readI32();
+		record.age = reader.readI32();
+		record.state = reader.readI32();
+		record.forcedIdle = reader.readU8() != 0;
+		record.disabledReason = reader.readI32();
+		record.idleReason = reader.readI32();
+		record.direction = reader.readI32();
+		record.integrity = reader.readI32();
+		record.workersAvailable = reader.readI32();
+		record.scientistsAvailable = reader.readI32();
+		record.production = readResources(reader);
+		record.storage = readResources(reader);
+
+		const auto parts = reader.readU16();
+
+		if (parts & HasCrimeRate) { record.crimeRate = reader.readI32(); }
+		if (parts & HasFactoryProduction)
+		{
+			const auto turnsCompleted = reader.readI32();
+			record.factoryProduction = StructureRecord::FactoryProduction{turnsCompleted, reader.readI32()};
+		}
+		if (parts & HasWarehouseProducts)
+		{
+			ProductPool::ProductTypeCount products{};
+			for (const auto product : SavedProducts) { products[static_cast<std::size_t>(product)] = reader.readI32(); }
+			record.warehouseProducts = products;
+		}
+		if (parts & HasFoodLevel) { record.foodLevel = reader.readI32(); }
+		if (parts & HasWaste)
+		{
+			const auto accumulated = reader.readI32();
+			record.waste = StructureRecord::Waste{accumulated, reader.readI32()};
+		}
+		if (parts & HasAssignedTrucks) { record.assignedTrucks = reader.readI32(); }
+		if (parts & HasDigTurnsRemaining) { record.digTurnsRemaining = reader.readI32(); }
+		if (parts & HasMaintenancePersonnel) { record.maintenancePersonnel = reader.readI32(); }
+	}
+
+	return records;
+}
+
+
+void writeRobotRecords(BinaryWriter& writer, const std::vector<RobotRecord>& records)
+{
+	writer.writeVarUint(records.size());
+
+	for (const auto& record : records)
+	{
+		writer.writeI32(record.type);
+		writer.writeI32(record.age);
+		writer.writeI32(record.taskTurns);
+
+		writer.writeU8(static_cast<std::uint8_t>((record.direction ? HasDirection : 0) | (record.position ? HasPosition : 0)));
+		if (record.direction) { writer.writeI32(*record.direction); }
+		if (record.position) { writeMapCoordinate(writer, *record.position); }
+	}
+}
+
+
+std::vector<RobotRecord> readRobotRecords(BinaryReader& reader)
+{
+	std::vector<RobotRecord> records(readCount(reader, MinRobotRecordSize));
+
+	for (auto& record : records)
+	{
+		record.type = reader.readI32();
+		record.age = reader.readI32();
+		record.taskTurns = reader.readI32();
+
+		const auto parts = reader.readU8();
+		if (parts & HasDirection) { record.direction = reader.readI32(); }
+		if (parts & HasPosition) { record.position = readMapCoordinate(reader); }
+	}
+
+	return records;
+}
+
+
+void writeResearchRecord(BinaryWriter& writer, const ResearchRecord& record)
+{
+	writer.writeVarUint(record.completed.size());
+	for (const auto techId : record.completed) { writer.writeI32(techId); }
+
+	writer.writeVarUint(record.current.size());
+	for (const auto& current : record.current)
+	{
+		writer.writeI32(current.techId);
+		writer.writeI32(current.progress);
+		writer.writeI32(current.assigned);
+	}
+}
+
+
+ResearchRecord readResearchRecord(BinaryReader& reader)
+{
+	ResearchRecord record;
+
+	record.completed.resize(readCount(reader, MinResearchEntrySize));
+	for (auto& techId : record.completed) { techId = reader.readI32(); }
+
+	record.current.resize(readCount(reader, 3 * MinResearchEntrySize));
+	for (auto& current : record.current)
+	{
+		current.techId = reader.readI32();
+		current.progress = reader.readI32();
+		current.assigned = reader.readI32();
+	}
+
+	return record;
+}
+
+
+NAS2D::Xml::XmlElement* structureRecordsToElement(const std::vector<StructureRecord>& records)
+{
+	auto* structures = new NAS2D::Xml::XmlElement("structures");
+
+	for (const auto& record : records)
+	{
+		NAS2D::Dictionary dictionary =
+		{{
+			{"x", record.position.xy.x},
+			{"y", record.position.xy.y},
+			{"depth", record.position.z},
+			{"age", record.age},
+			{"state", record.state},
+			{"forced_idle", record.forcedIdle},
+			{"disabled_reason", record.disabledReason},
+			{"idle_reason", record.idleReason},
+			{"type", record.type},
+			{"direction", record.direction},
+			{"integrity", record.integrity},
+			{"pop0", record.workersAvailable},
+			{"pop1", record.scientistsAvailable},
+		}};
+
+		if (record.crimeRate) { dictionary.set("crime_rate", *record.crimeRate); }
+		if (record.factoryProduction)
+		{
+			dictionary.set("production_completed", record.factoryProduction->turnsCompleted);
+			dictionary.set("production_type", record.factoryProduction->productType);
+		}
+
+		auto* structureElement = NAS2D::dictionaryToAttributes("structure", dictionary);
+
+		if (!record.production.isEmpty()) { structureElement->linkEndChild(writeResources(record.production, "production")); }
+		if (!record.storage.isEmpty()) { structureElement->linkEndChild(writeResources(record.storage, "storage")); }
+
+		if (record.warehouseProducts)
+		{
+			structureElement->linkEndChild(NAS2D::dictionaryToAttributes("warehouse_products", productsToDictionary(*record.warehouseProducts)));
+		}
+		if (record.foodLevel)
+		{
+			structureElement->linkEndChild(NAS2D::dictionaryToAttributes("food", {{{"level", *record.foodLevel}}}));
+		}
+		if (record.waste)
+		{
+			structureElement->linkEndChild(NAS2D::dictionaryToAttributes(
+				"waste",
+				{{
+					{"accumulated", record.waste->accumulated},
+					{"overflow", record.waste->overflow},
+				}}
+			));
+		}
+		if (record.assignedTrucks)
+		{
+			structureElement->linkEndChild(NAS2D::dictionaryToAttributes("trucks", {{{"assigned", *record.assignedTrucks}}}));
+		}
+		if (record.digTurnsRemaining)
+		{
+			structureElement->linkEndChild(NAS2D::dictionaryToAttributes("extension", {{{"turns_remaining", *record.digTurnsRemaining}}}));
+		}
+		if (record.maintenancePersonnel)
+		{
+			structureElement->linkEndChild(NAS2D::dictionaryToAttributes("personnel", {{{"assigned", *record.maintenancePersonnel}}}));
+		}
+
+		structures->linkEndChild(structureElement);
+	}
+
+	return structures;
+}
+
+
+std::vector<StructureRecord> elementToStructureRecords(const NAS2D::Xml::XmlElement& element)
+{
+	std::vector<StructureRecord> records;
+
+	for (const auto* structureElement = element.firstChildElement(); structureElement; structureElement = structureElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*structureElement);
+
+		StructureRecord record;
+		record.position = loadMapCoordinate(dictionary);
+		record.type = dictionary.get<int>("type");
+		record.age = dictionary.get<int>("age");
+		record.state = dictionary.get<int>("state");
+		record.forcedIdle = dictionary.get<bool>("forced_idle");
+		record.disabledReason = dictionary.get<int>("disabled_reason");
+		record.idleReason = dictionary.get<int>("idle_reason");
+		record.direction = dictionary.get<int>("direction");
+		record.integrity = dictionary.get<int>("integrity", 100);
+		record.workersAvailable = dictionary.get<int>("pop0");
+		record.scientistsAvailable = dictionary.get<int>("pop1");
+
+		record.production = readResourcesOptional(*structureElement, "production");
+		record.storage = readResourcesOptional(*structureElement, "storage");
+
+		if (dictionary.has("crime_rate")) { record.crimeRate = dictionary.get<int>("crime_rate"); }
+		if (dictionary.has("production_completed") || dictionary.has("production_type"))
+		{
+			record.factoryProduction = StructureRecord::FactoryProduction{dictionary.get<int>("production_completed", 0), dictionary.get<int>("production_type", 0)};
+		}
+
+		const auto* products = structureElement->firstChildElement("warehouse_products");
+		if (products) { record.warehouseProducts = dictionaryToProducts(NAS2D::attributesToDictionary(*products)); }
+
+		record.foodLevel = optionalAttribute<int>(*structureElement, "food", "level");
+
+		const auto* waste = structureElement->firstChildElement("waste");
+		if (waste)
+		{
+			const auto wasteDictionary = NAS2D::attributesToDictionary(*waste);
+			record.waste = StructureRecord::Waste{wasteDictionary.get<int>("accumulated"), wasteDictionary.get<int>("overflow")};
+		}
+
+		record.assignedTrucks = optionalAttribute<int>(*structureElement, "trucks", "assigned");
+		record.digTurnsRemaining = optionalAttribute<int>(*structureElement, "extension", "turns_remaining");
+
+		const auto* personnel = structureElement->firstChildElement("personnel");
+		if (personnel) { record.maintenancePersonnel = NAS2D::attributesToDictionary(*personnel).get<int>("assigned", 0); }
+
+		records.push_back(record);
+	}
+
+	return records;
+}
+
+
+NAS2D::Xml::XmlElement* robotRecordsToElement(const std::vector<RobotRecord>& records)
+{
+	auto* robots = new NAS2D::Xml::XmlElement("robots");
+
+	for (const auto& record : records)
+	{
+		NAS2D::Dictionary dictionary =
+		{{
+			{"type", record.type},
+			{"age", record.age},
+			{"production", record.taskTurns},
+		}};
+
+		if (record.direction) { dictionary.set("direction", *record.direction); }
+		if (record.position)
+		{
+			dictionary.set("x", record.position->xy.x);
+			dictionary.set("y", record.position->xy.y);
+			dictionary.set("depth", record.position->z);
+		}
+
+		robots->linkEndChild(NAS2D::dictionaryToAttributes("robot", dictionary));
+	}
+
+	return robots;
+}
+
+
+std::vector<RobotRecord> elementToRobotRecords(const NAS2D::Xml::XmlElement& element)
+{
+	std::vector<RobotRecord> records;
+
+	for (const auto* robotElement = element.firstChildElement(); robotElement; robotElement = robotElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*robotElement);
+
+		RobotRecord record;
+		record.type = dictionary.get<int>("type");
+		record.age = dictionary.get<int>("age");
+		record.taskTurns = dictionary.get<int>("production");
+
+		if (dictionary.has("direction")) { record.direction = dictionary.get<int>("direction"); }
+		if (dictionary.has("x"))
+		{
+			record.position = MapCoordinate{{dictionary.get<int>("x"), dictionary.get<int>("y", 0)}, dictionary.get<int>("depth", 0)};
+		}
+
+		records.push_back(record);
+	}
+
+	return records;
+}
+
+
+NAS2D::Xml::XmlElement* researchRecordToElement(const ResearchRecord& record)
+{
+	auto* research = new NAS2D::Xml::XmlElement("research");
+
+	std::vector<std::string> completed;
+	for (const auto techId : record.completed) { completed.push_back(std::to_string(techId)); }
+	research->attribute("completed_techs", NAS2D::join(completed, ","));
+
+	for (const auto& current : record.current)
+	{
+		research->linkEndChild(NAS2D::dictionaryToAttributes(
+			"current",
+			{{
+				{"tech_id", current.techId},
+				{"progress", current.progress},
+				{"assigned", current.assigned},
+			}}
+		));
+	}
+
+	return research;
+}
+
+
+ResearchRecord elementToResearchRecord(const NAS2D::Xml::XmlElement& element)
+{
+	ResearchRecord record;
+
+	for (const auto& item : NAS2D::split(element.attribute("completed_techs")))
+	{
+		if (item.empty()) { continue; }
+		record.completed.push_back(std::stoi(item));
+	}
+
+	for (const auto* currentElement = element.firstChildElement(); currentElement; currentElement = currentElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*currentElement);
+		record.current.push_back({
+			dictionary.get<int>("tech_id"),
+			dictionary.get<int>("progress"),
+			dictionary.get<int>("assigned"),
+		});
+	}
+
+	return record;
+}
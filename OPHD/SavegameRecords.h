@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Common.h"
+#include "ProductPool.h"
+#include "StorableResources.h"
+
+#include "Map/MapCoordinate.h"
+
+#include <array>
+#include <optional>
+#include <vector>
+
+
+class BinaryWriter;
+class BinaryReader;
+
+namespace NAS2D
+{
+	namespace Xml
+	{
+		class XmlElement;
+	}
+}
+
+
+/**
+ * Products a warehouse saves, in the order they are saved.
+ */
+inline constexpr std::array<ProductType, 8> SavedProducts{
+	ProductType::PRODUCT_DIGGER,
+	ProductType::PRODUCT_DOZER,
+	ProductType::PRODUCT_MINER,
+	ProductType::PRODUCT_EXPLORER,
+	ProductType::PRODUCT_TRUCK,
+	ProductType::PRODUCT_MAINTENANCE_PARTS,
+	ProductType::PRODUCT_CLOTHING,
+	ProductType::PRODUCT_MEDICINE,
+};
+
+
+/**
+ * A structure as stored in a savegame.
+ *
+ * The optional parts are only present for the kinds of structure that have
+ * them, e.g. food for food producers or trucks for mine facilities.
+ */
+struct StructureRecord
+{
+	struct FactoryProduction
+	{
+		int turnsCompleted;
+		int productType;
+	};
+
+	struct Waste
+	{
+		int accumulated;
+		int overflow;
+	};
+
+	MapCoordinate position;
+	int type{0};
+	int age{0};
+	int state{0};
+	bool forcedIdle{false};
+	int disabledReason{0};
+	int idleReason{0};
+	int direction{0};
+	int integrity{100};
+	int workersAvailable{0};
+	int scientistsAvailable{0};
+
+	StorableResources production;
+	StorableResources storage;
+
+	std::optional<int> crimeRate;
+	std::optional<FactoryProduction> factoryProduction;
+	std::optional<ProductPool::ProductTypeCount> warehouseProducts;
+	std::optional<int> foodLevel;
+	std::optional<Waste> waste;
+	std::optional<int> assignedTrucks;
+	std::optional<int> digTurnsRemaining;
+	std::optional<int> maintenancePersonnel;
+};
+
+
+/**
+ * A robot as stored in a savegame. Only robots that are out working have a
+ * position.
+ */
+struct RobotRecord
+{
+	int type{0};
+	int age{0};
+	int taskTurns{0};
+	std::optional<int> direction;
+	std::optional<MapCoordinate> position;
+};
+
+
+struct ResearchRecord
+{
+	struct Current
+	{
+		int techId;
+		int progress;
+		int assigned;
+	};
+
+	std::vector<int> completed;
+	std::vector<Current> current;
+};
+
+
+void writeStructureRecords(BinaryWriter& writer, const std::vector<StructureRecord>& records);
+std::vector<StructureRecord> readStructureRecords(BinaryReader& reader);
+
+void writeRobotRecords(BinaryWriter& writer, const std::vector<RobotRecord>& records);
+std::vector<RobotRecord> readRobotRecords(BinaryReader& reader);
+
+void writeResearchRecord(BinaryWriter& writer, const ResearchRecord& record);
+ResearchRecord readResearchRecord(BinaryReader& reader);
+
+NAS2D::Xml::XmlElement* structureRecordsToElement(const std::vector<StructureRecord>& records);
+std::vector<StructureRecord> elementToStructureRecords(const NAS2D::Xml::XmlElement& element);
+
+NAS2D::Xml::XmlElement* robotRecordsToElement(const std::vector<RobotRecord>& records);
+std::vector<RobotRecord> elementToRobotRecords(const NAS2D::Xml::XmlElement& element);
+
+NAS2D::Xml::XmlElement* researchRecordToElement(const ResearchRecord& record);
+ResearchRecord elementToResearchRecord(const NAS2D::Xml::XmlElement& element);
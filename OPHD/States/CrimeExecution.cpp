@@ -1,7 +1,6 @@
 #include "CrimeExecution.h"
 
 #include "../StructureManager.h"
-#include "../UI/NotificationArea.h"
 
 #include <libOPHD/RandomNumberGenerator.h>
 
@@ -9,7 +8,7 @@
 #include <NAS2D/Utility.h>
 
 
-CrimeExecution::CrimeExecution(NotificationArea& notificationArea) : mNotificationArea(notificationArea) {}
+CrimeExecution::CrimeExecution(NotificationSignal& notificationSignal) : mNotificationSignal(notificationSignal) {}
 
 
 void CrimeExecution::executeCrimes(const std::vector<Structure*>& structuresCommittingCrime)
@@ -58,11 +57,11 @@ void CrimeExecution::stealFood(FoodProduction& structure)
 
 		const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(&structure);
 
-		mNotificationArea.push({
+		mNotificationSignal({
 			"Food Stolen",
 			NAS2D::stringFrom(foodStolen) + " units of food was pilfered from a " + structure.name() + ". " + getReasonForStealing() + ".",
 			structureTile.xyz(),
-			NotificationArea::NotificationType::Warning});
+			NotificationType::Warning});
 	}
 }
 
@@ -88,7 +87,7 @@ void CrimeExecution::stealResources(Structure& structure, const std::array<std::
 
 	auto resourceIndicesWithStock = structure.storage().getIndicesWithStock();
 
-	auto indexToStealFrom = randomNumber.generate<std::size_t>(0, resourceIndicesWithStock.size() - 1);
+	auto indexToStealFrom = randomNumber.stream(RandomStream::CrimeExecution).generate<std::size_t>(0, resourceIndicesWithStock.size() - 1);
 
 	int amountStolen = calcAmountForStealing(2, 5);
 	if (amountStolen > structure.storage().resources[indexToStealFrom])
@@ -96,15 +95,26 @@ void CrimeExecution::stealResources(Structure& structure, const std::array<std::
 		amountStolen = structure.storage().resources[indexToStealFrom];
 	}
 
-	structure.storage().resources[indexToStealFrom] -= amountStolen;
+	StorableResources stolen;
+	stolen.resources[indexToStealFrom] = amountStolen;
+
+	// Refined resources are counted in the colony's totals
+	if (ResourceLedger::isContainer(structure))
+	{
+		NAS2D::Utility<StructureManager>::get().resourceLedger().removeFrom(structure, stolen);
+	}
+	else
+	{
+		structure.storage() -= stolen;
+	}
 
 	const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(&structure);
 
-	mNotificationArea.push({
+	mNotificationSignal({
 		"Resources Stolen",
 		NAS2D::stringFrom(amountStolen) + " units of " + resourceNames[indexToStealFrom] + " were stolen from a " + structure.name() + ". " + getReasonForStealing() + ".",
 		structureTile.xyz(),
-		NotificationArea::NotificationType::Warning});
+		NotificationType::Warning});
 }
 
 
@@ -114,17 +124,17 @@ void CrimeExecution::vandalize(Structure& structure)
 
 	const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(&structure);
 
-	mNotificationArea.push({
+	mNotificationSignal({
 		"Vandalism",
 		"A " + structure.name() + " was vandalized.",
 		structureTile.xyz(),
-		NotificationArea::NotificationType::Warning});
+		NotificationType::Warning});
 }
 
 
 int CrimeExecution::calcAmountForStealing(int unadjustedMin, int unadjustedMax)
 {
-	auto amountToSteal = randomNumber.generate(unadjustedMin, unadjustedMax);
+	auto amountToSteal = randomNumber.stream(RandomStream::CrimeExecution).generate(unadjustedMin, unadjustedMax);
 
 	return static_cast<int>(stealingMultipliers.at(mDifficulty) * amountToSteal);
 }
@@ -132,5 +142,5 @@ int CrimeExecution::calcAmountForStealing(int unadjustedMin, int unadjustedMax)
 
 std::string CrimeExecution::getReasonForStealing()
 {
-	return stealingResoureReasons[randomNumber.generate<std::size_t>(0, stealingResoureReasons.size() - 1)];
+	return stealingResoureReasons[randomNumber.stream(RandomStream::CrimeExecution).generate<std::size_t>(0, stealingResoureReasons.size() - 1)];
 }
@@ -2,6 +2,8 @@
 
 #include "../MapObjects/Structures/FoodProduction.h"
 #include "../Common.h"
+#include "../DeferredSignal.h"
+#include "../Notification.h"
 
 #include <vector>
 #include <array>
@@ -10,13 +12,13 @@
 #include <utility>
 
 
-class NotificationArea;
-
-
 class CrimeExecution
 {
 public:
-	CrimeExecution(NotificationArea& notificationArea);
+	using NotificationSignal = DeferredSignal<const Notification&>;
+
+public:
+	CrimeExecution(NotificationSignal& notificationSignal);
 
 	void difficulty(Difficulty difficulty) { mDifficulty = difficulty; }
 
@@ -49,7 +51,7 @@ private:
 	};
 
 	Difficulty mDifficulty{Difficulty::Medium};
-	NotificationArea& mNotificationArea;
+	NotificationSignal& mNotificationSignal;
 	std::vector<std::pair<std::string, int>> mMoraleChanges;
 
 	void stealResources(Structure& structure, const std::array<std::string, 4>& resourceNames);
@@ -4,12 +4,13 @@
 #include "../MapObjects/Structure.h"
 #include "../StructureManager.h"
 
+#include <libOPHD/Map/CoverageLayer.h>
 #include <libOPHD/RandomNumberGenerator.h>
 
 #include <NAS2D/Utility.h>
 
 
-void CrimeRateUpdate::update(const std::vector<std::vector<Tile*>>& policeOverlays)
+void CrimeRateUpdate::update(const CoverageLayer& policeCoverage)
 {
 	mMeanCrimeRate = 0;
 	mStructuresCommittingCrimes.clear();
@@ -27,13 +28,13 @@ void CrimeRateUpdate::update(const std::vector<std::vector<Tile*>>& policeOverla
 
 	for (auto* structure : structuresWithCrime)
 	{
-		int crimeRateChange = isProtectedByPolice(policeOverlays, structure) ? -1 : 1;
+		int crimeRateChange = isProtectedByPolice(policeCoverage, structure) ? -1 : 1;
 		structure->increaseCrimeRate(crimeRateChange);
 
 		// Crime Rate of 0% means no crime
 		// Crime Rate of 100% means crime occurs 10% of the time on medium difficulty
 		// chanceCrimeOccurs multiplier increases or decreases chance based on difficulty
-		if (static_cast<int>(static_cast<float>(structure->crimeRate()) * chanceCrimeOccurs[mDifficulty]) + randomNumber.generate<int>(0, 1000) > 1000)
+		if (static_cast<int>(static_cast<float>(structure->crimeRate()) * chanceCrimeOccurs[mDifficulty]) + randomNumber.stream(RandomStream::CrimeRate).generate<int>(0, 1000) > 1000)
 		{
 			mStructuresCommittingCrimes.push_back(structure);
 		}
@@ -47,19 +48,10 @@ void CrimeRateUpdate::update(const std::vector<std::vector<Tile*>>& policeOverla
 }
 
 
-bool CrimeRateUpdate::isProtectedByPolice(const std::vector<std::vector<Tile*>>& policeOverlays, Structure* structure)
+bool CrimeRateUpdate::isProtectedByPolice(const CoverageLayer& policeCoverage, Structure* structure)
 {
 	const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(structure);
-
-	for (const auto& tile : policeOverlays[static_cast<std::size_t>(structureTile.depth())])
-	{
-		if (tile->xy() == structureTile.xy())
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return policeCoverage.covered(structureTile.xy(), structureTile.depth());
 }
 
 
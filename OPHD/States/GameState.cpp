@@ -6,6 +6,8 @@
 #include "Wrapper.h"
 #include "../StructureManager.h"
 
+#include <libOPHD/FrameScheduler.h>
+
 #include <NAS2D/Utility.h>
 #include <NAS2D/EventHandler.h>
 #include <NAS2D/Mixer/Mixer.h>
@@ -187,6 +189,7 @@ NAS2D::State* GameState::update()
 
 	mFade.update();
 	mFade.draw(NAS2D::Utility<NAS2D::Renderer>::get());
+	if (mFade.isFading()) { NAS2D::Utility<FrameScheduler>::get().redraw(FrameScheduler::Redraw::Continuous); }
 
 	if (mMapView && mMapView->hasGameEnded())
 	{
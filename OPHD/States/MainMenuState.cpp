@@ -6,6 +6,7 @@
 #include "../Cache.h"
 #include "../Constants/Strings.h"
 #include "../Constants/UiConstants.h"
+#include "../Savegame.h"
 #include "../ShellOpenPath.h"
 
 #include "../UI/MessageBox.h"
@@ -137,7 +138,7 @@ void MainMenuState::onFileIoAction(const std::string& filePath, FileIo::FileOper
 		return;
 	}
 
-	std::string filename = constants::SaveGamePath + filePath + ".xml";
+	std::string filename = findSavegame(filePath);
 
 	try
 	{
@@ -2,7 +2,7 @@
 
 #include "MainMenuState.h"
 #include "MainReportsUiState.h"
-#include "Route.h"
+#include "RouteCache.h"
 
 #include "../Constants/Numbers.h"
 #include "../Constants/Strings.h"
@@ -22,13 +22,16 @@
 #include "../UI/DetailMap.h"
 #include "../UI/NavControl.h"
 
+#include <libOPHD/FrameScheduler.h>
+
 #include <NAS2D/Utility.h>
 #include <NAS2D/EventHandler.h>
 #include <NAS2D/Renderer/Renderer.h>
-#include <NAS2D/Math/PointInRectangleRange.h>
 
 #include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 
@@ -39,20 +42,16 @@ const NAS2D::Font* MAIN_FONT = nullptr;
 
 namespace
 {
-	// Relative proportion of mines with yields {low, med, high}
-	const std::map<Planet::Hostility, std::array<int, 3>> HostilityMineYields =
-	{
-		{Planet::Hostility::Low, {30, 50, 20}},
-		{Planet::Hostility::Medium, {45, 35, 20}},
-		{Planet::Hostility::High, {35, 20, 45}},
-	};
-
 	struct RobotMeta
 	{
 		std::string name;
 		const int sheetIndex;
 	};
 
+	// Zoom changes by this factor per step of the mouse wheel
+	constexpr float ZoomStep = 1.25f;
+
+
 	const std::map<Robot::Type, RobotMeta> RobotMetaTable
 	{
 		{Robot::Type::Digger, RobotMeta{constants::Robodigger, constants::RobodiggerSheetId}},
@@ -61,95 +60,6 @@ namespace
 	};
 
 
-	NAS2D::Point<int> clampPointToRect(NAS2D::Point<int> point, const NAS2D::Rectangle<int>& rect)
-	{
-		const auto endPoint = rect.endPoint();
-		return {
-			std::clamp(point.x, rect.position.x, endPoint.x),
-			std::clamp(point.y, rect.position.y, endPoint.y),
-		};
-	}
-
-
-	NAS2D::Rectangle<int> buildTileRectFromCenter(const NAS2D::Point<int>& centerPoint, int radius)
-	{
-		const auto mapRect = NAS2D::Rectangle<int>{{0, 0}, {299, 149}};
-		const auto offset = NAS2D::Vector{radius, radius};
-		const auto areaStartPoint = clampPointToRect(centerPoint - offset, mapRect);
-		const auto areaEndPoint = clampPointToRect(centerPoint + offset + NAS2D::Vector{1, 1}, mapRect);
-		return NAS2D::Rectangle<int>::Create(areaStartPoint, areaEndPoint);
-	}
-
-
-	void fillOverlayCircle(TileMap& tileMap, std::vector<Tile*>& tileList, Tile& centerTile, int range)
-	{
-		const auto center = centerTile.xy();
-		const auto depth = centerTile.depth();
-		auto tileRect = buildTileRectFromCenter(center, range);
-
-		for (const auto point : NAS2D::PointInRectangleRange(tileRect))
-		{
-			if (isPointInRange(center, point, range))
-			{
-				auto& tile = tileMap.getTile({point, depth});
-				if (std::find(tileList.begin(), tileList.end(), &tile) == tileList.end())
-				{
-					tileList.push_back(&tile);
-				}
-			}
-		}
-	}
-
-
-	template <typename StructureType>
-	void fillOverlay(TileMap& tileMap, std::vector<Tile*>& overlay, const std::vector<StructureType*>& structures)
-	{
-		auto& structureManager = NAS2D::Utility<StructureManager>::get();
-		for (const auto* structure : structures)
-		{
-			if (!structure->operational()) { continue; }
-			auto& centerTile = structureManager.tileFromStructure(structure);
-			fillOverlayCircle(tileMap, overlay, centerTile, structure->getRange());
-		}
-	}
-
-
-	template <typename StructureType>
-	void fillOverlay(TileMap& tileMap, std::vector<std::vector<Tile*>>& overlays, const std::vector<StructureType*>& structures)
-	{
-		auto& structureManager = NAS2D::Utility<StructureManager>::get();
-		for (const auto* structure : structures)
-		{
-			if (!structure->operational()) { continue; }
-			auto& centerTile = structureManager.tileFromStructure(structure);
-			fillOverlayCircle(tileMap, overlays[static_cast<std::size_t>(centerTile.depth())], centerTile, structure->getRange());
-		}
-	}
-
-
-	void pushAgingRobotMessage(const Robot* robot, const MapCoordinate& position, NotificationArea& notificationArea)
-	{
-		const auto robotLocationText = "(" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
-
-		if (robot->fuelCellAge() == 190) // FIXME: magic number
-		{
-			notificationArea.push({
-				"Aging Robot",
-				"Robot '" + robot->name() + "' at location " + robotLocationText + " is approaching its maximum age.",
-				position,
-				NotificationArea::NotificationType::Warning});
-		}
-		else if (robot->fuelCellAge() == 195) // FIXME: magic number
-		{
-			notificationArea.push({
-				"Aging Robot",
-				"Robot '" + robot->name() + "' at location " + robotLocationText + " will fail in a few turns. Replace immediately.",
-				position,
-				NotificationArea::NotificationType::Critical});
-		}
-	}
-
-
 	void updateFade(NAS2D::Renderer& renderer, NAS2D::Fade& fade)
 	{
 		fade.update();
@@ -158,25 +68,7 @@ namespace
 }
 
 
-const std::map<Difficulty, int> MapViewState::GracePeriod
-{
-	{Difficulty::Beginner, 30},
-	{Difficulty::Easy, 25},
-	{Difficulty::Medium, 20},
-	{Difficulty::Hard, 15}
-};
-
-const std::map<Difficulty, int> MapViewState::ColonyShipDeorbitMoraleLossMultiplier
-{
-	{Difficulty::Beginner, 1},
-	{Difficulty::Easy, 3},
-	{Difficulty::Medium, 6},
-	{Difficulty::Hard, 10}
-};
-
-
 MapViewState::MapViewState(MainReportsUiState& mainReportsState, const std::string& savegame) :
-	mCrimeExecution(mNotificationArea),
 	mTechnologyReader("tech0-1.xml"),
 	mLoadingExisting(true),
 	mExistingToLoad(savegame),
@@ -184,44 +76,35 @@ MapViewState::MapViewState(MainReportsUiState& mainReportsState, const std::stri
 	mStructures{"ui/structures.png", constants::StructureIconSize, constants::MarginTight},
 	mRobots{"ui/robots.png", constants::RobotIconSize, constants::MarginTight},
 	mConnections{"ui/structures.png", constants::StructureIconSize, constants::MarginTight},
-	mPopulationPanel{mPopulation, mPopulationPool, mMorale},
-	mResourceInfoBar{mResourcesCount, mPopulation, mMorale, mFood},
-	mRobotDeploymentSummary{mRobotPool}
+	mPopulationPanel{mSimulation.population(), mSimulation.populationPool(), mSimulation.morale()},
+	mResourceInfoBar{mSimulation.resources(), mSimulation.population(), mSimulation.morale(), mSimulation.food()},
+	mRobotDeploymentSummary{mSimulation.robotPool()}
 {
-	ccLocation() = CcNotPlaced;
 	NAS2D::Utility<NAS2D::EventHandler>::get().windowResized().connect({this, &MapViewState::onWindowResized});
 }
 
 
 MapViewState::MapViewState(MainReportsUiState& mainReportsState, const Planet::Attributes& planetAttributes, Difficulty selectedDifficulty) :
-	mTileMap(std::make_unique<TileMap>(planetAttributes.mapImagePath, planetAttributes.maxDepth, planetAttributes.maxMines, HostilityMineYields.at(planetAttributes.hostility))),
-	mCrimeExecution(mNotificationArea),
+	mSimulation(planetAttributes, selectedDifficulty),
 	mTechnologyReader("tech0-1.xml"),
-	mPlanetAttributes(planetAttributes),
 	mMainReportsState(mainReportsState),
-	mMapView{std::make_unique<MapView>(*mTileMap)},
+	mMapView{std::make_unique<MapView>(mSimulation.tileMap())},
 	mStructures{"ui/structures.png", constants::StructureIconSize, constants::MarginTight},
 	mRobots{"ui/robots.png", constants::RobotIconSize, constants::MarginTight},
 	mConnections{"ui/structures.png", constants::StructureIconSize, constants::MarginTight},
-	mPopulationPanel{mPopulation, mPopulationPool, mMorale},
-	mPoliceOverlays(static_cast<std::vector<Tile*>::size_type>(mTileMap->maxDepth()+1)),
-	mResourceInfoBar{mResourcesCount, mPopulation, mMorale, mFood},
-	mRobotDeploymentSummary{mRobotPool},
-	mMiniMap{std::make_unique<MiniMap>(*mMapView, *mTileMap, mRobotList, planetAttributes.mapImagePath)},
-	mDetailMap{std::make_unique<DetailMap>(*mMapView, *mTileMap, planetAttributes.tilesetPath)},
-	mNavControl{std::make_unique<NavControl>(*mMapView, *mTileMap)}
+	mPopulationPanel{mSimulation.population(), mSimulation.populationPool(), mSimulation.morale()},
+	mResourceInfoBar{mSimulation.resources(), mSimulation.population(), mSimulation.morale(), mSimulation.food()},
+	mRobotDeploymentSummary{mSimulation.robotPool()},
+	mMiniMap{std::make_unique<MiniMap>(*mMapView, mSimulation.tileMap(), mSimulation.robotList(), planetAttributes.mapImagePath)},
+	mDetailMap{std::make_unique<DetailMap>(*mMapView, mSimulation.tileMap(), planetAttributes.tilesetPath)},
+	mNavControl{std::make_unique<NavControl>(*mMapView, mSimulation.tileMap())}
 {
-	setMeanSolarDistance(mPlanetAttributes.meanSolarDistance);
-	difficulty(selectedDifficulty);
-	ccLocation() = CcNotPlaced;
 	NAS2D::Utility<NAS2D::EventHandler>::get().windowResized().connect({this, &MapViewState::onWindowResized});
 }
 
 
 MapViewState::~MapViewState()
 {
-	scrubRobotList();
-
 	NAS2D::Utility<NAS2D::Renderer>::get().setCursor(PointerType::POINTER_NORMAL);
 
 	auto& eventHandler = NAS2D::Utility<NAS2D::EventHandler>::get();
@@ -235,15 +118,12 @@ MapViewState::~MapViewState()
 	eventHandler.windowResized().disconnect({this, &MapViewState::onWindowResized});
 
 	eventHandler.textInputMode(false);
-
-	NAS2D::Utility<std::map<class MineFacility*, Route>>::get().clear();
 }
 
 
 void MapViewState::setPopulationLevel(PopulationLevel popLevel)
 {
-	mLandersColonist = static_cast<int>(popLevel);
-	mLandersCargo = 2; ///\todo This should be set based on difficulty level.
+	mSimulation.setPopulationLevel(popLevel);
 }
 
 
@@ -258,21 +138,28 @@ void MapViewState::initialize()
 
 	renderer.setCursor(PointerType::POINTER_NORMAL);
 
-	mPopulationPool.population(&mPopulation);
+	mSimulation.notification().connect({this, &MapViewState::onNotification});
+	mSimulation.robotsChanged().connect({this, &MapViewState::populateRobotMenu});
+	mSimulation.robotRemoved().connect({this, &MapViewState::onRobotRemoved});
+	mSimulation.resourcesChanged().connect({this, &MapViewState::updateStructuresAvailability});
+	mSimulation.mineFacilityExtended().connect({this, &MapViewState::onMineFacilityExtend});
+	mSimulation.colonyShipDeorbited().connect({this, &MapViewState::onColonyShipDeorbited});
+	mSimulation.connectednessChanged().connect({this, &MapViewState::onConnectednessChanged});
 
 	StructureCatalogue::init();
 	ProductCatalogue::init("factory_products.xml");
+	preloadSprites();
 
 	if (mLoadingExisting)
 	{
 		load(mExistingToLoad);
 	}
 
-	mResourceInfoBar.ignoreGlow(mTurnCount == 0);
+	mResourceInfoBar.ignoreGlow(mSimulation.turnCount() == 0);
 
 	setupUiPositions(renderer.size());
 
-	mMainReportsState.injectTechnology(mTechnologyReader, mResearchTracker);
+	mMainReportsState.injectTechnology(mTechnologyReader, mSimulation.researchTracker());
 
 	mFade.fadeIn(constants::FadeSpeed);
 
@@ -289,8 +176,6 @@ void MapViewState::initialize()
 	eventHandler.textInputMode(true);
 
 	MAIN_FONT = &fontCache.load(constants::FONT_PRIMARY, constants::FontPrimaryNormal);
-
-	mPathSolver = std::make_unique<micropather::MicroPather>(mTileMap.get(), 250, 6, false);
 }
 
 
@@ -316,14 +201,6 @@ void MapViewState::focusOnStructure(Structure* structure)
 }
 
 
-void MapViewState::difficulty(Difficulty difficulty)
-{
-	mDifficulty = difficulty;
-	mCrimeRateUpdate.difficulty(difficulty);
-	mCrimeExecution.difficulty(difficulty);
-}
-
-
 /**
  * Updates the entire state of the game.
  */
@@ -331,6 +208,7 @@ NAS2D::State* MapViewState::update()
 {
 	auto& renderer = NAS2D::Utility<NAS2D::Renderer>::get();
 	const auto windowClientRect = NAS2D::Rectangle{{0, 0}, renderer.size()};
+	auto& frameScheduler = NAS2D::Utility<FrameScheduler>::get();
 
 	// Game's over, don't bother drawing anything else
 	if (mGameOverDialog.visible())
@@ -339,6 +217,7 @@ NAS2D::State* MapViewState::update()
 		mGameOverDialog.update();
 
 		updateFade(renderer, mFade);
+		frameScheduler.redraw(mFade.isFading() ? FrameScheduler::Redraw::Continuous : FrameScheduler::Redraw::OnChange);
 
 		return this;
 	}
@@ -352,6 +231,7 @@ NAS2D::State* MapViewState::update()
 
 	mDetailMap->update();
 	mDetailMap->draw();
+	mProfilerWindow.frameStats(frameScheduler.stats(), mDetailMap->renderStats());
 
 	// FIXME: Ugly / hacky
 	if (modalUiElementDisplayed())
@@ -363,25 +243,13 @@ NAS2D::State* MapViewState::update()
 
 	updateFade(renderer, mFade);
 
-	return this;
-}
-
-
-void MapViewState::updatePlayerResources()
-{
-	const auto& storageTanks = NAS2D::Utility<StructureManager>::get().getStructures<StorageTanks>();
-	const auto& command = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
+	// Between events the screen only changes while fading, glowing low resource warnings, catching up on
+	// low detail chunk images or animating sprites and beacons
+	if (mFade.isFading() || mResourceInfoBar.glowing() || mDetailMap->lodChunksPending()) { frameScheduler.redraw(FrameScheduler::Redraw::Continuous); }
+	else if (mDetailMap->animated()) { frameScheduler.redraw(FrameScheduler::Redraw::Animated); }
+	else { frameScheduler.redraw(FrameScheduler::Redraw::OnChange); }
 
-	std::vector<Structure*> storage;
-	storage.insert(storage.end(), command.begin(), command.end());
-	storage.insert(storage.end(), storageTanks.begin(), storageTanks.end());
-
-	StorableResources resources;
-	for (auto* structure : storage)
-	{
-		resources += structure->storage();
-	}
-	mResourcesCount = resources;
+	return this;
 }
 
 
@@ -484,7 +352,7 @@ void MapViewState::onKeyDown(NAS2D::EventHandler::KeyCode key, NAS2D::EventHandl
 			break;
 
 		case NAS2D::EventHandler::KeyCode::KEY_END:
-			changeViewDepth(mTileMap->maxDepth());
+			changeViewDepth(mSimulation.tileMap().maxDepth());
 			break;
 
 		case NAS2D::EventHandler::KeyCode::KEY_F10:
@@ -495,6 +363,11 @@ void MapViewState::onKeyDown(NAS2D::EventHandler::KeyCode key, NAS2D::EventHandl
 			}
 			break;
 
+		case NAS2D::EventHandler::KeyCode::KEY_F9:
+			mProfilerWindow.visible(!mProfilerWindow.visible());
+			if (mProfilerWindow.visible()) { mWindowStack.bringToFront(&mProfilerWindow); }
+			break;
+
 		case NAS2D::EventHandler::KeyCode::KEY_F2:
 			mFileIoDialog.scanDirectory(constants::SaveGamePath);
 			mFileIoDialog.setMode(FileIo::FileOperation::Save);
@@ -544,7 +417,7 @@ void MapViewState::onMouseDown(NAS2D::EventHandler::MouseButton button, NAS2D::P
 
 		if (!mDetailMap->isMouseOverTile()) { return; }
 		const auto tilePosition = mDetailMap->mouseTilePosition();
-		if (!mTileMap->isValidPosition(tilePosition)) { return; }
+		if (!mSimulation.tileMap().isValidPosition(tilePosition)) { return; }
 
 		const bool inspectModifier = NAS2D::Utility<NAS2D::EventHandler>::get().shift() ||
 			button == NAS2D::EventHandler::MouseButton::Middle;
@@ -587,9 +460,9 @@ void MapViewState::onMouseDoubleClick(NAS2D::EventHandler::MouseButton button, N
 		if (mWindowStack.pointInWindow(MOUSE_COORDS)) { return; }
 		if (!mDetailMap->isMouseOverTile()) { return; }
 		const auto tilePosition = mDetailMap->mouseTilePosition();
-		if (!mTileMap->isValidPosition(tilePosition)) { return; }
+		if (!mSimulation.tileMap().isValidPosition(tilePosition)) { return; }
 
-		auto& tile = mTileMap->getTile(tilePosition);
+		auto& tile = mSimulation.tileMap().getTile(tilePosition);
 		if (tile.thingIsStructure())
 		{
 			Structure* structure = tile.structure();
@@ -637,15 +510,22 @@ void MapViewState::onMouseMove(NAS2D::Point<int> position, NAS2D::Vector<int> re
 
 void MapViewState::onMouseWheel(NAS2D::Vector<int> changeAmount)
 {
-	if (mInsertMode != InsertMode::Tube) { return; }
+	if (mInsertMode == InsertMode::Tube)
+	{
+		changeAmount.y > 0 ? mConnections.decrementSelection() : mConnections.incrementSelection();
+		return;
+	}
+
+	if (!active() || modalUiElementDisplayed()) { return; }
+	if (mWindowStack.pointInWindow(MOUSE_COORDS) || mBottomUiRect.contains(MOUSE_COORDS)) { return; }
 
-	changeAmount.y > 0 ? mConnections.decrementSelection() : mConnections.incrementSelection();
+	mDetailMap->zoom(mDetailMap->zoom() * std::pow(ZoomStep, static_cast<float>(changeAmount.y)));
 }
 
 
 void MapViewState::onInspect(const MapCoordinate& tilePosition, bool inspectModifier)
 {
-	auto& tile = mTileMap->getTile(tilePosition);
+	auto& tile = mSimulation.tileMap().getTile(tilePosition);
 	if (tile.empty())
 	{
 		onInspectTile(tile);
@@ -791,17 +671,6 @@ void MapViewState::clearMode()
 }
 
 
-void MapViewState::insertTube(ConnectorDir dir, int depth, Tile& tile)
-{
-	if (dir == ConnectorDir::CONNECTOR_VERTICAL)
-	{
-		throw std::runtime_error("MapViewState::insertTube() called with invalid ConnectorDir paramter.");
-	}
-
-	NAS2D::Utility<StructureManager>::get().addStructure(*new Tube(dir, depth != 0), tile);
-}
-
-
 void MapViewState::placeTubes(Tile& tile)
 {
 	if (!tile.bulldozed()) {
@@ -816,12 +685,10 @@ void MapViewState::placeTubes(Tile& tile)
 	 */
 	auto cd = static_cast<ConnectorDir>(mConnections.selectionIndex() + 1);
 
-	if (validTubeConnection(*mTileMap, mMouseTilePosition, cd))
+	if (validTubeConnection(mSimulation.tileMap(), mMouseTilePosition, cd))
 	{
-		insertTube(cd, mMapView->currentDepth(), mTileMap->getTile(mMouseTilePosition));
-
-		// FIXME: Naive approach -- will be slow with larger colonies.
-		updateConnectedness();
+		mSimulation.addTube(cd, mSimulation.tileMap().getTile(mMouseTilePosition));
+		mSimulation.updateConnectedness();
 	}
 	else
 	{
@@ -884,12 +751,9 @@ void MapViewState::placeStructure(Tile& tile)
 	{
 		if (!validLanderSite(tile)) { return; }
 
-		auto& s = *new ColonistLander(&tile);
-		s.deploySignal().connect({this, &MapViewState::onDeployColonistLander});
-		NAS2D::Utility<StructureManager>::get().addStructure(s, tile);
+		mSimulation.addColonistLander(tile);
 
-		--mLandersColonist;
-		if (mLandersColonist == 0)
+		if (mSimulation.colonistLanders() == 0)
 		{
 			clearMode();
 			resetUi();
@@ -900,12 +764,9 @@ void MapViewState::placeStructure(Tile& tile)
 	{
 		if (!validLanderSite(tile)) { return; }
 
-		auto& cargoLander = *new CargoLander(&tile);
-		cargoLander.deploySignal().connect({this, &MapViewState::onDeployCargoLander});
-		NAS2D::Utility<StructureManager>::get().addStructure(cargoLander, tile);
+		mSimulation.addCargoLander(tile);
 
-		--mLandersCargo;
-		if (mLandersCargo == 0)
+		if (mSimulation.cargoLanders() == 0)
 		{
 			clearMode();
 			resetUi();
@@ -914,37 +775,20 @@ void MapViewState::placeStructure(Tile& tile)
 	}
 	else
 	{
-		if (!validStructurePlacement(*mTileMap, mMouseTilePosition) && !selfSustained(mCurrentStructure))
+		if (!validStructurePlacement(mSimulation.tileMap(), mMouseTilePosition) && !selfSustained(mCurrentStructure))
 		{
 			doAlertMessage(constants::AlertInvalidStructureAction, constants::AlertStructureNoTube);
 			return;
 		}
 
 		// Check build cost
-		if (!StructureCatalogue::canBuild(mResourcesCount, mCurrentStructure))
+		if (!StructureCatalogue::canBuild(mSimulation.resources(), mCurrentStructure))
 		{
-			resourceShortageMessage(mResourcesCount, mCurrentStructure);
+			resourceShortageMessage(mSimulation.resources(), mCurrentStructure);
 			return;
 		}
 
-		auto& structure = *StructureCatalogue::get(mCurrentStructure);
-		NAS2D::Utility<StructureManager>::get().addStructure(structure, tile);
-
-		if (structure.isFactory())
-		{
-			auto& factory = static_cast<Factory&>(structure);
-			factory.productionComplete().connect({this, &MapViewState::onFactoryProductionComplete});
-			factory.resourcePool(&mResourcesCount);
-		}
-
-		if (structure.structureId() == StructureID::SID_MAINTENANCE_FACILITY)
-		{
-			static_cast<MaintenanceFacility&>(structure).resources(mResourcesCount);
-		}
-
-		auto cost = StructureCatalogue::costToBuild(mCurrentStructure);
-		removeRefinedResources(cost);
-		updatePlayerResources();
+		mSimulation.addStructure(mCurrentStructure, tile);
 		updateStructuresAvailability();
 	}
 }
@@ -953,7 +797,7 @@ void MapViewState::placeStructure(Tile& tile)
 void MapViewState::placeRobot(Tile& tile)
 {
 	if (!tile.excavated()) { return; }
-	if (!mRobotPool.isControlCapacityAvailable()) { return; }
+	if (!mSimulation.robotPool().isControlCapacityAvailable()) { return; }
 
 	if (!inCommRange(tile.xy()))
 	{
@@ -991,7 +835,7 @@ void MapViewState::placeRobodozer(Tile& tile)
 	}
 	else if (tile.mine())
 	{
-		if (tile.mine()->depth() != mTileMap->maxDepth() || !tile.mine()->exhausted())
+		if (tile.mine()->depth() != mSimulation.tileMap().maxDepth() || !tile.mine()->exhausted())
 		{
 			doAlertMessage(constants::AlertInvalidRobotPlacement, constants::AlertMineNotExhausted);
 			return;
@@ -999,11 +843,11 @@ void MapViewState::placeRobodozer(Tile& tile)
 
 		mMineOperationsWindow.hide();
 		const auto tilePosition = mDetailMap->mouseTilePosition().xy;
-		mTileMap->removeMineLocation(tilePosition);
+		mSimulation.tileMap().removeMineLocation(tilePosition);
 		tile.pushMine(nullptr);
-		for (int i = 0; i <= mTileMap->maxDepth(); ++i)
+		for (int i = 0; i <= mSimulation.tileMap().maxDepth(); ++i)
 		{
-			auto& mineShaftTile = mTileMap->getTile({tilePosition, i});
+			auto& mineShaftTile = mSimulation.tileMap().getTile({tilePosition, i});
 			NAS2D::Utility<StructureManager>::get().removeStructure(*mineShaftTile.structure());
 		}
 	}
@@ -1028,7 +872,8 @@ void MapViewState::placeRobodozer(Tile& tile)
 
 		if (structure->isRobotCommand())
 		{
-			if (mRobotPool.currentControlCount() >= mRobotPool.robotControlMax() - 10)
+			const auto& robotPool = mSimulation.robotPool();
+			if (robotPool.currentControlCount() >= robotPool.robotControlMax() - 10)
 			{
 				mNotificationArea.push({
 					"Cannot bulldoze",
@@ -1052,11 +897,11 @@ void MapViewState::placeRobodozer(Tile& tile)
 
 		if (structure->structureClass() == Structure::StructureClass::Communication)
 		{
-			updateCommRangeOverlay();
+			mSimulation.updateCommRangeOverlay();
 		}
 		if (structure->isPolice())
 		{
-			updatePoliceOverlay();
+			mSimulation.updatePoliceOverlay();
 		}
 
 		const auto& recycledResources = StructureCatalogue::recyclingValue(structure->structureId());
@@ -1071,19 +916,21 @@ void MapViewState::placeRobodozer(Tile& tile)
 				NotificationArea::NotificationType::Warning});
 		}
 
-		updatePlayerResources();
+		mSimulation.updatePlayerResources();
 		updateStructuresAvailability();
 
 		NAS2D::Utility<StructureManager>::get().removeStructure(*structure);
 		tile.deleteMapObject();
-		updateConnectedness();
+		mSimulation.updateConnectedness();
 	}
 
-	auto& robot = mRobotPool.getDozer();
+	auto& robotPool = mSimulation.robotPool();
+	auto& robot = robotPool.getDozer();
 	robot.startTask(tile);
-	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
+	robotPool.insertRobotIntoTable(mSimulation.robotList(), robot, tile);
+	NAS2D::Utility<RouteCache>::get().invalidate(tile);
 
-	if (!mRobotPool.robotAvailable(Robot::Type::Dozer))
+	if (!robotPool.robotAvailable(Robot::Type::Dozer))
 	{
 		mRobots.removeItem(constants::Robodozer);
 		clearMode();
@@ -1094,14 +941,15 @@ void MapViewState::placeRobodozer(Tile& tile)
 void MapViewState::placeRobodigger(Tile& tile)
 {
 	// Keep digger within a safe margin of the map boundaries.
-	if (!NAS2D::Rectangle<int>::Create({4, 4}, NAS2D::Point{-4, -4} + mTileMap->size()).contains(mMouseTilePosition.xy))
+	auto& tileMap = mSimulation.tileMap();
+	if (!NAS2D::Rectangle<int>::Create({4, 4}, NAS2D::Point{-4, -4} + tileMap.size()).contains(mMouseTilePosition.xy))
 	{
 		doAlertMessage(constants::AlertInvalidRobotPlacement, constants::AlertDiggerEdgeBuffer);
 		return;
 	}
 
 	// Check for obstructions underneath the the digger location.
-	if (tile.depth() != mTileMap->maxDepth() && !mTileMap->getTile({tile.xy(), tile.depth() + 1}).empty())
+	if (tile.depth() != tileMap.maxDepth() && !std::as_const(tileMap).getTile({tile.xy(), tile.depth() + 1}).empty())
 	{
 		doAlertMessage(constants::AlertInvalidRobotPlacement, constants::AlertDiggerBlockedBelow);
 		return;
@@ -1117,7 +965,7 @@ void MapViewState::placeRobodigger(Tile& tile)
 			"Digger destroyed a Mine at (" + std::to_string(position.x) + ", " + std::to_string(position.y) + ").",
 			tile.xyz(),
 			NotificationArea::NotificationType::Information});
-		mTileMap->removeMineLocation(position);
+		tileMap.removeMineLocation(position);
 	}
 
 	// Die if tile is occupied or not excavated.
@@ -1130,7 +978,7 @@ void MapViewState::placeRobodigger(Tile& tile)
 				doAlertMessage(constants::AlertInvalidRobotPlacement, constants::AlertStructureInWay);
 				return;
 			}
-			else if (tile.thingIsStructure() && tile.structure()->connectorDirection() == ConnectorDir::CONNECTOR_VERTICAL && tile.depth() == mTileMap->maxDepth())
+			else if (tile.thingIsStructure() && tile.structure()->connectorDirection() == ConnectorDir::CONNECTOR_VERTICAL && tile.depth() == tileMap.maxDepth())
 			{
 				doAlertMessage(constants::AlertInvalidRobotPlacement, constants::AlertMaxDigDepth);
 				return;
@@ -1189,11 +1037,12 @@ void MapViewState::placeRobominer(Tile& tile)
 		return;
 	}
 
-	auto& robot = mRobotPool.getMiner();
+	auto& robotPool = mSimulation.robotPool();
+	auto& robot = robotPool.getMiner();
 	robot.startTask(tile);
-	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
+	robotPool.insertRobotIntoTable(mSimulation.robotList(), robot, tile);
 
-	if (!mRobotPool.robotAvailable(Robot::Type::Miner))
+	if (!robotPool.robotAvailable(Robot::Type::Miner))
 	{
 		mRobots.removeItem(constants::Robominer);
 		clearMode();
@@ -1201,26 +1050,6 @@ void MapViewState::placeRobominer(Tile& tile)
 }
 
 
-Robot& MapViewState::addRobot(Robot::Type type)
-{
-	const std::map<Robot::Type, void (MapViewState::*)(Robot*)> RobotTypeToHandler
-	{
-		{Robot::Type::Digger, &MapViewState::onDiggerTaskComplete},
-		{Robot::Type::Dozer, &MapViewState::onDozerTaskComplete},
-		{Robot::Type::Miner, &MapViewState::onMinerTaskComplete},
-	};
-
-	if (RobotTypeToHandler.find(type) == RobotTypeToHandler.end())
-	{
-		throw std::runtime_error("Unknown Robot::Type: " + std::to_string(static_cast<int>(type)));
-	}
-
-	auto& robot = mRobotPool.addRobot(type);
-	robot.taskComplete().connect({this, RobotTypeToHandler.at(type)});
-	return robot;
-}
-
-
 /**
  * Checks the robot selection interface and if the robot is not available in it, adds
  * it back in.
@@ -1231,7 +1060,7 @@ void MapViewState::populateRobotMenu()
 
 	for (auto& [robotType, robotMeta] : RobotMetaTable)
 	{
-		if (mRobotPool.robotAvailable(robotType))
+		if (mSimulation.robotPool().robotAvailable(robotType))
 		{
 			mRobots.addItem({robotMeta.name, robotMeta.sheetIndex, static_cast<int>(robotType)});
 		}
@@ -1248,17 +1077,15 @@ void MapViewState::populateRobotMenu()
 void MapViewState::insertSeedLander(NAS2D::Point<int> point)
 {
 	// Has to be built away from the edges of the map
-	if (NAS2D::Rectangle<int>::Create({4, 4}, NAS2D::Point{-4, -4} + mTileMap->size()).contains(point))
+	if (NAS2D::Rectangle<int>::Create({4, 4}, NAS2D::Point{-4, -4} + mSimulation.tileMap().size()).contains(point))
 	{
 		// check for obstructions
-		if (!landingSiteSuitable(*mTileMap, point))
+		if (!landingSiteSuitable(mSimulation.tileMap(), point))
 		{
 			return;
 		}
 
-		auto& s = *new SeedLander(point);
-		s.deploySignal().connect({this, &MapViewState::onDeploySeedLander});
-		NAS2D::Utility<StructureManager>::get().addStructure(s, mTileMap->getTile({point, 0})); // Can only ever be placed on depth level 0
+		mSimulation.addSeedLander(point);
 
 		clearMode();
 		resetUi();
@@ -1273,92 +1100,6 @@ void MapViewState::insertSeedLander(NAS2D::Point<int> point)
 }
 
 
-/**
- * Updates all robots.
- */
-void MapViewState::updateRobots()
-{
-	auto robot_it = mRobotList.begin();
-	while (robot_it != mRobotList.end())
-	{
-		auto robot = robot_it->first;
-		auto tile = robot_it->second;
-
-		robot->update();
-
-		const auto& position = tile->xyz();
-
-		pushAgingRobotMessage(robot, position, mNotificationArea);
-
-		if (robot->isDead())
-		{
-			const auto robotLocationText = "(" +  std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
-
-			if (robot->selfDestruct())
-			{
-				mNotificationArea.push({
-					"Robot Self-Destructed",
-					robot->name() + " at location " + robotLocationText + " self destructed.",
-					position,
-					NotificationArea::NotificationType::Critical
-				});
-			}
-			else if (robot->type() != Robot::Type::Miner)
-			{
-				const auto text = "Your " + robot->name() + " at location " + robotLocationText + " has broken down. It will not be able to complete its task and will be removed from your inventory.";
-				mNotificationArea.push({"Robot Broke Down", text, position, NotificationArea::NotificationType::Critical});
-				robot->abortTask(*tile);
-			}
-
-			if (tile->thing() == robot)
-			{
-				tile->removeMapObject();
-			}
-
-			if (mRobotInspector.focusedRobot() == robot) { mRobotInspector.hide(); }
-
-			mRobotPool.erase(robot);
-			robot_it = mRobotList.erase(robot_it);
-		}
-		else if (robot->idle())
-		{
-			if (tile->thing() == robot)
-			{
-				tile->removeMapObject();
-
-				mNotificationArea.push({
-					"Robot Task Completed",
-					robot->name() + " completed its task at" + std::to_string(tile->xy().x) + ", " + std::to_string(tile->xy().y) + ").",
-					tile->xyz(),
-					NotificationArea::NotificationType::Success
-				});
-			}
-			robot_it = mRobotList.erase(robot_it);
-
-			if (robot->taskCanceled())
-			{
-				robot->abortTask(*tile);
-				populateRobotMenu();
-				robot->reset();
-
-				mNotificationArea.push({
-					"Robot Task Canceled",
-					robot->name() + " canceled its task at" + std::to_string(tile->xy().x) + ", " + std::to_string(tile->xy().y) + ").",
-					tile->xyz(),
-					NotificationArea::NotificationType::Information
-				});
-			}
-		}
-		else
-		{
-			++robot_it;
-		}
-	}
-
-	mRobotPool.update();
-}
-
-
 /**
  * Checks and sets the current structure mode.
  */
@@ -1377,54 +1118,6 @@ void MapViewState::setStructureID(StructureID type, InsertMode mode)
 }
 
 
-/**
- * Checks the connectedness of all tiles surrounding
- * the Command Center.
- */
-void MapViewState::updateConnectedness()
-{
-	auto& structureManager = NAS2D::Utility<StructureManager>::get();
-	structureManager.updateConnectedness(*mTileMap);
-	mConnectednessOverlay = structureManager.getConnectednessOverlay();
-}
-
-
-void MapViewState::updateCommRangeOverlay()
-{
-	mCommRangeOverlay.clear();
-
-	auto& structureManager = NAS2D::Utility<StructureManager>::get();
-	fillOverlay(*mTileMap, mCommRangeOverlay, structureManager.getStructures<CommandCenter>());
-	fillOverlay(*mTileMap, mCommRangeOverlay, structureManager.getStructures<CommTower>());
-}
-
-
-void MapViewState::updatePoliceOverlay()
-{
-	for (auto& policeOverlayLevel : mPoliceOverlays)
-	{
-		policeOverlayLevel.clear();
-	}
-
-	auto& structureManager = NAS2D::Utility<StructureManager>::get();
-	fillOverlay(*mTileMap, mPoliceOverlays[0], structureManager.getStructures<SurfacePolice>());
-	fillOverlay(*mTileMap, mPoliceOverlays, structureManager.getStructures<UndergroundPolice>());
-}
-
-
-/**
- * Removes deployed robots from the TileMap to
- * prevent dangling pointers. Yay for raw memory!
- */
-void MapViewState::scrubRobotList()
-{
-	for (auto it : mRobotList)
-	{
-		it.second->removeMapObject();
-	}
-}
-
-
 bool MapViewState::hasGameEnded()
 {
 	return mFade.isFaded();
@@ -1,17 +1,13 @@
 #pragma once
 
 #include "Wrapper.h"
-#include "CrimeRateUpdate.h"
-#include "CrimeExecution.h"
 #include "StructureTracker.h"
 
 #include "Planet.h"
 
+#include "../ColonySimulation.h"
 #include "../Common.h"
 #include "../StorableResources.h"
-#include "../RobotPool.h"
-
-#include "../Constants/Numbers.h"
 
 #include "../Map/MapCoordinate.h"
 
@@ -29,6 +25,7 @@
 #include "../UI/MajorEventAnnouncement.h"
 #include "../UI/MineOperationsWindow.h"
 #include "../UI/PopulationPanel.h"
+#include "../UI/ProfilerWindow.h"
 #include "../UI/ResourceBreakdownPanel.h"
 #include "../UI/RobotInspector.h"
 #include "../UI/StructureInspector.h"
@@ -39,11 +36,6 @@
 #include "../UI/MiniMap.h"
 #include "../UI/CheatMenu.h"
 
-#include <libOPHD/Population/PopulationPool.h>
-#include <libOPHD/Population/Population.h>
-#include <libOPHD/Population/Morale.h>
-
-#include <libOPHD/Technology/ResearchTracker.h>
 #include <libOPHD/Technology/TechnologyCatalog.h>
 
 #include <libControls/WindowStack.h>
@@ -56,22 +48,8 @@
 
 #include <string>
 #include <memory>
-#include <map>
 
 
-namespace NAS2D
-{
-	namespace Xml
-	{
-		class XmlElement;
-	}
-}
-
-namespace micropather
-{
-	class MicroPather;
-}
-
 class Tile;
 class TileMap;
 class MapView;
@@ -95,20 +73,13 @@ enum class InsertMode
 	Structure
 };
 
-using RobotTileTable = std::map<Robot*, Tile*>;
-
-
 extern const NAS2D::Font* MAIN_FONT;
 
 
 class MapViewState : public Wrapper
 {
 public:
-	enum class PopulationLevel
-	{
-		Small = 1,
-		Large = 2
-	};
+	using PopulationLevel = ColonySimulation::PopulationLevel;
 
 public:
 	using QuitSignal = NAS2D::Signal<>;
@@ -128,8 +99,8 @@ public:
 
 	void focusOnStructure(Structure* s);
 
-	Difficulty difficulty() { return mDifficulty; }
-	void difficulty(Difficulty difficulty);
+	Difficulty difficulty() { return mSimulation.difficulty(); }
+	void difficulty(Difficulty difficulty) { mSimulation.difficulty(difficulty); }
 
 	bool hasGameEnded();
 
@@ -160,21 +131,19 @@ private:
 
 	void onSystemMenu();
 
-	// ROBOT EVENT HANDLERS
-	void onDozerTaskComplete(Robot* robot);
-	void onDiggerTaskComplete(Robot* robot);
-	void onMinerTaskComplete(Robot* robot);
+	// SIMULATION EVENT HANDLERS
+	void onNotification(const NotificationArea::Notification& notification);
+	void onRobotRemoved(Robot* robot);
+	void onMineFacilityExtend(MineFacility* mineFacility);
+	void onColonyShipDeorbited(bool landersLost);
+	void onConnectednessChanged();
 
 	// DRAWING FUNCTIONS
 	void drawUI();
 	void drawSystemButton() const;
 
 	// INSERT OBJECT HANDLING
-	void onDeployCargoLander();
-	void onDeployColonistLander();
-	void onDeploySeedLander(NAS2D::Point<int> point);
 	void insertSeedLander(NAS2D::Point<int> point);
-	void insertTube(ConnectorDir dir, int depth, Tile& tile);
 
 	void placeTubes(Tile& tile);
 	void placeStructure(Tile& tile);
@@ -184,64 +153,26 @@ private:
 	void placeRobodigger(Tile&);
 	void placeRobominer(Tile&);
 
-	Robot& addRobot(Robot::Type type);
-
 	void setStructureID(StructureID type, InsertMode mode);
 
 	// MISCELLANEOUS UTILITY FUNCTIONS
-	void updateFood();
-	void transferFoodToCommandCenter();
-
-	void updateCommRangeOverlay();
-	void updatePoliceOverlay();
-	void updateConnectedness();
 	void changeViewDepth(int);
 	void moveView(MapOffset offset);
 	void onChangeDepth(int oldDepth, int newDepth);
 
-	void pullRobotFromFactory(ProductType pt, Factory& factory);
-	void onFactoryProductionComplete(Factory& factory);
 	void onCheatCodeEntry(const std::string& cheatCode);
 
-	void onMineFacilityExtend(MineFacility* mf);
-
-	void updatePlayerResources();
 	void updateResearch();
+	void updatePopulationPanel();
 
 	// TURN LOGIC
-	void checkColonyShip();
-	void checkWarehouseCapacity();
+	void preloadSprites();
+	void runSimulationTurn();
 	void nextTurn();
-	void updatePopulation();
-	void updateCommercial();
-	void updateMaintenance();
-	void updateMorale();
-	void notifyBirthsAndDeaths();
-	void updateResidentialCapacity();
-	void updateBiowasteRecycling();
-	void updateResources();
-	void updateRoads();
-	void updateRobots();
-
-	void findMineRoutes();
-	void transportOreFromMines();
-	void transportResourcesToStorage();
-
-	void checkAgingStructures();
-	void checkNewlyBuiltStructures();
 
 	// SAVE GAME MANAGEMENT FUNCTIONS
-	void readRobots(NAS2D::Xml::XmlElement* element);
-	void readStructures(NAS2D::Xml::XmlElement* element);
-	void readTurns(NAS2D::Xml::XmlElement* element);
-	void readPopulation(NAS2D::Xml::XmlElement* element);
-	void readMoraleChanges(NAS2D::Xml::XmlElement*);
-
-	void scrubRobotList();
-
 	void load(const std::string& filePath);
-	void save(const std::string& filePath);
-	NAS2D::Xml::XmlElement* serializeProperties();
+	void save(const std::string& name);
 
 	// UI MANAGEMENT FUNCTIONS
 	void clearMode();
@@ -292,51 +223,12 @@ private:
 	void onTakeMeThere(const MapCoordinate& position);
 
 private:
-	std::unique_ptr<TileMap> mTileMap;
-	CrimeRateUpdate mCrimeRateUpdate;
-	CrimeExecution mCrimeExecution;
+	ColonySimulation mSimulation;
 
 	StructureTracker mStructureTracker;
 
-	ResearchTracker mResearchTracker;
 	TechnologyCatalog mTechnologyReader;
 
-	Planet::Attributes mPlanetAttributes;
-
-	int mFood{0};
-
-	// DIFFICULTY
-	Difficulty mDifficulty = Difficulty::Medium;
-
-	// Length of "honeymoon period" of no crime/morale updates after landing, in turns
-	static const std::map<Difficulty, int> GracePeriod;
-
-	// Morale loss multiplier on colonist death due to colony ship de-orbit
-	static const std::map<Difficulty, int> ColonyShipDeorbitMoraleLossMultiplier;
-
-	// MISCELLANEOUS
-	int mTurnCount = 0;
-
-	int mTurnNumberOfLanding = constants::ColonyShipOrbitTime; /**< First turn that human colonists landed. */
-
-	Morale mMorale;
-
-	int mLandersColonist = 0;
-	int mLandersCargo = 0;
-
-	int mResidentialCapacity = 0;
-
-	// POOLS
-	StorableResources mResourcesCount;
-	RobotPool mRobotPool; /**< Robots that are currently available for use. */
-	PopulationPool mPopulationPool;
-
-	RobotTileTable mRobotList; /**< List of active robots and their positions on the map. */
-	Population mPopulation;
-
-	// ROUTING
-	std::unique_ptr<micropather::MicroPather> mPathSolver;
-
 	bool mLoadingExisting = false;
 	std::string mExistingToLoad; /**< Filename of the existing game to load. */
 
@@ -383,6 +275,7 @@ private:
 	NotificationArea mNotificationArea;
 	NotificationWindow mNotificationWindow;
 	PopulationPanel mPopulationPanel;
+	ProfilerWindow mProfilerWindow;
 	ResourceBreakdownPanel mResourceBreakdownPanel;
 	RobotInspector mRobotInspector;
 	StructureInspector mStructureInspector;
@@ -398,11 +291,6 @@ private:
 	ReportsUiSignal mReportsUiSignal;
 	MapChangedSignal mMapChangedSignal;
 
-	std::vector<Tile*> mConnectednessOverlay;
-	std::vector<Tile*> mCommRangeOverlay;
-	std::vector<std::vector<Tile*>> mPoliceOverlays;
-	std::vector<Tile*> mTruckRouteOverlay;
-
 	ResourceInfoBar mResourceInfoBar;
 	RobotDeploymentSummary mRobotDeploymentSummary;
 	std::unique_ptr<MiniMap> mMiniMap;
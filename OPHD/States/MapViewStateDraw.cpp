@@ -34,7 +34,7 @@ void MapViewState::drawSystemButton() const
 	const auto turnImageRect = NAS2D::Rectangle<int>{{128, 0}, {constants::ResourceIconSize, constants::ResourceIconSize}};
 	renderer.drawSubImage(mUiIcons, position, turnImageRect);
 	const auto& font = fontCache.load(constants::FONT_PRIMARY, constants::FontPrimaryNormal);
-	renderer.drawText(font, std::to_string(mTurnCount), position + textOffset, NAS2D::Color::White);
+	renderer.drawText(font, std::to_string(mSimulation.turnCount()), position + textOffset, NAS2D::Color::White);
 
 	position = mTooltipSystemButton.rect().position + NAS2D::Vector{constants::MarginTight, constants::MarginTight};
 	bool isMouseInMenu = mTooltipSystemButton.rect().contains(MOUSE_COORDS);
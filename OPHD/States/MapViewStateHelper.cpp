@@ -246,35 +246,6 @@ bool isPointInRange(NAS2D::Point<int> point1, NAS2D::Point<int> point2, int dist
 }
 
 
-/**
- * Gets a pointer to a Warehouse structure that has the specified
- * amount of storage available.
- *
- * \param	type		Product to store. Use value from ProductType enumerator.
- * \param	count		Count of products that need to be stored.
- *
- * \return	Returns a pointer to a Warehouse structure or \c nullptr if
- *			there are no warehouses available with the required space.
- */
-Warehouse* getAvailableWarehouse(ProductType type, std::size_t count)
-{
-	for (auto* warehouse : NAS2D::Utility<StructureManager>::get().getStructures<Warehouse>())
-	{
-		if (!warehouse->operational())
-		{
-			continue;
-		}
-
-		if (warehouse->products().canStore(type, static_cast<int>(count)))
-		{
-			return warehouse;
-		}
-	}
-
-	return nullptr;
-}
-
-
 /**
  * Simulates moving the products out of a specified warehouse and raises
  * an alert to the user if not all products can be moved out of the
@@ -285,25 +256,7 @@ Warehouse* getAvailableWarehouse(ProductType type, std::size_t count)
  */
 bool simulateMoveProducts(Warehouse* sourceWarehouse)
 {
-	ProductPool sourcePool = sourceWarehouse->products();
-	const auto& warehouses = NAS2D::Utility<StructureManager>::get().getStructures<Warehouse>();
-	for (auto* warehouse : warehouses)
-	{
-		if (warehouse->operational())
-		{
-			if (warehouse != sourceWarehouse)
-			{
-				ProductPool destinationPool = warehouse->products();
-				sourcePool.transferAllTo(destinationPool);
-				if (sourcePool.empty())
-				{
-					return true;
-				}
-			}
-		}
-	}
-
-	if (sourcePool.empty())
+	if (NAS2D::Utility<StructureManager>::get().productInventory().planTransfer(*sourceWarehouse).complete)
 	{
 		return true;
 	}
@@ -317,17 +270,8 @@ bool simulateMoveProducts(Warehouse* sourceWarehouse)
  */
 void moveProducts(Warehouse* sourceWarehouse)
 {
-	const auto& warehouses = NAS2D::Utility<StructureManager>::get().getStructures<Warehouse>();
-	for (auto* warehouse : warehouses)
-	{
-		if (warehouse->operational())
-		{
-			if (warehouse != sourceWarehouse)
-			{
-				sourceWarehouse->products().transferAllTo(warehouse->products());
-			}
-		}
-	}
+	auto& productInventory = NAS2D::Utility<StructureManager>::get().productInventory();
+	productInventory.transfer(*sourceWarehouse, productInventory.planTransfer(*sourceWarehouse));
 }
 
 
@@ -354,37 +298,12 @@ void resourceShortageMessage(const StorableResources& resources, StructureID sid
 
 /**
  * Add refined resources to the players storage structures.
+ *
+ * \return	Resources that could not be stored.
  */
 StorableResources addRefinedResources(StorableResources resourcesToAdd)
 {
-	/**
-	 * The Command Center acts as backup storage especially during the beginning of the
-	 * game before storage tanks are built. This ensure that the CC is in the storage
-	 * structure list and that it's always the first structure in the list.
-	 */
-
-	const auto& command = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
-	const auto& storageTanks = NAS2D::Utility<StructureManager>::get().getStructures<StorageTanks>();
-
-	std::vector<Structure*> storage;
-	storage.insert(storage.end(), command.begin(), command.end());
-	storage.insert(storage.end(), storageTanks.begin(), storageTanks.end());
-
-	for (auto* structure : storage)
-	{
-		if (resourcesToAdd.isEmpty()) { break; }
-
-		auto& storageTanksResources = structure->storage();
-
-		auto newResources = storageTanksResources + resourcesToAdd;
-		auto capped = newResources.cap(structure->storageCapacity() / 4);
-
-		storageTanksResources = capped;
-		resourcesToAdd = newResources - capped;
-	}
-
-	// Return remaining unstored refined resources
-	return resourcesToAdd;
+	return NAS2D::Utility<StructureManager>::get().resourceLedger().deposit(resourcesToAdd);
 }
 
 
@@ -396,22 +315,5 @@ StorableResources addRefinedResources(StorableResources resourcesToAdd)
  */
 void removeRefinedResources(StorableResources& resourcesToRemove)
 {
-	// Command Center is backup storage, we want to pull from it last
-
-	const auto& command = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
-	const auto& storageTanks = NAS2D::Utility<StructureManager>::get().getStructures<StorageTanks>();
-
-	std::vector<Structure*> storage;
-	storage.insert(storage.end(), storageTanks.begin(), storageTanks.end());
-	storage.insert(storage.end(), command.begin(), command.end());
-
-	for (auto* structure : storage)
-	{
-		if (resourcesToRemove.isEmpty()) { break; }
-
-		auto& resourcesInStorage = structure->storage();
-		const auto toTransfer = resourcesToRemove.cap(resourcesInStorage);
-		resourcesInStorage -= toTransfer;
-		resourcesToRemove -= toTransfer;
-	}
+	NAS2D::Utility<StructureManager>::get().resourceLedger().withdraw(resourcesToRemove);
 }
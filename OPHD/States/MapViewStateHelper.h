@@ -35,7 +35,6 @@ bool inCommRange(NAS2D::Point<int> position);
 bool isPointInRange(NAS2D::Point<int> point1, NAS2D::Point<int> point2, int distance);
 bool selfSustained(StructureID id);
 
-Warehouse* getAvailableWarehouse(ProductType type, std::size_t count);
 
 bool simulateMoveProducts(Warehouse*);
 void moveProducts(Warehouse*);
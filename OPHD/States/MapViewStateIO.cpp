@@ -6,13 +6,10 @@
 
 #include "MapViewState.h"
 
-#include "Route.h"
-
 #include "../Cache.h"
 #include "../Constants/Strings.h"
 #include "../IOHelper.h"
-#include "../ProductCatalogue.h"
-#include "../StructureCatalogue.h"
+#include "../Savegame.h"
 #include "../StructureManager.h"
 #include "../Map/TileMap.h"
 #include "../Map/MapView.h"
@@ -20,125 +17,25 @@
 #include "../UI/DetailMap.h"
 #include "../UI/NavControl.h"
 
-#include <libOPHD/Technology/ResearchTracker.h>
 #include <libOPHD/XmlSerializer.h>
 
 #include <NAS2D/Utility.h>
 #include <NAS2D/Filesystem.h>
-#include <NAS2D/StringUtils.h>
+#include <NAS2D/Configuration.h>
 #include <NAS2D/Xml/XmlDocument.h>
 #include <NAS2D/Xml/XmlMemoryBuffer.h>
-#include <NAS2D/Dictionary.h>
 #include <NAS2D/ParserHelper.h>
-#include <NAS2D/ContainerUtils.h>
 
 #include <string>
-#include <vector>
 #include <stdexcept>
 
 
-namespace
-{
-	MapCoordinate loadMapCoordinate(const NAS2D::Dictionary& dictionary)
-	{
-		const auto x = dictionary.get<int>("x");
-		const auto y = dictionary.get<int>("y");
-		const auto depth = dictionary.get<int>("depth");
-		return MapCoordinate{{x, y}, depth};
-	}
-
-
-	NAS2D::Dictionary robotToDictionary(RobotTileTable& robotTileTable, Robot& robot)
-	{
-		NAS2D::Dictionary dictionary = robot.getDataDict();
-
-		const auto it = robotTileTable.find(&robot);
-		if (it != robotTileTable.end())
-		{
-			const auto& tile = *it->second;
-			const auto position = tile.xy();
-			dictionary += NAS2D::Dictionary{{
-				{"x", position.x},
-				{"y", position.y},
-				{"depth", tile.depth()},
-			}};
-		}
-
-		return dictionary;
-	}
-
-
-	NAS2D::Xml::XmlElement* writeRobots(RobotPool& robotPool, RobotTileTable& robotMap)
-	{
-		auto* robots = new NAS2D::Xml::XmlElement("robots");
-
-		for (auto robot : robotPool.robots())
-		{
-			auto dictionary = robotToDictionary(robotMap, *robot);
-			robots->linkEndChild(NAS2D::dictionaryToAttributes("robot", dictionary));
-		}
-
-		return robots;
-	}
-
-
-	NAS2D::Xml::XmlElement* writeResearch(const ResearchTracker& tracker)
-	{
-		auto* research = new NAS2D::Xml::XmlElement("research");
-
-		const auto intToStr = [](const auto& x){return std::to_string(x);};
-		const auto completedResearch = NAS2D::join(NAS2D::mapToVector(tracker.completedResearch(), intToStr), ",");
-
-		research->attribute("completed_techs", completedResearch);
-
-		for (const auto& [techId, values] : tracker.currentResearch())
-		{
-			research->linkEndChild(NAS2D::dictionaryToAttributes(
-				"current",
-				{{
-					{"tech_id", techId},
-					{"progress", values.progress},
-					{"assigned", values.scientistsAssigned},
-				}}
-			));
-		}
-
-		return research;
-	}
-
-
-	ResearchTracker readResearch(NAS2D::Xml::XmlElement* element)
-	{
-		ResearchTracker tracker;
-
-		if (!element) { return tracker; }
-
-		const auto researchList = NAS2D::split(element->attribute("completed_techs"));
-
-		for (auto& item : researchList)
-		{
-			tracker.addCompletedResearch(std::stoi(item));
-		}
-
-		for (auto currentResearch = element->firstChildElement();
-			currentResearch != nullptr;
-			currentResearch = currentResearch->nextSiblingElement())
-		{
-			const auto dictionary = NAS2D::attributesToDictionary(*currentResearch);
-
-			tracker.startResearch(
-				dictionary.get<int>("tech_id"),
-				dictionary.get<int>("progress"),
-				dictionary.get<int>("assigned")
-			);
-		}
-
-		return tracker;
-	}
-}
-
-
-void MapViewState::save(const std::string& filePath)
+/**
+ * Saves the game under the given name in the binary format, or as XML if the
+ * "save_as_xml" option is set. Any copy of the savegame in the other format is
+ * removed so it can't be picked up by a later load.
+ */
+void MapViewState::save(const std::string& name)
 {
 	auto& renderer = NAS2D::Utility<NAS2D::Renderer>::get();
 	renderer.drawBoxFilled(NAS2D::Rectangle{{0, 0}, renderer.size()}, NAS2D::Color{0, 0, 0, 100});
@@ -146,71 +43,43 @@ void MapViewState::save(const std::string& filePath)
 	renderer.drawImage(*imageSaving, renderer.center() - imageSaving->size() / 2);
 	renderer.update();
 
-	NAS2D::Xml::XmlDocument doc;
-
-	auto* root = NAS2D::dictionaryToAttributes(
-		constants::SaveGameRootNode,
-		{{{"version", constants::SaveGameVersion}}}
-	);
-	doc.linkEndChild(root);
-
-	root->linkEndChild(serializeProperties());
-	mTileMap->serialize(root);
-	mMapView->serialize(root);
-	root->linkEndChild(NAS2D::Utility<StructureManager>::get().serialize());
-	root->linkEndChild(writeRobots(mRobotPool, mRobotList));
-	root->linkEndChild(writeResources(mResourceBreakdownPanel.previousResources(), "prev_resources"));
-	root->linkEndChild(writeResearch(mResearchTracker));
-	root->linkEndChild(NAS2D::dictionaryToAttributes("turns", {{{"count", mTurnCount}}}));
+	const auto saveAsXml = NAS2D::Utility<NAS2D::Configuration>::get()["options"].get<bool>("save_as_xml");
+	const auto format = saveAsXml ? SavegameFormat::Xml : SavegameFormat::Binary;
+	const auto otherFormat = saveAsXml ? SavegameFormat::Binary : SavegameFormat::Xml;
 
-	const auto& population = mPopulation.getPopulations();
-	root->linkEndChild(NAS2D::dictionaryToAttributes(
-		"population",
-		{{
-			{"morale", mMorale.currentMorale()},
-			{"prev_morale", mMorale.previousMorale()},
-			{"colonist_landers", mLandersColonist},
-			{"cargo_landers", mLandersCargo},
-			{"turn_number_of_landing", mTurnNumberOfLanding},
-			{"children", population.child},
-			{"students", population.student},
-			{"workers", population.worker},
-			{"scientists", population.scientist},
-			{"retired", population.retiree},
-			{"mean_crime", mPopulationPanel.crimeRate()},
-		}}
-	));
+	auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::get();
 
-	auto moraleChangeReasons = new NAS2D::Xml::XmlElement("morale_change");
-	auto& moraleChangeList = mPopulationPanel.moraleReasonList();
-	for (auto& [message, value] : moraleChangeList)
+	if (format == SavegameFormat::Binary)
 	{
-		moraleChangeReasons->linkEndChild(NAS2D::dictionaryToAttributes(
-			"change", {{{"message", message}, {"val", value}}}
-		));
+		SavegameWriter savegame;
+		mSimulation.serialize(savegame);
+		savegame.linkEndChild(mMapView->serialize());
+		savegame.linkEndChild(writeResources(mResourceBreakdownPanel.previousResources(), "prev_resources"));
+		savegame.save(savegamePath(name, format));
 	}
-	root->linkEndChild(moraleChangeReasons);
+	else
+	{
+		NAS2D::Xml::XmlDocument doc;
 
-	// Write out the XML file.
-	NAS2D::Xml::XmlMemoryBuffer buff;
-	doc.accept(&buff);
+		auto* root = NAS2D::dictionaryToAttributes(
+			constants::SaveGameRootNode,
+			{{{"version", constants::SaveGameVersion}}}
+		);
+		doc.linkEndChild(root);
 
-	NAS2D::Utility<NAS2D::Filesystem>::get().writeFile(filePath, buff.buffer());
-}
+		mSimulation.serialize(root);
+		root->linkEndChild(mMapView->serialize());
+		root->linkEndChild(writeResources(mResourceBreakdownPanel.previousResources(), "prev_resources"));
 
+		// Write out the XML file.
+		NAS2D::Xml::XmlMemoryBuffer buff;
+		doc.accept(&buff);
 
-NAS2D::Xml::XmlElement* MapViewState::serializeProperties()
-{
-	return NAS2D::dictionaryToAttributes(
-		"properties",
-		{{
-			{"sitemap", mPlanetAttributes.mapImagePath},
-			{"tset", mPlanetAttributes.tilesetPath},
-			{"diggingdepth", mPlanetAttributes.maxDepth},
-			{"meansolardistance", mPlanetAttributes.meanSolarDistance},
-			{"difficulty", difficultyString(difficulty())},
-		}}
-	);
+		filesystem.writeFile(savegamePath(name, format), buff.buffer());
+	}
+
+	const auto stalePath = savegamePath(name, otherFormat);
+	if (filesystem.exists(stalePath)) { filesystem.del(stalePath); }
 }
 
 
@@ -229,373 +98,46 @@ void MapViewState::load(const std::string& filePath)
 	mBtnToggleRouteOverlay.toggle(false);
 	mBtnTogglePoliceOverlay.toggle(false);
 	mBtnToggleHeightmap.toggle(false);
-	mPopulationPanel.clearMoraleReasons();
 
 	if (!NAS2D::Utility<NAS2D::Filesystem>::get().exists(filePath))
 	{
 		throw std::runtime_error("File '" + filePath + "' was not found.");
 	}
 
-	scrubRobotList();
-	NAS2D::Utility<StructureManager>::get().dropAllStructures();
-	ccLocation() = CcNotPlaced;
-
 	mStructureTracker.reset();
+	mRobots.clear();
 
-	mTileMap.reset();
-
-	auto xmlDocument = openSavegame(filePath);
-	auto* root = xmlDocument.firstChildElement(constants::SaveGameRootNode);
-
-	NAS2D::Xml::XmlElement* map = root->firstChildElement("properties");
-	const auto dictionary = NAS2D::attributesToDictionary(*map);
-
-	mPlanetAttributes = Planet::Attributes();
-	mPlanetAttributes.maxDepth = dictionary.get<int>("diggingdepth");
-	mPlanetAttributes.mapImagePath = dictionary.get("sitemap");
-	mPlanetAttributes.tilesetPath = dictionary.get("tset");
-	mPlanetAttributes.meanSolarDistance = dictionary.get<float>("meansolardistance");
-
-	setMeanSolarDistance(mPlanetAttributes.meanSolarDistance);
+	auto savegame = loadSavegame(filePath);
+	auto* root = savegame.root();
 
-	difficulty(stringToEnum(difficultyTable, dictionary.get("difficulty", std::string{"Medium"})));
+	mSimulation.load(savegame);
 
-	mTileMap = std::make_unique<TileMap>(mPlanetAttributes.mapImagePath, mPlanetAttributes.maxDepth);
-	mTileMap->deserialize(root);
-	mMapView = std::make_unique<MapView>(*mTileMap);
+	auto& tileMap = mSimulation.tileMap();
+	const auto& planetAttributes = mSimulation.planetAttributes();
+	mMapView = std::make_unique<MapView>(tileMap);
 	mMapView->deserialize(root);
-	mMiniMap = std::make_unique<MiniMap>(*mMapView, *mTileMap, mRobotList, mPlanetAttributes.mapImagePath);
-	mDetailMap = std::make_unique<DetailMap>(*mMapView, *mTileMap, mPlanetAttributes.tilesetPath);
-	mNavControl = std::make_unique<NavControl>(*mMapView, *mTileMap);
-
-	mPathSolver = std::make_unique<micropather::MicroPather>(mTileMap.get(), 250, 6, false);
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
-	routeTable.clear();
-
-	readRobots(root->firstChildElement("robots"));
-	readStructures(root->firstChildElement("structures"));
-
-	mResearchTracker = readResearch(root->firstChildElement("research"));
+	mMiniMap = std::make_unique<MiniMap>(*mMapView, tileMap, mSimulation.robotList(), planetAttributes.mapImagePath);
+	mDetailMap = std::make_unique<DetailMap>(*mMapView, tileMap, planetAttributes.tilesetPath);
+	mNavControl = std::make_unique<NavControl>(*mMapView, tileMap);
 
 	mResourceBreakdownPanel.previousResources() = readResources(*root, "prev_resources");
-	readPopulation(root->firstChildElement("population"));
-	readTurns(root->firstChildElement("turns"));
-
-	readMoraleChanges(root->firstChildElement("morale_change"));
-
-	updateConnectedness();
-
-	NAS2D::Utility<StructureManager>::get().updateEnergyProduction();
-	NAS2D::Utility<StructureManager>::get().updateEnergyConsumed();
-	NAS2D::Utility<StructureManager>::get().assignColonistsToResidences(mPopulationPool);
 
-	mRobotPool.update();
-	updateResidentialCapacity();
+	updatePopulationPanel();
 	updateStructuresAvailability();
-
-	updateRoads();
-	findMineRoutes();
-	updateFood();
-	updatePlayerResources();
 	updateResearch();
 
-	if (mTurnCount == 0)
+	if (mSimulation.turnCount() == 0 && NAS2D::Utility<StructureManager>::get().count() != 0)
 	{
-		if (NAS2D::Utility<StructureManager>::get().count() == 0)
-		{
-			mBtnTurns.enabled(false);
-			populateStructureMenu();
-		}
-		else
-		{
-			/**
-			 * There should only ever be one structure if the turn count is 0, the
-			 * SEED Lander which at this point should not have been deployed.
-			 */
-			const auto& list = NAS2D::Utility<StructureManager>::get().getStructures<SeedLander>();
-			if (list.size() != 1) { throw std::runtime_error("MapViewState::load(): Turn counter at 0 but more than one structure in list."); }
-
-			SeedLander* seedLander = list[0];
-			if (!seedLander) { throw std::runtime_error("MapViewState::load(): Structure in list is not a SeedLander."); }
-
-			seedLander->deploySignal().connect({this, &MapViewState::onDeploySeedLander});
-
-			mStructures.clear();
-			mConnections.clear();
-			mBtnTurns.enabled(true);
-		}
+		// The SEED Lander has been placed but not yet deployed.
+		mStructures.clear();
+		mConnections.clear();
+		mBtnTurns.enabled(true);
 	}
 	else
 	{
+		mBtnTurns.enabled(mSimulation.turnCount() > 0);
 		populateStructureMenu();
 	}
 
-	updateCommRangeOverlay();
-	mPoliceOverlays.resize(static_cast<std::vector<Tile*>::size_type>(mTileMap->maxDepth()+1));
-	updatePoliceOverlay();
-
 	mMapChangedSignal();
 }
-
-
-void MapViewState::readRobots(NAS2D::Xml::XmlElement* element)
-{
-	mRobotPool.clear();
-	mRobotList.clear();
-	mRobots.clear();
-
-	for (NAS2D::Xml::XmlElement* robotElement = element->firstChildElement(); robotElement; robotElement = robotElement->nextSiblingElement())
-	{
-		const auto dictionary = NAS2D::attributesToDictionary(*robotElement);
-
-		const auto type = dictionary.get<int>("type");
-		const auto age = dictionary.get<int>("age");
-		const auto production_time = dictionary.get<int>("production");
-		const auto x = dictionary.get<int>("x", 0);
-		const auto y = dictionary.get<int>("y", 0);
-		const auto depth = dictionary.get<int>("depth", 0);
-		const auto direction = dictionary.get<int>("direction", 0);
-
-		const auto robotType = static_cast<Robot::Type>(type);
-		auto& robot = addRobot(robotType);
-		if (robotType == Robot::Type::Digger)
-		{
-			static_cast<Robodigger&>(robot).direction(static_cast<Direction>(direction));
-		}
-
-		robot.fuelCellAge(age);
-
-		if (production_time > 0)
-		{
-			robot.startTask(production_time);
-			mRobotPool.insertRobotIntoTable(mRobotList, robot, mTileMap->getTile({{x, y}, depth}));
-			mRobotList[&robot]->index(TerrainType::Dozed);
-		}
-
-		if (depth > 0)
-		{
-			mRobotList[&robot]->excavated(true);
-		}
-	}
-
-	populateRobotMenu();
-}
-
-
-void MapViewState::readStructures(NAS2D::Xml::XmlElement* element)
-{
-	for (NAS2D::Xml::XmlElement* structureElement = element->firstChildElement(); structureElement != nullptr; structureElement = structureElement->nextSiblingElement())
-	{
-		const auto dictionary = NAS2D::attributesToDictionary(*structureElement);
-
-		const auto type = dictionary.get<int>("type");
-		const auto age = dictionary.get<int>("age");
-		const auto state = dictionary.get<int>("state");
-		const auto direction = dictionary.get<int>("direction");
-		const auto forced_idle = dictionary.get<bool>("forced_idle");
-		const auto disabled_reason = dictionary.get<int>("disabled_reason");
-		const auto idle_reason = dictionary.get<int>("idle_reason");
-
-		const auto crime_rate = dictionary.get<int>("crime_rate", 0);
-		const auto integrity = dictionary.get<int>("integrity", 100);
-
-		const auto production_completed = dictionary.get<int>("production_completed", 0);
-		const auto production_type = dictionary.get<int>("production_type", 0);
-
-		const auto pop0 = dictionary.get<int>("pop0");
-		const auto pop1 = dictionary.get<int>("pop1");
-
-		const auto mapCoordinate = loadMapCoordinate(dictionary);
-		auto& tile = mTileMap->getTile(mapCoordinate);
-		tile.index(TerrainType::Dozed);
-		tile.excavated(true);
-
-		auto structureId = static_cast<StructureID>(type);
-		if (structureId == StructureID::SID_TUBE)
-		{
-			ConnectorDir connectorDir = static_cast<ConnectorDir>(direction);
-			insertTube(connectorDir, mapCoordinate.z, mTileMap->getTile(mapCoordinate));
-			continue; // FIXME: ugly
-		}
-
-		auto& structure = *StructureCatalogue::get(structureId);
-
-		if (structureId == StructureID::SID_COMMAND_CENTER)
-		{
-			ccLocation() = mapCoordinate.xy;
-		}
-
-		if (structureId == StructureID::SID_MINE_FACILITY)
-		{
-			auto* mine = mTileMap->getTile({mapCoordinate.xy, 0}).mine();
-			if (mine == nullptr)
-			{
-				throw std::runtime_error("Mine Facility is located on a Tile with no Mine.");
-			}
-
-			auto& mineFacility = *static_cast<MineFacility*>(&structure);
-			mineFacility.mine(mine);
-			mineFacility.maxDepth(mTileMap->maxDepth());
-			mineFacility.extensionComplete().connect({this, &MapViewState::onMineFacilityExtend});
-
-			auto trucks = structureElement->firstChildElement("trucks");
-			if (trucks)
-			{
-				mineFacility.assignedTrucks(NAS2D::attributesToDictionary(*trucks).get<int>("assigned"));
-			}
-
-			auto extension = structureElement->firstChildElement("extension");
-			if (extension)
-			{
-				mineFacility.digTimeRemaining(NAS2D::attributesToDictionary(*extension).get<int>("turns_remaining"));
-			}
-		}
-
-		if (structureId == StructureID::SID_AIR_SHAFT && mapCoordinate.z != 0)
-		{
-			static_cast<AirShaft*>(&structure)->ug(); // force underground state
-		}
-
-		if (structureId == StructureID::SID_SEED_LANDER)
-		{
-			static_cast<SeedLander*>(&structure)->position(mapCoordinate.xy);
-		}
-
-		if (structureId == StructureID::SID_AGRIDOME ||
-			structureId == StructureID::SID_COMMAND_CENTER)
-		{
-			auto& foodProduction = *static_cast<FoodProduction*>(&structure);
-
-			auto foodStorage = structureElement->firstChildElement("food");
-			if (foodStorage == nullptr)
-			{
-				throw std::runtime_error("MapViewState::readStructures(): FoodProduction structure saved without a food level node.");
-			}
-
-			foodProduction.foodLevel(NAS2D::attributesToDictionary(*foodStorage).get<int>("level"));
-		}
-
-		structure.age(age);
-		structure.forced_state_change(static_cast<StructureState>(state), static_cast<DisabledReason>(disabled_reason), static_cast<IdleReason>(idle_reason));
-		structure.connectorDirection(static_cast<ConnectorDir>(direction));
-		structure.integrity(integrity);
-
-		if (forced_idle != 0) { structure.forceIdle(forced_idle != 0); }
-
-		structure.production() = readResourcesOptional(*structureElement, "production");
-		structure.storage() = readResourcesOptional(*structureElement, "storage");
-
-		if (structure.structureClass() == Structure::StructureClass::Residence)
-		{
-			auto waste = structureElement->firstChildElement("waste");
-			if (waste)
-			{
-				auto& residence = *static_cast<Residence*>(&structure);
-				const auto wasteDictionary = NAS2D::attributesToDictionary(*waste);
-				residence.wasteAccumulated(wasteDictionary.get<int>("accumulated"));
-				residence.wasteOverflow(wasteDictionary.get<int>("overflow"));
-			}
-		}
-
-		if (structure.structureClass() == Structure::StructureClass::Maintenance)
-		{
-			auto personnel = structureElement->firstChildElement("personnel");
-			if (personnel)
-			{
-				auto& maintenanceFacility = *static_cast<MaintenanceFacility*>(&structure);
-				maintenanceFacility.personnel(NAS2D::attributesToDictionary(*personnel).get<int>("assigned", 0));
-				maintenanceFacility.resources(mResourcesCount);
-			}
-		}
-
-		if (structure.isWarehouse())
-		{
-			auto& warehouse = *static_cast<Warehouse*>(&structure);
-			warehouse.products().deserialize(NAS2D::attributesToDictionary(
-				*structureElement->firstChildElement("warehouse_products")
-			));
-		}
-
-		if (structure.isFactory())
-		{
-			auto& factory = *static_cast<Factory*>(&structure);
-			factory.productType(static_cast<ProductType>(production_type));
-			factory.productionTurnsCompleted(production_completed);
-			factory.resourcePool(&mResourcesCount);
-			factory.productionComplete().connect({this, &MapViewState::onFactoryProductionComplete});
-		}
-
-		if (structure.hasCrime())
-		{
-			structure.crimeRate(crime_rate);
-		}
-
-		structure.populationAvailable() = {pop0, pop1};
-
-		NAS2D::Utility<StructureManager>::get().addStructure(structure, tile);
-	}
-}
-
-
-void MapViewState::readTurns(NAS2D::Xml::XmlElement* element)
-{
-	if (element)
-	{
-		mTurnCount = NAS2D::attributesToDictionary(*element).get<int>("count");
-
-		if (mTurnCount > 0)
-		{
-			mBtnTurns.enabled(true);
-			populateStructureMenu();
-		}
-	}
-}
-
-
-/**
- * Reads the population tag.
- */
-void MapViewState::readPopulation(NAS2D::Xml::XmlElement* element)
-{
-	if (element)
-	{
-		mPopulation = {};
-
-		const auto dictionary = NAS2D::attributesToDictionary(*element);
-
-		mLandersColonist = dictionary.get<int>("colonist_landers");
-		mLandersCargo = dictionary.get<int>("cargo_landers");
-
-		mMorale = Morale(dictionary.get<int>("morale"), dictionary.get<int>("prev_morale"));
-
-		mTurnNumberOfLanding = dictionary.get<int>("turn_number_of_landing", constants::ColonyShipOrbitTime);
-
-		const auto meanCrimeRate = dictionary.get<int>("mean_crime", 0);
-
-		const auto children = dictionary.get<int>("children");
-		const auto students = dictionary.get<int>("students");
-		const auto workers = dictionary.get<int>("workers");
-		const auto scientists = dictionary.get<int>("scientists");
-		const auto retired = dictionary.get<int>("retired");
-
-		mPopulationPanel.crimeRate(meanCrimeRate);
-
-		mPopulation.addPopulation({children, students, workers, scientists, retired});
-	}
-}
-
-
-void MapViewState::readMoraleChanges(NAS2D::Xml::XmlElement* moraleChangeElement)
-{
-	if (!moraleChangeElement) { return; }
-
-	for (auto messageElement = moraleChangeElement->firstChildElement(); messageElement; messageElement = messageElement->nextSiblingElement())
-	{
-		const auto dictionary = NAS2D::attributesToDictionary(*messageElement);
-
-		const auto message = dictionary.get("message");
-		const auto val = dictionary.get<int>("val");
-
-		mPopulationPanel.addMoraleReason(message, val);
-	}
-}
@@ -13,6 +13,7 @@
 #include "../Constants/UiConstants.h"
 
 #include "../DirectionOffset.h"
+#include "../Savegame.h"
 #include "../StructureCatalogue.h"
 #include "../StructureManager.h"
 #include "../Map/MapCoordinate.h"
@@ -78,7 +79,7 @@ void MapViewState::initUi()
 	mPopulationPanel.position({675, constants::ResourceIconSize + 4 + constants::MarginTight});
 
 	mResourceBreakdownPanel.position({0, 22});
-	mResourceBreakdownPanel.playerResources(&mResourcesCount);
+	mResourceBreakdownPanel.playerResources(&mSimulation.resources());
 
 	mGameOverDialog.returnToMainMenu().connect({this, &MapViewState::onGameOver});
 	mGameOverDialog.hide();
@@ -103,6 +104,9 @@ void MapViewState::initUi()
 	mWindowStack.addWindow(&mRobotInspector);
 	mWindowStack.addWindow(&mNotificationWindow);
 	mWindowStack.addWindow(&mCheatMenu);
+	mWindowStack.addWindow(&mProfilerWindow);
+
+	mProfilerWindow.hide();
 
 	mNotificationArea.notificationClicked().connect({this, &MapViewState::onNotificationClicked});
 
@@ -226,6 +230,7 @@ void MapViewState::setupUiPositions(NAS2D::Vector<int> size)
 	// Anchored window positions
 	mFileIoDialog.position(NAS2D::Point{centerPosition(mFileIoDialog).x, 50});
 	mCheatMenu.position(NAS2D::Point{centerPosition(mCheatMenu).x, centerPosition(mCheatMenu).y});
+	mProfilerWindow.position(NAS2D::Point{size.x - mProfilerWindow.size().x - constants::Margin, 50});
 	mGameOverDialog.position(centerPosition(mGameOverDialog) - NAS2D::Vector{0, 100});
 	mAnnouncement.position(centerPosition(mAnnouncement) - NAS2D::Vector{0, 100});
 	mGameOptionsDialog.position(centerPosition(mGameOptionsDialog) - NAS2D::Vector{0, 100});
@@ -332,8 +337,8 @@ void MapViewState::populateStructureMenu()
 		mConnections.addItem({constants::AgTubeLeft, 111, ConnectorDir::CONNECTOR_LEFT});
 
 		// Special case code, not thrilled with this
-		if (mLandersColonist > 0) { mStructures.addItem({constants::ColonistLander, 2, StructureID::SID_COLONIST_LANDER}); }
-		if (mLandersCargo > 0) { mStructures.addItem({constants::CargoLander, 1, StructureID::SID_CARGO_LANDER}); }
+		if (mSimulation.colonistLanders() > 0) { mStructures.addItem({constants::ColonistLander, 2, StructureID::SID_COLONIST_LANDER}); }
+		if (mSimulation.cargoLanders() > 0) { mStructures.addItem({constants::CargoLander, 1, StructureID::SID_CARGO_LANDER}); }
 	}
 	else
 	{
@@ -375,6 +380,7 @@ void MapViewState::drawUI()
 	renderer.drawBox(mBottomUiRect, NAS2D::Color{21, 21, 21});
 	renderer.drawLine(NAS2D::Point{mBottomUiRect.position.x + 1, mBottomUiRect.position.y}, NAS2D::Point{mBottomUiRect.position.x + mBottomUiRect.size.x - 2, mBottomUiRect.position.y}, NAS2D::Color{56, 56, 56});
 
+	mMiniMap->update();
 	mMiniMap->draw();
 	mNavControl->draw();
 	mRobotDeploymentSummary.draw();
@@ -420,10 +426,10 @@ void MapViewState::setOverlay(std::vector<Tile*>& tileList, Tile::Overlay overla
 
 void MapViewState::clearOverlays()
 {
-	clearOverlay(mConnectednessOverlay);
-	clearOverlay(mCommRangeOverlay);
-	clearOverlay(mPoliceOverlays[static_cast<std::size_t>(mMapView->currentDepth())]);
-	clearOverlay(mTruckRouteOverlay);
+	clearOverlay(mSimulation.connectednessOverlay());
+	clearOverlay(mSimulation.commRangeOverlay());
+	clearOverlay(mSimulation.policeOverlay(mMapView->currentDepth()));
+	clearOverlay(mSimulation.truckRouteOverlay());
 }
 
 
@@ -435,8 +441,8 @@ void MapViewState::clearOverlay(std::vector<Tile*>& tileList)
 
 void MapViewState::changePoliceOverlayDepth(int oldDepth, int newDepth)
 {
-	clearOverlay(mPoliceOverlays[static_cast<std::size_t>(oldDepth)]);
-	setOverlay(mPoliceOverlays[static_cast<std::size_t>(newDepth)], Tile::Overlay::Police);
+	clearOverlay(mSimulation.policeOverlay(oldDepth));
+	setOverlay(mSimulation.policeOverlay(newDepth), Tile::Overlay::Police);
 }
 
 
@@ -459,7 +465,7 @@ void MapViewState::onToggleConnectedness()
 		mBtnToggleRouteOverlay.toggle(false);
 		mBtnTogglePoliceOverlay.toggle(false);
 
-		setOverlay(mConnectednessOverlay, Tile::Overlay::Connectedness);
+		setOverlay(mSimulation.connectednessOverlay(), Tile::Overlay::Connectedness);
 	}
 }
 
@@ -474,7 +480,7 @@ void MapViewState::onToggleCommRangeOverlay()
 		mBtnToggleRouteOverlay.toggle(false);
 		mBtnTogglePoliceOverlay.toggle(false);
 
-		setOverlay(mCommRangeOverlay, Tile::Overlay::Communications);
+		setOverlay(mSimulation.commRangeOverlay(), Tile::Overlay::Communications);
 	}
 }
 
@@ -488,7 +494,7 @@ void MapViewState::onTogglePoliceOverlay()
 		mBtnToggleConnectedness.toggle(false);
 		mBtnToggleRouteOverlay.toggle(false);
 
-		setOverlay(mPoliceOverlays[static_cast<std::size_t>(mMapView->currentDepth())], Tile::Overlay::Police);
+		setOverlay(mSimulation.policeOverlay(mMapView->currentDepth()), Tile::Overlay::Police);
 	}
 }
 
@@ -502,7 +508,7 @@ void MapViewState::onToggleRouteOverlay()
 		mBtnToggleCommRangeOverlay.toggle(false);
 		mBtnTogglePoliceOverlay.toggle(false);
 
-		setOverlay(mTruckRouteOverlay, Tile::Overlay::TruckingRoutes);
+		setOverlay(mSimulation.truckRouteOverlay(), Tile::Overlay::TruckingRoutes);
 	}
 }
 
@@ -529,7 +535,7 @@ void MapViewState::onStructuresSelectionChange(const IconGrid::Item* item)
 	// Check availability
 	if (!item->available)
 	{
-		resourceShortageMessage(mResourcesCount, static_cast<StructureID>(item->meta));
+		resourceShortageMessage(mSimulation.resources(), static_cast<StructureID>(item->meta));
 		mStructures.clearSelection();
 		return;
 	}
@@ -580,23 +586,24 @@ void MapViewState::onDiggerSelectionDialog(Direction direction, Tile& tile)
 	{
 		NAS2D::Utility<StructureManager>::get().removeStructure(*tile.structure());
 		tile.deleteMapObject();
-		updateConnectedness();
+		mSimulation.updateConnectedness();
 	}
 
 	// Assumes a digger is available.
-	Robodigger& robot = mRobotPool.getDigger();
+	auto& robotPool = mSimulation.robotPool();
+	Robodigger& robot = robotPool.getDigger();
 	robot.startTask(tile);
-	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
+	robotPool.insertRobotIntoTable(mSimulation.robotList(), robot, tile);
 
 	robot.direction(direction);
 
 	const auto directionOffset = directionEnumToOffset(direction);
 	if (directionOffset != DirectionCenter)
 	{
-		mTileMap->getTile({tile.xy() + directionOffset, tile.depth()}).excavated(true);
+		mSimulation.tileMap().getTile({tile.xy() + directionOffset, tile.depth()}).excavated(true);
 	}
 
-	if (!mRobotPool.robotAvailable(Robot::Type::Digger))
+	if (!robotPool.robotAvailable(Robot::Type::Digger))
 	{
 		mRobots.removeItem(constants::Robodigger);
 		clearMode();
@@ -659,7 +666,7 @@ void MapViewState::onFileIoAction(const std::string& filePath, FileIo::FileOpera
 	{
 		try
 		{
-			load(constants::SaveGamePath + filePath + ".xml");
+			load(findSavegame(filePath));
 			auto& renderer = NAS2D::Utility<NAS2D::Renderer>::get();
 			setupUiPositions(renderer.size());
 		}
@@ -671,7 +678,7 @@ void MapViewState::onFileIoAction(const std::string& filePath, FileIo::FileOpera
 	}
 	else
 	{
-		save(constants::SaveGamePath + filePath + ".xml");
+		save(filePath);
 	}
 
 	mFileIoDialog.hide();
@@ -716,47 +723,47 @@ void MapViewState::onCheatCodeEntry(const std::string& cheatCode)
 		}
 		break;
 		case CheatMenu::CheatCode::AddChildren:
-			mPopulation.addPopulation({10, 0, 0, 0, 0});
+			mSimulation.population().addPopulation({10, 0, 0, 0, 0});
 		break;
 		case CheatMenu::CheatCode::AddStudents:
-			mPopulation.addPopulation({0, 10, 0, 0, 0});
+			mSimulation.population().addPopulation({0, 10, 0, 0, 0});
 		break;
 		case CheatMenu::CheatCode::AddWorkers:
-			mPopulation.addPopulation({0, 0, 10, 0, 0});
+			mSimulation.population().addPopulation({0, 0, 10, 0, 0});
 		break;
 		case CheatMenu::CheatCode::AddScientists:
-			mPopulation.addPopulation({0, 0, 0, 10, 0});
+			mSimulation.population().addPopulation({0, 0, 0, 10, 0});
 		break;
 		case CheatMenu::CheatCode::AddRetired:
-			mPopulation.addPopulation({0, 0, 0, 0, 10});
+			mSimulation.population().addPopulation({0, 0, 0, 0, 10});
 		break;
 		case CheatMenu::CheatCode::RemoveChildren:
-			mPopulation.removePopulation({10, 0, 0, 0, 0});
+			mSimulation.population().removePopulation({10, 0, 0, 0, 0});
 		break;
 		case CheatMenu::CheatCode::RemoveStudents:
-			mPopulation.removePopulation({0, 10, 0, 0, 0});
+			mSimulation.population().removePopulation({0, 10, 0, 0, 0});
 		break;
 		case CheatMenu::CheatCode::RemoveWorkers:
-			mPopulation.removePopulation({0, 0, 10, 0, 0});
+			mSimulation.population().removePopulation({0, 0, 10, 0, 0});
 		break;
 		case CheatMenu::CheatCode::RemoveScientists:
-			mPopulation.removePopulation({0, 0, 0, 10, 0});
+			mSimulation.population().removePopulation({0, 0, 0, 10, 0});
 		break;
 		case CheatMenu::CheatCode::RemoveRetired:
-			mPopulation.removePopulation({0, 0, 0, 0, 10});
+			mSimulation.population().removePopulation({0, 0, 0, 0, 10});
 		break;
 		case CheatMenu::CheatCode::AddRobots:
-			mRobotPool.addRobot(Robot::Type::Digger);
-			mRobotPool.addRobot(Robot::Type::Dozer);
-			mRobotPool.addRobot(Robot::Type::Miner);
+			mSimulation.addRobot(Robot::Type::Digger);
+			mSimulation.addRobot(Robot::Type::Dozer);
+			mSimulation.addRobot(Robot::Type::Miner);
 		break;
 
 	}
-	updatePlayerResources();
+	mSimulation.updatePlayerResources();
 	updateStructuresAvailability();
-	updateFood();
-	updatePopulation();
-	updateRobots();
+	mSimulation.updateFood();
+	mSimulation.updatePopulation();
+	mSimulation.updateRobots();
 }
 
 /**
@@ -767,6 +774,6 @@ void MapViewState::updateStructuresAvailability()
 	for (int sid = 1; sid < StructureID::SID_COUNT; ++sid)
 	{
 		const StructureID id = static_cast<StructureID>(sid);
-		mStructures.itemAvailable(StructureName(id), StructureCatalogue::canBuild(mResourcesCount, id));
+		mStructures.itemAvailable(StructureName(id), StructureCatalogue::canBuild(mSimulation.resources(), id));
 	}
 }
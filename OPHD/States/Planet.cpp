@@ -118,7 +118,8 @@ namespace
 		}
 
 		const auto requiredFields = std::vector<std::string>{"PlanetType", "ImagePath", "Hostility", "MaxDepth", "MaxMines", "MapImagePath", "TilesetPath", "Name", "MeanSolarDistance", "Description"};
-		NAS2D::reportMissingOrUnexpected(dictionary.keys(), requiredFields, {});
+		const auto optionalFields = std::vector<std::string>{"MapWidth", "MapHeight"};
+		NAS2D::reportMissingOrUnexpected(dictionary.keys(), requiredFields, optionalFields);
 
 		return {
 			stringToEnum(planetTypeTable, dictionary.get("PlanetType")),
@@ -131,6 +132,7 @@ namespace
 			dictionary.get("Name"),
 			dictionary.get<float>("MeanSolarDistance"),
 			dictionary.get("Description"),
+			{dictionary.get<int>("MapWidth", 0), dictionary.get<int>("MapHeight", 0)},
 		};
 	}
 }
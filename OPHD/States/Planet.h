@@ -42,6 +42,9 @@ public:
 		float meanSolarDistance = 0;
 
 		std::string description;
+
+		/* Size of the site in tiles. Zero uses the size of the map image. */
+		NAS2D::Vector<int> mapSize{0, 0};
 	};
 
 public:
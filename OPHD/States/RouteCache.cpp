@@ -0,0 +1,109 @@
+#include "RouteCache.h"
+
+#include "../Map/Tile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+void RouteCache::insert(MineFacility* mine, Route route)
+{
+	erase(mine);
+
+	for (auto* tile : route.path)
+	{
+		auto& routesOnTile = mRoutesByTile[static_cast<const Tile*>(tile)];
+		if (std::find(routesOnTile.begin(), routesOnTile.end(), mine) == routesOnTile.end())
+		{
+			routesOnTile.push_back(mine);
+		}
+	}
+
+	mRoutes[mine] = std::move(route);
+	++mRevision;
+}
+
+
+void RouteCache::erase(MineFacility* mine)
+{
+	const auto routeIt = mRoutes.find(mine);
+	if (routeIt == mRoutes.end()) { return; }
+
+	for (auto* tile : routeIt->second.path)
+	{
+		const auto tileIt = mRoutesByTile.find(static_cast<const Tile*>(tile));
+		if (tileIt == mRoutesByTile.end()) { continue; }
+
+		auto& routesOnTile = tileIt->second;
+		routesOnTile.erase(std::remove(routesOnTile.begin(), routesOnTile.end(), mine), routesOnTile.end());
+		if (routesOnTile.empty()) { mRoutesByTile.erase(tileIt); }
+	}
+
+	mRoutes.erase(routeIt);
+	++mRevision;
+}
+
+
+void RouteCache::clear()
+{
+	mRoutes.clear();
+	mRoutesByTile.clear();
+	++mRevision;
+}
+
+
+bool RouteCache::contains(const MineFacility* mine) const
+{
+	return mRoutes.find(mine) != mRoutes.end();
+}
+
+
+const Route& RouteCache::at(const MineFacility* mine) const
+{
+	const auto routeIt = mRoutes.find(mine);
+	if (routeIt == mRoutes.end())
+	{
+		throw std::runtime_error("RouteCache::at(): No route for the specified mine");
+	}
+
+	return routeIt->second;
+}
+
+
+/**
+ * Drops every route that passes over a tile whose contents or terrain
+ * changed.
+ */
+void RouteCache::invalidate(const Tile& tile)
+{
+	const auto tileIt = mRoutesByTile.find(&tile);
+	if (tileIt == mRoutesByTile.end()) { return; }
+
+	// erase() modifies the list being iterated
+	const auto routesOnTile = tileIt->second;
+	for (auto* mine : routesOnTile)
+	{
+		erase(mine);
+	}
+}
+
+
+/**
+ * Handler for TileMap's tile changed signal. A tile whose terrain changed
+ * now costs more or less to cross, and one that is built on or cleared may
+ * no longer be passable or may have just become so.
+ */
+void RouteCache::onTileChanged(const Tile& tile)
+{
+	invalidate(tile);
+}
+
+
+/**
+ * Handler for StructureManager's structure added and removed signals.
+ */
+void RouteCache::onStructureChanged(Structure& /*structure*/, Tile& tile)
+{
+	invalidate(tile);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Route.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+
+class MineFacility;
+class Structure;
+class Tile;
+
+
+/**
+ * Truck routes from mines to smelters, indexed by the tiles they pass over.
+ *
+ * Routes stay valid until something changes on one of their tiles. Changes
+ * reach invalidate() through the tile map's tileChanged() signal and
+ * StructureManager's structure signals, and it drops only the routes that
+ * pass over the changed tile. Because both ends of a route are tiles on its
+ * path, removing a mine or smelter also drops its routes.
+ */
+class RouteCache
+{
+public:
+	using RouteTable = std::map<MineFacility*, Route, std::less<>>;
+
+	void insert(MineFacility* mine, Route route);
+	void erase(MineFacility* mine);
+	void clear();
+
+	bool contains(const MineFacility* mine) const;
+	const Route& at(const MineFacility* mine) const;
+
+	const RouteTable& routes() const { return mRoutes; }
+
+	/** Count of changes to the set of routes, for anything drawn from them. */
+	std::uint64_t revision() const { return mRevision; }
+
+	void invalidate(const Tile& tile);
+
+	void onTileChanged(const Tile& tile);
+	void onStructureChanged(Structure& structure, Tile& tile);
+
+private:
+	RouteTable mRoutes;
+	std::map<const Tile*, std::vector<MineFacility*>> mRoutesByTile;
+	std::uint64_t mRevision{0};
+};
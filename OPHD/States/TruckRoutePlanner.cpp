@@ -0,0 +1,66 @@
+#include "TruckRoutePlanner.h"
+
+#include "../StructureManager.h"
+#include "../Map/TileMap.h"
+#include "../MapObjects/Structures/MineFacility.h"
+#include "../MapObjects/Structures/OreRefining.h"
+
+#include <NAS2D/Utility.h>
+
+#include <utility>
+
+
+TruckRoutePlanner::TruckRoutePlanner(TileMap& tileMap) :
+	mTileMap{tileMap},
+	mPathFinder{tileMap.size(), tileMap.movementCosts()}
+{
+}
+
+
+/**
+ * Gets the cheapest route from each mine to the nearest operational smelter.
+ *
+ * Mines that cannot reach any operational smelter are left out of the table.
+ */
+TruckRoutePlanner::RouteTable TruckRoutePlanner::findRoutes(const std::vector<MineFacility*>& mines, const std::vector<OreRefining*>& smelters)
+{
+	RouteTable routes;
+	if (mines.empty()) { return routes; }
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	std::vector<NAS2D::Point<int>> smelterPositions;
+	for (const auto* smelter : smelters)
+	{
+		if (!smelter->operational()) { continue; }
+		smelterPositions.push_back(structureManager.tileFromStructure(smelter).xy());
+	}
+
+	if (smelterPositions.empty()) { return routes; }
+
+	std::vector<NAS2D::Point<int>> minePositions;
+	for (const auto* mine : mines)
+	{
+		minePositions.push_back(structureManager.tileFromStructure(mine).xy());
+	}
+
+	// Movement costs change as structures are built and roads wear down
+	mPathFinder.movementCosts(mTileMap.movementCosts());
+	const auto paths = mPathFinder.findNearest(minePositions, smelterPositions);
+
+	for (std::size_t i = 0; i < mines.size(); ++i)
+	{
+		if (paths[i].empty()) { continue; }
+
+		Route route;
+		route.cost = paths[i].cost;
+		for (const auto point : paths[i].points)
+		{
+			route.path.push_back(&mTileMap.getTile({point, 0}));
+		}
+
+		routes[mines[i]] = std::move(route);
+	}
+
+	return routes;
+}
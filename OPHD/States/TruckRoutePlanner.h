@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Route.h"
+
+#include <libOPHD/Map/GridPathFinder.h>
+
+#include <map>
+#include <vector>
+
+
+class MineFacility;
+class OreRefining;
+class TileMap;
+
+
+/**
+ * Finds the cheapest truck route from each mine to any operational smelter.
+ *
+ * Instead of solving a path for every mine and smelter pair, a single search
+ * is expanded outward from all operational smelters at once (see
+ * GridPathFinder::findNearest()), so every mine is routed by the one search.
+ *
+ * A route's cost is the sum of the movement cost of every tile entered after
+ * leaving the mine.
+ */
+class TruckRoutePlanner
+{
+public:
+	using RouteTable = std::map<MineFacility*, Route>;
+
+	TruckRoutePlanner(TileMap& tileMap);
+
+	RouteTable findRoutes(const std::vector<MineFacility*>& mines, const std::vector<OreRefining*>& smelters);
+
+private:
+	TileMap& mTileMap;
+	GridPathFinder mPathFinder;
+};
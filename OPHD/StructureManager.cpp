@@ -2,16 +2,15 @@
 
 #include "Constants/Numbers.h"
 #include "ProductPool.h"
-#include "IOHelper.h"
+#include "SavegameRecords.h"
 #include "Map/Tile.h"
 #include "MapObjects/Robot.h"
 #include "GraphWalker.h"
 
-#include "States/MapViewStateHelper.h" // <-- For removeRefinedResources()
-
+#include <libOPHD/Profiler.h>
+#include <libOPHD/SlabArena.h>
 #include <libOPHD/Population/PopulationPool.h>
 
-#include <NAS2D/ParserHelper.h>
 #include <NAS2D/StringUtils.h>
 #include <NAS2D/ContainerUtils.h>
 
@@ -21,6 +20,26 @@
 
 namespace
 {
+	template <typename StructureType>
+	void addToTypedList(std::vector<StructureType*>& structures, Structure& structure)
+	{
+		if (StructureIdsOf<StructureType>[static_cast<std::size_t>(structure.structureId())])
+		{
+			structures.push_back(static_cast<StructureType*>(&structure));
+		}
+	}
+
+
+	template <typename StructureType>
+	void removeFromTypedList(std::vector<StructureType*>& structures, Structure& structure)
+	{
+		if (StructureIdsOf<StructureType>[static_cast<std::size_t>(structure.structureId())])
+		{
+			structures.erase(std::remove(structures.begin(), structures.end(), static_cast<StructureType*>(&structure)), structures.end());
+		}
+	}
+
+
 	auto populateKeys()
 	{
 		std::map<Structure::StructureClass, StructureList> result;
@@ -44,93 +63,63 @@ namespace
 	}
 
 
-	NAS2D::Xml::XmlElement* serializeStructure(Structure& structure, Tile& tile)
+	StructureRecord structureRecord(Structure& structure, const Tile& tile)
 	{
-		const auto& position = tile.xyz();
-		NAS2D::Dictionary dictionary =
-		{{
-			{"x", position.xy.x},
-			{"y", position.xy.y},
-			{"depth", position.z},
-		}};
-		dictionary += structure.getDataDict();
-
-		auto* structureElement = dictionaryToAttributes("structure", dictionary);
-
-		const auto& production = structure.production();
-		if (!production.isEmpty())
+		StructureRecord record;
+		record.position = tile.xyz();
+		record.type = static_cast<int>(structure.structureId());
+		record.age = structure.age();
+		record.state = static_cast<int>(structure.state());
+		record.forcedIdle = structure.forceIdle();
+		record.disabledReason = static_cast<int>(structure.disabledReason());
+		record.idleReason = static_cast<int>(structure.idleReason());
+		record.direction = static_cast<int>(structure.connectorDirection());
+		record.integrity = structure.integrity();
+		record.workersAvailable = structure.populationAvailable().workers;
+		record.scientistsAvailable = structure.populationAvailable().scientists;
+		record.production = structure.production();
+		record.storage = structure.storage();
+
+		if (structure.hasCrime())
 		{
-			structureElement->linkEndChild(writeResources(production, "production"));
+			record.crimeRate = structure.crimeRate();
 		}
 
-		const auto& stored = structure.storage();
-		if (!stored.isEmpty())
+		if (structure.isFactory())
 		{
-			structureElement->linkEndChild(writeResources(stored, "storage"));
+			const auto& factory = static_cast<Factory&>(structure);
+			record.factoryProduction = StructureRecord::FactoryProduction{factory.productionTurnsCompleted(), static_cast<int>(factory.productType())};
 		}
 
 		if (structure.isWarehouse())
 		{
-			structureElement->linkEndChild(NAS2D::dictionaryToAttributes(
-				"warehouse_products",
-				static_cast<Warehouse&>(structure).products().serialize()
-			));
+			record.warehouseProducts = static_cast<Warehouse&>(structure).products().counts();
 		}
 
 		if (structure.isFoodStore())
 		{
-			structureElement->linkEndChild(
-				NAS2D::dictionaryToAttributes(
-					"food",
-					{{{"level", static_cast<FoodProduction&>(structure).foodLevel()}}}
-				)
-			);
+			record.foodLevel = static_cast<FoodProduction&>(structure).foodLevel();
 		}
 
 		if (structure.structureClass() == Structure::StructureClass::Residence)
 		{
-			Residence& residence = static_cast<Residence&>(structure);
-			structureElement->linkEndChild(
-				NAS2D::dictionaryToAttributes(
-					"waste",
-					{{
-						{"accumulated", residence.wasteAccumulated()},
-						{"overflow", residence.wasteOverflow()},
-					}}
-				)
-			);
+			const auto& residence = static_cast<Residence&>(structure);
+			record.waste = StructureRecord::Waste{residence.wasteAccumulated(), residence.wasteOverflow()};
 		}
 
 		if (structure.isMineFacility())
 		{
-			MineFacility& facility = static_cast<MineFacility&>(structure);
-
-			structureElement->linkEndChild(
-				NAS2D::dictionaryToAttributes(
-					"trucks",
-					{{{"assigned", facility.assignedTrucks()}}}
-				)
-			);
-			structureElement->linkEndChild(
-				NAS2D::dictionaryToAttributes(
-					"extension",
-					{{{"turns_remaining", facility.digTimeRemaining()}}}
-				)
-			);
+			const auto& facility = static_cast<MineFacility&>(structure);
+			record.assignedTrucks = facility.assignedTrucks();
+			record.digTurnsRemaining = facility.digTimeRemaining();
 		}
 
 		if (structure.structureClass() == Structure::StructureClass::Maintenance)
 		{
-			auto& maintenance = static_cast<MaintenanceFacility&>(structure);
-			structureElement->linkEndChild(
-				NAS2D::dictionaryToAttributes(
-					"personnel",
-					{{{"assigned", maintenance.personnel()}}}
-				)
-			);
+			record.maintenancePersonnel = static_cast<MaintenanceFacility&>(structure).personnel();
 		}
 
-		return structureElement;
+		return record;
 	}
 }
 
@@ -160,7 +149,16 @@ void StructureManager::addStructure(Structure& structure, Tile& tile)
 	mStructureTileTable[&structure] = &tile;
 
 	mStructureLists[structure.structureClass()].push_back(&structure);
+	std::apply([&structure](auto&... typedLists) { (addToTypedList(typedLists, structure), ...); }, mTypedStructureLists);
 	tile.pushMapObject(&structure);
+
+	countStructure(structure, structure.state(), 1);
+	if (ResourceLedger::isContainer(structure)) { mResourceLedger.addContainer(structure); }
+	if (structure.isWarehouse()) { mProductInventory.addWarehouse(static_cast<Warehouse&>(structure)); }
+	structure.stateChanged().connect({this, &StructureManager::onStructureStateChanged});
+
+	mPendingConnections.push_back(&structure);
+	mStructureAddedSignal(structure, tile);
 }
 
 
@@ -172,6 +170,10 @@ void StructureManager::addStructure(Structure& structure, Tile& tile)
  */
 void StructureManager::removeStructure(Structure& structure)
 {
+	// Removing a structure that wasn't connected can't disconnect anything else
+	if (structure.connected()) { mConnectednessDirty = true; }
+	mPendingConnections.erase(std::remove(mPendingConnections.begin(), mPendingConnections.end(), &structure), mPendingConnections.end());
+
 	StructureList& structures = mStructureLists[structure.structureClass()];
 
 	const auto it = std::find(structures.begin(), structures.end(), &structure);
@@ -179,12 +181,19 @@ void StructureManager::removeStructure(Structure& structure)
 	if (isFoundStructureTable)
 	{
 		structures.erase(it);
+		std::apply([&structure](auto&... typedLists) { (removeFromTypedList(typedLists, structure), ...); }, mTypedStructureLists);
+
+		structure.stateChanged().disconnect({this, &StructureManager::onStructureStateChanged});
+		countStructure(structure, structure.state(), -1);
+		if (ResourceLedger::isContainer(structure)) { mResourceLedger.removeContainer(structure); }
+		if (structure.isWarehouse()) { mProductInventory.removeWarehouse(static_cast<Warehouse&>(structure)); }
 	}
 
 	const auto tileTableIt = mStructureTileTable.find(&structure);
 	const auto isFoundTileTable = tileTableIt != mStructureTileTable.end();
 	if (isFoundTileTable)
 	{
+		mStructureRemovedSignal(structure, *tileTableIt->second);
 		tileTableIt->second->deleteMapObject();
 		mStructureTileTable.erase(tileTableIt);
 	}
@@ -216,16 +225,21 @@ StructureList StructureManager::allStructures() const
 }
 
 
+/**
+ * Gets the Tile a managed Structure occupies.
+ *
+ * \note	Constant time lookup. Safe to call from per-turn and per-frame code.
+ *
+ * \throws	Throws \c std::runtime_error if the Structure is not managed.
+ */
 Tile& StructureManager::tileFromStructure(const Structure* structure) const
 {
-	for (const auto& [keyStructure, valueTile] : mStructureTileTable)
+	const auto it = mStructureTileTable.find(structure);
+	if (it == mStructureTileTable.end())
 	{
-		if (keyStructure == structure)
-		{
-			return *valueTile;
-		}
+		throw std::runtime_error("Could not find tile for structure");
 	}
-	throw std::runtime_error("Could not find tile for structure");
+	return *it->second;
 }
 
 
@@ -243,10 +257,47 @@ std::vector<MapCoordinate> StructureManager::operationalCommandCenterPositions()
 }
 
 
+/**
+ * Brings the 'connected' flag of all structures up to date.
+ *
+ * Structures added since the last update are connected by walking outward
+ * from them only. A full walk from every operational command center is done
+ * only when a connected structure was removed or the set of operational
+ * command centers changed.
+ *
+ * Emits connectivityChanged() if any structure's 'connected' flag changed.
+ */
 void StructureManager::updateConnectedness(TileMap& tileMap)
 {
-	disconnectAll();
-	walkGraph(operationalCommandCenterPositions(), tileMap);
+	const auto commandCenters = operationalCommandCenters();
+	if (commandCenters != mConnectedCommandCenters) { mConnectednessDirty = true; }
+
+	bool changed = false;
+	if (mConnectednessDirty)
+	{
+		const auto previouslyConnected = connectedFlags();
+
+		disconnectAll();
+		walkGraph(operationalCommandCenterPositions(), tileMap);
+
+		changed = previouslyConnected != connectedFlags();
+		mConnectedCommandCenters = commandCenters;
+		mConnectednessDirty = false;
+	}
+	else if (!mPendingConnections.empty())
+	{
+		std::vector<MapCoordinate> positions;
+		for (const auto* structure : mPendingConnections)
+		{
+			positions.push_back(tileFromStructure(structure).xyz());
+		}
+
+		changed = extendGraph(positions, tileMap) > 0;
+	}
+
+	mPendingConnections.clear();
+
+	if (changed) { mConnectivityChangedSignal(); }
 }
 
 
@@ -265,14 +316,48 @@ std::vector<Tile*> StructureManager::getConnectednessOverlay() const
 }
 
 
+/**
+ * Gets the 'connected' flag of every structure, in structure table order.
+ *
+ * \note	Only comparable between calls with no structures added or removed.
+ */
+std::vector<bool> StructureManager::connectedFlags() const
+{
+	std::vector<bool> flags;
+	flags.reserve(mStructureTileTable.size());
+	for (const auto& [structure, tile] : mStructureTileTable)
+	{
+		flags.push_back(structure->connected());
+	}
+	return flags;
+}
+
+
+StructureList StructureManager::operationalCommandCenters() const
+{
+	StructureList commandCenters;
+	for (auto* commandCenter : structureList(Structure::StructureClass::Command))
+	{
+		if (commandCenter->operational())
+		{
+			commandCenters.push_back(commandCenter);
+		}
+	}
+	return commandCenters;
+}
+
+
 /**
  * Resets the 'connected' flag on all structures in the primary structure list.
  */
 void StructureManager::disconnectAll()
 {
-	for (auto& pair : mStructureTileTable)
+	for (auto& classListPair : mStructureLists)
 	{
-		pair.first->connected(false);
+		for (auto* structure : classListPair.second)
+		{
+			structure->connected(false);
+		}
 	}
 }
 
@@ -284,8 +369,25 @@ void StructureManager::dropAllStructures()
 		pair.second->deleteMapObject();
 	}
 
+	// Release the structure slabs in one go rather than keeping them for
+	// reuse, unless a structure is still alive outside of the manager
+	Structure::arena().reset();
+
 	mStructureTileTable.clear();
 	mStructureLists = populateKeys();
+	mTypedStructureLists = {};
+
+	mClassStateCounts = {};
+	mIdStateCounts = {};
+	mStateCounts = {};
+	mOperationalEnergyRequired = 0;
+	++mRevision;
+	mResourceLedger.clear();
+	mProductInventory.clear();
+
+	mPendingConnections.clear();
+	mConnectedCommandCenters.clear();
+	mConnectednessDirty = true;
 }
 
 
@@ -294,27 +396,13 @@ void StructureManager::dropAllStructures()
  */
 int StructureManager::count() const
 {
-	int count = 0;
-	for (auto& pair : mStructureLists)
-	{
-		count += static_cast<int>(pair.second.size());
-	}
-
-	return count;
+	return static_cast<int>(mStructureTileTable.size());
 }
 
 
 int StructureManager::getCountInState(Structure::StructureClass structureClass, StructureState state) const
 {
-	int count = 0;
-	for (const auto* structure : structureList(structureClass))
-	{
-		if (structure->state() == state)
-		{
-			++count;
-		}
-	}
-	return count;
+	return mClassStateCounts[static_cast<std::size_t>(structureClass)][static_cast<std::size_t>(state)];
 }
 
 
@@ -323,13 +411,7 @@ int StructureManager::getCountInState(Structure::StructureClass structureClass,
  */
 int StructureManager::disabled() const
 {
-	int count = 0;
-	for (auto& pair : mStructureLists)
-	{
-		count += getCountInState(pair.first, StructureState::Disabled);
-	}
-
-	return count;
+	return mStateCounts[static_cast<std::size_t>(StructureState::Disabled)];
 }
 
 
@@ -338,24 +420,13 @@ int StructureManager::disabled() const
  */
 int StructureManager::destroyed() const
 {
-	int count = 0;
-	for (auto& pair : mStructureLists)
-	{
-		count += getCountInState(pair.first, StructureState::Destroyed);
-	}
-
-	return count;
+	return mStateCounts[static_cast<std::size_t>(StructureState::Destroyed)];
 }
 
 
 bool StructureManager::CHAPAvailable() const
 {
-	for (const auto* chap : structureList(Structure::StructureClass::LifeSupport))
-	{
-		if (chap->operational()) { return true; }
-	}
-
-	return false;
+	return getCountInState(Structure::StructureClass::LifeSupport, StructureState::Operational) > 0;
 }
 
 
@@ -381,18 +452,7 @@ void StructureManager::updateEnergyProduction()
  */
 void StructureManager::updateEnergyConsumed()
 {
-	mTotalEnergyUsed = 0;
-
-	for (auto& classListPair : mStructureLists)
-	{
-		for (const auto* structure : classListPair.second)
-		{
-			if (structure->operational())
-			{
-				mTotalEnergyUsed += structure->energyRequirement();
-			}
-		}
-	}
+	mTotalEnergyUsed = mOperationalEnergyRequired;
 }
 
 
@@ -428,7 +488,7 @@ void StructureManager::assignScientistsToResearchFacilities(PopulationPool& popu
 }
 
 
-void StructureManager::update(const StorableResources& resources, PopulationPool& population)
+void StructureManager::update(PopulationPool& population)
 {
 	mAgingStructures.clear();
 	mNewlyBuiltStructures.clear();
@@ -437,41 +497,61 @@ void StructureManager::update(const StorableResources& resources, PopulationPool
 	// Called separately so that 1) high priority structures can be updated first and
 	// 2) so that resource handling code (like energy) can be handled between update
 	// calls to lower priority structures.
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Lander]); // No resource needs
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Command]); // Self sufficient
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::EnergyProduction]); // Nothing can work without energy
+	{
+		OPHD_PROFILE_SCOPE("Energy");
+		updateStructures(population, mStructureLists[Structure::StructureClass::Lander]); // No resource needs
+		updateStructures(population, mStructureLists[Structure::StructureClass::Command]); // Self sufficient
+		updateStructures(population, mStructureLists[Structure::StructureClass::EnergyProduction]); // Nothing can work without energy
 
-	updateEnergyProduction();
+		updateEnergyProduction();
+	}
 
 	// Basic resource production
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Mine]); // Can't operate without resources.
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Smelter]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::LifeSupport]); // Air, water food must come before others
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::FoodProduction]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::MedicalCenter]); // No medical facilities, people die
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Nursery]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Factory]); // Production
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Maintenance]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Storage]); // Everything else.
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Park]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::SurfacePolice]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::UndergroundPolice]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::RecreationCenter]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Recycling]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Residence]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::RobotCommand]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Warehouse]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Laboratory]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Commercial]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::University]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Communication]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Road]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Undefined]);
+	{
+		OPHD_PROFILE_SCOPE("Resource Production");
+		updateStructures(population, mStructureLists[Structure::StructureClass::Mine]); // Can't operate without resources.
+		updateStructures(population, mStructureLists[Structure::StructureClass::Smelter]);
+	}
+
+	{
+		OPHD_PROFILE_SCOPE("Life Support");
+		updateStructures(population, mStructureLists[Structure::StructureClass::LifeSupport]); // Air, water food must come before others
+		updateStructures(population, mStructureLists[Structure::StructureClass::FoodProduction]);
+
+		updateStructures(population, mStructureLists[Structure::StructureClass::MedicalCenter]); // No medical facilities, people die
+		updateStructures(population, mStructureLists[Structure::StructureClass::Nursery]);
+	}
+
+	{
+		OPHD_PROFILE_SCOPE("Production");
+		updateStructures(population, mStructureLists[Structure::StructureClass::Factory]); // Production
+		updateStructures(population, mStructureLists[Structure::StructureClass::Maintenance]);
+	}
+
+	{
+		OPHD_PROFILE_SCOPE("Other Structures");
+		updateStructures(population, mStructureLists[Structure::StructureClass::Storage]); // Everything else.
+		updateStructures(population, mStructureLists[Structure::StructureClass::Park]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::SurfacePolice]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::UndergroundPolice]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::RecreationCenter]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Recycling]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Residence]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::RobotCommand]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Warehouse]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Laboratory]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Commercial]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::University]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Communication]);
+		updateStructures(population, mStructureLists[Structure::StructureClass::Road]);
+
+		updateStructures(population, mStructureLists[Structure::StructureClass::Undefined]);
+	}
+
+	// Resources committed by operating structures are removed in one pass
+	mResourceLedger.settle();
+
+	OPHD_PROFILE_SCOPE("Population Assignment");
 
 	assignColonistsToResidences(population);
 
@@ -484,26 +564,62 @@ void StructureManager::update(const StorableResources& resources, PopulationPool
 }
 
 
-NAS2D::Xml::XmlElement* StructureManager::serialize() const
+std::vector<StructureRecord> StructureManager::structureRecords() const
 {
-	auto* structures = new NAS2D::Xml::XmlElement("structures");
+	std::vector<StructureRecord> records;
+	records.reserve(static_cast<std::size_t>(count()));
 
-	for (auto& [structure, tile] : mStructureTileTable)
+	for (auto& classListPair : mStructureLists)
 	{
-		structures->linkEndChild(serializeStructure(*structure, *tile));
+		for (auto* structure : classListPair.second)
+		{
+			records.push_back(structureRecord(*structure, tileFromStructure(structure)));
+		}
 	}
 
-	return structures;
+	return records;
+}
+
+
+void StructureManager::onStructureStateChanged(Structure& structure, StructureState oldState)
+{
+	countStructure(structure, oldState, -1);
+	countStructure(structure, structure.state(), 1);
+
+	if (structure.isWarehouse()) { mProductInventory.updateWarehouse(static_cast<Warehouse&>(structure)); }
 }
 
 
-void StructureManager::updateStructures(const StorableResources& resources, PopulationPool& population, StructureList& structures)
+/**
+ * Adds delta to the counters a structure in a given state contributes to.
+ */
+void StructureManager::countStructure(const Structure& structure, StructureState state, int delta)
 {
+	const auto stateIndex = static_cast<std::size_t>(state);
+	mClassStateCounts[static_cast<std::size_t>(structure.structureClass())][stateIndex] += delta;
+	mIdStateCounts[static_cast<std::size_t>(structure.structureId())][stateIndex] += delta;
+	mStateCounts[stateIndex] += delta;
+	++mRevision;
+
+	if (state == StructureState::Operational)
+	{
+		mOperationalEnergyRequired += delta * structure.energyRequirement();
+	}
+}
+
+
+void StructureManager::updateStructures(PopulationPool& population, StructureList& structures)
+{
+	OPHD_PROFILE_COUNT("Structures Updated", structures.size());
+
 	Structure* structure = nullptr;
 	for (std::size_t i = 0; i < structures.size(); ++i)
 	{
 		structure = structures[i];
+
+		const auto integrity = structure->integrity();
 		structure->update();
+		if (structure->integrity() != integrity) { mIntegrityChangedSignal(*structure); }
 
 		if (structure->ages() && (structure->age() >= structure->maxAge() - 10))
 		{
@@ -567,7 +683,7 @@ void StructureManager::updateStructures(const StorableResources& resources, Popu
 		}
 
 		// Check that enough resources are available for input.
-		if (!structure->isIdle() && !(resources >= structure->resourcesIn()))
+		if (!structure->isIdle() && !mResourceLedger.canAfford(structure->resourcesIn()))
 		{
 			structure->disable(DisabledReason::RefinedResources);
 			continue;
@@ -579,8 +695,7 @@ void StructureManager::updateStructures(const StorableResources& resources, Popu
 		{
 			population.usePopulation(populationRequired);
 
-			auto consumed = structure->resourcesIn();
-			removeRefinedResources(consumed);
+			mResourceLedger.charge(structure->resourcesIn());
 
 			mTotalEnergyUsed += structure->energyRequirement();
 
@@ -1,108 +1,63 @@
 #pragma once
 
-#include "MapObjects/Structure.h"
-#include "MapObjects/Structures.h"
+#include "ProductInventory.h"
+#include "ResourceLedger.h"
+#include "StructureTraits.h"
 
+#include <NAS2D/Signal/Signal.h>
+
+#include <array>
+#include <cstdint>
 #include <map>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 
-namespace NAS2D
-{
-	namespace Xml
-	{
-		class XmlElement;
-	}
-}
-
 class Tile;
 class TileMap;
 class PopulationPool;
 struct StorableResources;
 struct MapCoordinate;
-
-
-template <typename T> constexpr bool dependent_false = false;
-
-template <typename StructureType>
-constexpr Structure::StructureClass structureTypeToClass() {
-	if constexpr (std::is_same_v<StructureType, Agridome>) { return Structure::StructureClass::FoodProduction; }
-	else if constexpr (std::is_same_v<StructureType, AirShaft>) { return Structure::StructureClass::Tube; }
-	else if constexpr (std::is_same_v<StructureType, CargoLander>) { return Structure::StructureClass::Lander; }
-	else if constexpr (std::is_same_v<StructureType, CHAP>) { return Structure::StructureClass::LifeSupport; }
-	else if constexpr (std::is_same_v<StructureType, ColonistLander>) { return Structure::StructureClass::Lander; }
-	else if constexpr (std::is_same_v<StructureType, CommandCenter>) { return Structure::StructureClass::Command; }
-	else if constexpr (std::is_same_v<StructureType, Commercial>) { return Structure::StructureClass::Commercial; }
-	else if constexpr (std::is_same_v<StructureType, CommTower>) { return Structure::StructureClass::Communication; }
-	else if constexpr (std::is_same_v<StructureType, Factory>) { return Structure::StructureClass::Factory; }
-	else if constexpr (std::is_same_v<StructureType, FoodProduction>) { return Structure::StructureClass::FoodProduction; }
-	else if constexpr (std::is_same_v<StructureType, FusionReactor>) { return Structure::StructureClass::EnergyProduction; }
-	else if constexpr (std::is_same_v<StructureType, HotLaboratory>) { return Structure::StructureClass::Laboratory; }
-	else if constexpr (std::is_same_v<StructureType, Laboratory>) { return Structure::StructureClass::Laboratory; }
-	else if constexpr (std::is_same_v<StructureType, MaintenanceFacility>) { return Structure::StructureClass::Maintenance; }
-	else if constexpr (std::is_same_v<StructureType, MedicalCenter>) { return Structure::StructureClass::MedicalCenter; }
-	else if constexpr (std::is_same_v<StructureType, MineFacility>) { return Structure::StructureClass::Mine; }
-	else if constexpr (std::is_same_v<StructureType, MineShaft>) { return Structure::StructureClass::Undefined; }
-	else if constexpr (std::is_same_v<StructureType, Nursery>) { return Structure::StructureClass::Nursery; }
-	else if constexpr (std::is_same_v<StructureType, OreRefining>) { return Structure::StructureClass::Smelter; }
-	else if constexpr (std::is_same_v<StructureType, Park>) { return Structure::StructureClass::Park; }
-	else if constexpr (std::is_same_v<StructureType, PowerStructure>) { return Structure::StructureClass::EnergyProduction; }
-	else if constexpr (std::is_same_v<StructureType, RecreationCenter>) { return Structure::StructureClass::RecreationCenter; }
-	else if constexpr (std::is_same_v<StructureType, Recycling>) { return Structure::StructureClass::Recycling; }
-	else if constexpr (std::is_same_v<StructureType, RedLightDistrict>) { return Structure::StructureClass::Residence; }
-	else if constexpr (std::is_same_v<StructureType, ResearchFacility>) { return Structure::StructureClass::Laboratory; }
-	else if constexpr (std::is_same_v<StructureType, Residence>) { return Structure::StructureClass::Residence; }
-	else if constexpr (std::is_same_v<StructureType, Road>) { return Structure::StructureClass::Road; }
-	else if constexpr (std::is_same_v<StructureType, RobotCommand>) { return Structure::StructureClass::RobotCommand; }
-	else if constexpr (std::is_same_v<StructureType, SeedFactory>) { return Structure::StructureClass::Factory; }
-	else if constexpr (std::is_same_v<StructureType, SeedLander>) { return Structure::StructureClass::Lander; }
-	else if constexpr (std::is_same_v<StructureType, SeedPower>) { return Structure::StructureClass::EnergyProduction; }
-	else if constexpr (std::is_same_v<StructureType, SeedSmelter>) { return Structure::StructureClass::Smelter; }
-	else if constexpr (std::is_same_v<StructureType, Smelter>) { return Structure::StructureClass::Smelter; }
-	else if constexpr (std::is_same_v<StructureType, SolarPanelArray>) { return Structure::StructureClass::EnergyProduction; }
-	else if constexpr (std::is_same_v<StructureType, SolarPlant>) { return Structure::StructureClass::EnergyProduction; }
-	else if constexpr (std::is_same_v<StructureType, StorageTanks>) { return Structure::StructureClass::Storage; }
-	else if constexpr (std::is_same_v<StructureType, SurfaceFactory>) { return Structure::StructureClass::Factory; }
-	else if constexpr (std::is_same_v<StructureType, SurfacePolice>) { return Structure::StructureClass::SurfacePolice; }
-	else if constexpr (std::is_same_v<StructureType, Tube>) { return Structure::StructureClass::Tube; }
-	else if constexpr (std::is_same_v<StructureType, UndergroundFactory>) { return Structure::StructureClass::Factory; }
-	else if constexpr (std::is_same_v<StructureType, UndergroundPolice>) { return Structure::StructureClass::UndergroundPolice; }
-	else if constexpr (std::is_same_v<StructureType, University>) { return Structure::StructureClass::University; }
-	else if constexpr (std::is_same_v<StructureType, Warehouse>) { return Structure::StructureClass::Warehouse; }
-	else { static_assert(dependent_false<StructureType>, "Unknown type"); }
-}
+struct StructureRecord;
 
 
 /**
  * Handles structure updating and resource management for structures.
  *
- * Keeps track of which structures are operational, idle and disabled.
+ * Keeps track of which structures are operational, idle and disabled. Counts
+ * of structures in each state are kept up to date as structures change state
+ * so state queries don't need to scan the structure lists.
+ *
+ * \note	Not thread safe. While a turn runs on its worker thread, the worker
+ *			owns the StructureManager and the UI thread must not use it, see
+ *			MapViewState::runSimulationTurn().
  */
 class StructureManager
 {
+public:
+	using ConnectivityChangedSignal = NAS2D::Signal<>;
+	using StructureTileSignal = NAS2D::Signal<Structure&, Tile&>;
+	using StructureSignal = NAS2D::Signal<Structure&>;
+
 public:
 	StructureManager();
 
 	void addStructure(Structure& structure, Tile& tile);
 	void removeStructure(Structure& structure);
 
+	/**
+	 * Gets every structure of StructureType, or of a type derived from it,
+	 * that is kept in StructureType's StructureClass list.
+	 *
+	 * The list is maintained as structures are added and removed; it is not
+	 * a copy and is invalidated when structures of the same type are added
+	 * or removed.
+	 */
 	template <typename StructureType>
-	const std::vector<StructureType*> getStructures() const
+	const std::vector<StructureType*>& getStructures() const
 	{
-		// Get list of structures with same function
-		const auto& sameClassStructures = structureList(structureTypeToClass<StructureType>());
-
-		std::vector<StructureType*> output;
-		// Filter for instances of the exact type parameter
-		for (auto* structure : sameClassStructures)
-		{
-			StructureType* derivedStructure = dynamic_cast<StructureType*>(structure);
-			if (derivedStructure)
-			{
-				output.push_back(derivedStructure);
-			}
-		}
-		return output;
+		return std::get<std::vector<StructureType*>>(mTypedStructureLists);
 	}
 
 	const StructureList& structureList(Structure::StructureClass structureClass) const;
@@ -115,21 +70,33 @@ public:
 	void updateConnectedness(TileMap& tileMap);
 	std::vector<Tile*> getConnectednessOverlay() const;
 
+	ConnectivityChangedSignal::Source& connectivityChanged() { return mConnectivityChangedSignal; }
+	StructureTileSignal::Source& structureAdded() { return mStructureAddedSignal; }
+	StructureTileSignal::Source& structureRemoved() { return mStructureRemovedSignal; }
+	StructureSignal::Source& integrityChanged() { return mIntegrityChangedSignal; }
+
 	void dropAllStructures();
 
 	int count() const;
 
+	/** Count of structures added, removed or changing state, for anything drawn from them. */
+	std::uint64_t revision() const { return mRevision; }
+
 	int getCountInState(Structure::StructureClass structureClass, StructureState state) const;
 
+	/**
+	 * Gets the number of structures of StructureType, or of a type derived
+	 * from it, that are in a given state.
+	 */
 	template <typename StructureType>
 	unsigned int countInState(StructureState state) const
 	{
 		unsigned int count = 0;
-		for (const auto* structure : getStructures<StructureType>())
+		for (std::size_t id = 0; id < StructureIdsOf<StructureType>.size(); ++id)
 		{
-			if (structure->state() == state)
+			if (StructureIdsOf<StructureType>[id])
 			{
-				++count;
+				count += static_cast<unsigned int>(mIdStateCounts[id][static_cast<std::size_t>(state)]);
 			}
 		}
 		return count;
@@ -150,28 +117,65 @@ public:
 	int totalEnergyUsed() const { return mTotalEnergyUsed; }
 	int totalEnergyAvailable() const { return mTotalEnergyOutput - mTotalEnergyUsed; }
 
+	ResourceLedger& resourceLedger() { return mResourceLedger; }
+	const ResourceLedger& resourceLedger() const { return mResourceLedger; }
+
+	ProductInventory& productInventory() { return mProductInventory; }
+	const ProductInventory& productInventory() const { return mProductInventory; }
+
 	void assignColonistsToResidences(PopulationPool&);
 	void assignScientistsToResearchFacilities(PopulationPool&);
 
-	void update(const StorableResources&, PopulationPool&);
+	void update(PopulationPool&);
 
-	NAS2D::Xml::XmlElement* serialize() const;
+	std::vector<StructureRecord> structureRecords() const;
 
 private:
-	using StructureTileTable = std::map<Structure*, Tile*>;
+	using StructureTileTable = std::unordered_map<const Structure*, Tile*>;
 	using StructureClassTable = std::map<Structure::StructureClass, StructureList>;
 
+	template <typename Types> struct TypedStructureListsOf;
+	template <typename... Types> struct TypedStructureListsOf<StructureTypeList<Types...>> { using type = std::tuple<std::vector<Types*>...>; };
+	using TypedStructureLists = TypedStructureListsOf<StructureTypes>::type;
+
+	static constexpr std::size_t StructureClassCount = static_cast<std::size_t>(Structure::StructureClass::Warehouse) + 1;
+	static constexpr std::size_t StructureStateCount = static_cast<std::size_t>(StructureState::Destroyed) + 1;
+	using StateCounts = std::array<int, StructureStateCount>;
+
+	void onStructureStateChanged(Structure& structure, StructureState oldState);
+	void countStructure(const Structure& structure, StructureState state, int delta);
+
 	void disconnectAll();
+	std::vector<bool> connectedFlags() const;
+	StructureList operationalCommandCenters() const;
 
-	void updateStructures(const StorableResources&, PopulationPool&, StructureList&);
+	void updateStructures(PopulationPool&, StructureList&);
 
-	StructureTileTable mStructureTileTable; /**< List mapping Structures to a particular tile. */
+	StructureTileTable mStructureTileTable; /**< Hashed index mapping Structures to the Tile they occupy. */
 	StructureClassTable mStructureLists; /**< Map containing all of the structure list types available. */
+	TypedStructureLists mTypedStructureLists; /**< One list per StructureTraits type, in the same order as mStructureLists. */
+
+	std::array<StateCounts, StructureClassCount> mClassStateCounts{}; /**< Number of structures in each state, per StructureClass. */
+	std::array<StateCounts, StructureID::SID_COUNT> mIdStateCounts{}; /**< Number of structures in each state, per StructureID. */
+	StateCounts mStateCounts{}; /**< Number of structures in each state. */
+	int mOperationalEnergyRequired = 0; /**< Sum of the energy requirement of every operational structure. */
+	std::uint64_t mRevision = 0;
 
 	StructureList mAgingStructures;
 	StructureList mNewlyBuiltStructures;
 	StructureList mStructuresWithCrime;
 
+	StructureList mPendingConnections; /**< Structures added since connectedness was last updated. */
+	StructureList mConnectedCommandCenters; /**< Operational command centers as of the last full connectedness walk. */
+	bool mConnectednessDirty = true; /**< Set when a connected structure was removed; requires a full walk. */
+	ConnectivityChangedSignal mConnectivityChangedSignal;
+	StructureTileSignal mStructureAddedSignal;
+	StructureTileSignal mStructureRemovedSignal; /**< Emitted before the structure is freed. */
+	StructureSignal mIntegrityChangedSignal; /**< Emitted when a structure's integrity decays during update(). */
+
+	ResourceLedger mResourceLedger; /**< Refined resources held by Command Centers and Storage Tanks. */
+	ProductInventory mProductInventory; /**< Products held by Warehouses. */
+
 	int mTotalEnergyOutput = 0; /**< Total energy output of all energy producers in the structure list. */
 	int mTotalEnergyUsed = 0;
 };
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "MapObjects/Structure.h"
+#include "MapObjects/Structures.h"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+
+template <typename T> constexpr bool dependent_false = false;
+
+
+template <Structure::StructureClass Class, StructureID Id = StructureID::SID_NONE>
+struct StructureTraitsEntry
+{
+	static constexpr Structure::StructureClass structureClass = Class;
+	static constexpr StructureID structureId = Id;
+};
+
+
+/**
+ * Compile time table of the StructureClass list each Structure type is kept
+ * in and, for types that are instantiated directly, the StructureID its
+ * instances are created with.
+ *
+ * \note	Each instantiable type's entry must match the class and ID it
+ *			passes to the Structure constructor.
+ */
+template <typename StructureType>
+struct StructureTraits
+{
+	static_assert(dependent_false<StructureType>, "Unknown type");
+};
+
+template <> struct StructureTraits<Agridome> : StructureTraitsEntry<Structure::StructureClass::FoodProduction, StructureID::SID_AGRIDOME> {};
+template <> struct StructureTraits<AirShaft> : StructureTraitsEntry<Structure::StructureClass::Tube, StructureID::SID_AIR_SHAFT> {};
+template <> struct StructureTraits<CargoLander> : StructureTraitsEntry<Structure::StructureClass::Lander, StructureID::SID_CARGO_LANDER> {};
+template <> struct StructureTraits<CHAP> : StructureTraitsEntry<Structure::StructureClass::LifeSupport, StructureID::SID_CHAP> {};
+template <> struct StructureTraits<ColonistLander> : StructureTraitsEntry<Structure::StructureClass::Lander, StructureID::SID_COLONIST_LANDER> {};
+template <> struct StructureTraits<CommandCenter> : StructureTraitsEntry<Structure::StructureClass::Command, StructureID::SID_COMMAND_CENTER> {};
+template <> struct StructureTraits<Commercial> : StructureTraitsEntry<Structure::StructureClass::Commercial, StructureID::SID_COMMERCIAL> {};
+template <> struct StructureTraits<CommTower> : StructureTraitsEntry<Structure::StructureClass::Communication, StructureID::SID_COMM_TOWER> {};
+template <> struct StructureTraits<FusionReactor> : StructureTraitsEntry<Structure::StructureClass::EnergyProduction, StructureID::SID_FUSION_REACTOR> {};
+template <> struct StructureTraits<HotLaboratory> : StructureTraitsEntry<Structure::StructureClass::Laboratory, StructureID::SID_HOT_LABORATORY> {};
+template <> struct StructureTraits<Laboratory> : StructureTraitsEntry<Structure::StructureClass::Laboratory, StructureID::SID_LABORATORY> {};
+template <> struct StructureTraits<MaintenanceFacility> : StructureTraitsEntry<Structure::StructureClass::Maintenance, StructureID::SID_MAINTENANCE_FACILITY> {};
+template <> struct StructureTraits<MedicalCenter> : StructureTraitsEntry<Structure::StructureClass::MedicalCenter, StructureID::SID_MEDICAL_CENTER> {};
+template <> struct StructureTraits<MineFacility> : StructureTraitsEntry<Structure::StructureClass::Mine, StructureID::SID_MINE_FACILITY> {};
+template <> struct StructureTraits<MineShaft> : StructureTraitsEntry<Structure::StructureClass::Undefined, StructureID::SID_MINE_SHAFT> {};
+template <> struct StructureTraits<Nursery> : StructureTraitsEntry<Structure::StructureClass::Nursery, StructureID::SID_NURSERY> {};
+template <> struct StructureTraits<Park> : StructureTraitsEntry<Structure::StructureClass::Park, StructureID::SID_PARK> {};
+template <> struct StructureTraits<RecreationCenter> : StructureTraitsEntry<Structure::StructureClass::RecreationCenter, StructureID::SID_RECREATION_CENTER> {};
+template <> struct StructureTraits<Recycling> : StructureTraitsEntry<Structure::StructureClass::Recycling, StructureID::SID_RECYCLING> {};
+template <> struct StructureTraits<RedLightDistrict> : StructureTraitsEntry<Structure::StructureClass::Residence, StructureID::SID_RED_LIGHT_DISTRICT> {};
+template <> struct StructureTraits<Residence> : StructureTraitsEntry<Structure::StructureClass::Residence, StructureID::SID_RESIDENCE> {};
+template <> struct StructureTraits<Road> : StructureTraitsEntry<Structure::StructureClass::Road, StructureID::SID_ROAD> {};
+template <> struct StructureTraits<RobotCommand> : StructureTraitsEntry<Structure::StructureClass::RobotCommand, StructureID::SID_ROBOT_COMMAND> {};
+template <> struct StructureTraits<SeedFactory> : StructureTraitsEntry<Structure::StructureClass::Factory, StructureID::SID_SEED_FACTORY> {};
+template <> struct StructureTraits<SeedLander> : StructureTraitsEntry<Structure::StructureClass::Lander, StructureID::SID_SEED_LANDER> {};
+template <> struct StructureTraits<SeedPower> : StructureTraitsEntry<Structure::StructureClass::EnergyProduction, StructureID::SID_SEED_POWER> {};
+template <> struct StructureTraits<SeedSmelter> : StructureTraitsEntry<Structure::StructureClass::Smelter, StructureID::SID_SEED_SMELTER> {};
+template <> struct StructureTraits<Smelter> : StructureTraitsEntry<Structure::StructureClass::Smelter, StructureID::SID_SMELTER> {};
+template <> struct StructureTraits<SolarPanelArray> : StructureTraitsEntry<Structure::StructureClass::EnergyProduction, StructureID::SID_SOLAR_PANEL1> {};
+template <> struct StructureTraits<SolarPlant> : StructureTraitsEntry<Structure::StructureClass::EnergyProduction, StructureID::SID_SOLAR_PLANT> {};
+template <> struct StructureTraits<StorageTanks> : StructureTraitsEntry<Structure::StructureClass::Storage, StructureID::SID_STORAGE_TANKS> {};
+template <> struct StructureTraits<SurfaceFactory> : StructureTraitsEntry<Structure::StructureClass::Factory, StructureID::SID_SURFACE_FACTORY> {};
+template <> struct StructureTraits<SurfacePolice> : StructureTraitsEntry<Structure::StructureClass::SurfacePolice, StructureID::SID_SURFACE_POLICE> {};
+template <> struct StructureTraits<Tube> : StructureTraitsEntry<Structure::StructureClass::Tube, StructureID::SID_TUBE> {};
+template <> struct StructureTraits<UndergroundFactory> : StructureTraitsEntry<Structure::StructureClass::Factory, StructureID::SID_UNDERGROUND_FACTORY> {};
+template <> struct StructureTraits<UndergroundPolice> : StructureTraitsEntry<Structure::StructureClass::UndergroundPolice, StructureID::SID_UNDERGROUND_POLICE> {};
+template <> struct StructureTraits<University> : StructureTraitsEntry<Structure::StructureClass::University, StructureID::SID_UNIVERSITY> {};
+template <> struct StructureTraits<Warehouse> : StructureTraitsEntry<Structure::StructureClass::Warehouse, StructureID::SID_WAREHOUSE> {};
+
+// Base types; never instantiated directly
+template <> struct StructureTraits<Factory> : StructureTraitsEntry<Structure::StructureClass::Factory> {};
+template <> struct StructureTraits<FoodProduction> : StructureTraitsEntry<Structure::StructureClass::FoodProduction> {};
+template <> struct StructureTraits<OreRefining> : StructureTraitsEntry<Structure::StructureClass::Smelter> {};
+template <> struct StructureTraits<PowerStructure> : StructureTraitsEntry<Structure::StructureClass::EnergyProduction> {};
+template <> struct StructureTraits<ResearchFacility> : StructureTraitsEntry<Structure::StructureClass::Laboratory> {};
+
+
+template <typename... Types>
+struct StructureTypeList {};
+
+
+/** Every type with a StructureTraits entry. */
+using StructureTypes = StructureTypeList<
+	Agridome, AirShaft, CargoLander, CHAP, ColonistLander, CommandCenter, Commercial, CommTower,
+	FusionReactor, HotLaboratory, Laboratory, MaintenanceFacility, MedicalCenter, MineFacility,
+	MineShaft, Nursery, Park, RecreationCenter, Recycling, RedLightDistrict, Residence, Road,
+	RobotCommand, SeedFactory, SeedLander, SeedPower, SeedSmelter, Smelter, SolarPanelArray,
+	SolarPlant, StorageTanks, SurfaceFactory, SurfacePolice, Tube, UndergroundFactory,
+	UndergroundPolice, University, Warehouse,
+	Factory, FoodProduction, OreRefining, PowerStructure, ResearchFacility>;
+
+
+template <typename StructureType>
+constexpr Structure::StructureClass structureTypeToClass()
+{
+	return StructureTraits<StructureType>::structureClass;
+}
+
+
+using StructureIdSet = std::array<bool, StructureID::SID_COUNT>;
+
+template <typename StructureType, typename... Types>
+constexpr StructureIdSet structureIdsOf(StructureTypeList<Types...>)
+{
+	StructureIdSet ids{};
+	(
+		(ids[static_cast<std::size_t>(StructureTraits<Types>::structureId)] =
+			StructureTraits<Types>::structureId != StructureID::SID_NONE &&
+			std::is_base_of_v<StructureType, Types> &&
+			StructureTraits<Types>::structureClass == StructureTraits<StructureType>::structureClass),
+		...
+	);
+	return ids;
+}
+
+
+/**
+ * StructureIDs whose structures are instances of StructureType and are kept
+ * in StructureType's StructureClass list; the structures that a dynamic_cast
+ * over that list would accept.
+ */
+template <typename StructureType>
+inline constexpr StructureIdSet StructureIdsOf = structureIdsOf<StructureType>(StructureTypes{});
+
+static_assert(StructureIdsOf<Factory>[StructureID::SID_SEED_FACTORY] && StructureIdsOf<Factory>[StructureID::SID_UNDERGROUND_FACTORY]);
+static_assert(StructureIdsOf<FoodProduction>[StructureID::SID_AGRIDOME] && !StructureIdsOf<FoodProduction>[StructureID::SID_COMMAND_CENTER]);
+static_assert(!StructureIdsOf<Residence>[StructureID::SID_RED_LIGHT_DISTRICT]);
@@ -1,4 +1,5 @@
 #include "DetailMap.h"
+#include "PixelCanvas.h"
 
 #include "../Constants/UiConstants.h"
 #include "../Map/Tile.h"
@@ -11,8 +12,10 @@
 #include <NAS2D/Utility.h>
 #include <NAS2D/Math/PointInRectangleRange.h>
 
-#include <map>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <utility>
 
 
 using namespace NAS2D;
@@ -23,31 +26,89 @@ namespace {
 	const auto TileDrawSize = NAS2D::Vector{128, 64};
 	const auto TileDrawOffset = NAS2D::Vector{TileDrawSize.x / 2, TileDrawSize.y - TileSize.y};
 
-	const std::map<Tile::Overlay, NAS2D::Color> OverlayColors =
+	// Indexed by Tile::Overlay
+	const std::array<NAS2D::Color, 5> OverlayColors =
 	{
-		{Tile::Overlay::None, NAS2D::Color::Normal},
-		{Tile::Overlay::Communications, {125, 200, 255}},
-		{Tile::Overlay::Connectedness, NAS2D::Color::Green},
-		{Tile::Overlay::TruckingRoutes, NAS2D::Color::Orange},
-		{Tile::Overlay::Police, NAS2D::Color::Red}
+		NAS2D::Color{125, 200, 255}, // Communications
+		NAS2D::Color::Green, // Connectedness
+		NAS2D::Color::Orange, // TruckingRoutes
+		NAS2D::Color::Red, // Police
+		NAS2D::Color::Normal // None
 	};
 
-	const std::map<Tile::Overlay, NAS2D::Color> OverlayHighlightColors =
+	const std::array<NAS2D::Color, 5> OverlayHighlightColors =
 	{
-		{Tile::Overlay::None, NAS2D::Color{125, 200, 255}},
-		{Tile::Overlay::Communications, {100, 180, 230}},
-		{Tile::Overlay::Connectedness, NAS2D::Color{71, 224, 146}},
-		{Tile::Overlay::TruckingRoutes, NAS2D::Color{125, 200, 255}},
-		{Tile::Overlay::Police, NAS2D::Color{100, 180, 230}}
+		NAS2D::Color{100, 180, 230}, // Communications
+		NAS2D::Color{71, 224, 146}, // Connectedness
+		NAS2D::Color{125, 200, 255}, // TruckingRoutes
+		NAS2D::Color{100, 180, 230}, // Police
+		NAS2D::Color{125, 200, 255} // None
 	};
 
 	const double ThrobSpeed = 250.0; // Throb speed of mine beacon
 	NAS2D::Timer throbTimer;
 
+	// Tileset is scaled down by these factors for each level of detail.
+	// The first level is used down to a zoom of 1 / its factor.
+	constexpr std::array<int, 2> LodDivisors = {4, 8};
 
-	const NAS2D::Color& overlayColor(Tile::Overlay overlay, bool isHighlighted)
+	// Caps the time spent building chunk images in a single frame
+	constexpr int MaxLodChunkBuildsPerFrame = 4;
+
+	// Area covered by the tiles of one chunk, drawn at full size
+	const auto LodChunkSize = NAS2D::Vector{TileStore::ChunkSize * TileSize.x, (TileStore::ChunkSize - 1) * TileSize.y + TileDrawSize.y};
+
+	// Low detail images show what is on a tile by tinting it
+	const auto LodStructureColor = NAS2D::Color::White;
+	const auto LodRobotColor = NAS2D::Color::Cyan;
+	const auto LodMineColor = NAS2D::Color::Yellow;
+
+
+	/**
+	 * Averages an area of an image, weighting colors by their alpha so
+	 * transparent pixels don't darken the edges of a tile.
+	 */
+	NAS2D::Color averageColor(const NAS2D::Image& image, NAS2D::Rectangle<int> area)
+	{
+		int red = 0;
+		int green = 0;
+		int blue = 0;
+		int alpha = 0;
+		for (const auto point : PointInRectangleRange{area})
+		{
+			const auto color = image.pixelColor(point);
+			red += color.red * color.alpha;
+			green += color.green * color.alpha;
+			blue += color.blue * color.alpha;
+			alpha += color.alpha;
+		}
+
+		if (alpha == 0) { return NAS2D::Color::NoAlpha; }
+
+		const auto pixelCount = area.size.x * area.size.y;
+		return {
+			static_cast<uint8_t>(red / alpha),
+			static_cast<uint8_t>(green / alpha),
+			static_cast<uint8_t>(blue / alpha),
+			static_cast<uint8_t>(alpha / pixelCount)
+		};
+	}
+
+
+	NAS2D::Color lodColor(NAS2D::Color color, NAS2D::Color tint, const NAS2D::Color* marker)
 	{
-		return (isHighlighted ? OverlayHighlightColors : OverlayColors).at(overlay);
+		color.red = static_cast<uint8_t>(color.red * tint.red / 255);
+		color.green = static_cast<uint8_t>(color.green * tint.green / 255);
+		color.blue = static_cast<uint8_t>(color.blue * tint.blue / 255);
+
+		if (marker)
+		{
+			color.red = static_cast<uint8_t>((color.red + marker->red) / 2);
+			color.green = static_cast<uint8_t>((color.green + marker->green) / 2);
+			color.blue = static_cast<uint8_t>((color.blue + marker->blue) / 2);
+		}
+
+		return color;
 	}
 }
 
@@ -58,18 +119,56 @@ DetailMap::DetailMap(MapView& mapView, TileMap& tileMap, const std::string& tile
 	mTileset{tilesetPath},
 	mMineBeacon{"structures/mine_beacon.png"}
 {
+	buildLodTiles();
 	resize(Utility<Renderer>::get().size());
 }
 
 
 void DetailMap::resize(NAS2D::Vector<int> size)
 {
-	// Set up map draw position
-	const auto sizeInTiles = size.skewInverseBy(TileSize);
+	mWindowSize = size;
+
+	// Zooming out stops once the longest side of the map fits in the view
+	const auto mapSize = mTileMap.size();
+	const auto longestSide = static_cast<float>(std::max(mapSize.x, mapSize.y));
+	mMinZoom = std::min({MaxZoom, static_cast<float>(size.x) / (static_cast<float>(TileSize.x) * longestSide), static_cast<float>(size.y) / (static_cast<float>(TileSize.y) * longestSide)});
+	mZoom = std::clamp(mZoom, mMinZoom, MaxZoom);
+
+	// Set up map draw position, allowing for rounding at the minimum zoom
+	const auto drawTileSize = tileSize();
+	const auto sizeInTiles = NAS2D::Vector{
+		static_cast<int>(static_cast<float>(size.x) / drawTileSize.x + 0.001f),
+		static_cast<int>(static_cast<float>(size.y) / drawTileSize.y + 0.001f)
+	};
 	mMapView.viewSize(std::min(sizeInTiles.x, sizeInTiles.y));
 
 	// Find top left corner of rectangle containing top tile of diamond
-	mOriginPixelPosition = NAS2D::Point{size.x / 2, TileDrawOffset.y + (size.y - constants::BottomUiHeight - mMapView.viewSize() * TileSize.y) / 2};
+	const auto diamondHeight = static_cast<float>(mMapView.viewSize()) * drawTileSize.y;
+	mOriginPixelPosition = NAS2D::Point{size.x / 2, static_cast<int>(static_cast<float>(TileDrawOffset.y) * mZoom + (static_cast<float>(size.y - constants::BottomUiHeight) - diamondHeight) / 2)};
+}
+
+
+/**
+ * Sets the zoom, keeping the tile at the center of the view in place.
+ *
+ * Below MaxZoom the map is drawn from low detail chunk images.
+ */
+void DetailMap::zoom(float zoom)
+{
+	const auto viewTileRect = mMapView.viewTileRect();
+	const auto center = viewTileRect.position + viewTileRect.size / 2;
+
+	// Snap to full detail rather than stopping just short of it from rounding
+	mZoom = (zoom > MaxZoom * 0.99f) ? MaxZoom : std::max(zoom, mMinZoom);
+	resize(mWindowSize);
+	mMapView.centerOn(center);
+
+	if (isDetailed())
+	{
+		for (auto& lodChunks : mLodChunks) { lodChunks.clear(); }
+		mLodDraws.clear();
+		mRenderStats.lodChunkImages = 0;
+	}
 }
 
 
@@ -98,15 +197,56 @@ Tile& DetailMap::mouseTile()
 }
 
 
+NAS2D::Vector<float> DetailMap::tileSize() const
+{
+	return TileSize.to<float>() * mZoom;
+}
+
+
+/**
+ * Gets where the tileset image of a tile is drawn, given the tile's offset
+ * from the top of the view diamond.
+ */
+NAS2D::Point<float> DetailMap::tileDrawPosition(NAS2D::Vector<int> viewOffset) const
+{
+	const auto drawTileSize = tileSize();
+	const auto isometricOffset = NAS2D::Vector{
+		static_cast<float>(viewOffset.x - viewOffset.y) * drawTileSize.x / 2,
+		static_cast<float>(viewOffset.x + viewOffset.y) * drawTileSize.y / 2
+	};
+	return mOriginPixelPosition.to<float>() + isometricOffset - TileDrawOffset.to<float>() * mZoom;
+}
+
+
+std::size_t DetailMap::lodLevel() const
+{
+	for (std::size_t level = 0; level < LodLevelCount - 1; ++level)
+	{
+		if (mZoom * static_cast<float>(LodDivisors[level]) >= 1.0f) { return level; }
+	}
+	return LodLevelCount - 1;
+}
+
+
 void DetailMap::update()
 {
-	for (const auto tilePosition : PointInRectangleRange{mMapView.viewTileRect()})
+	if (!isDetailed())
+	{
+		updateLodChunks();
+		return;
+	}
+
+	if (!isTerrainLayerCurrent())
 	{
-		auto& tile = mTileMap.getTile({tilePosition, mMapView.currentDepth()});
+		buildTerrainLayer();
+	}
 
-		if (tile.thing())
+	const auto& tileStore = mTileMap.tileStore();
+	for (const auto& entry : mTerrainLayer)
+	{
+		if (auto* thing = tileStore.mapObject(entry.tileIndex))
 		{
-			tile.thing()->sprite().update();
+			thing->sprite().update();
 		}
 	}
 }
@@ -114,38 +254,314 @@ void DetailMap::update()
 
 void DetailMap::draw() const
 {
-	auto& renderer = Utility<Renderer>::get();
+	const auto drawStart = std::chrono::steady_clock::now();
+	mRenderStats.drawCalls = 0;
+
+	if (isDetailed())
+	{
+		drawDetailed();
+	}
+	else
+	{
+		drawLowDetail();
+	}
+
+	mRenderStats.drawTime = std::chrono::steady_clock::now() - drawStart;
+}
 
-	int tsetOffset = mMapView.currentDepth() > 0 ? TileDrawSize.y : 0;
 
-	for (const auto tilePosition : PointInRectangleRange{mMapView.viewTileRect()})
+void DetailMap::drawDetailed() const
+{
+	auto& renderer = Utility<Renderer>::get();
+
+	for (const auto& entry : mTerrainLayer)
 	{
-		auto& tile = mTileMap.getTile({tilePosition, mMapView.currentDepth()});
+		const bool isTileHighlighted = entry.tilePosition == mMouseTilePosition;
+		renderer.drawSubImage(mTileset, entry.drawPosition, entry.subImageRect, isTileHighlighted ? entry.highlightColor : entry.color);
+	}
 
-		if (tile.excavated())
+	int drawCalls = static_cast<int>(mTerrainLayer.size());
+
+	// Structures, robots and mine beacons go on top of the finished terrain
+	const auto& tileStore = mTileMap.tileStore();
+	const auto glow = static_cast<uint8_t>(120 + std::sin(throbTimer.tick() / ThrobSpeed) * 57);
+	for (const auto& entry : mTerrainLayer)
+	{
+		if (auto* thing = tileStore.mapObject(entry.tileIndex))
 		{
-			const auto offset = tilePosition - mMapView.viewTileRect().position;
-			const auto position = mOriginPixelPosition - TileDrawOffset + NAS2D::Vector{(offset.x - offset.y) * TileSize.x / 2, (offset.x + offset.y) * TileSize.y / 2};
-			const auto subImageRect = NAS2D::Rectangle{{static_cast<int>(tile.index()) * TileDrawSize.x, tsetOffset}, TileDrawSize};
-			const bool isTileHighlighted = tilePosition == mMouseTilePosition;
+			thing->sprite().draw(entry.drawPosition);
+			++drawCalls;
+		}
+		else if (tileStore.mine(entry.tileIndex) != nullptr)
+		{
+			// Draw a beacon on an unoccupied tile with a mine
+			renderer.drawImage(mMineBeacon, entry.drawPosition + NAS2D::Vector{0, -64});
+			renderer.drawSubImage(mMineBeacon, entry.drawPosition + NAS2D::Vector{59, 15}, NAS2D::Rectangle<int>{{59, 79}, {10, 7}}, NAS2D::Color{glow, glow, glow});
+			drawCalls += 2;
+		}
+	}
 
-			renderer.drawSubImage(mTileset, position, subImageRect, overlayColor(tile.overlay(), isTileHighlighted));
+	mRenderStats.drawCalls += drawCalls;
+}
 
-			// Draw a beacon on an unoccupied tile with a mine
-			if (tile.mine() != nullptr && !tile.thing())
+
+/**
+ * Checks whether the terrain layer still matches the view, the window size
+ * and the tiles it was built from.
+ */
+bool DetailMap::isTerrainLayerCurrent() const
+{
+	return mTerrainLayerDepth == mMapView.currentDepth() &&
+		mTerrainLayerView == mMapView.viewTileRect() &&
+		mTerrainLayerOrigin == mOriginPixelPosition &&
+		mTerrainLayerRevision == mTileMap.revision();
+}
+
+
+/**
+ * Works out the draw position, tileset rectangle and overlay colors of every
+ * visible excavated tile, in drawing order.
+ */
+void DetailMap::buildTerrainLayer()
+{
+	const auto& tileStore = mTileMap.tileStore();
+	const auto viewTileRect = mMapView.viewTileRect();
+	const auto depth = mMapView.currentDepth();
+	const int tsetOffset = depth > 0 ? TileDrawSize.y : 0;
+
+	mTerrainLayer.clear();
+	mTerrainLayerAnimated = false;
+	for (const auto tilePosition : PointInRectangleRange{viewTileRect})
+	{
+		if (!mTileMap.isValidPosition({tilePosition, depth})) { continue; }
+
+		const auto index = tileStore.linearIndex({tilePosition, depth});
+		if (!tileStore.excavated(index)) { continue; }
+
+		mTerrainLayerAnimated = mTerrainLayerAnimated || tileStore.mapObject(index) || tileStore.mine(index);
+
+		const auto overlay = static_cast<std::size_t>(tileStore.overlay(index));
+		mTerrainLayer.push_back({
+			index,
+			tilePosition,
+			tileDrawPosition(tilePosition - viewTileRect.position).to<int>(),
+			NAS2D::Rectangle{{static_cast<int>(tileStore.terrain(index)) * TileDrawSize.x, tsetOffset}, TileDrawSize},
+			OverlayColors[overlay],
+			OverlayHighlightColors[overlay]
+		});
+	}
+
+	mTerrainLayerView = viewTileRect;
+	mTerrainLayerDepth = depth;
+	mTerrainLayerOrigin = mOriginPixelPosition;
+	mTerrainLayerRevision = mTileMap.revision();
+
+	mRenderStats.terrainTiles = static_cast<int>(mTerrainLayer.size());
+	++mRenderStats.layerRebuilds;
+}
+
+
+/**
+ * Scales every cell of the tileset down to each level of detail.
+ */
+void DetailMap::buildLodTiles()
+{
+	const auto cellCounts = NAS2D::Vector{mTileset.size().x / TileDrawSize.x, mTileset.size().y / TileDrawSize.y};
+
+	for (std::size_t level = 0; level < LodLevelCount; ++level)
+	{
+		const auto divisor = LodDivisors[level];
+		const auto lodTileSize = TileDrawSize / divisor;
+
+		auto& lodTiles = mLodTiles[level];
+		lodTiles.clear();
+		for (int row = 0; row < cellCounts.y; ++row)
+		{
+			for (int column = 0; column < cellCounts.x; ++column)
 			{
-				uint8_t glow = static_cast<uint8_t>(120 + std::sin(throbTimer.tick() / ThrobSpeed) * 57);
-				renderer.drawImage(mMineBeacon, position + NAS2D::Vector{0, -64});
-				renderer.drawSubImage(mMineBeacon, position + NAS2D::Vector{59, 15}, NAS2D::Rectangle<int>{{59, 79}, {10, 7}}, NAS2D::Color{glow, glow, glow});
+				const auto cellOrigin = NAS2D::Point{column * TileDrawSize.x, row * TileDrawSize.y};
+
+				std::vector<NAS2D::Color> pixels;
+				pixels.reserve(static_cast<std::size_t>(lodTileSize.x * lodTileSize.y));
+				for (int y = 0; y < lodTileSize.y; ++y)
+				{
+					for (int x = 0; x < lodTileSize.x; ++x)
+					{
+						pixels.push_back(averageColor(mTileset, {cellOrigin + NAS2D::Vector{x, y} * divisor, {divisor, divisor}}));
+					}
+				}
+				lodTiles.push_back(std::move(pixels));
 			}
+		}
+	}
+}
+
+
+/**
+ * Brings the low detail images of the visible chunks up to date, and
+ * lines them up for drawing.
+ *
+ * Only a few images are built per frame. Until a chunk's image is current,
+ * its last image, or its image from the other level of detail, is drawn,
+ * and lodChunksPending() tells the caller to keep drawing frames.
+ */
+void DetailMap::updateLodChunks()
+{
+	const auto& tileStore = mTileMap.tileStore();
+	const auto level = lodLevel();
+	const auto depth = mMapView.currentDepth();
+	const auto viewTileRect = mMapView.viewTileRect();
+	const auto mapSize = mTileMap.size();
+
+	// Chunks overlapping the part of the view that is on the map
+	const auto firstTile = NAS2D::Point{std::max(viewTileRect.position.x, 0), std::max(viewTileRect.position.y, 0)};
+	const auto endTile = NAS2D::Point{std::min(viewTileRect.endPoint().x, mapSize.x), std::min(viewTileRect.endPoint().y, mapSize.y)};
+	const auto firstChunk = NAS2D::Point{firstTile.x >> TileStore::ChunkShift, firstTile.y >> TileStore::ChunkShift};
+	const auto endChunk = NAS2D::Point{(endTile.x + TileStore::ChunkSize - 1) >> TileStore::ChunkShift, (endTile.y + TileStore::ChunkSize - 1) >> TileStore::ChunkShift};
+
+	int builds = 0;
+	++mLodUpdate;
+	mLodChunksPending = 0;
+
+	mLodDraws.clear();
+	for (const auto chunkPosition : PointInRectangleRange{NAS2D::Rectangle<int>::Create(firstChunk, endChunk)})
+	{
+		const auto chunkFirstTile = NAS2D::Point{chunkPosition.x << TileStore::ChunkShift, chunkPosition.y << TileStore::ChunkShift};
+		const auto chunk = TileStore::chunkOf(tileStore.linearIndex({chunkFirstTile, depth}));
+
+		// Nothing in an unallocated chunk has been excavated, so there is nothing to draw
+		if (!tileStore.isMaterialized(chunk)) { continue; }
+
+		auto& lodChunks = mLodChunks[level];
+		auto lodChunk = lodChunks.find(chunk);
+		const bool isStale = lodChunk == lodChunks.end() || lodChunk->second.revision != tileStore.chunkRevision(chunk);
+		if (isStale && builds < MaxLodChunkBuildsPerFrame)
+		{
+			lodChunk = lodChunks.insert_or_assign(chunk, buildLodChunk(level, chunkPosition, depth)).first;
+			++builds;
+		}
+		else if (isStale)
+		{
+			++mLodChunksPending;
+		}
+
+		// Images of the other level are kept while in view, as a fallback until this level's are built
+		auto& otherLodChunks = mLodChunks[LodLevelCount - 1 - level];
+		const auto otherLodChunk = otherLodChunks.find(chunk);
+		if (otherLodChunk != otherLodChunks.end()) { otherLodChunk->second.lastSeen = mLodUpdate; }
+
+		const NAS2D::Image* image = nullptr;
+		if (lodChunk != lodChunks.end())
+		{
+			lodChunk->second.lastSeen = mLodUpdate;
+			image = lodChunk->second.image.get();
+		}
+		else
+		{
+			if (otherLodChunk == otherLodChunks.end()) { continue; }
+			image = otherLodChunk->second.image.get();
+		}
+
+		const auto chunkOffset = NAS2D::Vector{static_cast<float>((TileStore::ChunkSize - 1) * TileSize.x / 2) * mZoom, 0.0f};
+		mLodDraws.push_back({image, tileDrawPosition(chunkFirstTile - viewTileRect.position) - chunkOffset, LodChunkSize.to<float>() * mZoom});
+	}
+
+	// Let go of images of chunks that have gone out of view
+	mRenderStats.lodChunkImages = 0;
+	for (auto& lodChunks : mLodChunks)
+	{
+		std::erase_if(lodChunks, [this](const auto& entry) { return entry.second.lastSeen != mLodUpdate; });
+		mRenderStats.lodChunkImages += static_cast<int>(lodChunks.size());
+	}
+	mRenderStats.lodChunkBuilds += builds;
+}
+
+
+/**
+ * Draws the tiles of a chunk into an image, scaled down for a level of
+ * detail. Overlays tint tiles as they do at full detail, and structures,
+ * robots and mines tint them further.
+ */
+DetailMap::LodChunk DetailMap::buildLodChunk(std::size_t level, NAS2D::Point<int> chunkPosition, int depth) const
+{
+	const auto& tileStore = mTileMap.tileStore();
+	const auto divisor = LodDivisors[level];
+	const auto lodTileSize = TileDrawSize / divisor;
+	const auto imageSize = LodChunkSize / divisor;
+	const auto& lodTiles = mLodTiles[level];
+	const auto tilesetColumns = static_cast<std::size_t>(mTileset.size().x / TileDrawSize.x);
 
-			// Tell an occupying thing to update itself.
-			if (tile.thing())
+	PixelCanvas canvas{imageSize};
+
+	const auto firstTile = NAS2D::Point{chunkPosition.x << TileStore::ChunkShift, chunkPosition.y << TileStore::ChunkShift};
+	for (int localY = 0; localY < TileStore::ChunkSize; ++localY)
+	{
+		for (int localX = 0; localX < TileStore::ChunkSize; ++localX)
+		{
+			const auto position = MapCoordinate{firstTile + NAS2D::Vector{localX, localY}, depth};
+			if (!mTileMap.isValidPosition(position)) { continue; }
+
+			const auto index = tileStore.linearIndex(position);
+			if (!tileStore.excavated(index)) { continue; }
+
+			const auto cell = (depth > 0 ? tilesetColumns : 0) + static_cast<std::size_t>(tileStore.terrain(index));
+			if (cell >= lodTiles.size()) { continue; }
+
+			const NAS2D::Color* marker =
+				tileStore.holds(index, MapObjectKind::Structure) ? &LodStructureColor :
+				tileStore.holds(index, MapObjectKind::Robot) ? &LodRobotColor :
+				tileStore.mine(index) ? &LodMineColor : nullptr;
+			const auto& tint = OverlayColors[static_cast<std::size_t>(tileStore.overlay(index))];
+
+			const auto tileOrigin = NAS2D::Vector{
+				(localX - localY + TileStore::ChunkSize - 1) * TileSize.x / 2 / divisor,
+				(localX + localY) * TileSize.y / 2 / divisor
+			};
+			const auto& lodTile = lodTiles[cell];
+			for (int y = 0; y < lodTileSize.y; ++y)
 			{
-				tile.thing()->sprite().draw(position);
+				for (int x = 0; x < lodTileSize.x; ++x)
+				{
+					const auto color = lodTile[static_cast<std::size_t>(y * lodTileSize.x + x)];
+					if (color.alpha == 0) { continue; }
+
+					canvas.blend(NAS2D::Point{tileOrigin.x + x, tileOrigin.y + y}, lodColor(color, tint, marker));
+				}
 			}
 		}
 	}
+
+	return {canvas.image(), tileStore.chunkRevision(TileStore::chunkOf(tileStore.linearIndex({firstTile, depth})))};
+}
+
+
+void DetailMap::drawLowDetail() const
+{
+	auto& renderer = Utility<Renderer>::get();
+
+	for (const auto& lodDraw : mLodDraws)
+	{
+		renderer.drawImageStretched(*lodDraw.image, lodDraw.position, lodDraw.size);
+	}
+
+	mRenderStats.drawCalls += static_cast<int>(mLodDraws.size());
+
+	// Chunk images can't show the highlight, so outline the tile instead
+	if (isMouseOverTile())
+	{
+		const auto drawTileSize = tileSize();
+		const auto top = tileDrawPosition(mMouseTilePosition - mMapView.viewTileRect().position) + TileDrawOffset.to<float>() * mZoom;
+		const auto right = top + NAS2D::Vector{drawTileSize.x / 2, drawTileSize.y / 2};
+		const auto bottom = top + NAS2D::Vector{0.0f, drawTileSize.y};
+		const auto left = top + NAS2D::Vector{-drawTileSize.x / 2, drawTileSize.y / 2};
+		const auto& color = OverlayHighlightColors[static_cast<std::size_t>(Tile::Overlay::None)];
+
+		renderer.drawLine(top, right, color);
+		renderer.drawLine(right, bottom, color);
+		renderer.drawLine(bottom, left, color);
+		renderer.drawLine(left, top, color);
+		mRenderStats.drawCalls += 4;
+	}
 }
 
 
@@ -153,23 +569,29 @@ void DetailMap::drawGrid() const
 {
 	auto& renderer = Utility<Renderer>::get();
 
-	const auto viewSize = mMapView.viewSize();
-	const auto incrementY = NAS2D::Vector{-TileSize.x, TileSize.y};
-	const auto leftEdge = mOriginPixelPosition + incrementY * viewSize / 2;
-	const auto rightEdge = mOriginPixelPosition + TileSize * viewSize / 2;
-	for (int index = 0; index <= viewSize; ++index)
+	const auto viewSize = static_cast<float>(mMapView.viewSize());
+	const auto drawTileSize = tileSize();
+	const auto origin = mOriginPixelPosition.to<float>();
+	const auto incrementY = NAS2D::Vector{-drawTileSize.x, drawTileSize.y};
+	const auto leftEdge = origin + incrementY * viewSize / 2;
+	const auto rightEdge = origin + drawTileSize * viewSize / 2;
+	for (int index = 0; index <= mMapView.viewSize(); ++index)
 	{
-		const auto offsetX = TileSize * index / 2;
-		const auto offsetY = incrementY * index / 2;
-		renderer.drawLine(leftEdge + offsetX, mOriginPixelPosition + offsetX);
-		renderer.drawLine(mOriginPixelPosition + offsetY, rightEdge + offsetY);
+		const auto offsetX = drawTileSize * static_cast<float>(index) / 2;
+		const auto offsetY = incrementY * static_cast<float>(index) / 2;
+		renderer.drawLine(leftEdge + offsetX, origin + offsetX);
+		renderer.drawLine(origin + offsetY, rightEdge + offsetY);
 	}
 }
 
 
 void DetailMap::onMouseMove(NAS2D::Point<int> position)
 {
-	const auto pixelOffset = position - mOriginPixelPosition;
-	const auto tileOffset = NAS2D::Vector{pixelOffset.x * TileSize.y + pixelOffset.y * TileSize.x, pixelOffset.y * TileSize.x - pixelOffset.x * TileSize.y} / (TileSize.x * TileSize.y);
+	const auto drawTileSize = tileSize();
+	const auto pixelOffset = (position - mOriginPixelPosition).to<float>();
+	const auto tileOffset = NAS2D::Vector{
+		static_cast<int>(std::floor(pixelOffset.x / drawTileSize.x + pixelOffset.y / drawTileSize.y)),
+		static_cast<int>(std::floor(pixelOffset.y / drawTileSize.y - pixelOffset.x / drawTileSize.x))
+	};
 	mMouseTilePosition = mMapView.viewTileRect().position + tileOffset;
 }
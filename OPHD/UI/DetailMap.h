@@ -4,8 +4,17 @@
 
 #include "../Map/MapCoordinate.h"
 
+#include <NAS2D/Math/Rectangle.h>
+#include <NAS2D/Renderer/Color.h>
 #include <NAS2D/Resource/Image.h>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
 
 class Tile;
 class TileMap;
@@ -15,6 +24,18 @@ class MapView;
 class DetailMap : public Control
 {
 public:
+	static constexpr float MaxZoom = 1.0f;
+
+	struct RenderStats
+	{
+		int drawCalls{0}; /**< Renderer calls made by the last draw(). */
+		int terrainTiles{0}; /**< Tiles in the cached terrain layer. */
+		int layerRebuilds{0}; /**< Times the terrain layer was rebuilt since the map was created. */
+		int lodChunkImages{0}; /**< Low detail chunk images currently held. */
+		int lodChunkBuilds{0}; /**< Low detail chunk images built since the map was created. */
+		std::chrono::steady_clock::duration drawTime{0};
+	};
+
 	DetailMap(MapView& mapView, TileMap& tileMap, const std::string& tilesetPath);
 
 	bool isMouseOverTile() const;
@@ -22,21 +43,99 @@ public:
 	MapCoordinate mouseTilePosition() const;
 	Tile& mouseTile();
 
+	float zoom() const { return mZoom; }
+	void zoom(float zoom);
+
+	bool animated() const { return isDetailed() && mTerrainLayerAnimated; }
+	bool lodChunksPending() const { return !isDetailed() && mLodChunksPending > 0; }
+
 	void onMouseMove(NAS2D::Point<int> position);
 	void resize(NAS2D::Vector<int>);
 
 	void update() override;
 	void draw() const override;
 
+	const RenderStats& renderStats() const { return mRenderStats; }
+
 protected:
 	void drawGrid() const;
 
 private:
+	static constexpr std::size_t LodLevelCount = 2;
+
+	/**
+	 * Everything needed to draw one excavated tile, worked out when the
+	 * terrain layer is built rather than every frame.
+	 */
+	struct TerrainEntry
+	{
+		std::size_t tileIndex; /**< Index in the TileMap's TileStore. */
+		NAS2D::Point<int> tilePosition;
+		NAS2D::Point<int> drawPosition;
+		NAS2D::Rectangle<int> subImageRect;
+		NAS2D::Color color;
+		NAS2D::Color highlightColor;
+	};
+
+	/**
+	 * Pre-rendered picture of one TileStore chunk at low detail, used
+	 * instead of drawing its tiles one by one when zoomed out.
+	 */
+	struct LodChunk
+	{
+		std::unique_ptr<NAS2D::Image> image;
+		std::uint64_t revision; /**< TileStore chunk revision it was built from. */
+		std::uint64_t lastSeen{0}; /**< Last LOD update the chunk was in view. */
+	};
+
+	struct LodDraw
+	{
+		const NAS2D::Image* image;
+		NAS2D::Point<float> position;
+		NAS2D::Vector<float> size;
+	};
+
+	NAS2D::Vector<float> tileSize() const;
+	NAS2D::Point<float> tileDrawPosition(NAS2D::Vector<int> viewOffset) const;
+
+	bool isDetailed() const { return mZoom >= MaxZoom; }
+	std::size_t lodLevel() const;
+
+	bool isTerrainLayerCurrent() const;
+	void buildTerrainLayer();
+	void drawDetailed() const;
+
+	void buildLodTiles();
+	void updateLodChunks();
+	LodChunk buildLodChunk(std::size_t level, NAS2D::Point<int> chunkPosition, int depth) const;
+	void drawLowDetail() const;
+
 	MapView& mMapView;
 	TileMap& mTileMap;
 	const NAS2D::Image mTileset;
 	const NAS2D::Image mMineBeacon;
 
+	NAS2D::Vector<int> mWindowSize{0, 0};
+	float mZoom{MaxZoom};
+	float mMinZoom{MaxZoom};
+
 	NAS2D::Point<int> mOriginPixelPosition; // Top pixel at top of diamond
 	NAS2D::Point<int> mMouseTilePosition;
+
+	// Terrain layer and the view it was built for
+	std::vector<TerrainEntry> mTerrainLayer;
+	NAS2D::Rectangle<int> mTerrainLayerView{{0, 0}, {0, 0}};
+	int mTerrainLayerDepth{-1};
+	std::uint64_t mTerrainLayerRevision{0};
+	NAS2D::Point<int> mTerrainLayerOrigin{0, 0};
+	bool mTerrainLayerAnimated{false}; /**< Some tile in the layer has a sprite or mine beacon. */
+
+	// Tileset scaled down for each level of detail, one entry per tileset cell
+	std::array<std::vector<std::vector<NAS2D::Color>>, LodLevelCount> mLodTiles;
+	std::array<std::map<std::size_t, LodChunk>, LodLevelCount> mLodChunks; /**< Keyed by TileStore chunk. */
+	std::vector<LodDraw> mLodDraws;
+	std::uint64_t mLodUpdate{0}; /**< Count of LOD updates, stamped on the chunks in view. */
+	int mLodChunksPending{0}; /**< Chunks in view left stale by the last LOD update. */
+
+	mutable RenderStats mRenderStats;
 };
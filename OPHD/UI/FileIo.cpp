@@ -3,6 +3,7 @@
 #include "../Constants/Strings.h"
 #include "../Constants/UiConstants.h"
 #include "../Common.h"
+#include "../Savegame.h"
 #include "../ShellOpenPath.h"
 
 #include "MessageBox.h"
@@ -109,17 +110,25 @@ void FileIo::scanDirectory(const std::string& directory)
 	mScanPath = (Utility<Filesystem>::get().prefPath() / directory).string();
 
 	const auto& filesystem = Utility<Filesystem>::get();
-	auto dirList = filesystem.directoryList(directory);
-	std::sort(dirList.begin(), dirList.end());
+	const auto dirList = filesystem.directoryList(directory);
 
-	mListBox.clear();
+	// A savegame can exist in both the binary and XML formats; list it once
+	std::vector<std::string> names;
 	for (auto& dir : dirList)
 	{
 		if (!filesystem.isDirectory(directory + dir.string()))
 		{
-			mListBox.add(dir.stem().string());
+			names.push_back(dir.stem().string());
 		}
 	}
+	std::sort(names.begin(), names.end());
+	names.erase(std::unique(names.begin(), names.end()), names.end());
+
+	mListBox.clear();
+	for (const auto& name : names)
+	{
+		mListBox.add(name);
+	}
 }
 
 
@@ -177,13 +186,11 @@ void FileIo::onFileIo()
 
 void FileIo::onFileDelete()
 {
-	std::string filename = constants::SaveGamePath + mFileName.text() + ".xml";
-
 	try
 	{
 		if(doYesNoMessage(constants::WindowFileIoTitleDelete, "Are you sure you want to delete " + mFileName.text() + "?"))
 		{
-			Utility<Filesystem>::get().del(filename);
+			deleteSavegame(mFileName.text());
 		}
 	}
 	catch(const std::exception& e)
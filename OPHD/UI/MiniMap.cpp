@@ -1,10 +1,11 @@
 #include "MiniMap.h"
+#include "PixelCanvas.h"
 
 #include "../Cache.h"
 #include "../Map/TileMap.h"
 #include "../Map/MapView.h"
 #include "../MapObjects/Robot.h"
-#include "../States/Route.h"
+#include "../States/RouteCache.h"
 #include "../StructureManager.h"
 
 #include <NAS2D/Utility.h>
@@ -13,13 +14,26 @@
 #include <NAS2D/Renderer/Color.h>
 #include <NAS2D/Renderer/Renderer.h>
 
+#include <algorithm>
 #include <map>
+#include <utility>
 
 
 namespace
 {
 	const std::string MapTerrainExtension = "_a.png";
 	const std::string MapDisplayExtension = "_b.png";
+
+	const auto CommandCenterCommRangeImageRect = NAS2D::Rectangle<int>{{166, 226}, {30, 30}};
+	const auto CommTowerCommRangeImageRect = NAS2D::Rectangle<int>{{146, 236}, {20, 20}};
+
+
+	int mineBeaconStatusOffsetX(const Mine& mine)
+	{
+		if (!mine.active()) { return 0; }
+		else if (!mine.exhausted()) { return 8; }
+		return 16;
+	}
 }
 
 
@@ -46,6 +60,18 @@ void MiniMap::heightMapVisible(bool isVisible)
 }
 
 
+/**
+ * Redraws any marker layers whose data has changed.
+ */
+void MiniMap::update()
+{
+	updateLayer(mStructureLayer, {NAS2D::Utility<StructureManager>::get().revision()}, &MiniMap::drawStructureLayer);
+	updateLayer(mMineLayer, mineLayerKey(), &MiniMap::drawMineLayer);
+	updateLayer(mRouteLayer, {NAS2D::Utility<RouteCache>::get().revision()}, &MiniMap::drawRouteLayer);
+	updateLayer(mRobotLayer, {mTileMap.revision(), mRobotList.size()}, &MiniMap::drawRobotLayer);
+}
+
+
 /**
  * Draws the minimap and all icons/overlays for it.
  */
@@ -55,16 +81,65 @@ void MiniMap::draw() const
 	const auto miniMapFloatRect = mRect.to<float>();
 	renderer.clipRect(miniMapFloatRect);
 
-	renderer.drawImage((mIsHeightMapVisible ? mBackgroundHeightMap : mBackgroundSatellite), miniMapFloatRect.position);
+	renderer.drawImageStretched((mIsHeightMapVisible ? mBackgroundHeightMap : mBackgroundSatellite), miniMapFloatRect.position, mTileMap.size().to<float>() * scale());
+
+	for (const auto* layer : {&mStructureLayer, &mMineLayer, &mRouteLayer, &mRobotLayer})
+	{
+		if (layer->image) { renderer.drawImage(*layer->image, mRect.position); }
+	}
+
+	const auto& viewTileRect = mMapView.viewTileRect();
+	const auto viewRect = NAS2D::Rectangle<int>::Create(tileToPixel(viewTileRect.position), tileToPixel(viewTileRect.endPoint()));
+	renderer.drawBox(viewRect.translate({1, 1}), NAS2D::Color{0, 0, 0, 180});
+	renderer.drawBox(viewRect, NAS2D::Color::White);
+
+	renderer.clipRectClear();
+}
+
 
+void MiniMap::updateLayer(Layer& layer, std::vector<std::uint64_t> key, LayerDrawFunction drawLayer)
+{
+	// Layers are drawn at the size of the minimap, so resizing it redraws them
+	key.push_back(static_cast<std::uint64_t>(mRect.size.x));
+	key.push_back(static_cast<std::uint64_t>(mRect.size.y));
+	if (layer.key == key) { return; }
+
+	layer.key = std::move(key);
+	layer.image.reset();
+	if (mRect.size.x <= 0 || mRect.size.y <= 0) { return; }
+
+	PixelCanvas canvas{mRect.size};
+	(this->*drawLayer)(canvas);
+	layer.image = canvas.image();
+}
+
+
+/**
+ * Mines don't report changes, so their beacon states are part of the key.
+ * Mines are few, so checking them every frame costs little next to drawing
+ * them.
+ */
+std::vector<std::uint64_t> MiniMap::mineLayerKey() const
+{
+	std::vector<std::uint64_t> key{mTileMap.revision()};
+	for (auto minePosition : mTileMap.mineLocations())
+	{
+		const Mine* mine = std::as_const(mTileMap).getTile({minePosition, 0}).mine();
+		if (!mine) { break; }
+		key.push_back(static_cast<std::uint64_t>(mineBeaconStatusOffsetX(*mine)));
+	}
+	return key;
+}
+
+
+void MiniMap::drawStructureLayer(PixelCanvas& canvas) const
+{
 	const auto& structureManager = NAS2D::Utility<StructureManager>::get();
-	const auto miniMapOffset = mRect.position - NAS2D::Point{0, 0};
 	for (const auto& ccPosition : structureManager.operationalCommandCenterPositions())
 	{
-		const auto ccOffsetPosition = ccPosition.xy + miniMapOffset;
-		const auto ccCommRangeImageRect = NAS2D::Rectangle<int>{{166, 226}, {30, 30}};
-		renderer.drawSubImage(mUiIcons, ccOffsetPosition - ccCommRangeImageRect.size / 2, ccCommRangeImageRect);
-		renderer.drawBoxFilled(NAS2D::Rectangle{ccOffsetPosition - NAS2D::Vector{1, 1}, {3, 3}}, NAS2D::Color::White);
+		const auto ccOffsetPosition = tileToLayerPixel(ccPosition.xy);
+		canvas.drawSubImage(mUiIcons, ccOffsetPosition - CommandCenterCommRangeImageRect.size / 2, CommandCenterCommRangeImageRect);
+		canvas.drawBoxFilled(NAS2D::Rectangle{ccOffsetPosition - NAS2D::Vector{1, 1}, {3, 3}}, NAS2D::Color::White);
 	}
 
 	for (const auto* commTower : structureManager.getStructures<CommTower>())
@@ -72,48 +147,45 @@ void MiniMap::draw() const
 		if (commTower->operational())
 		{
 			const auto commTowerPosition = structureManager.tileFromStructure(commTower).xy();
-			const auto commTowerRangeImageRect = NAS2D::Rectangle<int>{{146, 236}, {20, 20}};
-			renderer.drawSubImage(mUiIcons, commTowerPosition + miniMapOffset - commTowerRangeImageRect.size / 2, commTowerRangeImageRect);
+			canvas.drawSubImage(mUiIcons, tileToLayerPixel(commTowerPosition) - CommTowerCommRangeImageRect.size / 2, CommTowerCommRangeImageRect);
 		}
 	}
+}
+
 
+void MiniMap::drawMineLayer(PixelCanvas& canvas) const
+{
 	for (auto minePosition : mTileMap.mineLocations())
 	{
-		Mine* mine = mTileMap.getTile({minePosition, 0}).mine();
+		const Mine* mine = std::as_const(mTileMap).getTile({minePosition, 0}).mine();
 		if (!mine) { break; } // avoids potential race condition where a mine is destroyed during an updated cycle.
 
-		auto mineBeaconStatusOffsetX = 0;
-		if (!mine->active()) { mineBeaconStatusOffsetX = 0; }
-		else if (!mine->exhausted()) { mineBeaconStatusOffsetX = 8; }
-		else { mineBeaconStatusOffsetX = 16; }
-
-		const auto mineImageRect = NAS2D::Rectangle<int>{{mineBeaconStatusOffsetX, 0}, {7, 7}};
-		renderer.drawSubImage(mUiIcons, minePosition + miniMapOffset - NAS2D::Vector{2, 2}, mineImageRect);
+		const auto mineImageRect = NAS2D::Rectangle<int>{{mineBeaconStatusOffsetX(*mine), 0}, {7, 7}};
+		canvas.drawSubImage(mUiIcons, tileToLayerPixel(minePosition) - NAS2D::Vector{2, 2}, mineImageRect);
 	}
+}
 
-	// Temporary debug aid, will be slow with high numbers of mines
-	// especially with routes of longer lengths.
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
-	for (auto route : routeTable)
+
+void MiniMap::drawRouteLayer(PixelCanvas& canvas) const
+{
+	for (const auto& [mine, route] : NAS2D::Utility<RouteCache>::get().routes())
 	{
-		for (auto tile : route.second.path)
+		for (auto tile : route.path)
 		{
 			const auto tilePosition = static_cast<Tile*>(tile)->xy();
-			renderer.drawPoint(tilePosition + miniMapOffset, NAS2D::Color::Magenta);
+			canvas.blend(tileToLayerPixel(tilePosition), NAS2D::Color::Magenta);
 		}
 	}
+}
+
 
+void MiniMap::drawRobotLayer(PixelCanvas& canvas) const
+{
 	for (auto robotEntry : mRobotList)
 	{
 		const auto robotPosition = robotEntry.second->xy();
-		renderer.drawPoint(robotPosition + miniMapOffset, NAS2D::Color::Cyan);
+		canvas.blend(tileToLayerPixel(robotPosition), NAS2D::Color::Cyan);
 	}
-
-	const auto& viewTileRect = mMapView.viewTileRect();
-	renderer.drawBox(viewTileRect.translate(miniMapOffset + NAS2D::Vector{1, 1}), NAS2D::Color{0, 0, 0, 180});
-	renderer.drawBox(viewTileRect.translate(miniMapOffset), NAS2D::Color::White);
-
-	renderer.clipRectClear();
 }
 
 
@@ -156,6 +228,39 @@ void MiniMap::onMouseMove(NAS2D::Point<int> position, NAS2D::Vector<int> /*relat
 
 void MiniMap::onSetView(NAS2D::Point<int> mousePixel)
 {
-	const auto position = NAS2D::Point{0, 0} + (mousePixel - mRect.position);
-	mMapView.centerOn(position);
+	mMapView.centerOn(pixelToTile(mousePixel));
+}
+
+
+/**
+ * Gets how many pixels of the minimap a tile takes up. The whole map is fit
+ * into the minimap's area without changing its aspect ratio.
+ */
+float MiniMap::scale() const
+{
+	const auto mapSize = mTileMap.size().to<float>();
+	const auto areaSize = mRect.size.to<float>();
+	return std::min(areaSize.x / mapSize.x, areaSize.y / mapSize.y);
+}
+
+
+NAS2D::Point<int> MiniMap::tileToPixel(NAS2D::Point<int> tilePosition) const
+{
+	return mRect.position + ((tilePosition - NAS2D::Point{0, 0}).to<float>() * scale()).to<int>();
+}
+
+
+NAS2D::Point<int> MiniMap::pixelToTile(NAS2D::Point<int> mousePixel) const
+{
+	return NAS2D::Point{0, 0} + ((mousePixel - mRect.position).to<float>() / scale()).to<int>();
+}
+
+
+/**
+ * Gets the position of a tile in the marker layers, which start at the top
+ * left corner of the minimap.
+ */
+NAS2D::Point<int> MiniMap::tileToLayerPixel(NAS2D::Point<int> tilePosition) const
+{
+	return NAS2D::Point{0, 0} + (tileToPixel(tilePosition) - mRect.position);
 }
@@ -8,8 +8,11 @@
 #include <NAS2D/Math/Point.h>
 #include <NAS2D/Math/Vector.h>
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 
 class Tile;
@@ -17,6 +20,7 @@ class TileMap;
 class MapView;
 class Robot;
 class MapViewState;
+class PixelCanvas;
 
 
 class MiniMap : public Control
@@ -27,6 +31,7 @@ public:
 	bool heightMapVisible() const;
 	void heightMapVisible(bool isVisible);
 
+	void update() override;
 	void draw() const override;
 
 protected:
@@ -38,6 +43,33 @@ protected:
 	void onSetView(NAS2D::Point<int> mousePixel);
 
 private:
+	/**
+	 * Markers drawn over the background, pre-rendered at the size of the
+	 * minimap. Redrawn only when the key, a summary of the data the markers
+	 * come from, changes.
+	 */
+	struct Layer
+	{
+		std::vector<std::uint64_t> key;
+		std::unique_ptr<NAS2D::Image> image;
+	};
+
+	using LayerDrawFunction = void (MiniMap::*)(PixelCanvas&) const;
+
+	void updateLayer(Layer& layer, std::vector<std::uint64_t> key, LayerDrawFunction drawLayer);
+
+	std::vector<std::uint64_t> mineLayerKey() const;
+
+	void drawStructureLayer(PixelCanvas& canvas) const;
+	void drawMineLayer(PixelCanvas& canvas) const;
+	void drawRouteLayer(PixelCanvas& canvas) const;
+	void drawRobotLayer(PixelCanvas& canvas) const;
+
+	float scale() const;
+	NAS2D::Point<int> tileToPixel(NAS2D::Point<int> tilePosition) const;
+	NAS2D::Point<int> pixelToTile(NAS2D::Point<int> mousePixel) const;
+	NAS2D::Point<int> tileToLayerPixel(NAS2D::Point<int> tilePosition) const;
+
 	MapView& mMapView;
 	TileMap& mTileMap;
 	const std::map<Robot*, Tile*>& mRobotList;
@@ -46,4 +78,9 @@ private:
 	NAS2D::Image mBackgroundHeightMap;
 	const NAS2D::Image& mUiIcons;
 	bool mLeftButtonDown{false};
+
+	Layer mStructureLayer; /**< Command centers, comm towers and their ranges. */
+	Layer mMineLayer;
+	Layer mRouteLayer; /**< Truck routes from mines to smelters. */
+	Layer mRobotLayer;
 };
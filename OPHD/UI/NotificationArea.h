@@ -2,7 +2,7 @@
 
 #include <libControls/Control.h>
 
-#include "../Map/MapCoordinate.h"
+#include "../Notification.h"
 
 #include <NAS2D/EventHandler.h>
 #include <NAS2D/Math/Point.h>
@@ -24,22 +24,8 @@ namespace NAS2D
 class NotificationArea : public Control
 {
 public:
-	enum class NotificationType
-	{
-		Critical,
-		Information,
-		Success,
-		Warning
-	};
-
-
-	struct Notification
-	{
-		std::string brief{""};
-		std::string message{""};
-		MapCoordinate position{{-1, -1}, 0};
-		NotificationType type{NotificationType::Information};
-	};
+	using NotificationType = ::NotificationType;
+	using Notification = ::Notification;
 
 	using NotificationClickedSignal = NAS2D::Signal<const Notification&>;
 
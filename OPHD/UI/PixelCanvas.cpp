@@ -0,0 +1,59 @@
+#include "PixelCanvas.h"
+
+#include <NAS2D/Resource/Image.h>
+#include <NAS2D/Math/PointInRectangleRange.h>
+
+
+PixelCanvas::PixelCanvas(NAS2D::Vector<int> size) :
+	mSize{size},
+	mPixels(static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y) * 4, 0)
+{}
+
+
+/**
+ * Draws a color over a pixel, leaving pixels outside of the canvas alone.
+ */
+void PixelCanvas::blend(NAS2D::Point<int> point, NAS2D::Color color)
+{
+	if (color.alpha == 0) { return; }
+	if (point.x < 0 || point.y < 0 || point.x >= mSize.x || point.y >= mSize.y) { return; }
+
+	auto* pixel = &mPixels[(static_cast<std::size_t>(point.y) * static_cast<std::size_t>(mSize.x) + static_cast<std::size_t>(point.x)) * 4];
+
+	const int destinationAlpha = pixel[3] * (255 - color.alpha) / 255;
+	const int alpha = color.alpha + destinationAlpha;
+	pixel[0] = static_cast<std::uint8_t>((color.red * color.alpha + pixel[0] * destinationAlpha) / alpha);
+	pixel[1] = static_cast<std::uint8_t>((color.green * color.alpha + pixel[1] * destinationAlpha) / alpha);
+	pixel[2] = static_cast<std::uint8_t>((color.blue * color.alpha + pixel[2] * destinationAlpha) / alpha);
+	pixel[3] = static_cast<std::uint8_t>(alpha);
+}
+
+
+void PixelCanvas::drawBoxFilled(const NAS2D::Rectangle<int>& rect, NAS2D::Color color)
+{
+	for (const auto point : NAS2D::PointInRectangleRange{rect})
+	{
+		blend(point, color);
+	}
+}
+
+
+/**
+ * Copies part of an image onto the canvas.
+ *
+ * \note	Reads the image a pixel at a time, so it is meant for small
+ *			images drawn when a canvas is rebuilt, not every frame.
+ */
+void PixelCanvas::drawSubImage(const NAS2D::Image& image, NAS2D::Point<int> position, const NAS2D::Rectangle<int>& subImageRect)
+{
+	for (const auto point : NAS2D::PointInRectangleRange{subImageRect})
+	{
+		blend(position + (point - subImageRect.position), image.pixelColor(point));
+	}
+}
+
+
+std::unique_ptr<NAS2D::Image> PixelCanvas::image()
+{
+	return std::make_unique<NAS2D::Image>(mPixels.data(), 4, mSize);
+}
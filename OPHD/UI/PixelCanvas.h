@@ -0,0 +1,42 @@
+#pragma once
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Rectangle.h>
+#include <NAS2D/Math/Vector.h>
+#include <NAS2D/Renderer/Color.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Image;
+}
+
+
+/**
+ * RGBA pixel buffer, drawn into on the CPU and then turned into an Image.
+ *
+ * Used to pre-render parts of the map that change rarely so they can be
+ * drawn with a single call instead of one call per tile or marker. Drawing
+ * blends over what is already there and clips to the canvas.
+ */
+class PixelCanvas
+{
+public:
+	explicit PixelCanvas(NAS2D::Vector<int> size);
+
+	NAS2D::Vector<int> size() const { return mSize; }
+
+	void blend(NAS2D::Point<int> point, NAS2D::Color color);
+	void drawBoxFilled(const NAS2D::Rectangle<int>& rect, NAS2D::Color color);
+	void drawSubImage(const NAS2D::Image& image, NAS2D::Point<int> position, const NAS2D::Rectangle<int>& subImageRect);
+
+	std::unique_ptr<NAS2D::Image> image();
+
+private:
+	NAS2D::Vector<int> mSize;
+	std::vector<std::uint8_t> mPixels;
+};
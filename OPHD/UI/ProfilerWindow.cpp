@@ -0,0 +1,169 @@
+#include "ProfilerWindow.h"
+
+#include "../Cache.h"
+#include "../Constants/UiConstants.h"
+
+#include <libOPHD/Profiler.h>
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+#include <NAS2D/Renderer/Renderer.h>
+
+#include <array>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr int IndentWidth = 12;
+
+
+	constexpr int FrameStatLines = 10;
+
+
+	std::string formatMilliseconds(Profiler::Clock::duration duration)
+	{
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(duration).count() << " ms";
+		return stream.str();
+	}
+}
+
+
+ProfilerWindow::ProfilerWindow() :
+	Window{"Turn Profile"},
+	mFont{fontCache.load(constants::FONT_PRIMARY, constants::FontPrimaryNormal)},
+	mFontBold{fontCache.load(constants::FONT_PRIMARY_BOLD, constants::FontPrimaryNormal)}
+{
+	size({360, 520});
+
+	add(btnSaveCsv, {5, 495});
+	btnSaveCsv.size({80, 20});
+
+	add(btnSaveTrace, {90, 495});
+	btnSaveTrace.size({80, 20});
+
+	add(btnClose, {295, 495});
+	btnClose.size({60, 20});
+}
+
+
+std::string ProfilerWindow::filePath(const std::string& extension) const
+{
+	return "turn_profile_" + std::to_string(mTurnNumber) + extension;
+}
+
+
+void ProfilerWindow::frameStats(const FrameScheduler::Stats& frameStats, const DetailMap::RenderStats& mapStats)
+{
+	mFrameStats = frameStats;
+	mMapStats = mapStats;
+}
+
+
+void ProfilerWindow::onSaveCsv()
+{
+	std::ostringstream stream;
+	profiler.writeCsv(stream);
+
+	const auto path = filePath(".csv");
+	Utility<Filesystem>::get().writeFile(path, stream.str());
+	mStatus = "Saved " + path;
+}
+
+
+void ProfilerWindow::onSaveTrace()
+{
+	std::ostringstream stream;
+	profiler.writeChromeTrace(stream);
+
+	const auto path = filePath(".json");
+	Utility<Filesystem>::get().writeFile(path, stream.str());
+	mStatus = "Saved " + path;
+}
+
+
+void ProfilerWindow::onClose()
+{
+	hide();
+}
+
+
+void ProfilerWindow::update()
+{
+	if (!visible()) { return; }
+
+	Window::update();
+
+	auto& renderer = Utility<Renderer>::get();
+
+	const auto left = position().x + 5;
+	const auto right = position().x + size().x - 5;
+	const auto statusY = position().y + 490 - mFont.height();
+	const auto frameY = statusY - (FrameStatLines + 1) * mFont.height();
+	const auto bottom = frameY - mFont.height();
+	auto y = position().y + sWindowTitleBarHeight + 5;
+
+	const std::array<std::pair<std::string, std::string>, FrameStatLines> frameLines{{
+		{"Frame Time", formatMilliseconds(mFrameStats.frameTime)},
+		{"Average Frame Time", formatMilliseconds(mFrameStats.averageFrameTime)},
+		{"Frames Per Second", std::to_string(mFrameStats.framesPerSecond)},
+		{"Idle", std::to_string(mFrameStats.idlePercent) + "%"},
+		{"Map Draw Time", formatMilliseconds(mMapStats.drawTime)},
+		{"Map Draw Calls", std::to_string(mMapStats.drawCalls)},
+		{"Terrain Layer Tiles", std::to_string(mMapStats.terrainTiles)},
+		{"Terrain Layer Rebuilds", std::to_string(mMapStats.layerRebuilds)},
+		{"LOD Chunk Images", std::to_string(mMapStats.lodChunkImages)},
+		{"LOD Chunk Builds", std::to_string(mMapStats.lodChunkBuilds)},
+	}};
+
+	auto frameLineY = frameY;
+	for (const auto& [name, value] : frameLines)
+	{
+		renderer.drawText(mFont, name, Point{left, frameLineY}, constants::PrimaryTextColor);
+		renderer.drawText(mFont, value, Point{right - mFont.width(value), frameLineY}, constants::PrimaryTextColor);
+		frameLineY += mFont.height();
+	}
+
+	if (!ProfilerEnabled)
+	{
+		renderer.drawText(mFont, "Profiling was disabled at compile time (OPHD_NO_PROFILER).", Point{left, y}, constants::PrimaryTextColor);
+		return;
+	}
+
+	renderer.drawText(mFontBold, "Turn " + std::to_string(mTurnNumber), Point{left, y}, constants::PrimaryTextColor);
+	y += mFontBold.height() + 2;
+
+	for (const auto& sample : profiler.samples())
+	{
+		if (y > bottom) { break; }
+
+		const auto& font = sample.depth == 0 ? mFontBold : mFont;
+		renderer.drawText(font, sample.name, Point{left + sample.depth * IndentWidth, y}, constants::PrimaryTextColor);
+
+		const auto time = formatMilliseconds(sample.duration);
+		renderer.drawText(font, time, Point{right - font.width(time), y}, constants::PrimaryTextColor);
+		y += font.height();
+	}
+
+	y += 4;
+	for (const auto& counter : profiler.counters())
+	{
+		if (y > bottom) { break; }
+
+		const auto value = std::to_string(counter.value);
+		renderer.drawText(mFont, counter.name, Point{left, y}, constants::PrimaryTextColor);
+		renderer.drawText(mFont, value, Point{right - mFont.width(value), y}, constants::PrimaryTextColor);
+		y += mFont.height();
+	}
+
+	if (!mStatus.empty())
+	{
+		renderer.drawText(mFont, mStatus, Point{left, statusY}, constants::PrimaryTextColor);
+	}
+}
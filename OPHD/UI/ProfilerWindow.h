@@ -0,0 +1,47 @@
+#pragma once
+
+#include "DetailMap.h"
+
+#include <libControls/Window.h>
+#include <libControls/Button.h>
+
+#include <libOPHD/FrameScheduler.h>
+
+#include <string>
+
+
+/**
+ * Debug window listing the timings and counters of the most recent turn,
+ * with buttons to save them to the pref path. Also shows frame timings and
+ * how much work drawing the map was.
+ */
+class ProfilerWindow : public Window
+{
+public:
+	ProfilerWindow();
+
+	void turnNumber(int turn) { mTurnNumber = turn; }
+	void frameStats(const FrameScheduler::Stats& frameStats, const DetailMap::RenderStats& mapStats);
+
+	void update() override;
+
+private:
+	void onSaveCsv();
+	void onSaveTrace();
+	void onClose();
+
+	std::string filePath(const std::string& extension) const;
+
+	const NAS2D::Font& mFont;
+	const NAS2D::Font& mFontBold;
+
+	Button btnSaveCsv{"Save CSV", {this, &ProfilerWindow::onSaveCsv}};
+	Button btnSaveTrace{"Save Trace", {this, &ProfilerWindow::onSaveTrace}};
+	Button btnClose{"Close", {this, &ProfilerWindow::onClose}};
+
+	int mTurnNumber{0};
+	std::string mStatus;
+
+	FrameScheduler::Stats mFrameStats;
+	DetailMap::RenderStats mMapStats;
+};
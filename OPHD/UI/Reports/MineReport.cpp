@@ -10,7 +10,7 @@
 #include "../../StructureManager.h"
 #include "../../ProductionCost.h"
 
-#include "../../States/Route.h"
+#include "../../States/RouteCache.h"
 
 #include "../../MapObjects/Structures/MineFacility.h"
 
@@ -432,8 +432,7 @@ void MineReport::drawTruckMangementPane(const NAS2D::Point<int>& origin)
 	drawLabelAndValueRightJustify(origin + NAS2D::Vector{0, 30}, labelWidth, "Trucks Assigned to Facility", std::to_string(miningFacility->assignedTrucks()), constants::PrimaryTextColor);
 	drawLabelAndValueRightJustify(origin + NAS2D::Vector{0, 45}, labelWidth, "Trucks Available in Storage", std::to_string(mAvailableTrucks), constants::PrimaryTextColor);
 
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
-	bool routeAvailable = routeTable.find(miningFacility) != routeTable.end();
+	bool routeAvailable = NAS2D::Utility<RouteCache>::get().contains(miningFacility);
 
 	if (miningFacility->operational() || miningFacility->isIdle())
 	{
@@ -454,10 +453,9 @@ void MineReport::drawTruckMangementPane(const NAS2D::Point<int>& origin)
 void MineReport::drawTruckHaulInfo(const NAS2D::Point<int>& origin)
 {
 	auto& r = Utility<Renderer>::get();
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
 	const auto mFacility = static_cast<MineFacility*>(mSelectedFacility);
 
-	auto& route = routeTable[mFacility];
+	const auto& route = NAS2D::Utility<RouteCache>::get().at(mFacility);
 	drawLabelAndValueRightJustify(origin,
 		btnAddTruck.positionX() - origin.x - 10,
 		"Route Cost",
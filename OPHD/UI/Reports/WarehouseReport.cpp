@@ -85,23 +85,11 @@ WarehouseReport::~WarehouseReport()
 
 void WarehouseReport::computeTotalWarehouseCapacity()
 {
-	int capacityTotal = 0;
-	int capacityAvailable = 0;
+	const auto& productInventory = Utility<StructureManager>::get().productInventory();
 
-	const auto& warehouses = Utility<StructureManager>::get().getStructures<Warehouse>();
-	for (auto* warehouse : warehouses)
-	{
-		if (warehouse->operational())
-		{
-			const auto& warehouseProducts = warehouse->products();
-			capacityAvailable += warehouseProducts.availableStorage();
-			capacityTotal += warehouseProducts.capacity();
-		}
-	}
-
-	warehouseCount = warehouses.size();
-	warehouseCapacityTotal = capacityTotal;
-	warehouseCapacityUsed = capacityTotal - capacityAvailable;
+	warehouseCount = productInventory.warehouseCount();
+	warehouseCapacityTotal = productInventory.capacity();
+	warehouseCapacityUsed = productInventory.capacity() - productInventory.availableStorage();
 }
 
 
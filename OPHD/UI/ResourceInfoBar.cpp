@@ -138,6 +138,7 @@ void ResourceInfoBar::draw() const
 
 	const auto glowIntensity = calcGlowIntensity();
 	const auto glowColor = NAS2D::Color{255, glowIntensity, glowIntensity};
+	mGlowing = false;
 
 	constexpr auto iconSize = constants::ResourceIconSize;
 	const std::array resources
@@ -151,7 +152,9 @@ void ResourceInfoBar::draw() const
 	for (const auto& [imageRect, amount, spacing] : resources)
 	{
 		renderer.drawSubImage(mUiIcons, position, imageRect);
-		const auto color = (amount <= 10 && !mIgnoreGlow) ? glowColor : NAS2D::Color::White;
+		const auto isGlowing = amount <= 10 && !mIgnoreGlow;
+		mGlowing = mGlowing || isGlowing;
+		const auto color = isGlowing ? glowColor : NAS2D::Color::White;
 		renderer.drawText(*MAIN_FONT, std::to_string(amount), position + textOffset, color);
 		position.x += spacing;
 	}
@@ -169,7 +172,9 @@ void ResourceInfoBar::draw() const
 	for (const auto& [imageRect, parts, total, isHighlighted] : storageCapacities)
 	{
 		renderer.drawSubImage(mUiIcons, position, imageRect);
-		const auto color = (isHighlighted  && !mIgnoreGlow) ? glowColor : NAS2D::Color::White;
+		const auto isGlowing = isHighlighted && !mIgnoreGlow;
+		mGlowing = mGlowing || isGlowing;
+		const auto color = isGlowing ? glowColor : NAS2D::Color::White;
 		const auto text = std::to_string(parts) + "/" + std::to_string(total);
 		renderer.drawText(*MAIN_FONT, text, position + textOffset, color);
 		position.x += (x + offsetX) * 2;
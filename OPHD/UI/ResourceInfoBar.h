@@ -24,6 +24,7 @@ public:
 	bool isPopulationPanelVisible() const;
 
 	void ignoreGlow(const bool ignore);
+	bool glowing() const { return mGlowing; }
 
 	void update() override;
 	void draw() const override;
@@ -53,4 +54,5 @@ private:
 	bool mPinResourcePanel = false;
 	bool mPinPopulationPanel = false;
 	bool mIgnoreGlow = false;
+	mutable bool mGlowing = false; /**< A low amount was glowing when last drawn. */
 };
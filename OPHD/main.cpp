@@ -2,6 +2,7 @@
 #include "Common.h"
 #include "Constants/Strings.h"
 #include "Constants/Numbers.h"
+#include "Savegame.h"
 #include "WindowEventWrapper.h"
 
 #include "States/GameState.h"
@@ -12,6 +13,8 @@
 
 #include "UI/MessageBox.h"
 
+#include <libOPHD/FrameScheduler.h>
+
 #include <NAS2D/Utility.h>
 #include <NAS2D/Filesystem.h>
 #include <NAS2D/EventHandler.h>
@@ -24,8 +27,10 @@
 
 #include <SDL2/SDL.h>
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 
 using namespace NAS2D;
@@ -47,6 +52,23 @@ namespace {
 			std::cout << "\t" << str << std::endl;
 		}
 	}
+
+
+	/**
+	 * Sleeps until the frame cap allows another frame, then until the next
+	 * frame is due or an event arrives, whichever comes first.
+	 */
+	void waitForFrame(const FrameScheduler& frameScheduler)
+	{
+		std::this_thread::sleep_until(frameScheduler.earliestFrameTime());
+
+		const auto due = frameScheduler.nextFrameTime();
+		for (auto now = FrameScheduler::Clock::now(); now < due; now = FrameScheduler::Clock::now())
+		{
+			const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(due - now);
+			if (SDL_WaitEventTimeout(nullptr, static_cast<int>(timeout.count())) == 1) { return; }
+		}
+	}
 }
 
 
@@ -82,7 +104,8 @@ int main(int argc, char *argv[])
 						{"screenheight", constants::MinimumWindowSize.y},
 						{"bitdepth", 32},
 						{"fullscreen", false},
-						{"vsync", true}
+						{"vsync", true},
+						{"framecap", 60}
 					}}
 				},
 				{
@@ -100,7 +123,8 @@ int main(int argc, char *argv[])
 					"options",
 					{{
 						{"skip-splash", false},
-						{"maximized", true}
+						{"maximized", true},
+						{"save_as_xml", false}
 					}}
 				}
 			}
@@ -157,7 +181,7 @@ int main(int argc, char *argv[])
 
 		if (argc > 1)
 		{
-			std::string filename = constants::SaveGamePath + argv[1] + ".xml";
+			std::string filename = findSavegame(argv[1]);
 			if (!filesystem.exists(filename))
 			{
 				std::cout << "Savegame specified on command line: " << argv[1] << " could not be found." << std::endl;
@@ -183,10 +207,17 @@ int main(int argc, char *argv[])
 			stateManager.setState(new MainMenuState());
 		}
 
+		auto& frameScheduler = Utility<FrameScheduler>::init(graphics.get<int>("framecap"));
+
 		// Game Loop
+		frameScheduler.beginFrame(FrameScheduler::Clock::now());
 		while (stateManager.update())
 		{
 			renderer.update();
+			frameScheduler.endFrame(FrameScheduler::Clock::now());
+
+			waitForFrame(frameScheduler);
+			frameScheduler.beginFrame(FrameScheduler::Clock::now());
 		}
 
 		cf.save("config.xml"); // force configuration to save any changes.
@@ -202,6 +233,7 @@ int main(int argc, char *argv[])
 	Utility<EventHandler>::clear();
 	std::cout << "EventHandler Terminated." << std::endl;
 	Utility<Mixer>::clear();
+	Utility<FrameScheduler>::clear();
 	Utility<Configuration>::clear();
 	Utility<Filesystem>::clear();
 
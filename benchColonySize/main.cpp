@@ -0,0 +1,299 @@
+// ==================================================================================
+// = Colony size benchmark. Builds synthetic colonies of 100, 1,000 and 10,000
+// = structures on the first shipped planet and reports how long nextTurn() takes
+// = for each. Runs headless, like benchTurns, so no savegame is needed.
+// =
+// = Each colony starts from a deployed SEED Lander. A grid of tube rows runs from
+// = it, with a row of structures on either side of every tube row, so everything
+// = is connected to the command center. The structure mix is repeated across the
+// = grid and the colony is given a population in proportion to its size.
+// = Placement rules are not applied: every structure is built on the surface.
+// =
+// = Turns are only timed once every structure has finished construction.
+// =
+// = Usage: benchColonySize [turns]
+// ==================================================================================
+
+#include "OPHD/ColonySimulation.h"
+#include "OPHD/ProductCatalogue.h"
+#include "OPHD/StructureCatalogue.h"
+#include "OPHD/StructureManager.h"
+#include "OPHD/Map/Tile.h"
+#include "OPHD/Map/TileMap.h"
+#include "OPHD/MapObjects/StructureType.h"
+#include "OPHD/States/MapViewStateHelper.h"
+#include "OPHD/States/Planet.h"
+
+#include <libOPHD/Population/PopulationTable.h>
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	constexpr auto ColonySizes = std::array{100, 1000, 10000};
+
+	constexpr NAS2D::Point<int> LanderPosition{3, 3};
+
+	// Roughly the make up of a grown colony; repeated across the grid
+	constexpr std::array StructureMix{
+		StructureID::SID_RESIDENCE,
+		StructureID::SID_RESIDENCE,
+		StructureID::SID_RESIDENCE,
+		StructureID::SID_AGRIDOME,
+		StructureID::SID_AGRIDOME,
+		StructureID::SID_FUSION_REACTOR,
+		StructureID::SID_STORAGE_TANKS,
+		StructureID::SID_WAREHOUSE,
+		StructureID::SID_LABORATORY,
+		StructureID::SID_MEDICAL_CENTER,
+		StructureID::SID_COMMERCIAL,
+		StructureID::SID_PARK,
+		StructureID::SID_RECREATION_CENTER,
+		StructureID::SID_NURSERY,
+		StructureID::SID_UNIVERSITY,
+		StructureID::SID_SURFACE_POLICE,
+		StructureID::SID_SURFACE_FACTORY,
+		StructureID::SID_CHAP,
+		StructureID::SID_RECYCLING,
+		StructureID::SID_MAINTENANCE_FACILITY,
+	};
+
+	// Population added per structure
+	constexpr PopulationTable PopulationPerStructure{1, 1, 2, 1, 0};
+
+
+	struct ColonyResults
+	{
+		int structures{0};
+		int tubes{0};
+		NAS2D::Vector<int> mapSize{0, 0};
+		std::chrono::nanoseconds buildTime{0};
+		std::chrono::nanoseconds totalTurnTime{0};
+		std::chrono::nanoseconds maxTurnTime{0};
+		int turns{0};
+	};
+
+
+	double toMilliseconds(std::chrono::nanoseconds duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+
+	int gridColumns(int structureCount)
+	{
+		return static_cast<int>(std::ceil(std::sqrt(static_cast<double>(structureCount))));
+	}
+
+
+	/**
+	 * Tube rows needed to fit the structures, with some room for the tiles
+	 * that are skipped because they hold a mine.
+	 */
+	int gridTubeRows(int structureCount)
+	{
+		const auto columns = gridColumns(structureCount);
+		return (structureCount + structureCount / 10 + 2 * columns - 1) / (2 * columns);
+	}
+
+
+	NAS2D::Vector<int> requiredMapSize(int structureCount)
+	{
+		return {
+			LanderPosition.x + 4 + gridColumns(structureCount) + 1,
+			LanderPosition.y + 3 * gridTubeRows(structureCount) + 1,
+		};
+	}
+
+
+	void addTube(ColonySimulation& simulation, NAS2D::Point<int> position)
+	{
+		auto& tile = simulation.tileMap().getTile({position, 0});
+		if (!tile.empty()) { return; }
+
+		tile.index(TerrainType::Dozed);
+		simulation.addTube(ConnectorDir::CONNECTOR_INTERSECTION, tile);
+	}
+
+
+	/**
+	 * Lays the tube grid east and south of the SEED Lander and fills both sides
+	 * of every tube row with structures from StructureMix.
+	 *
+	 * \return	Number of tubes placed.
+	 */
+	int buildColony(ColonySimulation& simulation, int structureCount)
+	{
+		const auto columns = gridColumns(structureCount);
+		const auto tubeRows = gridTubeRows(structureCount);
+		const NAS2D::Point<int> origin{LanderPosition.x + 3, LanderPosition.y};
+
+		auto& structureManager = NAS2D::Utility<StructureManager>::get();
+		const auto tubesBefore = structureManager.count();
+
+		// Link the grid to the tube east of the SEED Lander
+		addTube(simulation, {LanderPosition.x + 2, LanderPosition.y});
+
+		int placed = 0;
+		for (int row = 0; row < tubeRows && placed < structureCount; ++row)
+		{
+			const auto y = origin.y + 3 * row;
+
+			// Joins this tube row to the one above
+			if (row > 0)
+			{
+				addTube(simulation, {origin.x, y - 2});
+				addTube(simulation, {origin.x, y - 1});
+			}
+
+			for (int x = origin.x; x <= origin.x + columns; ++x)
+			{
+				addTube(simulation, {x, y});
+			}
+
+			for (const auto structureY : {y - 1, y + 1})
+			{
+				for (int x = origin.x + 1; x <= origin.x + columns && placed < structureCount; ++x)
+				{
+					auto& tile = simulation.tileMap().getTile({{x, structureY}, 0});
+					if (tile.hasMine() || !tile.empty()) { continue; }
+
+					tile.index(TerrainType::Dozed);
+					simulation.addStructure(StructureMix[static_cast<std::size_t>(placed) % StructureMix.size()], tile);
+					++placed;
+				}
+			}
+		}
+
+		if (placed < structureCount)
+		{
+			throw std::runtime_error("Not enough room on the map for " + std::to_string(structureCount) + " structures");
+		}
+
+		return structureManager.count() - tubesBefore - placed;
+	}
+
+
+	int constructionTurns()
+	{
+		int turns = 0;
+		for (const auto structureId : StructureMix)
+		{
+			turns = std::max(turns, StructureCatalogue::getType(structureId).turnsToBuild);
+		}
+		return turns + 1;
+	}
+
+
+	ColonyResults benchmarkColony(Planet::Attributes attributes, int structureCount, int turns)
+	{
+		const auto requiredSize = requiredMapSize(structureCount);
+		attributes.mapSize = {std::max(attributes.mapSize.x, requiredSize.x), std::max(attributes.mapSize.y, requiredSize.y)};
+
+		ColonyResults results;
+		results.structures = structureCount;
+
+		const auto buildStart = std::chrono::steady_clock::now();
+
+		ColonySimulation simulation{attributes, Difficulty::Medium, 1};
+		results.mapSize = simulation.tileMap().size();
+
+		simulation.addSeedLander(LanderPosition);
+		for (int turn = 0; ccLocation() == CcNotPlaced; ++turn)
+		{
+			if (turn > 10) { throw std::runtime_error("SEED Lander did not deploy"); }
+			simulation.nextTurn();
+		}
+
+		results.tubes = buildColony(simulation, structureCount);
+
+		PopulationTable population;
+		for (int i = 0; i < structureCount; ++i) { population += PopulationPerStructure; }
+		simulation.population().addPopulation(population);
+
+		for (int turn = 0; turn < constructionTurns(); ++turn)
+		{
+			simulation.nextTurn();
+		}
+
+		results.buildTime = std::chrono::steady_clock::now() - buildStart;
+
+		for (; results.turns < turns && !simulation.isGameOver(); ++results.turns)
+		{
+			const auto turnStart = std::chrono::steady_clock::now();
+			simulation.nextTurn();
+			const auto turnTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - turnStart);
+
+			results.totalTurnTime += turnTime;
+			results.maxTurnTime = std::max(results.maxTurnTime, turnTime);
+		}
+
+		NAS2D::Utility<StructureManager>::get().dropAllStructures();
+
+		return results;
+	}
+
+
+	void printResults(const ColonyResults& results)
+	{
+		std::cout << std::right << std::setw(12) << results.structures
+			<< std::setw(8) << results.tubes
+			<< std::setw(12) << (std::to_string(results.mapSize.x) + "x" + std::to_string(results.mapSize.y))
+			<< std::fixed << std::setprecision(3)
+			<< std::setw(14) << toMilliseconds(results.buildTime)
+			<< std::setw(8) << results.turns
+			<< std::setw(12) << (results.turns > 0 ? toMilliseconds(results.totalTurnTime) / results.turns : 0.0)
+			<< std::setw(12) << toMilliseconds(results.maxTurnTime) << std::endl;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	const int turns = argc > 1 ? std::max(1, std::stoi(argv[1])) : 20;
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>("OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() / "data");
+
+		StructureCatalogue::init();
+		ProductCatalogue::init("factory_products.xml");
+
+		const auto planets = parsePlanetAttributes();
+		if (planets.empty()) { throw std::runtime_error("No planets found"); }
+
+		std::cout << "Planet: " << planets.front().name << std::endl << std::endl;
+		std::cout << std::right << std::setw(12) << "structures"
+			<< std::setw(8) << "tubes"
+			<< std::setw(12) << "map"
+			<< std::setw(14) << "build (ms)"
+			<< std::setw(8) << "turns"
+			<< std::setw(12) << "mean (ms)"
+			<< std::setw(12) << "max (ms)" << std::endl;
+
+		for (const auto structureCount : ColonySizes)
+		{
+			printResults(benchmarkColony(planets.front(), structureCount, turns));
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,204 @@
+// ==================================================================================
+// = Map size benchmark. For every shipped planet, starts a new game on the planet's
+// = own site and on sites with 4x and 16x its area, then reports how long starting
+// = the game, running turns, saving and loading took. Finishes with a site on the
+// = first planet at the largest size the game targets, 2048x2048.
+// =
+// = No colony is founded, so turn times only cover the work that grows with the
+// = size of the map rather than with the size of the colony.
+// =
+// = Before saving, a tile on the deepest level and a surface tile are dug out and
+// = dozed in the far corner of the map. Each save is loaded back and checked for
+// = the map size and those tiles; any failure stops the benchmark with an error.
+// =
+// = Usage: benchMapSize [turns]
+// ==================================================================================
+
+#include "OPHD/ColonySimulation.h"
+#include "OPHD/ProductCatalogue.h"
+#include "OPHD/Savegame.h"
+#include "OPHD/StructureCatalogue.h"
+#include "OPHD/Map/TileMap.h"
+#include "OPHD/States/Planet.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace
+{
+	// Scale applied to each side of the map; 4x and 16x the area
+	constexpr auto SideScales = std::array{1, 2, 4};
+
+	// Largest site the game is meant to handle
+	constexpr NAS2D::Vector<int> TargetMapSize{2048, 2048};
+
+
+	struct SiteResults
+	{
+		NAS2D::Vector<int> size{0, 0};
+		std::chrono::nanoseconds newGameTime{0};
+		std::chrono::nanoseconds turnTime{0};
+		std::chrono::nanoseconds saveTime{0};
+		std::chrono::nanoseconds loadTime{0};
+		std::size_t saveBytes{0};
+	};
+
+
+	double toMilliseconds(std::chrono::nanoseconds duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+
+	/**
+	 * Dozes the surface tile and digs out the deepest tile in the far corner
+	 * of the map, so the save has tiles to restore on every level.
+	 */
+	void markFarCorner(TileMap& tileMap)
+	{
+		const auto corner = NAS2D::Point{tileMap.size().x - 1, tileMap.size().y - 1};
+
+		tileMap.getTile({corner, 0}).index(TerrainType::Dozed);
+
+		auto& deepest = tileMap.getTile({corner, tileMap.maxDepth()});
+		deepest.index(TerrainType::Dozed);
+		deepest.excavated(true);
+	}
+
+
+	void checkLoadedSite(const TileMap& tileMap, NAS2D::Vector<int> expectedSize, const std::string& name)
+	{
+		const auto size = tileMap.size();
+		if (size != expectedSize)
+		{
+			throw std::runtime_error("Loaded site '" + name + "' is " + std::to_string(size.x) + "x" + std::to_string(size.y) +
+				", expected " + std::to_string(expectedSize.x) + "x" + std::to_string(expectedSize.y));
+		}
+
+		const auto corner = NAS2D::Point{size.x - 1, size.y - 1};
+		const auto& surface = tileMap.getTile({corner, 0});
+		const auto& deepest = tileMap.getTile({corner, tileMap.maxDepth()});
+		if (surface.index() != TerrainType::Dozed || !deepest.excavated() || deepest.index() != TerrainType::Dozed)
+		{
+			throw std::runtime_error("Loaded site '" + name + "' lost the tiles dug out before saving");
+		}
+	}
+
+
+	SiteResults benchmarkSite(const Planet::Attributes& attributes, int turns)
+	{
+		SiteResults results;
+		std::string saveData;
+
+		{
+			const auto newGameStart = std::chrono::steady_clock::now();
+			ColonySimulation simulation{attributes, Difficulty::Medium, 1};
+			results.newGameTime = std::chrono::steady_clock::now() - newGameStart;
+			results.size = simulation.tileMap().size();
+
+			for (int turn = 0; turn < turns; ++turn)
+			{
+				const auto turnStart = std::chrono::steady_clock::now();
+				simulation.nextTurn();
+				results.turnTime += std::chrono::steady_clock::now() - turnStart;
+			}
+
+			markFarCorner(simulation.tileMap());
+
+			const auto saveStart = std::chrono::steady_clock::now();
+			SavegameWriter savegame;
+			simulation.serialize(savegame);
+			savegame.finish();
+			results.saveTime = std::chrono::steady_clock::now() - saveStart;
+			results.saveBytes = savegame.buffer().size();
+			saveData = savegame.buffer();
+		}
+
+		const auto loadStart = std::chrono::steady_clock::now();
+		SavegameReader savegame{saveData, attributes.name};
+		ColonySimulation loaded;
+		loaded.load(savegame);
+		results.loadTime = std::chrono::steady_clock::now() - loadStart;
+
+		checkLoadedSite(std::as_const(loaded).tileMap(), results.size, attributes.name);
+
+		return results;
+	}
+
+
+	void printResults(const std::string& name, const std::string& area, const SiteResults& results, int turns)
+	{
+		std::cout << std::left << std::setw(12) << name
+			<< std::right << std::setw(8) << area
+			<< std::setw(12) << (std::to_string(results.size.x) + "x" + std::to_string(results.size.y))
+			<< std::fixed << std::setprecision(3)
+			<< std::setw(16) << toMilliseconds(results.newGameTime)
+			<< std::setw(12) << toMilliseconds(results.turnTime) / turns
+			<< std::setw(12) << toMilliseconds(results.saveTime)
+			<< std::setw(12) << toMilliseconds(results.loadTime)
+			<< std::setw(12) << results.saveBytes / 1024 << std::endl;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	const int turns = argc > 1 ? std::max(1, std::stoi(argv[1])) : 10;
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>("OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() / "data");
+
+		StructureCatalogue::init();
+		ProductCatalogue::init("factory_products.xml");
+
+		std::cout << std::left << std::setw(12) << "Map"
+			<< std::right << std::setw(8) << "area"
+			<< std::setw(12) << "size"
+			<< std::setw(16) << "new game (ms)"
+			<< std::setw(12) << "turn (ms)"
+			<< std::setw(12) << "save (ms)"
+			<< std::setw(12) << "load (ms)"
+			<< std::setw(12) << "save (KB)" << std::endl;
+
+		const auto planets = parsePlanetAttributes();
+		if (planets.empty()) { throw std::runtime_error("No planets found"); }
+
+		for (auto attributes : planets)
+		{
+			auto baseSize = attributes.mapSize;
+			for (const auto sideScale : SideScales)
+			{
+				attributes.mapSize = baseSize * sideScale;
+
+				const auto results = benchmarkSite(attributes, turns);
+				if (sideScale == 1) { baseSize = results.size; }
+
+				printResults(attributes.name, std::to_string(sideScale * sideScale) + "x", results, turns);
+			}
+		}
+
+		auto target = planets.front();
+		target.mapSize = TargetMapSize;
+		printResults(target.name, "target", benchmarkSite(target, turns), turns);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
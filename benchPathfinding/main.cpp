@@ -0,0 +1,287 @@
+// ==================================================================================
+// = Pathfinding benchmark. For every shipped planet map, solves the same set of
+// = routes between mine locations with MicroPather (as OPHD used to) and with
+// = GridPathFinder, and reports timings and how the path costs compare.
+// =
+// = GridPathFinder's costs are checked against a plain Dijkstra search written here,
+// = which reads tile costs straight from the TileMap and shares no code with
+// = GridPathFinder, and each path it returns is walked to check that its steps
+// = are adjacent and add up to its cost. Its costs must never be higher than
+// = MicroPather's; MicroPather's straight line distance heuristic can
+// = overestimate once roads make steps cheaper than 1.0, in which case its paths
+// = are not always the cheapest.
+// =
+// = Usage: benchPathfinding [routes per map]
+// ==================================================================================
+
+#include "OPHD/MicroPather/micropather.h"
+#include "OPHD/Map/Tile.h"
+#include "OPHD/Map/TileMap.h"
+#include "OPHD/States/Planet.h"
+
+#include <libOPHD/Map/GridPathFinder.h>
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	constexpr float CostTolerance = 0.001f;
+
+	constexpr auto Offsets = std::array{NAS2D::Vector{0, -1}, NAS2D::Vector{1, 0}, NAS2D::Vector{0, 1}, NAS2D::Vector{-1, 0}};
+
+
+	/**
+	 * The MicroPather graph TileMap used to implement.
+	 */
+	class TileMapGraph : public micropather::Graph
+	{
+	public:
+		TileMapGraph(TileMap& tileMap) : mTileMap{tileMap} {}
+
+		float LeastCostEstimate(void* stateStart, void* stateEnd) override
+		{
+			return std::sqrt(static_cast<float>((static_cast<Tile*>(stateEnd)->xy() - static_cast<Tile*>(stateStart)->xy()).lengthSquared()));
+		}
+
+		void AdjacentCost(void* state, std::vector<micropather::StateCost>* adjacent) override
+		{
+			const auto position = static_cast<Tile*>(state)->xy();
+
+			for (const auto offset : Offsets)
+			{
+				const auto adjacentPosition = position + offset;
+				if (!mTileMap.isValidPosition({adjacentPosition, 0})) { continue; }
+
+				auto& adjacentTile = mTileMap.getTile({adjacentPosition, 0});
+				adjacent->push_back({&adjacentTile, adjacentTile.movementCost()});
+			}
+		}
+
+		void PrintStateInfo(void* /*state*/) override {}
+
+	private:
+		TileMap& mTileMap;
+	};
+
+
+	/**
+	 * Cheapest cost from start to goal found by a textbook Dijkstra search over
+	 * the surface, or nothing if goal can't be reached.
+	 */
+	std::optional<float> referenceCost(const TileMap& tileMap, NAS2D::Point<int> start, NAS2D::Point<int> goal)
+	{
+		const auto size = tileMap.size();
+		const auto indexOf = [size](NAS2D::Point<int> point) { return static_cast<std::size_t>(point.y * size.x + point.x); };
+
+		std::vector<float> costs(static_cast<std::size_t>(size.x * size.y), std::numeric_limits<float>::infinity());
+		using QueueEntry = std::pair<float, NAS2D::Point<int>>;
+		const auto greater = [](const QueueEntry& a, const QueueEntry& b) { return a.first > b.first; };
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, decltype(greater)> queue{greater};
+
+		costs[indexOf(start)] = 0.0f;
+		queue.push({0.0f, start});
+
+		while (!queue.empty())
+		{
+			const auto [cost, position] = queue.top();
+			queue.pop();
+
+			if (position == goal) { return cost; }
+			if (cost > costs[indexOf(position)]) { continue; }
+
+			for (const auto offset : Offsets)
+			{
+				const auto next = position + offset;
+				if (!tileMap.isValidPosition({next, 0})) { continue; }
+
+				const auto stepCost = tileMap.getTile({next, 0}).movementCost();
+				if (stepCost == GridPathFinder::Impassable) { continue; }
+
+				const auto nextCost = cost + stepCost;
+				if (nextCost < costs[indexOf(next)])
+				{
+					costs[indexOf(next)] = nextCost;
+					queue.push({nextCost, next});
+				}
+			}
+		}
+
+		return std::nullopt;
+	}
+
+
+	/**
+	 * Checks that a path runs from start to goal in single orthogonal steps
+	 * over passable tiles, and that the cost of those steps is its cost.
+	 */
+	bool isValidPath(const TileMap& tileMap, const GridPath& path, NAS2D::Point<int> start, NAS2D::Point<int> goal)
+	{
+		if (path.points.front() != start || path.points.back() != goal) { return false; }
+
+		float cost = 0.0f;
+		for (std::size_t i = 1; i < path.points.size(); ++i)
+		{
+			const auto step = path.points[i] - path.points[i - 1];
+			if (std::abs(step.x) + std::abs(step.y) != 1) { return false; }
+
+			const auto stepCost = tileMap.getTile({path.points[i], 0}).movementCost();
+			if (stepCost == GridPathFinder::Impassable) { return false; }
+			cost += stepCost;
+		}
+
+		return std::abs(cost - path.cost) <= CostTolerance;
+	}
+
+
+	struct MapResults
+	{
+		int routes{0};
+		int solved{0};
+		int matchingMicroPather{0};
+		int cheaperThanMicroPather{0};
+		int errors{0};
+		std::chrono::nanoseconds microPatherTime{0};
+		std::chrono::nanoseconds gridTime{0};
+	};
+
+
+	double toMilliseconds(std::chrono::nanoseconds duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+
+	MapResults benchmarkMap(const Planet::Attributes& attributes, int routeCount)
+	{
+		TileMap tileMap{attributes.mapImagePath, attributes.mapSize, attributes.maxDepth, attributes.maxMines, {1, 1, 1}};
+		const auto& mineLocations = tileMap.mineLocations();
+
+		TileMapGraph graph{tileMap};
+		micropather::MicroPather microPather{&graph, 250, 6, false};
+		GridPathFinder gridPathFinder{tileMap.size(), tileMap.movementCosts()};
+
+		// Fixed seed so every run and every pathfinder solves the same routes
+		std::mt19937 generator{1};
+		std::uniform_int_distribution<std::size_t> pickMine{0, mineLocations.size() - 1};
+
+		MapResults results;
+		for (; results.routes < routeCount && mineLocations.size() > 1; ++results.routes)
+		{
+			const auto start = mineLocations[pickMine(generator)];
+			const auto end = mineLocations[pickMine(generator)];
+
+			std::vector<void*> microPatherPath;
+			float microPatherCost = 0.0f;
+			const auto microPatherStart = std::chrono::steady_clock::now();
+			microPather.Reset();
+			const auto result = microPather.Solve(&tileMap.getTile({start, 0}), &tileMap.getTile({end, 0}), &microPatherPath, &microPatherCost);
+			results.microPatherTime += std::chrono::steady_clock::now() - microPatherStart;
+
+			const auto gridStart = std::chrono::steady_clock::now();
+			const auto gridPath = gridPathFinder.findPath(start, end);
+			results.gridTime += std::chrono::steady_clock::now() - gridStart;
+
+			const auto reference = referenceCost(tileMap, start, end);
+
+			const auto microPatherSolved = result != micropather::MicroPather::NO_SOLUTION;
+			if (result == micropather::MicroPather::START_END_SAME) { microPatherCost = 0.0f; }
+
+			if (microPatherSolved != !gridPath.empty() || gridPath.empty() != !reference)
+			{
+				++results.errors;
+				continue;
+			}
+
+			if (gridPath.empty()) { continue; }
+			++results.solved;
+
+			if (!isValidPath(tileMap, gridPath, start, end) || std::abs(gridPath.cost - *reference) > CostTolerance || gridPath.cost > microPatherCost + CostTolerance)
+			{
+				++results.errors;
+			}
+			else if (std::abs(gridPath.cost - microPatherCost) <= CostTolerance)
+			{
+				++results.matchingMicroPather;
+			}
+			else
+			{
+				++results.cheaperThanMicroPather;
+			}
+		}
+
+		return results;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	const int routeCount = argc > 1 ? std::max(1, std::stoi(argv[1])) : 200;
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>("OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() / "data");
+
+		std::cout << std::left << std::setw(12) << "Map"
+			<< std::right << std::setw(8) << "routes"
+			<< std::setw(8) << "solved"
+			<< std::setw(8) << "match"
+			<< std::setw(9) << "cheaper"
+			<< std::setw(8) << "errors"
+			<< std::setw(18) << "MicroPather (ms)"
+			<< std::setw(11) << "Grid (ms)"
+			<< std::setw(10) << "speedup" << std::endl;
+
+		int totalErrors = 0;
+		for (const auto& attributes : parsePlanetAttributes())
+		{
+			const auto results = benchmarkMap(attributes, routeCount);
+			totalErrors += results.errors;
+
+			const auto microPatherMs = toMilliseconds(results.microPatherTime);
+			const auto gridMs = toMilliseconds(results.gridTime);
+
+			std::cout << std::left << std::setw(12) << attributes.name
+				<< std::right << std::setw(8) << results.routes
+				<< std::setw(8) << results.solved
+				<< std::setw(8) << results.matchingMicroPather
+				<< std::setw(9) << results.cheaperThanMicroPather
+				<< std::setw(8) << results.errors
+				<< std::fixed << std::setprecision(3)
+				<< std::setw(18) << microPatherMs
+				<< std::setw(11) << gridMs
+				<< std::setw(9) << std::setprecision(1) << (gridMs > 0.0 ? microPatherMs / gridMs : 0.0) << "x" << std::endl;
+		}
+
+		if (totalErrors > 0)
+		{
+			std::cerr << std::endl << totalErrors << " routes had mismatched reachability or costs" << std::endl;
+			return 1;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+// ==================================================================================
+// = Tile query benchmark. Compares looking up the Structure on a tile with a
+// = dynamic_cast, as Tile used to, against the kind tag Tile now checks.
+// =
+// = For every shipped planet map, the surface is covered with a grid of roads and
+// = two workloads are timed with each lookup:
+// =
+// =	- A connectedness walk: a flood fill across every tile holding a structure,
+// =	  as walkGraph does from the command centers.
+// =	- A route solve: gathering the movement cost of every surface tile, the same
+// =	  way Tile::movementCost does, followed by a GridPathFinder search from one
+// =	  corner of the road grid to the other.
+// =
+// = Usage: benchTileQueries [iterations per map]
+// ==================================================================================
+
+#include "OPHD/StructureCatalogue.h"
+#include "OPHD/Constants/Numbers.h"
+#include "OPHD/Map/Tile.h"
+#include "OPHD/Map/TileMap.h"
+#include "OPHD/MapObjects/Structures/Road.h"
+#include "OPHD/States/Planet.h"
+
+#include <libOPHD/Map/GridPathFinder.h>
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	constexpr int RoadSpacing = 3;
+
+
+	struct DynamicCastLookup
+	{
+		Structure* operator()(const Tile& tile) const { return dynamic_cast<Structure*>(tile.thing()); }
+	};
+
+
+	struct KindTagLookup
+	{
+		Structure* operator()(const Tile& tile) const { return tile.structure(); }
+	};
+
+
+	struct WorkloadResults
+	{
+		std::chrono::nanoseconds walkTime{0};
+		std::chrono::nanoseconds routeTime{0};
+		std::size_t visited{0};
+		float routeCost{0.0f};
+	};
+
+
+	double toMilliseconds(std::chrono::nanoseconds duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+
+	bool isRoadTile(NAS2D::Point<int> point)
+	{
+		return point.x % RoadSpacing == 0 || point.y % RoadSpacing == 0;
+	}
+
+
+	void placeRoads(TileMap& tileMap)
+	{
+		const auto size = tileMap.size();
+		for (int y = 0; y < size.y; ++y)
+		{
+			for (int x = 0; x < size.x; ++x)
+			{
+				auto& tile = tileMap.getTile({{x, y}, 0});
+				if (!isRoadTile({x, y}) || tile.hasMine() || tile.index() == TerrainType::Impassable) { continue; }
+
+				tile.pushMapObject(new Road());
+			}
+		}
+	}
+
+
+	template <typename Lookup>
+	std::size_t connectednessWalk(TileMap& tileMap, NAS2D::Point<int> start, Lookup lookup)
+	{
+		const auto size = tileMap.size();
+		std::vector<bool> seen(static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y));
+		std::vector<NAS2D::Point<int>> stack{start};
+		std::size_t visited = 0;
+
+		const auto offsets = std::array{NAS2D::Vector{0, -1}, NAS2D::Vector{1, 0}, NAS2D::Vector{0, 1}, NAS2D::Vector{-1, 0}};
+		while (!stack.empty())
+		{
+			const auto point = stack.back();
+			stack.pop_back();
+
+			const auto index = static_cast<std::size_t>(point.y) * static_cast<std::size_t>(size.x) + static_cast<std::size_t>(point.x);
+			if (seen[index]) { continue; }
+			seen[index] = true;
+
+			if (!lookup(tileMap.getTile({point, 0}))) { continue; }
+			++visited;
+
+			for (const auto offset : offsets)
+			{
+				const auto next = point + offset;
+				if (tileMap.isValidPosition({next, 0})) { stack.push_back(next); }
+			}
+		}
+
+		return visited;
+	}
+
+
+	template <typename Lookup>
+	float movementCost(const Tile& tile, Lookup lookup)
+	{
+		if (tile.index() == TerrainType::Impassable) { return GridPathFinder::Impassable; }
+
+		const auto* structure = lookup(tile);
+		if (structure && structure->isRoad())
+		{
+			if (!structure->operational()) { return constants::RouteBaseCost * static_cast<float>(TerrainType::Difficult) + 1.0f; }
+			return structure->integrity() < constants::RoadIntegrityChange ? 0.75f : 0.5f;
+		}
+		if (!tile.empty() && (!structure || (!structure->isMineFacility() && !structure->isSmelter()))) { return GridPathFinder::Impassable; }
+
+		return constants::RouteBaseCost * static_cast<float>(tile.index()) + 1.0f;
+	}
+
+
+	template <typename Lookup>
+	float routeSolve(TileMap& tileMap, GridPathFinder& pathFinder, NAS2D::Point<int> start, NAS2D::Point<int> goal, Lookup lookup)
+	{
+		const auto size = tileMap.size();
+		std::vector<float> costs;
+		costs.reserve(static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y));
+		for (int y = 0; y < size.y; ++y)
+		{
+			for (int x = 0; x < size.x; ++x)
+			{
+				costs.push_back(movementCost(tileMap.getTile({{x, y}, 0}), lookup));
+			}
+		}
+
+		pathFinder.movementCosts(std::move(costs));
+		return pathFinder.findPath(start, goal).cost;
+	}
+
+
+	template <typename Lookup>
+	WorkloadResults runWorkloads(TileMap& tileMap, int iterations, Lookup lookup)
+	{
+		const auto size = tileMap.size();
+		const auto start = NAS2D::Point{0, 0};
+		const auto goal = NAS2D::Point{(size.x - 1) / RoadSpacing * RoadSpacing, (size.y - 1) / RoadSpacing * RoadSpacing};
+
+		GridPathFinder pathFinder{size, std::vector<float>(static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y), 1.0f)};
+
+		WorkloadResults results;
+		for (int i = 0; i < iterations; ++i)
+		{
+			const auto walkStart = std::chrono::steady_clock::now();
+			results.visited = connectednessWalk(tileMap, start, lookup);
+			results.walkTime += std::chrono::steady_clock::now() - walkStart;
+
+			const auto routeStart = std::chrono::steady_clock::now();
+			results.routeCost = routeSolve(tileMap, pathFinder, start, goal, lookup);
+			results.routeTime += std::chrono::steady_clock::now() - routeStart;
+		}
+
+		return results;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	const int iterations = argc > 1 ? std::max(1, std::stoi(argv[1])) : 20;
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>("OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() / "data");
+
+		StructureCatalogue::init();
+
+		std::cout << std::left << std::setw(12) << "Map"
+			<< std::right << std::setw(16) << "walk cast (ms)"
+			<< std::setw(15) << "walk tag (ms)"
+			<< std::setw(10) << "speedup"
+			<< std::setw(17) << "route cast (ms)"
+			<< std::setw(16) << "route tag (ms)"
+			<< std::setw(10) << "speedup" << std::endl;
+
+		int mismatches = 0;
+		for (const auto& attributes : parsePlanetAttributes())
+		{
+			TileMap tileMap{attributes.mapImagePath, attributes.mapSize, attributes.maxDepth, attributes.maxMines, {1, 1, 1}};
+			placeRoads(tileMap);
+
+			const auto cast = runWorkloads(tileMap, iterations, DynamicCastLookup{});
+			const auto tag = runWorkloads(tileMap, iterations, KindTagLookup{});
+			if (cast.visited != tag.visited || cast.routeCost != tag.routeCost) { ++mismatches; }
+
+			const auto walkCastMs = toMilliseconds(cast.walkTime) / iterations;
+			const auto walkTagMs = toMilliseconds(tag.walkTime) / iterations;
+			const auto routeCastMs = toMilliseconds(cast.routeTime) / iterations;
+			const auto routeTagMs = toMilliseconds(tag.routeTime) / iterations;
+
+			std::cout << std::left << std::setw(12) << attributes.name
+				<< std::right << std::fixed << std::setprecision(3)
+				<< std::setw(16) << walkCastMs
+				<< std::setw(15) << walkTagMs
+				<< std::setw(9) << std::setprecision(2) << (walkTagMs > 0.0 ? walkCastMs / walkTagMs : 0.0) << "x"
+				<< std::setw(17) << std::setprecision(3) << routeCastMs
+				<< std::setw(16) << routeTagMs
+				<< std::setw(9) << std::setprecision(2) << (routeTagMs > 0.0 ? routeCastMs / routeTagMs : 0.0) << "x" << std::endl;
+		}
+
+		if (mismatches > 0)
+		{
+			std::cerr << std::endl << mismatches << " maps had different results between lookups" << std::endl;
+			return 1;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+// ==================================================================================
+// = Headless turn benchmark. Loads a savegame into a ColonySimulation, runs a number
+// = of turns and reports how long each turn phase took, as recorded by the profiler.
+// = No window, Renderer or Mixer is created so this can be run on machines without
+// = a GPU.
+// =
+// = Usage: benchTurns <savegame name> [turns]
+// =
+// = benchColonySize times turns for synthetic colonies of fixed sizes instead.
+// ==================================================================================
+
+#include "OPHD/ColonySimulation.h"
+#include "OPHD/ProductCatalogue.h"
+#include "OPHD/Savegame.h"
+#include "OPHD/StructureCatalogue.h"
+
+#include <libOPHD/Profiler.h>
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	struct PhaseStats
+	{
+		std::string name;
+		int depth;
+		std::chrono::nanoseconds total{0};
+		std::chrono::nanoseconds min{std::chrono::nanoseconds::max()};
+		std::chrono::nanoseconds max{0};
+	};
+
+
+	double toMilliseconds(std::chrono::nanoseconds duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+
+	void accumulate(std::vector<PhaseStats>& stats, const std::vector<Profiler::Sample>& samples)
+	{
+		for (const auto& sample : samples)
+		{
+			auto it = std::find_if(stats.begin(), stats.end(), [&sample](const PhaseStats& entry) { return entry.depth == sample.depth && entry.name == sample.name; });
+			if (it == stats.end())
+			{
+				stats.push_back({sample.name, sample.depth});
+				it = stats.end() - 1;
+			}
+
+			const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(sample.duration);
+			it->total += duration;
+			it->min = std::min(it->min, duration);
+			it->max = std::max(it->max, duration);
+		}
+	}
+
+
+	void printStats(const std::vector<PhaseStats>& stats, int turns)
+	{
+		std::cout << std::left << std::setw(26) << "Phase"
+			<< std::right << std::setw(12) << "mean (ms)"
+			<< std::setw(12) << "min (ms)"
+			<< std::setw(12) << "max (ms)" << std::endl;
+
+		for (const auto& entry : stats)
+		{
+			std::cout << std::left << std::setw(26) << (std::string(static_cast<std::size_t>(entry.depth) * 2, ' ') + entry.name)
+				<< std::right << std::fixed << std::setprecision(3)
+				<< std::setw(12) << toMilliseconds(entry.total) / turns
+				<< std::setw(12) << toMilliseconds(entry.min)
+				<< std::setw(12) << toMilliseconds(entry.max) << std::endl;
+		}
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <savegame name> [turns]" << std::endl;
+		return 1;
+	}
+
+	const int turns = argc > 2 ? std::max(1, std::stoi(argv[2])) : 100;
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>("OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() / "data");
+		filesystem.mountReadWrite(filesystem.prefPath());
+
+		StructureCatalogue::init();
+		ProductCatalogue::init("factory_products.xml");
+
+		const auto filename = findSavegame(argv[1]);
+		auto savegame = loadSavegame(filename);
+
+		ColonySimulation simulation;
+		simulation.load(savegame);
+
+		std::vector<PhaseStats> stats;
+		std::chrono::nanoseconds totalTime{0};
+		int turnsRun = 0;
+
+		for (; turnsRun < turns && !simulation.isGameOver(); ++turnsRun)
+		{
+			profiler.begin();
+
+			const auto start = std::chrono::steady_clock::now();
+			simulation.nextTurn();
+			totalTime += std::chrono::steady_clock::now() - start;
+
+			accumulate(stats, profiler.samples());
+		}
+
+		std::cout << "Savegame: " << filename << std::endl;
+		std::cout << "Turns: " << turnsRun << " (ended on turn " << simulation.turnCount() << ")" << std::endl << std::endl;
+
+		if (turnsRun == 0) { return 0; }
+
+		if (ProfilerEnabled)
+		{
+			printStats(stats, turnsRun);
+		}
+		else
+		{
+			std::cout << "Per phase timings are unavailable: built with OPHD_NO_PROFILER" << std::endl;
+		}
+
+		std::cout << std::endl << "Mean turn time: " << std::fixed << std::setprecision(3) << toMilliseconds(totalTime) / turnsRun << " ms" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
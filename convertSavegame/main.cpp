@@ -0,0 +1,78 @@
+// ==================================================================================
+// = Converts savegames between the binary and XML formats. The input format is
+// = detected from the file contents; the output format is chosen by the output
+// = file's extension (.xml for XML, anything else for binary).
+// =
+// = Usage: convertSavegame <input file> <output file>
+// ==================================================================================
+
+#include "OPHD/Savegame.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	std::string readFile(const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("Unable to open '" + filePath + "' for reading");
+		}
+
+		return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	}
+
+
+	void writeFile(const std::string& filePath, const std::string& data)
+	{
+		std::ofstream file(filePath, std::ios::binary);
+		if (!file.write(data.data(), static_cast<std::streamsize>(data.size())))
+		{
+			throw std::runtime_error("Unable to write '" + filePath + "'");
+		}
+	}
+
+
+	bool endsWith(const std::string& value, const std::string& suffix)
+	{
+		return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <input file> <output file>" << std::endl;
+		return 1;
+	}
+
+	const std::string inputPath = argv[1];
+	const std::string outputPath = argv[2];
+
+	try
+	{
+		SavegameReader savegame{readFile(inputPath), inputPath};
+
+		const auto toXml = endsWith(outputPath, ".xml");
+		const auto output = toXml ? savegameToXml(savegame) : savegameToBinary(savegame);
+		writeFile(outputPath, output);
+
+		std::cout << inputPath << " (" << (savegame.format() == SavegameFormat::Binary ? "binary" : "XML") << ") -> "
+			<< outputPath << " (" << (toXml ? "XML" : "binary") << "), " << output.size() << " bytes" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,158 @@
+#include "BinarySerializer.h"
+
+#include <limits>
+#include <stdexcept>
+
+
+void BinaryWriter::writeU8(std::uint8_t value)
+{
+	mBuffer.push_back(static_cast<char>(value));
+}
+
+
+void BinaryWriter::writeU16(std::uint16_t value)
+{
+	writeU8(static_cast<std::uint8_t>(value & 0xFF));
+	writeU8(static_cast<std::uint8_t>(value >> 8));
+}
+
+
+void BinaryWriter::writeU32(std::uint32_t value)
+{
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		writeU8(static_cast<std::uint8_t>((value >> shift) & 0xFF));
+	}
+}
+
+
+void BinaryWriter::writeI32(std::int32_t value)
+{
+	writeU32(static_cast<std::uint32_t>(value));
+}
+
+
+/**
+ * Writes an unsigned value in LEB128 form: seven bits per byte, high bit set
+ * on every byte except the last. Small values (the common case for counts and
+ * run lengths) take a single byte.
+ */
+void BinaryWriter::writeVarUint(std::uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		writeU8(static_cast<std::uint8_t>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	writeU8(static_cast<std::uint8_t>(value));
+}
+
+
+void BinaryWriter::writeBytes(std::string_view bytes)
+{
+	mBuffer.append(bytes);
+}
+
+
+void BinaryWriter::writeString(std::string_view value)
+{
+	writeVarUint(value.size());
+	writeBytes(value);
+}
+
+
+void BinaryWriter::patchU32(std::size_t offset, std::uint32_t value)
+{
+	if (offset + 4 > mBuffer.size())
+	{
+		throw std::runtime_error("BinaryWriter::patchU32(): Offset is past the end of the buffer: " + std::to_string(offset));
+	}
+
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		mBuffer[offset + i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+	}
+}
+
+
+BinaryReader::BinaryReader(std::string_view buffer) :
+	mBuffer{buffer}
+{}
+
+
+std::uint8_t BinaryReader::readU8()
+{
+	require(1);
+	return static_cast<std::uint8_t>(mBuffer[mPosition++]);
+}
+
+
+std::uint16_t BinaryReader::readU16()
+{
+	const auto low = readU8();
+	const auto high = readU8();
+	return static_cast<std::uint16_t>(low | (high << 8));
+}
+
+
+std::uint32_t BinaryReader::readU32()
+{
+	std::uint32_t value = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		value |= static_cast<std::uint32_t>(readU8()) << shift;
+	}
+	return value;
+}
+
+
+std::int32_t BinaryReader::readI32()
+{
+	return static_cast<std::int32_t>(readU32());
+}
+
+
+std::uint64_t BinaryReader::readVarUint()
+{
+	std::uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		const auto byte = readU8();
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return value;
+		}
+	}
+
+	throw std::runtime_error("BinaryReader::readVarUint(): Encoded value is too long");
+}
+
+
+std::string_view BinaryReader::readBytes(std::size_t count)
+{
+	require(count);
+	const auto bytes = mBuffer.substr(mPosition, count);
+	mPosition += count;
+	return bytes;
+}
+
+
+std::string BinaryReader::readString()
+{
+	const auto length = readVarUint();
+	if (length > std::numeric_limits<std::size_t>::max())
+	{
+		throw std::runtime_error("BinaryReader::readString(): String length is out of range");
+	}
+	return std::string{readBytes(static_cast<std::size_t>(length))};
+}
+
+
+void BinaryReader::require(std::size_t count) const
+{
+	if (count > remaining())
+	{
+		throw std::runtime_error("BinaryReader: Unexpected end of data at offset " + std::to_string(mPosition) + " reading " + std::to_string(count) + " bytes");
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/**
+ * Appends little-endian binary values to an in-memory buffer.
+ *
+ * Values are written in the order they are given; nothing is buffered
+ * beyond the output itself, so large data sets can be written as they
+ * are walked without building an intermediate tree first.
+ */
+class BinaryWriter
+{
+public:
+	void writeU8(std::uint8_t value);
+	void writeU16(std::uint16_t value);
+	void writeU32(std::uint32_t value);
+	void writeI32(std::int32_t value);
+	void writeVarUint(std::uint64_t value);
+	void writeBytes(std::string_view bytes);
+	void writeString(std::string_view value);
+
+	/** Overwrites a previously written U32, e.g. to back-patch a section length. */
+	void patchU32(std::size_t offset, std::uint32_t value);
+
+	std::size_t size() const { return mBuffer.size(); }
+	const std::string& buffer() const { return mBuffer; }
+
+private:
+	std::string mBuffer;
+};
+
+
+/**
+ * Reads values written by BinaryWriter back out of a buffer.
+ *
+ * \note	Does not own the buffer; it must outlive the reader.
+ *
+ * \throws	std::runtime_error if a read would run past the end of the buffer.
+ */
+class BinaryReader
+{
+public:
+	explicit BinaryReader(std::string_view buffer);
+
+	std::uint8_t readU8();
+	std::uint16_t readU16();
+	std::uint32_t readU32();
+	std::int32_t readI32();
+	std::uint64_t readVarUint();
+	std::string_view readBytes(std::size_t count);
+	std::string readString();
+
+	std::size_t position() const { return mPosition; }
+	std::size_t remaining() const { return mBuffer.size() - mPosition; }
+	bool atEnd() const { return mPosition >= mBuffer.size(); }
+
+private:
+	void require(std::size_t count) const;
+
+	std::string_view mBuffer;
+	std::size_t mPosition{0};
+};
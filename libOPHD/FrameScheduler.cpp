@@ -0,0 +1,84 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+
+
+namespace
+{
+	constexpr auto StatsWindow = std::chrono::seconds{1};
+}
+
+
+/**
+ * \param	frameCap	Most frames to draw per second, or 0 for no cap.
+ */
+FrameScheduler::FrameScheduler(int frameCap) :
+	mFrameCap{std::max(frameCap, 0)},
+	mFrameInterval{mFrameCap > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::seconds{1}) / mFrameCap : Clock::duration{0}}
+{}
+
+
+/**
+ * Asks for the scene to be drawn again at least this often. Called by
+ * whatever draws during a frame; when several parts of the scene ask, the
+ * most frequent wins. A frame that never asks is redrawn continuously.
+ */
+void FrameScheduler::redraw(Redraw redraw)
+{
+	mRedraw = mRedraw ? std::max(*mRedraw, redraw) : redraw;
+}
+
+
+/**
+ * Earliest time the frame cap allows the next frame to start.
+ */
+FrameScheduler::Clock::time_point FrameScheduler::earliestFrameTime() const
+{
+	return mFrameStart + mFrameInterval;
+}
+
+
+/**
+ * Time the next frame is due if nothing happens in the meantime.
+ */
+FrameScheduler::Clock::time_point FrameScheduler::nextFrameTime() const
+{
+	if (mInvalidated || mLastRedraw == Redraw::Continuous) { return earliestFrameTime(); }
+
+	const auto idleInterval = mLastRedraw == Redraw::Animated ?
+		std::chrono::duration_cast<Clock::duration>(std::chrono::seconds{1}) / IdleFrameRate :
+		std::chrono::duration_cast<Clock::duration>(IdleRedrawInterval);
+
+	return mFrameStart + std::max(mFrameInterval, idleInterval);
+}
+
+
+void FrameScheduler::beginFrame(Clock::time_point now)
+{
+	if (mWindowStart == Clock::time_point{}) { mWindowStart = now; }
+
+	mFrameStart = now;
+	mInvalidated = false;
+	mRedraw.reset();
+}
+
+
+void FrameScheduler::endFrame(Clock::time_point now)
+{
+	mLastRedraw = mRedraw.value_or(Redraw::Continuous);
+
+	mStats.frameTime = now - mFrameStart;
+	mWindowFrameTime += mStats.frameTime;
+	++mWindowFrames;
+
+	const auto elapsed = now - mWindowStart;
+	if (elapsed < StatsWindow) { return; }
+
+	mStats.averageFrameTime = mWindowFrameTime / mWindowFrames;
+	mStats.framesPerSecond = static_cast<int>(mWindowFrames * StatsWindow / elapsed);
+	mStats.idlePercent = 100 - static_cast<int>(mWindowFrameTime * 100 / elapsed);
+
+	mWindowStart = now;
+	mWindowFrameTime = Clock::duration{0};
+	mWindowFrames = 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+
+/**
+ * Decides when the next frame should be drawn so the game does not redraw
+ * a scene that has not changed.
+ *
+ * A frame is drawn as soon as the frame cap allows when something has been
+ * invalidated, or when the state drawn last asked for continuous redraws.
+ * Otherwise the scene is considered idle and is only redrawn at a reduced
+ * rate. Input is not tracked here; the main loop wakes up for any pending
+ * event once the frame cap allows a frame.
+ *
+ * Times are passed in rather than read from the clock so the schedule can
+ * be tested.
+ */
+class FrameScheduler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * How soon the scene drawn by a frame needs to be drawn again. Ordered
+	 * from least to most frequent.
+	 */
+	enum class Redraw
+	{
+		OnChange, /**< Nothing moves until something is invalidated. */
+		Animated, /**< Ambient animation only, drawn at IdleFrameRate. */
+		Continuous /**< Drawn as often as the frame cap allows. */
+	};
+
+	struct Stats
+	{
+		Clock::duration frameTime{0}; /**< Time from the start to the end of the last frame. */
+		Clock::duration averageFrameTime{0}; /**< Mean frame time over the last full second. */
+		int framesPerSecond{0}; /**< Frames drawn in the last full second. */
+		int idlePercent{0}; /**< Share of the last full second spent between frames. */
+	};
+
+	static constexpr int IdleFrameRate = 15;
+	static constexpr auto IdleRedrawInterval = std::chrono::milliseconds{500};
+
+	explicit FrameScheduler(int frameCap);
+
+	int frameCap() const { return mFrameCap; }
+
+	void invalidate() { mInvalidated = true; }
+	void redraw(Redraw redraw);
+
+	Clock::time_point earliestFrameTime() const;
+	Clock::time_point nextFrameTime() const;
+
+	void beginFrame(Clock::time_point now);
+	void endFrame(Clock::time_point now);
+
+	const Stats& stats() const { return mStats; }
+
+private:
+	int mFrameCap;
+	Clock::duration mFrameInterval;
+
+	bool mInvalidated{true};
+	std::optional<Redraw> mRedraw;
+	Redraw mLastRedraw{Redraw::Continuous};
+
+	Clock::time_point mFrameStart;
+
+	// Totals for the second being measured
+	Clock::time_point mWindowStart;
+	Clock::duration mWindowFrameTime{0};
+	int mWindowFrames{0};
+
+	Stats mStats;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Binary min-heap that also indexes its items, so an item's key can be
+ * changed or the item removed in O(log n) without searching for it.
+ *
+ * Each item can be in the heap at most once. Items with equal keys come out
+ * in no particular order.
+ */
+template <typename Item, typename Key>
+class IndexedMinHeap
+{
+public:
+	bool empty() const { return mEntries.empty(); }
+	std::size_t size() const { return mEntries.size(); }
+
+	bool contains(const Item& item) const { return mPositions.find(item) != mPositions.end(); }
+
+	const Key& key(const Item& item) const { return mEntries[position(item)].key; }
+
+	const Item& top() const
+	{
+		if (empty()) { throw std::runtime_error("IndexedMinHeap::top(): Heap is empty"); }
+		return mEntries.front().item;
+	}
+
+	const Key& topKey() const
+	{
+		if (empty()) { throw std::runtime_error("IndexedMinHeap::topKey(): Heap is empty"); }
+		return mEntries.front().key;
+	}
+
+
+	/**
+	 * Adds an item, or changes its key if it is already in the heap.
+	 */
+	void push(const Item& item, const Key& key)
+	{
+		const auto it = mPositions.find(item);
+		if (it == mPositions.end())
+		{
+			mEntries.push_back({item, key});
+			mPositions.emplace(item, mEntries.size() - 1);
+			siftUp(mEntries.size() - 1);
+			return;
+		}
+
+		const auto index = it->second;
+		const bool decreased = key < mEntries[index].key;
+		mEntries[index].key = key;
+		decreased ? siftUp(index) : siftDown(index);
+	}
+
+
+	Item pop()
+	{
+		auto item = top();
+		erase(item);
+		return item;
+	}
+
+
+	/**
+	 * Removes an item. Does nothing if the item isn't in the heap.
+	 */
+	void erase(const Item& item)
+	{
+		const auto it = mPositions.find(item);
+		if (it == mPositions.end()) { return; }
+
+		const auto index = it->second;
+		mPositions.erase(it);
+
+		const auto last = mEntries.size() - 1;
+		if (index != last)
+		{
+			mEntries[index] = std::move(mEntries[last]);
+			mPositions[mEntries[index].item] = index;
+		}
+		mEntries.pop_back();
+
+		if (index < mEntries.size())
+		{
+			siftUp(index);
+			siftDown(mPositions[mEntries[index].item]);
+		}
+	}
+
+
+	void clear()
+	{
+		mEntries.clear();
+		mPositions.clear();
+	}
+
+private:
+	struct Entry
+	{
+		Item item;
+		Key key;
+	};
+
+	std::size_t position(const Item& item) const
+	{
+		const auto it = mPositions.find(item);
+		if (it == mPositions.end()) { throw std::runtime_error("IndexedMinHeap: Item is not in the heap"); }
+		return it->second;
+	}
+
+	void swapEntries(std::size_t a, std::size_t b)
+	{
+		std::swap(mEntries[a], mEntries[b]);
+		mPositions[mEntries[a].item] = a;
+		mPositions[mEntries[b].item] = b;
+	}
+
+	void siftUp(std::size_t index)
+	{
+		while (index > 0)
+		{
+			const auto parent = (index - 1) / 2;
+			if (!(mEntries[index].key < mEntries[parent].key)) { return; }
+			swapEntries(index, parent);
+			index = parent;
+		}
+	}
+
+	void siftDown(std::size_t index)
+	{
+		while (true)
+		{
+			const auto left = index * 2 + 1;
+			const auto right = left + 1;
+			auto smallest = index;
+
+			if (left < mEntries.size() && mEntries[left].key < mEntries[smallest].key) { smallest = left; }
+			if (right < mEntries.size() && mEntries[right].key < mEntries[smallest].key) { smallest = right; }
+			if (smallest == index) { return; }
+
+			swapEntries(index, smallest);
+			index = smallest;
+		}
+	}
+
+	std::vector<Entry> mEntries;
+	std::unordered_map<Item, std::size_t> mPositions;
+};
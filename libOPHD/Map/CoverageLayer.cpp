@@ -0,0 +1,175 @@
+#include "CoverageLayer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	constexpr int LocalMask = CoverageLayer::ChunkSize - 1;
+
+
+	int chunksAlong(int cells)
+	{
+		return (cells + CoverageLayer::ChunkSize - 1) / CoverageLayer::ChunkSize;
+	}
+}
+
+
+CoverageLayer::CoverageLayer(NAS2D::Vector<int> size, int levels) :
+	mSize{size},
+	mChunkCounts{chunksAlong(size.x), chunksAlong(size.y)},
+	mLevels{levels}
+{
+	if (size.x < 0 || size.y < 0 || levels < 0)
+	{
+		throw std::runtime_error("CoverageLayer: Invalid dimensions: " + std::to_string(size.x) + "x" + std::to_string(size.y) + "x" + std::to_string(levels));
+	}
+
+	mChunks.resize(static_cast<std::size_t>(mChunkCounts.x) * static_cast<std::size_t>(mChunkCounts.y) * static_cast<std::size_t>(levels));
+}
+
+
+void CoverageLayer::addCircle(NAS2D::Point<int> center, int depth, int radius)
+{
+	adjustCircle(center, depth, radius, 1);
+}
+
+
+/**
+ * Removes an area previously added with addCircle().
+ *
+ * \note	Must be called with the same arguments that were passed to
+ *			addCircle(), otherwise counts of other areas are disturbed.
+ */
+void CoverageLayer::removeCircle(NAS2D::Point<int> center, int depth, int radius)
+{
+	adjustCircle(center, depth, radius, -1);
+}
+
+
+void CoverageLayer::clear()
+{
+	for (auto& chunk : mChunks) { chunk.reset(); }
+}
+
+
+bool CoverageLayer::contains(NAS2D::Point<int> point, int depth) const
+{
+	return point.x >= 0 && point.y >= 0 && depth >= 0 && point.x < mSize.x && point.y < mSize.y && depth < mLevels;
+}
+
+
+/**
+ * Gets whether any area covers the point. Points outside the layer are never
+ * covered.
+ */
+bool CoverageLayer::covered(NAS2D::Point<int> point, int depth) const
+{
+	if (!contains(point, depth)) { return false; }
+
+	const auto& chunk = mChunks[chunkIndex(point, depth)];
+	return chunk && chunk->counts[cellIndex(point)] > 0;
+}
+
+
+/**
+ * Gets every covered point of a level, chunk by chunk.
+ */
+std::vector<NAS2D::Point<int>> CoverageLayer::coveredPoints(int depth) const
+{
+	std::vector<NAS2D::Point<int>> points;
+	if (depth < 0 || depth >= mLevels) { return points; }
+
+	for (int chunkY = 0; chunkY < mChunkCounts.y; ++chunkY)
+	{
+		for (int chunkX = 0; chunkX < mChunkCounts.x; ++chunkX)
+		{
+			const auto origin = NAS2D::Point{chunkX << ChunkShift, chunkY << ChunkShift};
+			const auto& chunk = mChunks[chunkIndex(origin, depth)];
+			if (!chunk) { continue; }
+
+			for (std::size_t cell = 0; cell < chunk->counts.size(); ++cell)
+			{
+				if (chunk->counts[cell] == 0) { continue; }
+
+				const auto local = static_cast<int>(cell);
+				points.push_back(origin + NAS2D::Vector{local & LocalMask, local >> ChunkShift});
+			}
+		}
+	}
+
+	return points;
+}
+
+
+void CoverageLayer::adjustCircle(NAS2D::Point<int> center, int depth, int radius, int delta)
+{
+	if (depth < 0 || depth >= mLevels || radius < 0) { return; }
+
+	const auto radiusSquared = radius * radius;
+	const auto startY = std::max(center.y - radius, 0);
+	const auto endY = std::min(center.y + radius, mSize.y - 1);
+
+	for (int y = startY; y <= endY; ++y)
+	{
+		// Widest x offset still within the radius for this row
+		const auto offsetY = y - center.y;
+		int offsetX = radius;
+		while (offsetX * offsetX + offsetY * offsetY > radiusSquared) { --offsetX; }
+
+		const auto startX = std::max(center.x - offsetX, 0);
+		const auto endX = std::min(center.x + offsetX, mSize.x - 1);
+		for (int x = startX; x <= endX; ++x)
+		{
+			adjustCell({x, y}, depth, delta);
+		}
+	}
+}
+
+
+/**
+ * Changes the count of a single cell, allocating its chunk when the first
+ * cell in it becomes covered and releasing it when the last one stops being
+ * covered.
+ */
+void CoverageLayer::adjustCell(NAS2D::Point<int> point, int depth, int delta)
+{
+	auto& chunk = mChunks[chunkIndex(point, depth)];
+	if (!chunk)
+	{
+		if (delta < 0)
+		{
+			throw std::runtime_error("CoverageLayer: Removed an area that was never added");
+		}
+		chunk = std::make_unique<Chunk>();
+	}
+
+	auto& count = chunk->counts[cellIndex(point)];
+	if (delta < 0 && count == 0)
+	{
+		throw std::runtime_error("CoverageLayer: Removed an area that was never added");
+	}
+
+	const auto wasCovered = count > 0;
+	count = static_cast<std::uint16_t>(count + delta);
+	if (!wasCovered && count > 0) { ++chunk->coveredCount; }
+	else if (wasCovered && count == 0) { --chunk->coveredCount; }
+
+	if (chunk->coveredCount == 0) { chunk.reset(); }
+}
+
+
+std::size_t CoverageLayer::chunkIndex(NAS2D::Point<int> point, int depth) const
+{
+	const auto chunkX = static_cast<std::size_t>(point.x >> ChunkShift);
+	const auto chunkY = static_cast<std::size_t>(point.y >> ChunkShift);
+	return (static_cast<std::size_t>(depth) * static_cast<std::size_t>(mChunkCounts.y) + chunkY) * static_cast<std::size_t>(mChunkCounts.x) + chunkX;
+}
+
+
+std::size_t CoverageLayer::cellIndex(NAS2D::Point<int> point)
+{
+	return static_cast<std::size_t>(((point.y & LocalMask) << ChunkShift) | (point.x & LocalMask));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Counts how many circular areas cover each tile of a map.
+ *
+ * Used for the comm range and police overlays. Each structure adds its area
+ * when it starts contributing and removes the same area when it stops, so
+ * overlapping areas are handled without rebuilding the whole layer and
+ * membership is a single array lookup.
+ *
+ * Each level is split into square chunks, which are only allocated while
+ * some area covers them, so large maps with few covering structures stay
+ * small and coveredPoints() only visits chunks with coverage.
+ */
+class CoverageLayer
+{
+public:
+	static constexpr int ChunkShift = 5;
+	static constexpr int ChunkSize = 1 << ChunkShift;
+
+	CoverageLayer() = default;
+	CoverageLayer(NAS2D::Vector<int> size, int levels);
+	CoverageLayer(CoverageLayer&&) noexcept = default;
+	CoverageLayer& operator=(CoverageLayer&&) noexcept = default;
+
+	NAS2D::Vector<int> size() const { return mSize; }
+	int levels() const { return mLevels; }
+
+	void addCircle(NAS2D::Point<int> center, int depth, int radius);
+	void removeCircle(NAS2D::Point<int> center, int depth, int radius);
+	void clear();
+
+	bool contains(NAS2D::Point<int> point, int depth) const;
+	bool covered(NAS2D::Point<int> point, int depth) const;
+
+	std::vector<NAS2D::Point<int>> coveredPoints(int depth) const;
+
+private:
+	struct Chunk
+	{
+		std::array<std::uint16_t, ChunkSize * ChunkSize> counts{};
+		int coveredCount{0}; /**< Cells with a non-zero count. */
+	};
+
+	void adjustCircle(NAS2D::Point<int> center, int depth, int radius, int delta);
+	void adjustCell(NAS2D::Point<int> point, int depth, int delta);
+	std::size_t chunkIndex(NAS2D::Point<int> point, int depth) const;
+	static std::size_t cellIndex(NAS2D::Point<int> point);
+
+	NAS2D::Vector<int> mSize{0, 0};
+	NAS2D::Vector<int> mChunkCounts{0, 0};
+	int mLevels{0};
+	std::vector<std::unique_ptr<Chunk>> mChunks;
+};
@@ -0,0 +1,262 @@
+#include "GridPathFinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace
+{
+	constexpr auto NoParent = std::numeric_limits<std::uint32_t>::max();
+
+
+	// Orders the open list so the heap's front is the lowest priority, breaking
+	// ties in favour of the node furthest along its path
+	struct OpenEntryCompare
+	{
+		template <typename Entry>
+		bool operator()(const Entry& a, const Entry& b) const
+		{
+			return a.priority > b.priority || (a.priority == b.priority && a.cost < b.cost);
+		}
+	};
+}
+
+
+GridPathFinder::GridPathFinder(NAS2D::Vector<int> size, std::vector<float> movementCosts) :
+	mSize{size}
+{
+	if (size.x < 0 || size.y < 0)
+	{
+		throw std::runtime_error("GridPathFinder: Invalid size: " + std::to_string(size.x) + "x" + std::to_string(size.y));
+	}
+
+	this->movementCosts(std::move(movementCosts));
+}
+
+
+/**
+ * Replaces the movement cost of every cell, stored row by row.
+ *
+ * \throws	std::runtime_error if the number of costs doesn't match the size
+ *			of the grid.
+ */
+void GridPathFinder::movementCosts(std::vector<float> movementCosts)
+{
+	const auto cellCount = static_cast<std::size_t>(mSize.x) * static_cast<std::size_t>(mSize.y);
+	if (movementCosts.size() != cellCount)
+	{
+		throw std::runtime_error("GridPathFinder: Expected " + std::to_string(cellCount) + " movement costs, got " + std::to_string(movementCosts.size()));
+	}
+
+	mMovementCosts = std::move(movementCosts);
+
+	// The A* heuristic must never overestimate, so it assumes every step
+	// is as cheap as the cheapest cell on the grid
+	mMinimumCost = Impassable;
+	for (const auto cost : mMovementCosts) { mMinimumCost = std::min(mMinimumCost, cost); }
+	if (mMinimumCost == Impassable) { mMinimumCost = 0.0f; }
+
+	if (mNodes.size() != cellCount)
+	{
+		mNodes.assign(cellCount, Node{0.0f, NoParent, 0, false});
+		mGeneration = 0;
+	}
+}
+
+
+/**
+ * Finds the cheapest path between two cells.
+ *
+ * \return	The path, including both ends, or an empty path if the goal
+ *			can't be reached.
+ */
+GridPath GridPathFinder::findPath(NAS2D::Point<int> start, NAS2D::Point<int> goal)
+{
+	if (!contains(start) || !contains(goal))
+	{
+		throw std::runtime_error("GridPathFinder::findPath(): Start or goal is outside of the grid");
+	}
+
+	const auto heuristic = [this, goal](NAS2D::Point<int> from) {
+		return mMinimumCost * static_cast<float>(std::abs(goal.x - from.x) + std::abs(goal.y - from.y));
+	};
+
+	beginSearch();
+	const auto goalIndex = index(goal);
+	open(index(start), NoParent, 0.0f, heuristic(start));
+
+	while (!mOpen.empty())
+	{
+		const auto entry = popOpen();
+		auto& node = mNodes[entry.index];
+		if (node.closed || entry.cost > node.cost) { continue; }
+		node.closed = true;
+
+		if (entry.index == goalIndex)
+		{
+			GridPath path;
+			path.cost = node.cost;
+			for (auto pathIndex = goalIndex; pathIndex != NoParent; pathIndex = mNodes[pathIndex].parent)
+			{
+				path.points.push_back(point(pathIndex));
+			}
+			std::reverse(path.points.begin(), path.points.end());
+			return path;
+		}
+
+		const auto openNeighbour = [this, &entry, &heuristic](std::uint32_t neighbour) {
+			const auto stepCost = mMovementCosts[neighbour];
+			if (stepCost == Impassable) { return; }
+
+			const auto newCost = entry.cost + stepCost;
+			open(neighbour, entry.index, newCost, newCost + heuristic(point(neighbour)));
+		};
+
+		const auto position = point(entry.index);
+		const auto width = static_cast<std::uint32_t>(mSize.x);
+
+		if (position.y > 0) { openNeighbour(entry.index - width); }
+		if (position.x < mSize.x - 1) { openNeighbour(entry.index + 1); }
+		if (position.y < mSize.y - 1) { openNeighbour(entry.index + width); }
+		if (position.x > 0) { openNeighbour(entry.index - 1); }
+	}
+
+	return {};
+}
+
+
+/**
+ * Finds the cheapest path from each start to whichever goal is cheapest to
+ * reach from it.
+ *
+ * Runs a single Dijkstra search outward from all goals at once, stopping
+ * once every start has been reached. Costs are the same as running
+ * findPath() from each start to each goal and keeping the cheapest.
+ *
+ * \return	One path per start, in the same order. Paths run from the start
+ *			to the goal and are empty if no goal can be reached.
+ */
+std::vector<GridPath> GridPathFinder::findNearest(const std::vector<NAS2D::Point<int>>& starts, const std::vector<NAS2D::Point<int>>& goals)
+{
+	std::vector<GridPath> paths(starts.size());
+	if (starts.empty() || goals.empty()) { return paths; }
+
+	std::vector<std::uint32_t> startIndices;
+	for (const auto start : starts)
+	{
+		if (!contains(start)) { throw std::runtime_error("GridPathFinder::findNearest(): Start is outside of the grid"); }
+		startIndices.push_back(index(start));
+	}
+	std::sort(startIndices.begin(), startIndices.end());
+	startIndices.erase(std::unique(startIndices.begin(), startIndices.end()), startIndices.end());
+
+	beginSearch();
+	for (const auto goal : goals)
+	{
+		if (!contains(goal)) { throw std::runtime_error("GridPathFinder::findNearest(): Goal is outside of the grid"); }
+		open(index(goal), NoParent, 0.0f, 0.0f);
+	}
+
+	auto startsRemaining = startIndices.size();
+	while (!mOpen.empty() && startsRemaining > 0)
+	{
+		const auto entry = popOpen();
+		auto& node = mNodes[entry.index];
+		if (node.closed || entry.cost > node.cost) { continue; }
+		node.closed = true;
+
+		if (std::binary_search(startIndices.begin(), startIndices.end(), entry.index)) { --startsRemaining; }
+
+		// Searching backwards, a step from a neighbour onto this cell costs
+		// this cell's movement cost. Impassable cells can still start a path
+		// so they are reached but never expanded.
+		const auto stepCost = mMovementCosts[entry.index];
+		if (stepCost == Impassable) { continue; }
+
+		const auto newCost = entry.cost + stepCost;
+		const auto position = point(entry.index);
+		const auto width = static_cast<std::uint32_t>(mSize.x);
+
+		if (position.y > 0) { open(entry.index - width, entry.index, newCost, newCost); }
+		if (position.x < mSize.x - 1) { open(entry.index + 1, entry.index, newCost, newCost); }
+		if (position.y < mSize.y - 1) { open(entry.index + width, entry.index, newCost, newCost); }
+		if (position.x > 0) { open(entry.index - 1, entry.index, newCost, newCost); }
+	}
+
+	for (std::size_t i = 0; i < starts.size(); ++i)
+	{
+		const auto startIndex = index(starts[i]);
+		if (!visited(startIndex) || !mNodes[startIndex].closed) { continue; }
+
+		auto& path = paths[i];
+		path.cost = mNodes[startIndex].cost;
+		for (auto pathIndex = startIndex; pathIndex != NoParent; pathIndex = mNodes[pathIndex].parent)
+		{
+			path.points.push_back(point(pathIndex));
+		}
+	}
+
+	return paths;
+}
+
+
+void GridPathFinder::beginSearch()
+{
+	mOpen.clear();
+
+	// On wrap around, stale generations could match again; start over
+	if (++mGeneration == 0)
+	{
+		for (auto& node : mNodes) { node.generation = 0; }
+		mGeneration = 1;
+	}
+}
+
+
+/**
+ * Adds a node to the open list if it hasn't been reached yet or if this is a
+ * cheaper way to reach it.
+ */
+bool GridPathFinder::open(std::uint32_t index, std::uint32_t parent, float cost, float priority)
+{
+	auto& node = mNodes[index];
+	if (visited(index) && (node.closed || cost >= node.cost)) { return false; }
+
+	node = {cost, parent, mGeneration, false};
+
+	// Superseded entries for this node stay in the heap and are skipped when popped
+	mOpen.push_back({priority, cost, index});
+	std::push_heap(mOpen.begin(), mOpen.end(), OpenEntryCompare{});
+	return true;
+}
+
+
+GridPathFinder::OpenEntry GridPathFinder::popOpen()
+{
+	std::pop_heap(mOpen.begin(), mOpen.end(), OpenEntryCompare{});
+	const auto entry = mOpen.back();
+	mOpen.pop_back();
+	return entry;
+}
+
+
+bool GridPathFinder::contains(NAS2D::Point<int> point) const
+{
+	return point.x >= 0 && point.y >= 0 && point.x < mSize.x && point.y < mSize.y;
+}
+
+
+std::uint32_t GridPathFinder::index(NAS2D::Point<int> point) const
+{
+	return static_cast<std::uint32_t>(point.y) * static_cast<std::uint32_t>(mSize.x) + static_cast<std::uint32_t>(point.x);
+}
+
+
+NAS2D::Point<int> GridPathFinder::point(std::uint32_t index) const
+{
+	const auto width = static_cast<std::uint32_t>(mSize.x);
+	return {static_cast<int>(index % width), static_cast<int>(index / width)};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+struct GridPath
+{
+	bool empty() const { return points.empty(); }
+
+	std::vector<NAS2D::Point<int>> points;
+	float cost{0.0f};
+};
+
+
+/**
+ * A* and Dijkstra search over a single level of a tile grid.
+ *
+ * Each cell has the cost of moving onto it from one of its four neighbours.
+ * Cells with a cost of Impassable can't be moved onto, though a search may
+ * still start on one. The cost of a path is the sum of the costs of every
+ * cell entered after leaving the start.
+ *
+ * Search state lives in a node array allocated once for the whole grid. Each
+ * search bumps a generation counter rather than clearing the array, so
+ * repeated searches only touch the nodes they expand.
+ */
+class GridPathFinder
+{
+public:
+	static constexpr float Impassable = std::numeric_limits<float>::max();
+
+	GridPathFinder() = default;
+	GridPathFinder(NAS2D::Vector<int> size, std::vector<float> movementCosts);
+
+	NAS2D::Vector<int> size() const { return mSize; }
+	void movementCosts(std::vector<float> movementCosts);
+
+	GridPath findPath(NAS2D::Point<int> start, NAS2D::Point<int> goal);
+	std::vector<GridPath> findNearest(const std::vector<NAS2D::Point<int>>& starts, const std::vector<NAS2D::Point<int>>& goals);
+
+private:
+	struct Node
+	{
+		float cost;
+		std::uint32_t parent;
+		std::uint32_t generation;
+		bool closed;
+	};
+
+	struct OpenEntry
+	{
+		float priority;
+		float cost;
+		std::uint32_t index;
+	};
+
+	void beginSearch();
+	bool visited(std::uint32_t index) const { return mNodes[index].generation == mGeneration; }
+	bool open(std::uint32_t index, std::uint32_t parent, float cost, float priority);
+	OpenEntry popOpen();
+
+	bool contains(NAS2D::Point<int> point) const;
+	std::uint32_t index(NAS2D::Point<int> point) const;
+	NAS2D::Point<int> point(std::uint32_t index) const;
+
+	NAS2D::Vector<int> mSize{0, 0};
+	std::vector<float> mMovementCosts;
+	float mMinimumCost{1.0f};
+
+	std::vector<Node> mNodes;
+	std::uint32_t mGeneration{0};
+	std::vector<OpenEntry> mOpen;
+};
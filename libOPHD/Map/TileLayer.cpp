@@ -0,0 +1,291 @@
+#include "TileLayer.h"
+
+#include "../BinarySerializer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	// Guards against absurd dimensions in a corrupt header. Chunks are only
+	// allocated as cells are written, so the dimensions alone cost nothing.
+	constexpr int MaxDimension = 1 << 16;
+	constexpr int MaxLevels = 1 << 8;
+
+	// Dense layers written by older savegames were never larger than this.
+	// Run-length encoding lets a few bytes describe any number of cells, so
+	// the cap is what bounds the work of reading a corrupt one.
+	constexpr std::size_t MaxDenseCells = std::size_t{1} << 24;
+
+	constexpr std::size_t LocalMask = TileLayer::ChunkSize - 1;
+
+
+	std::size_t chunksAlong(int cells)
+	{
+		return (static_cast<std::size_t>(cells) + TileLayer::ChunkSize - 1) >> TileLayer::ChunkShift;
+	}
+
+
+	void writeRuns(BinaryWriter& writer, const TileLayer::Chunk& cells)
+	{
+		std::size_t runStart = 0;
+		while (runStart < cells.size())
+		{
+			const auto value = cells[runStart];
+			auto runEnd = runStart + 1;
+			while (runEnd < cells.size() && cells[runEnd] == value) { ++runEnd; }
+
+			writer.writeVarUint(runEnd - runStart);
+			writer.writeU8(value);
+			runStart = runEnd;
+		}
+	}
+
+
+	void readRuns(BinaryReader& reader, TileLayer::Chunk& cells)
+	{
+		std::size_t position = 0;
+		while (position < cells.size())
+		{
+			const auto runLength = reader.readVarUint();
+			const auto value = reader.readU8();
+
+			if (runLength == 0 || runLength > cells.size() - position)
+			{
+				throw std::runtime_error("TileLayer: Run length out of range at cell " + std::to_string(position));
+			}
+
+			const auto runEnd = position + static_cast<std::size_t>(runLength);
+			std::fill(cells.begin() + static_cast<std::ptrdiff_t>(position), cells.begin() + static_cast<std::ptrdiff_t>(runEnd), value);
+			position = runEnd;
+		}
+	}
+
+
+	TileLayer readHeader(BinaryReader& reader)
+	{
+		const auto width = reader.readI32();
+		const auto height = reader.readI32();
+		const auto levels = reader.readI32();
+		return TileLayer{width, height, levels};
+	}
+}
+
+
+TileLayer::TileLayer(int newWidth, int newHeight, int newLevels) :
+	width{newWidth},
+	height{newHeight},
+	levels{newLevels}
+{
+	if (width < 0 || height < 0 || levels < 0 || width > MaxDimension || height > MaxDimension || levels > MaxLevels)
+	{
+		throw std::runtime_error("TileLayer: Invalid dimensions: " + std::to_string(width) + "x" + std::to_string(height) + "x" + std::to_string(levels));
+	}
+}
+
+
+bool TileLayer::contains(int x, int y, int depth) const
+{
+	return x >= 0 && y >= 0 && depth >= 0 && x < width && y < height && depth < levels;
+}
+
+
+/**
+ * Gets a cell for writing, allocating its chunk if needed.
+ */
+std::uint8_t& TileLayer::at(int x, int y, int depth)
+{
+	const auto local = ((static_cast<std::size_t>(y) & LocalMask) << ChunkShift) | (static_cast<std::size_t>(x) & LocalMask);
+	return chunk(chunkIndex(x, y, depth))[local];
+}
+
+
+std::uint8_t TileLayer::at(int x, int y, int depth) const
+{
+	const auto chunkIt = mChunks.find(chunkIndex(x, y, depth));
+	if (chunkIt == mChunks.end()) { return Empty; }
+
+	const auto local = ((static_cast<std::size_t>(y) & LocalMask) << ChunkShift) | (static_cast<std::size_t>(x) & LocalMask);
+	return chunkIt->second[local];
+}
+
+
+/**
+ * Gets every cell that is not Empty, chunk by chunk.
+ */
+std::vector<TileLayer::Cell> TileLayer::filledCells() const
+{
+	std::vector<Cell> cells;
+
+	const auto across = chunksAcross();
+	const auto down = chunksDown();
+	for (const auto& [index, cellValues] : mChunks)
+	{
+		const auto chunkRow = index / across;
+		const auto firstX = static_cast<int>((index % across) << ChunkShift);
+		const auto firstY = static_cast<int>((chunkRow % down) << ChunkShift);
+		const auto depth = static_cast<int>(chunkRow / down);
+
+		for (std::size_t local = 0; local < ChunkArea; ++local)
+		{
+			if (cellValues[local] == Empty) { continue; }
+			cells.push_back({firstX + static_cast<int>(local & LocalMask), firstY + static_cast<int>(local >> ChunkShift), depth, cellValues[local]});
+		}
+	}
+
+	return cells;
+}
+
+
+/**
+ * Number of chunks needed to cover every level.
+ */
+std::size_t TileLayer::chunkCount() const
+{
+	return chunksAcross() * chunksDown() * static_cast<std::size_t>(levels);
+}
+
+
+/**
+ * Gets a chunk for writing. A chunk that has not been allocated yet is
+ * created with every cell Empty.
+ *
+ * \note	Cells of an edge chunk that fall outside the layer are never read
+ *			and should be left Empty.
+ */
+TileLayer::Chunk& TileLayer::chunk(std::size_t chunkIndex)
+{
+	if (chunkIndex >= chunkCount())
+	{
+		throw std::runtime_error("TileLayer: Chunk out of range: " + std::to_string(chunkIndex));
+	}
+
+	auto [chunkIt, inserted] = mChunks.try_emplace(chunkIndex);
+	if (inserted) { chunkIt->second.fill(Empty); }
+	return chunkIt->second;
+}
+
+
+std::size_t TileLayer::chunksAcross() const
+{
+	return chunksAlong(width);
+}
+
+
+std::size_t TileLayer::chunksDown() const
+{
+	return chunksAlong(height);
+}
+
+
+std::size_t TileLayer::chunkIndex(int x, int y, int depth) const
+{
+	if (!contains(x, y, depth))
+	{
+		throw std::runtime_error("TileLayer: Position out of range: (" + std::to_string(x) + ", " + std::to_string(y) + ", " + std::to_string(depth) + ")");
+	}
+
+	const auto chunkX = static_cast<std::size_t>(x) >> ChunkShift;
+	const auto chunkY = static_cast<std::size_t>(y) >> ChunkShift;
+	return (static_cast<std::size_t>(depth) * chunksDown() + chunkY) * chunksAcross() + chunkX;
+}
+
+
+/**
+ * Writes the layer as its dimensions and the number of allocated chunks,
+ * followed by each chunk's index and its cells as (run length, value) pairs.
+ *
+ * Saved maps are overwhelmingly Empty with a few clusters of dozed or dug
+ * tiles, so this stays small however large the map is.
+ */
+void writeTileLayer(BinaryWriter& writer, const TileLayer& tileLayer)
+{
+	writer.writeI32(tileLayer.width);
+	writer.writeI32(tileLayer.height);
+	writer.writeI32(tileLayer.levels);
+
+	const auto& chunks = tileLayer.chunks();
+	writer.writeVarUint(chunks.size());
+	for (const auto& [index, cells] : chunks)
+	{
+		writer.writeVarUint(index);
+		writeRuns(writer, cells);
+	}
+}
+
+
+/**
+ * Reads a layer written by writeTileLayer().
+ *
+ * \throws	std::runtime_error if a chunk is out of range or out of order, or
+ *			its runs don't cover it exactly.
+ */
+TileLayer readTileLayer(BinaryReader& reader)
+{
+	auto tileLayer = readHeader(reader);
+
+	const auto chunkCount = reader.readVarUint();
+	if (chunkCount > tileLayer.chunkCount())
+	{
+		throw std::runtime_error("TileLayer: Too many chunks: " + std::to_string(chunkCount));
+	}
+
+	std::uint64_t nextIndex = 0;
+	for (std::uint64_t i = 0; i < chunkCount; ++i)
+	{
+		const auto index = reader.readVarUint();
+		if (index < nextIndex || index >= tileLayer.chunkCount())
+		{
+			throw std::runtime_error("TileLayer: Chunk out of range or out of order: " + std::to_string(index));
+		}
+
+		readRuns(reader, tileLayer.chunk(static_cast<std::size_t>(index)));
+		nextIndex = index + 1;
+	}
+
+	return tileLayer;
+}
+
+
+/**
+ * Reads a layer from older savegames, which stored every cell of every
+ * level, level by level and row by row, as (run length, value) pairs.
+ */
+TileLayer readDenseTileLayer(BinaryReader& reader)
+{
+	auto tileLayer = readHeader(reader);
+
+	const auto rowLength = static_cast<std::size_t>(tileLayer.width);
+	const auto levelArea = rowLength * static_cast<std::size_t>(tileLayer.height);
+	const auto cellCount = levelArea * static_cast<std::size_t>(tileLayer.levels);
+	if (cellCount > MaxDenseCells)
+	{
+		throw std::runtime_error("TileLayer: Too many cells: " + std::to_string(tileLayer.width) + "x" + std::to_string(tileLayer.height) + "x" + std::to_string(tileLayer.levels));
+	}
+
+	std::size_t position = 0;
+	while (position < cellCount)
+	{
+		const auto runLength = reader.readVarUint();
+		const auto value = reader.readU8();
+
+		if (runLength == 0 || runLength > cellCount - position)
+		{
+			throw std::runtime_error("TileLayer: Run length out of range at cell " + std::to_string(position));
+		}
+
+		const auto runEnd = position + static_cast<std::size_t>(runLength);
+		for (; value != TileLayer::Empty && position < runEnd; ++position)
+		{
+			const auto depth = position / levelArea;
+			const auto y = (position % levelArea) / rowLength;
+			const auto x = position % rowLength;
+			tileLayer.at(static_cast<int>(x), static_cast<int>(y), static_cast<int>(depth)) = value;
+		}
+		position = runEnd;
+	}
+
+	return tileLayer;
+}
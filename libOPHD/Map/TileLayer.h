@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+
+class BinaryWriter;
+class BinaryReader;
+
+
+/**
+ * One byte per tile for every level of a map, used to save the terrain of
+ * tiles that differ from what the map image would generate (dozed or
+ * excavated tiles).
+ *
+ * Only a few clusters of tiles are ever dozed or dug out, so cells are kept
+ * in square chunks that are allocated the first time one of their cells is
+ * written. Every cell of a chunk that was never written is TileLayer::Empty,
+ * so the size of a layer follows the number of changed tiles rather than the
+ * size of the map.
+ *
+ * Chunks are numbered level by level, row by row, and cells are stored row
+ * by row within a chunk.
+ */
+struct TileLayer
+{
+	static constexpr std::uint8_t Empty = 0xFF;
+
+	static constexpr int ChunkShift = 5;
+	static constexpr int ChunkSize = 1 << ChunkShift;
+	static constexpr std::size_t ChunkArea = ChunkSize * ChunkSize;
+
+	using Chunk = std::array<std::uint8_t, ChunkArea>;
+
+	struct Cell
+	{
+		int x;
+		int y;
+		int depth;
+		std::uint8_t value;
+	};
+
+	TileLayer() = default;
+	TileLayer(int width, int height, int levels);
+
+	bool contains(int x, int y, int depth) const;
+
+	std::uint8_t& at(int x, int y, int depth);
+	std::uint8_t at(int x, int y, int depth) const;
+
+	std::vector<Cell> filledCells() const;
+
+	std::size_t chunkCount() const;
+	const std::map<std::size_t, Chunk>& chunks() const { return mChunks; }
+	Chunk& chunk(std::size_t chunkIndex);
+
+	int width{0};
+	int height{0};
+	int levels{0};
+
+private:
+	std::size_t chunksAcross() const;
+	std::size_t chunksDown() const;
+	std::size_t chunkIndex(int x, int y, int depth) const;
+
+	std::map<std::size_t, Chunk> mChunks;
+};
+
+
+void writeTileLayer(BinaryWriter& writer, const TileLayer& tileLayer);
+TileLayer readTileLayer(BinaryReader& reader);
+TileLayer readDenseTileLayer(BinaryReader& reader);
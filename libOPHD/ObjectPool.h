@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Pool of objects of a single type, stored in fixed size blocks.
+ *
+ * Objects never move once created, so references and pointers to them stay
+ * valid until they are erased. Slots freed by erase() are reused by later
+ * emplace() calls. Iteration visits live objects in memory order, block by
+ * block.
+ */
+template <typename T, std::size_t BlockSize = 32>
+class ObjectPool
+{
+	static_assert(BlockSize > 0, "ObjectPool blocks must hold at least one object");
+
+	struct Block
+	{
+		alignas(T) std::byte storage[sizeof(T) * BlockSize];
+		std::array<bool, BlockSize> alive{};
+
+		T* slot(std::size_t index) { return std::launder(reinterpret_cast<T*>(storage + sizeof(T) * index)); }
+		const T* slot(std::size_t index) const { return std::launder(reinterpret_cast<const T*>(storage + sizeof(T) * index)); }
+	};
+
+	template <typename Pool, typename Value>
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		Iterator() = default;
+		Iterator(Pool* pool, std::size_t index) : mPool{pool}, mIndex{index} { skipDead(); }
+
+		reference operator*() const { return *mPool->mBlocks[mIndex / BlockSize]->slot(mIndex % BlockSize); }
+		pointer operator->() const { return &**this; }
+
+		Iterator& operator++()
+		{
+			++mIndex;
+			skipDead();
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			auto previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const { return mIndex == other.mIndex; }
+		bool operator!=(const Iterator& other) const { return mIndex != other.mIndex; }
+
+	private:
+		void skipDead()
+		{
+			const auto end = mPool->mBlocks.size() * BlockSize;
+			while (mIndex < end && !mPool->mBlocks[mIndex / BlockSize]->alive[mIndex % BlockSize]) { ++mIndex; }
+		}
+
+		Pool* mPool{nullptr};
+		std::size_t mIndex{0};
+	};
+
+public:
+	using iterator = Iterator<ObjectPool, T>;
+	using const_iterator = Iterator<const ObjectPool, const T>;
+
+	ObjectPool() = default;
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+	~ObjectPool() { clear(); }
+
+	bool empty() const { return mSize == 0; }
+	std::size_t size() const { return mSize; }
+	std::size_t blockCount() const { return mBlocks.size(); }
+
+	iterator begin() { return {this, 0}; }
+	iterator end() { return {this, mBlocks.size() * BlockSize}; }
+	const_iterator begin() const { return {this, 0}; }
+	const_iterator end() const { return {this, mBlocks.size() * BlockSize}; }
+
+
+	template <typename... Args>
+	T& emplace(Args&&... args)
+	{
+		if (mFreeSlots.empty())
+		{
+			mBlocks.push_back(std::make_unique<Block>());
+
+			// Hand out the new block front to back
+			const auto first = (mBlocks.size() - 1) * BlockSize;
+			for (auto index = first + BlockSize; index > first; --index) { mFreeSlots.push_back(index - 1); }
+		}
+
+		const auto index = mFreeSlots.back();
+		auto& block = *mBlocks[index / BlockSize];
+		auto* object = ::new (static_cast<void*>(block.storage + sizeof(T) * (index % BlockSize))) T(std::forward<Args>(args)...);
+
+		mFreeSlots.pop_back();
+		block.alive[index % BlockSize] = true;
+		++mSize;
+		return *object;
+	}
+
+
+	bool contains(const T* object) const { return find(object) != NotFound; }
+
+
+	/**
+	 * Destroys an object in the pool.
+	 *
+	 * \throws	std::runtime_error if the object is not in the pool.
+	 */
+	void erase(const T* object)
+	{
+		const auto index = find(object);
+		if (index == NotFound) { throw std::runtime_error("ObjectPool::erase(): Object is not in the pool"); }
+
+		auto& block = *mBlocks[index / BlockSize];
+		block.slot(index % BlockSize)->~T();
+		block.alive[index % BlockSize] = false;
+		mFreeSlots.push_back(index);
+		--mSize;
+	}
+
+
+	/**
+	 * Destroys every object and releases all blocks at once.
+	 */
+	void clear()
+	{
+		for (auto& block : mBlocks)
+		{
+			for (std::size_t i = 0; i < BlockSize; ++i)
+			{
+				if (block->alive[i]) { block->slot(i)->~T(); }
+			}
+		}
+
+		mBlocks.clear();
+		mFreeSlots.clear();
+		mSize = 0;
+	}
+
+private:
+	static constexpr std::size_t NotFound = static_cast<std::size_t>(-1);
+
+	std::size_t find(const T* object) const
+	{
+		const auto address = reinterpret_cast<std::uintptr_t>(object);
+		for (std::size_t blockIndex = 0; blockIndex < mBlocks.size(); ++blockIndex)
+		{
+			const auto& block = *mBlocks[blockIndex];
+			const auto first = reinterpret_cast<std::uintptr_t>(block.storage);
+			if (address < first || address >= first + sizeof(block.storage)) { continue; }
+
+			const auto offset = address - first;
+			if (offset % sizeof(T) != 0) { return NotFound; }
+
+			const auto slot = offset / sizeof(T);
+			return block.alive[slot] ? blockIndex * BlockSize + slot : NotFound;
+		}
+
+		return NotFound;
+	}
+
+	std::vector<std::unique_ptr<Block>> mBlocks;
+	std::vector<std::size_t> mFreeSlots; /**< Free slot indices, the next one to use at the back. */
+	std::size_t mSize{0};
+};
@@ -86,7 +86,7 @@ void Population::spawnPopulation(int morale, int residences, int nurseries, int
 	for (int toRetire = newRoles.retiree; toRetire > 0;)
 	{
 		/** Workers retire earlier than scientists. */
-		auto& retireRole = randomNumber.generate(0, 100) <= 45 ?
+		auto& retireRole = randomNumber.stream(RandomStream::Population).generate(0, 100) <= 45 ?
 			mPopulation.scientist : mPopulation.worker;
 		if (retireRole > 0)
 		{
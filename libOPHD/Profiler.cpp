@@ -0,0 +1,143 @@
+#include "Profiler.h"
+
+#include <string_view>
+
+
+namespace
+{
+	double toMicroseconds(Profiler::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+
+
+	/** Quotes a name for CSV, doubling any embedded quotes. */
+	void writeCsvString(std::ostream& stream, std::string_view value)
+	{
+		stream << '"';
+		for (const auto character : value)
+		{
+			if (character == '"') { stream << '"'; }
+			stream << character;
+		}
+		stream << '"';
+	}
+
+
+	void writeJsonString(std::ostream& stream, std::string_view value)
+	{
+		stream << '"';
+		for (const auto character : value)
+		{
+			if (character == '"' || character == '\\') { stream << '\\'; }
+			stream << character;
+		}
+		stream << '"';
+	}
+}
+
+
+/**
+ * Discards the previous capture and starts a new one. Sample start times
+ * are measured from this point.
+ */
+void Profiler::begin()
+{
+	mOrigin = Clock::now();
+	mDepth = 0;
+	mSamples.clear();
+	mCounters.clear();
+}
+
+
+std::size_t Profiler::enter(const char* name)
+{
+	mSamples.push_back({name, mDepth++, Clock::now() - mOrigin, Clock::duration::zero()});
+	return mSamples.size() - 1;
+}
+
+
+void Profiler::leave(std::size_t sample)
+{
+	// Scope was opened before begin() discarded its sample
+	if (sample >= mSamples.size()) { return; }
+
+	auto& entry = mSamples[sample];
+	entry.duration = Clock::now() - mOrigin - entry.start;
+	mDepth = entry.depth;
+}
+
+
+/**
+ * Adds to a named counter, creating it the first time it's used.
+ */
+void Profiler::count(const char* name, std::int64_t value)
+{
+	for (auto& counter : mCounters)
+	{
+		if (counter.name == name || std::string_view{counter.name} == name)
+		{
+			counter.value += value;
+			return;
+		}
+	}
+
+	mCounters.push_back({name, value});
+}
+
+
+/**
+ * Writes one row per sample and counter. Times are in microseconds.
+ */
+void Profiler::writeCsv(std::ostream& stream) const
+{
+	stream << "type,name,depth,start_us,duration_us,value\n";
+
+	for (const auto& sample : mSamples)
+	{
+		stream << "scope,";
+		writeCsvString(stream, sample.name);
+		stream << ',' << sample.depth << ',' << toMicroseconds(sample.start) << ',' << toMicroseconds(sample.duration) << ",\n";
+	}
+
+	for (const auto& counter : mCounters)
+	{
+		stream << "counter,";
+		writeCsvString(stream, counter.name);
+		stream << ",,,," << counter.value << '\n';
+	}
+}
+
+
+/**
+ * Writes the capture in the Chrome trace event format, which can be opened
+ * with chrome://tracing or Perfetto.
+ */
+void Profiler::writeChromeTrace(std::ostream& stream) const
+{
+	stream << "{\"traceEvents\":[";
+
+	bool first = true;
+	const auto separator = [&stream, &first]() {
+		if (!first) { stream << ','; }
+		first = false;
+	};
+
+	for (const auto& sample : mSamples)
+	{
+		separator();
+		stream << "\n{\"name\":";
+		writeJsonString(stream, sample.name);
+		stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << toMicroseconds(sample.start) << ",\"dur\":" << toMicroseconds(sample.duration) << '}';
+	}
+
+	for (const auto& counter : mCounters)
+	{
+		separator();
+		stream << "\n{\"name\":";
+		writeJsonString(stream, counter.name);
+		stream << ",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":0,\"args\":{\"value\":" << counter.value << "}}";
+	}
+
+	stream << "\n]}\n";
+}
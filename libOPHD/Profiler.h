@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+/**
+ * Collects nested timings and counters for one capture, typically a turn.
+ *
+ * Names are stored as pointers and must outlive the capture; in practice
+ * they are always string literals.
+ *
+ * Use the OPHD_PROFILE_SCOPE and OPHD_PROFILE_COUNT macros rather than
+ * calling this directly so instrumentation compiles away entirely when
+ * OPHD_NO_PROFILER is defined.
+ */
+class Profiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Sample
+	{
+		const char* name;
+		int depth;
+		Clock::duration start;
+		Clock::duration duration;
+	};
+
+	struct Counter
+	{
+		const char* name;
+		std::int64_t value;
+	};
+
+	void begin();
+
+	std::size_t enter(const char* name);
+	void leave(std::size_t sample);
+
+	void count(const char* name, std::int64_t value);
+
+	const std::vector<Sample>& samples() const { return mSamples; }
+	const std::vector<Counter>& counters() const { return mCounters; }
+
+	void writeCsv(std::ostream& stream) const;
+	void writeChromeTrace(std::ostream& stream) const;
+
+private:
+	Clock::time_point mOrigin{Clock::now()};
+	int mDepth{0};
+	std::vector<Sample> mSamples;
+	std::vector<Counter> mCounters;
+};
+
+
+/**
+ * Times the enclosing scope.
+ */
+class ProfileScope
+{
+public:
+	ProfileScope(Profiler& profiler, const char* name) :
+		mProfiler{profiler},
+		mSample{profiler.enter(name)}
+	{}
+
+	~ProfileScope() { mProfiler.leave(mSample); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	Profiler& mProfiler;
+	std::size_t mSample;
+};
+
+
+inline Profiler profiler;
+
+
+#define OPHD_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OPHD_PROFILE_CONCAT(a, b) OPHD_PROFILE_CONCAT_IMPL(a, b)
+
+#ifndef OPHD_NO_PROFILER
+	constexpr bool ProfilerEnabled = true;
+	#define OPHD_PROFILE_SCOPE(name) const ProfileScope OPHD_PROFILE_CONCAT(profileScope, __LINE__){profiler, name}
+	#define OPHD_PROFILE_COUNT(name, value) profiler.count(name, static_cast<std::int64_t>(value))
+#else
+	constexpr bool ProfilerEnabled = false;
+	#define OPHD_PROFILE_SCOPE(name) static_cast<void>(0)
+	#define OPHD_PROFILE_COUNT(name, value) static_cast<void>(0)
+#endif
@@ -0,0 +1,172 @@
+#include "RandomNumberGenerator.h"
+
+#include <random>
+
+
+namespace
+{
+	const std::array<std::string, RandomStreams::StreamCount> StreamNames
+	{
+		"map_generation",
+		"population",
+		"crime_rate",
+		"crime_execution",
+		"structure_decay",
+	};
+}
+
+
+Pcg32::Pcg32(std::uint64_t seed, std::uint64_t stream) :
+	mIncrement{(stream << 1u) | 1u}
+{
+	(*this)();
+	mState += seed;
+	(*this)();
+}
+
+
+/**
+ * Moves the generator forward as if operator() had been called \c delta
+ * times.
+ */
+void Pcg32::advance(std::uint64_t delta)
+{
+	std::uint64_t accumulatedMultiplier = 1;
+	std::uint64_t accumulatedIncrement = 0;
+	std::uint64_t multiplier = Multiplier;
+	std::uint64_t increment = mIncrement;
+
+	while (delta > 0)
+	{
+		if (delta & 1u)
+		{
+			accumulatedMultiplier *= multiplier;
+			accumulatedIncrement = accumulatedIncrement * multiplier + increment;
+		}
+		increment = (multiplier + 1) * increment;
+		multiplier *= multiplier;
+		delta >>= 1u;
+	}
+
+	mState = accumulatedMultiplier * mState + accumulatedIncrement;
+}
+
+
+RandomNumberGenerator::RandomNumberGenerator(std::uint64_t seed, std::uint64_t stream) :
+	mSeed{seed},
+	mStream{stream},
+	mGenerator{seed, stream}
+{
+}
+
+
+std::uint32_t RandomNumberGenerator::next()
+{
+	++mDraws;
+	return mGenerator();
+}
+
+
+std::uint64_t RandomNumberGenerator::next64()
+{
+	const std::uint64_t high = next();
+	return (high << 32u) | next();
+}
+
+
+/**
+ * Puts the stream at the position it would have after \c count draws.
+ */
+void RandomNumberGenerator::draws(std::uint64_t count)
+{
+	mGenerator = Pcg32{mSeed, mStream};
+	mGenerator.advance(count);
+	mDraws = count;
+}
+
+
+/**
+ * Gets an unbiased number in [0, range].
+ */
+std::uint64_t RandomNumberGenerator::bounded(std::uint64_t range)
+{
+	if (range == 0) { return 0; }
+
+	if (range < std::numeric_limits<std::uint32_t>::max())
+	{
+		// Lemire's multiply and reject method
+		const auto bound = static_cast<std::uint32_t>(range + 1);
+		const auto threshold = static_cast<std::uint32_t>(-bound) % bound;
+		while (true)
+		{
+			const auto product = static_cast<std::uint64_t>(next()) * bound;
+			if (static_cast<std::uint32_t>(product) >= threshold) { return product >> 32u; }
+		}
+	}
+
+	if (range == std::numeric_limits<std::uint64_t>::max()) { return next64(); }
+
+	const auto bound = range + 1;
+	const auto limit = std::numeric_limits<std::uint64_t>::max() - std::numeric_limits<std::uint64_t>::max() % bound;
+	while (true)
+	{
+		const auto value = next64();
+		if (value < limit) { return value % bound; }
+	}
+}
+
+
+RandomStreams::RandomStreams()
+{
+	seed(generateRandomSeed());
+}
+
+
+/**
+ * Restarts every stream from a new seed.
+ */
+void RandomStreams::seed(std::uint64_t seed)
+{
+	mSeed = seed;
+	for (std::size_t i = 0; i < StreamCount; ++i)
+	{
+		mStreams[i] = RandomNumberGenerator{seed, i};
+	}
+}
+
+
+/**
+ * Puts every stream back to where it was when draws() was called.
+ */
+void RandomStreams::restore(std::uint64_t seed, const DrawCounts& draws)
+{
+	this->seed(seed);
+	for (std::size_t i = 0; i < StreamCount; ++i)
+	{
+		mStreams[i].draws(draws[i]);
+	}
+}
+
+
+RandomStreams::DrawCounts RandomStreams::draws() const
+{
+	DrawCounts draws;
+	for (std::size_t i = 0; i < StreamCount; ++i)
+	{
+		draws[i] = mStreams[i].draws();
+	}
+	return draws;
+}
+
+
+const std::string& RandomStreams::streamName(RandomStream stream)
+{
+	return StreamNames.at(static_cast<std::size_t>(stream));
+}
+
+
+std::uint64_t generateRandomSeed()
+{
+	std::random_device randomDevice;
+	return (static_cast<std::uint64_t>(randomDevice()) << 32u) | randomDevice();
+}
@@ -1,14 +1,65 @@
 #pragma once
 
-#include <type_traits>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
-#include <random>
+#include <string>
+#include <type_traits>
+
+
+/**
+ * PCG32 (XSH RR) generator.
+ *
+ * Much smaller and faster than std::mt19937, and its position in the
+ * sequence can be moved forward by any number of draws in logarithmic time,
+ * which is how saved streams are restored.
+ *
+ * Satisfies UniformRandomBitGenerator.
+ */
+class Pcg32
+{
+public:
+	using result_type = std::uint32_t;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	Pcg32() : Pcg32(0, 0) {}
+	Pcg32(std::uint64_t seed, std::uint64_t stream);
+
+	result_type operator()()
+	{
+		const auto oldState = mState;
+		mState = oldState * Multiplier + mIncrement;
+		const auto xorShifted = static_cast<std::uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+		const auto rotation = static_cast<std::uint32_t>(oldState >> 59u);
+		return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31u));
+	}
+
+	void advance(std::uint64_t delta);
+
+private:
+	static constexpr std::uint64_t Multiplier = 6364136223846793005ull;
+
+	std::uint64_t mState{0};
+	std::uint64_t mIncrement{0};
+};
 
 
+/**
+ * A single, reproducible stream of random numbers.
+ *
+ * Distributions are implemented here rather than with the <random>
+ * distributions, whose output differs between standard library
+ * implementations, so a seed produces the same game on every platform.
+ */
 class RandomNumberGenerator
 {
 public:
-	RandomNumberGenerator() : generator(randomDevice()) {}
+	RandomNumberGenerator() : RandomNumberGenerator(0, 0) {}
+	RandomNumberGenerator(std::uint64_t seed, std::uint64_t stream);
 
 	template <typename T>
 	std::enable_if_t<std::is_arithmetic_v<T>, T>
@@ -21,23 +72,85 @@ public:
 
 		if constexpr (std::is_integral_v<T>)
 		{
-			std::uniform_int_distribution<T> distribution(min, max);
-			return distribution(generator);
-		}
-		else if constexpr (std::is_floating_point_v<T>)
-		{
-			std::uniform_real_distribution<T> distribution(min, max);
-			return distribution(generator);
+			const auto range = static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min);
+			return static_cast<T>(static_cast<std::uint64_t>(min) + bounded(range));
 		}
 		else
 		{
-			throw std::runtime_error("Inproper type provided for generating a random number");
+			// 53 random bits give an evenly spaced value in [0, 1)
+			const auto unit = static_cast<double>(next64() >> 11) * 0x1.0p-53;
+			return static_cast<T>(static_cast<double>(min) + unit * (static_cast<double>(max) - static_cast<double>(min)));
 		}
 	}
 
+	std::uint32_t next();
+	std::uint64_t next64();
+
+	std::uint64_t draws() const { return mDraws; }
+	void draws(std::uint64_t count);
+
 private:
-	std::random_device randomDevice;
-	std::mt19937 generator;
+	std::uint64_t bounded(std::uint64_t range);
+
+	std::uint64_t mSeed;
+	std::uint64_t mStream;
+	Pcg32 mGenerator;
+	std::uint64_t mDraws{0};
+};
+
+
+/**
+ * Subsystems with their own random number stream.
+ *
+ * Each stream is independent, so changing how often one subsystem draws
+ * numbers doesn't change what any other subsystem gets.
+ *
+ * \note	Append new streams to the end; a stream's position in this list
+ *			selects its sequence.
+ */
+enum class RandomStream
+{
+	MapGeneration,
+	Population,
+	CrimeRate,
+	CrimeExecution,
+	StructureDecay,
+
+	Count
+};
+
+
+/**
+ * Seeded set of per-subsystem random number streams.
+ *
+ * The seed and the number of draws taken from each stream are all that is
+ * needed to put every stream back where it was, so they are stored in
+ * savegames to make games reproducible.
+ */
+class RandomStreams
+{
+public:
+	static constexpr auto StreamCount = static_cast<std::size_t>(RandomStream::Count);
+	using DrawCounts = std::array<std::uint64_t, StreamCount>;
+
+	RandomStreams();
+
+	void seed(std::uint64_t seed);
+	std::uint64_t seed() const { return mSeed; }
+
+	void restore(std::uint64_t seed, const DrawCounts& draws);
+	DrawCounts draws() const;
+
+	RandomNumberGenerator& stream(RandomStream stream) { return mStreams[static_cast<std::size_t>(stream)]; }
+
+	static const std::string& streamName(RandomStream stream);
+
+private:
+	std::uint64_t mSeed{0};
+	std::array<RandomNumberGenerator, StreamCount> mStreams;
 };
 
-inline RandomNumberGenerator randomNumber;
+
+std::uint64_t generateRandomSeed();
+
+inline RandomStreams randomNumber;
@@ -0,0 +1,92 @@
+#include "SlabArena.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+
+namespace
+{
+	std::size_t sizeClassIndex(std::size_t size)
+	{
+		return (std::max<std::size_t>(size, 1) + SlabArena::Granularity - 1) / SlabArena::Granularity;
+	}
+}
+
+
+SlabArena::SlabArena(std::size_t slotsPerSlab) :
+	mSlotsPerSlab{slotsPerSlab}
+{
+	if (slotsPerSlab == 0)
+	{
+		throw std::runtime_error("SlabArena: Slabs must hold at least one slot");
+	}
+}
+
+
+void* SlabArena::allocate(std::size_t size)
+{
+	const auto index = sizeClassIndex(size);
+	if (index >= mSizeClasses.size()) { mSizeClasses.resize(index + 1); }
+
+	auto& sizeClass = mSizeClasses[index];
+	++mLiveCount;
+
+	if (!sizeClass.freeSlots.empty())
+	{
+		auto* slot = sizeClass.freeSlots.back();
+		sizeClass.freeSlots.pop_back();
+		return slot;
+	}
+
+	const auto slotSize = index * Granularity;
+	if (sizeClass.slabs.empty() || sizeClass.usedInLastSlab == mSlotsPerSlab)
+	{
+		// new[] of std::byte is aligned for any fundamental type, and slot
+		// sizes are multiples of that alignment
+		sizeClass.slabs.emplace_back(new std::byte[slotSize * mSlotsPerSlab]);
+		sizeClass.usedInLastSlab = 0;
+	}
+
+	return sizeClass.slabs.back().get() + slotSize * sizeClass.usedInLastSlab++;
+}
+
+
+/**
+ * Returns a slot to its size class.
+ *
+ * \param	size	The size that was passed to allocate().
+ */
+void SlabArena::deallocate(void* pointer, std::size_t size)
+{
+	if (!pointer) { return; }
+
+	const auto index = sizeClassIndex(size);
+	if (index >= mSizeClasses.size() || mLiveCount == 0)
+	{
+		throw std::runtime_error("SlabArena: Deallocated memory that was not allocated by the arena");
+	}
+
+	mSizeClasses[index].freeSlots.push_back(pointer);
+	--mLiveCount;
+}
+
+
+/**
+ * Releases every slab, if no allocation is still live.
+ *
+ * \return	True if the slabs were released.
+ */
+bool SlabArena::reset()
+{
+	if (mLiveCount > 0) { return false; }
+
+	mSizeClasses.clear();
+	return true;
+}
+
+
+std::size_t SlabArena::slabCount() const
+{
+	return std::accumulate(mSizeClasses.begin(), mSizeClasses.end(), std::size_t{0}, [](std::size_t count, const SizeClass& sizeClass) { return count + sizeClass.slabs.size(); });
+}
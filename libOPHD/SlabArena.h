@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Allocator for objects of mixed types that are created and destroyed
+ * individually, such as the different Structure classes.
+ *
+ * Requests are rounded up to a size class and served from slabs that each
+ * hold a run of slots of that class, so objects of the same size end up next
+ * to each other in memory. Freed slots are kept for reuse by the same size
+ * class rather than returned to the system.
+ *
+ * reset() releases every slab in one step once all objects have been
+ * destroyed.
+ */
+class SlabArena
+{
+public:
+	static constexpr std::size_t Granularity = alignof(std::max_align_t);
+
+	explicit SlabArena(std::size_t slotsPerSlab = 64);
+	SlabArena(const SlabArena&) = delete;
+	SlabArena& operator=(const SlabArena&) = delete;
+
+	void* allocate(std::size_t size);
+	void deallocate(void* pointer, std::size_t size);
+
+	bool reset();
+
+	std::size_t liveCount() const { return mLiveCount; }
+	std::size_t slabCount() const;
+
+private:
+	struct SizeClass
+	{
+		std::vector<std::unique_ptr<std::byte[]>> slabs;
+		std::size_t usedInLastSlab{0}; /**< Slots of the newest slab handed out so far. */
+		std::vector<void*> freeSlots;
+	};
+
+	const std::size_t mSlotsPerSlab;
+	std::vector<SizeClass> mSizeClasses; /**< Indexed by slot size in multiples of Granularity. */
+	std::size_t mLiveCount{0};
+};
@@ -0,0 +1,260 @@
+#include <libOPHD/BinarySerializer.h>
+#include <libOPHD/Map/TileLayer.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+TEST(BinarySerializer, RoundTripFixedWidth)
+{
+	BinaryWriter writer;
+	writer.writeU8(0xAB);
+	writer.writeU16(0xBEEF);
+	writer.writeU32(0xDEADBEEF);
+	writer.writeI32(-12345);
+
+	EXPECT_EQ(11u, writer.size());
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_EQ(0xAB, reader.readU8());
+	EXPECT_EQ(0xBEEF, reader.readU16());
+	EXPECT_EQ(0xDEADBEEFu, reader.readU32());
+	EXPECT_EQ(-12345, reader.readI32());
+	EXPECT_TRUE(reader.atEnd());
+}
+
+
+TEST(BinarySerializer, LittleEndian)
+{
+	BinaryWriter writer;
+	writer.writeU32(0x04030201);
+	EXPECT_EQ(std::string("\x01\x02\x03\x04", 4), writer.buffer());
+}
+
+
+TEST(BinarySerializer, VarUint)
+{
+	BinaryWriter writer;
+	writer.writeVarUint(0);
+	writer.writeVarUint(127);
+	writer.writeVarUint(128);
+	writer.writeVarUint(0xFFFFFFFFFFull);
+
+	// 1 + 1 + 2 + 6 bytes
+	EXPECT_EQ(10u, writer.size());
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_EQ(0u, reader.readVarUint());
+	EXPECT_EQ(127u, reader.readVarUint());
+	EXPECT_EQ(128u, reader.readVarUint());
+	EXPECT_EQ(0xFFFFFFFFFFull, reader.readVarUint());
+}
+
+
+TEST(BinarySerializer, String)
+{
+	BinaryWriter writer;
+	writer.writeString("");
+	writer.writeString("structures");
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_EQ("", reader.readString());
+	EXPECT_EQ("structures", reader.readString());
+	EXPECT_TRUE(reader.atEnd());
+}
+
+
+TEST(BinarySerializer, PatchU32)
+{
+	BinaryWriter writer;
+	writer.writeU32(0);
+	writer.writeU8(7);
+	writer.patchU32(0, 42);
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_EQ(42u, reader.readU32());
+	EXPECT_EQ(7, reader.readU8());
+
+	EXPECT_THROW(writer.patchU32(2, 0), std::runtime_error);
+}
+
+
+TEST(BinarySerializer, ReadPastEndThrows)
+{
+	BinaryWriter writer;
+	writer.writeU16(1);
+	writer.writeString("abc");
+
+	BinaryReader reader{std::string_view{writer.buffer()}.substr(0, 4)};
+	EXPECT_EQ(1, reader.readU16());
+	EXPECT_THROW(reader.readString(), std::runtime_error);
+	EXPECT_THROW(reader.readU32(), std::runtime_error);
+}
+
+
+TEST(TileLayer, Construction)
+{
+	TileLayer tileLayer{4, 3, 2};
+	EXPECT_EQ(2u, tileLayer.chunkCount());
+	EXPECT_TRUE(tileLayer.chunks().empty());
+	EXPECT_EQ(TileLayer::Empty, tileLayer.at(3, 2, 1));
+	EXPECT_TRUE(tileLayer.contains(0, 0, 0));
+	EXPECT_FALSE(tileLayer.contains(4, 0, 0));
+	EXPECT_FALSE(tileLayer.contains(0, 0, 2));
+	EXPECT_THROW(tileLayer.at(0, 3, 0), std::runtime_error);
+	EXPECT_THROW((TileLayer{-1, 3, 2}), std::runtime_error);
+	EXPECT_THROW((TileLayer{65537, 4, 2}), std::runtime_error);
+}
+
+
+TEST(TileLayer, ChunksAllocatedOnWrite)
+{
+	TileLayer tileLayer{100, 40, 3};
+	tileLayer.at(99, 39, 2) = 1;
+	tileLayer.at(98, 39, 2) = 2;
+	tileLayer.at(0, 0, 0) = 0;
+
+	EXPECT_EQ(2u, tileLayer.chunks().size());
+	EXPECT_EQ(1, tileLayer.at(99, 39, 2));
+	EXPECT_EQ(TileLayer::Empty, tileLayer.at(97, 39, 2));
+
+	const auto cells = tileLayer.filledCells();
+	ASSERT_EQ(3u, cells.size());
+	EXPECT_EQ(0, cells[0].x);
+	EXPECT_EQ(0, cells[0].depth);
+	EXPECT_EQ(98, cells[1].x);
+	EXPECT_EQ(39, cells[1].y);
+	EXPECT_EQ(2, cells[1].depth);
+	EXPECT_EQ(2, cells[1].value);
+	EXPECT_EQ(99, cells[2].x);
+}
+
+
+TEST(TileLayer, RoundTrip)
+{
+	TileLayer tileLayer{300, 150, 5};
+	tileLayer.at(0, 0, 0) = 0;
+	tileLayer.at(10, 20, 0) = 0;
+	tileLayer.at(11, 20, 0) = 0;
+	tileLayer.at(12, 20, 0) = 1;
+	tileLayer.at(299, 149, 4) = 2;
+
+	BinaryWriter writer;
+	writeTileLayer(writer, tileLayer);
+
+	// Run-length encoding keeps a mostly empty map tiny
+	EXPECT_LT(writer.size(), 64u);
+
+	BinaryReader reader{writer.buffer()};
+	const auto result = readTileLayer(reader);
+	EXPECT_TRUE(reader.atEnd());
+	EXPECT_EQ(tileLayer.width, result.width);
+	EXPECT_EQ(tileLayer.height, result.height);
+	EXPECT_EQ(tileLayer.levels, result.levels);
+	EXPECT_EQ(tileLayer.chunks(), result.chunks());
+}
+
+
+TEST(TileLayer, LargeMapRoundTrip)
+{
+	// Far past the size a dense layer could hold
+	TileLayer tileLayer{4096, 4096, 8};
+	tileLayer.at(4095, 4095, 7) = 0;
+	tileLayer.at(2048, 10, 3) = 1;
+
+	BinaryWriter writer;
+	writeTileLayer(writer, tileLayer);
+	EXPECT_LT(writer.size(), 64u);
+
+	BinaryReader reader{writer.buffer()};
+	const auto result = readTileLayer(reader);
+	EXPECT_TRUE(reader.atEnd());
+	EXPECT_EQ(tileLayer.chunks(), result.chunks());
+	EXPECT_EQ(0, result.at(4095, 4095, 7));
+	EXPECT_EQ(1, result.at(2048, 10, 3));
+}
+
+
+TEST(TileLayer, CorruptRunLengthThrows)
+{
+	BinaryWriter writer;
+	writer.writeI32(2);
+	writer.writeI32(2);
+	writer.writeI32(1);
+	writer.writeVarUint(1);
+	writer.writeVarUint(0);
+	writer.writeVarUint(TileLayer::ChunkArea + 1);
+	writer.writeU8(0);
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_THROW(readTileLayer(reader), std::runtime_error);
+}
+
+
+TEST(TileLayer, CorruptChunkIndexThrows)
+{
+	BinaryWriter writer;
+	writer.writeI32(2);
+	writer.writeI32(2);
+	writer.writeI32(1);
+	writer.writeVarUint(1);
+	writer.writeVarUint(1);
+	writer.writeVarUint(TileLayer::ChunkArea);
+	writer.writeU8(0);
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_THROW(readTileLayer(reader), std::runtime_error);
+}
+
+
+TEST(TileLayer, OversizedHeaderThrows)
+{
+	BinaryWriter writer;
+	writer.writeI32(65537);
+	writer.writeI32(65536);
+	writer.writeI32(256);
+	writer.writeVarUint(0);
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_THROW(readTileLayer(reader), std::runtime_error);
+}
+
+
+TEST(TileLayer, ReadDense)
+{
+	BinaryWriter writer;
+	writer.writeI32(3);
+	writer.writeI32(2);
+	writer.writeI32(2);
+	writer.writeVarUint(4);
+	writer.writeU8(TileLayer::Empty);
+	writer.writeVarUint(2);
+	writer.writeU8(1);
+	writer.writeVarUint(6);
+	writer.writeU8(TileLayer::Empty);
+
+	BinaryReader reader{writer.buffer()};
+	const auto result = readDenseTileLayer(reader);
+	EXPECT_TRUE(reader.atEnd());
+
+	const auto cells = result.filledCells();
+	ASSERT_EQ(2u, cells.size());
+	EXPECT_EQ(1, result.at(1, 1, 0));
+	EXPECT_EQ(1, result.at(2, 1, 0));
+	EXPECT_EQ(TileLayer::Empty, result.at(1, 1, 1));
+}
+
+
+TEST(TileLayer, OversizedDenseHeaderThrows)
+{
+	BinaryWriter writer;
+	writer.writeI32(65536);
+	writer.writeI32(65536);
+	writer.writeI32(256);
+	writer.writeVarUint(1);
+	writer.writeU8(0);
+
+	BinaryReader reader{writer.buffer()};
+	EXPECT_THROW(readDenseTileLayer(reader), std::runtime_error);
+}
@@ -0,0 +1,67 @@
+#include <libOPHD/Map/CoverageLayer.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+TEST(CoverageLayer, Circle)
+{
+	CoverageLayer layer{{20, 20}, 2};
+	layer.addCircle({10, 10}, 1, 3);
+
+	EXPECT_TRUE(layer.covered({10, 10}, 1));
+	EXPECT_TRUE(layer.covered({13, 10}, 1));
+	EXPECT_TRUE(layer.covered({12, 12}, 1));
+	EXPECT_FALSE(layer.covered({13, 13}, 1));
+	EXPECT_FALSE(layer.covered({10, 10}, 0));
+	EXPECT_EQ(29u, layer.coveredPoints(1).size());
+	EXPECT_TRUE(layer.coveredPoints(0).empty());
+}
+
+
+TEST(CoverageLayer, Overlap)
+{
+	CoverageLayer layer{{20, 20}, 1};
+	layer.addCircle({5, 5}, 0, 2);
+	layer.addCircle({7, 5}, 0, 2);
+
+	layer.removeCircle({5, 5}, 0, 2);
+	EXPECT_TRUE(layer.covered({6, 5}, 0));
+	EXPECT_FALSE(layer.covered({4, 5}, 0));
+
+	layer.removeCircle({7, 5}, 0, 2);
+	EXPECT_TRUE(layer.coveredPoints(0).empty());
+	EXPECT_THROW(layer.removeCircle({7, 5}, 0, 2), std::runtime_error);
+}
+
+
+TEST(CoverageLayer, ClippedToMap)
+{
+	CoverageLayer layer{{4, 4}, 1};
+	layer.addCircle({0, 0}, 0, 10);
+	EXPECT_EQ(16u, layer.coveredPoints(0).size());
+	EXPECT_FALSE(layer.covered({-1, 0}, 0));
+	EXPECT_FALSE(layer.covered({0, 4}, 0));
+	EXPECT_FALSE(layer.covered({0, 0}, 1));
+}
+
+
+TEST(CoverageLayer, SpansChunks)
+{
+	constexpr auto ChunkSize = CoverageLayer::ChunkSize;
+	CoverageLayer layer{{ChunkSize * 3 + 5, ChunkSize * 2}, 1};
+	layer.addCircle({ChunkSize, ChunkSize}, 0, 2);
+	layer.addCircle({ChunkSize * 3 + 4, 0}, 0, 1);
+
+	EXPECT_TRUE(layer.covered({ChunkSize - 1, ChunkSize - 1}, 0));
+	EXPECT_TRUE(layer.covered({ChunkSize, ChunkSize}, 0));
+	EXPECT_TRUE(layer.covered({ChunkSize * 3 + 4, 1}, 0));
+	EXPECT_FALSE(layer.covered({ChunkSize * 3 + 5, 0}, 0));
+	EXPECT_EQ(13u + 3u, layer.coveredPoints(0).size());
+
+	layer.removeCircle({ChunkSize, ChunkSize}, 0, 2);
+	EXPECT_FALSE(layer.covered({ChunkSize, ChunkSize}, 0));
+	EXPECT_EQ(3u, layer.coveredPoints(0).size());
+	EXPECT_THROW(layer.removeCircle({ChunkSize, ChunkSize}, 0, 2), std::runtime_error);
+}
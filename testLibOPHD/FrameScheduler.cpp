@@ -0,0 +1,92 @@
+#include <libOPHD/FrameScheduler.h>
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	using namespace std::chrono_literals;
+
+	const auto Start = FrameScheduler::Clock::time_point{} + 1h;
+
+
+	void drawFrame(FrameScheduler& scheduler, FrameScheduler::Clock::time_point start, std::optional<FrameScheduler::Redraw> redraw)
+	{
+		scheduler.beginFrame(start);
+		if (redraw) { scheduler.redraw(*redraw); }
+		scheduler.endFrame(start + 2ms);
+	}
+}
+
+
+TEST(FrameScheduler, FrameCap)
+{
+	FrameScheduler scheduler{50};
+	drawFrame(scheduler, Start, std::nullopt);
+
+	EXPECT_EQ(Start + 20ms, scheduler.earliestFrameTime());
+	EXPECT_EQ(Start + 20ms, scheduler.nextFrameTime());
+}
+
+
+TEST(FrameScheduler, Uncapped)
+{
+	FrameScheduler scheduler{0};
+	drawFrame(scheduler, Start, FrameScheduler::Redraw::Continuous);
+
+	EXPECT_EQ(0, scheduler.frameCap());
+	EXPECT_EQ(Start, scheduler.nextFrameTime());
+}
+
+
+TEST(FrameScheduler, IdleRates)
+{
+	FrameScheduler scheduler{60};
+
+	drawFrame(scheduler, Start, FrameScheduler::Redraw::Animated);
+	EXPECT_EQ(Start + FrameScheduler::Clock::duration{1s} / FrameScheduler::IdleFrameRate, scheduler.nextFrameTime());
+
+	drawFrame(scheduler, Start, FrameScheduler::Redraw::OnChange);
+	EXPECT_EQ(Start + FrameScheduler::IdleRedrawInterval, scheduler.nextFrameTime());
+}
+
+
+TEST(FrameScheduler, MostFrequentRedrawWins)
+{
+	FrameScheduler scheduler{50};
+	scheduler.beginFrame(Start);
+	scheduler.redraw(FrameScheduler::Redraw::Continuous);
+	scheduler.redraw(FrameScheduler::Redraw::OnChange);
+	scheduler.endFrame(Start + 2ms);
+
+	EXPECT_EQ(Start + 20ms, scheduler.nextFrameTime());
+}
+
+
+TEST(FrameScheduler, Invalidate)
+{
+	FrameScheduler scheduler{50};
+	drawFrame(scheduler, Start, FrameScheduler::Redraw::OnChange);
+
+	scheduler.invalidate();
+	EXPECT_EQ(Start + 20ms, scheduler.nextFrameTime());
+
+	drawFrame(scheduler, Start + 20ms, FrameScheduler::Redraw::OnChange);
+	EXPECT_EQ(Start + 20ms + FrameScheduler::IdleRedrawInterval, scheduler.nextFrameTime());
+}
+
+
+TEST(FrameScheduler, Stats)
+{
+	FrameScheduler scheduler{0};
+	for (int i = 0; i <= 10; ++i)
+	{
+		drawFrame(scheduler, Start + i * 100ms, std::nullopt);
+	}
+
+	const auto& stats = scheduler.stats();
+	EXPECT_EQ(2ms, stats.frameTime);
+	EXPECT_EQ(2ms, stats.averageFrameTime);
+	EXPECT_EQ(10, stats.framesPerSecond);
+	EXPECT_EQ(98, stats.idlePercent);
+}
@@ -0,0 +1,90 @@
+#include <libOPHD/Map/GridPathFinder.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace
+{
+	constexpr auto X = GridPathFinder::Impassable;
+}
+
+
+TEST(GridPathFinder, FindPath)
+{
+	GridPathFinder pathFinder{{4, 3}, {
+		1, 1, 1, 1,
+		1, X, X, 1,
+		1, 1, 1, 1,
+	}};
+
+	const auto path = pathFinder.findPath({0, 1}, {3, 1});
+	EXPECT_EQ(5.0f, path.cost);
+	ASSERT_EQ(6u, path.points.size());
+	EXPECT_EQ((NAS2D::Point{0, 1}), path.points.front());
+	EXPECT_EQ((NAS2D::Point{3, 1}), path.points.back());
+
+	const auto same = pathFinder.findPath({2, 2}, {2, 2});
+	EXPECT_EQ(0.0f, same.cost);
+	EXPECT_EQ(1u, same.points.size());
+}
+
+
+TEST(GridPathFinder, PrefersCheapCells)
+{
+	GridPathFinder pathFinder{{3, 3}, {
+		1.0f, 0.5f, 1.0f,
+		1.0f, 9.0f, 1.0f,
+		1.0f, 1.0f, 1.0f,
+	}};
+
+	// Around the top through the cheap cell rather than the costly centre
+	EXPECT_EQ(2.5f, pathFinder.findPath({0, 1}, {2, 0}).cost);
+	EXPECT_EQ(3.5f, pathFinder.findPath({0, 1}, {2, 1}).cost);
+}
+
+
+TEST(GridPathFinder, Unreachable)
+{
+	GridPathFinder pathFinder{{3, 1}, {1, X, 1}};
+	EXPECT_TRUE(pathFinder.findPath({0, 0}, {2, 0}).empty());
+	EXPECT_THROW(pathFinder.findPath({0, 0}, {3, 0}), std::runtime_error);
+}
+
+
+TEST(GridPathFinder, FindNearest)
+{
+	GridPathFinder pathFinder{{6, 2}, {
+		1, 1, 1, 1, 1, 1,
+		X, X, 1, X, 1, 1,
+	}};
+
+	// Impassable starts can still leave
+	const auto paths = pathFinder.findNearest({{2, 1}, {0, 1}, {5, 1}}, {{0, 0}, {5, 0}});
+	ASSERT_EQ(3u, paths.size());
+	EXPECT_EQ(3.0f, paths[0].cost);
+	EXPECT_EQ((NAS2D::Point{2, 1}), paths[0].points.front());
+	EXPECT_EQ(1.0f, paths[1].cost);
+	EXPECT_EQ(1.0f, paths[2].cost);
+	EXPECT_EQ((NAS2D::Point{5, 0}), paths[2].points.back());
+
+	// Matches the cheapest of the individual searches
+	for (const auto start : {NAS2D::Point{2, 1}, NAS2D::Point{4, 1}})
+	{
+		const auto nearest = pathFinder.findNearest({start}, {{0, 0}, {5, 0}});
+		const auto left = pathFinder.findPath(start, {0, 0});
+		const auto right = pathFinder.findPath(start, {5, 0});
+		EXPECT_EQ(std::min(left.cost, right.cost), nearest[0].cost);
+	}
+
+	GridPathFinder walledOff{{3, 1}, {1, X, 1}};
+	EXPECT_TRUE(walledOff.findNearest({{0, 0}}, {{2, 0}})[0].empty());
+}
+
+
+TEST(GridPathFinder, InvalidCosts)
+{
+	EXPECT_THROW((GridPathFinder{{2, 2}, {1, 1, 1}}), std::runtime_error);
+}
@@ -0,0 +1,77 @@
+#include <libOPHD/IndexedMinHeap.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+TEST(IndexedMinHeap, PopsInKeyOrder)
+{
+	IndexedMinHeap<int, int> heap;
+	const std::vector<int> keys{50, 10, 90, 30, 70, 20, 80, 40, 60};
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		heap.push(static_cast<int>(i), keys[i]);
+	}
+
+	EXPECT_EQ(keys.size(), heap.size());
+
+	std::vector<int> popped;
+	while (!heap.empty())
+	{
+		popped.push_back(heap.topKey());
+		heap.pop();
+	}
+
+	EXPECT_EQ((std::vector<int>{10, 20, 30, 40, 50, 60, 70, 80, 90}), popped);
+}
+
+
+TEST(IndexedMinHeap, UpdateKey)
+{
+	IndexedMinHeap<char, int> heap;
+	heap.push('a', 10);
+	heap.push('b', 20);
+	heap.push('c', 30);
+
+	heap.push('c', 5);
+	EXPECT_EQ('c', heap.top());
+	EXPECT_EQ(3u, heap.size());
+
+	heap.push('c', 40);
+	EXPECT_EQ('a', heap.top());
+	EXPECT_EQ(40, heap.key('c'));
+}
+
+
+TEST(IndexedMinHeap, Erase)
+{
+	IndexedMinHeap<int, int> heap;
+	for (int i = 0; i < 20; ++i) { heap.push(i, (i * 7) % 20); }
+
+	heap.erase(0);
+	heap.erase(13);
+	heap.erase(100);
+
+	EXPECT_FALSE(heap.contains(0));
+	EXPECT_FALSE(heap.contains(13));
+	EXPECT_EQ(18u, heap.size());
+
+	int previous = -1;
+	while (!heap.empty())
+	{
+		EXPECT_LE(previous, heap.topKey());
+		previous = heap.topKey();
+		heap.pop();
+	}
+}
+
+
+TEST(IndexedMinHeap, EmptyThrows)
+{
+	IndexedMinHeap<int, int> heap;
+	EXPECT_THROW(heap.top(), std::runtime_error);
+	EXPECT_THROW(heap.pop(), std::runtime_error);
+	EXPECT_THROW(heap.key(1), std::runtime_error);
+}
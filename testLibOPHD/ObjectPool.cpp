@@ -0,0 +1,78 @@
+#include <libOPHD/ObjectPool.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+	struct Counted
+	{
+		Counted(int newValue, int& newLiveCount) : value{newValue}, liveCount{newLiveCount} { ++liveCount; }
+		~Counted() { --liveCount; }
+
+		int value;
+		int& liveCount;
+	};
+}
+
+
+TEST(ObjectPool, EmplaceAndIterate)
+{
+	ObjectPool<int, 4> pool;
+	for (int i = 0; i < 10; ++i) { pool.emplace(i); }
+
+	EXPECT_EQ(10u, pool.size());
+	EXPECT_EQ(3u, pool.blockCount());
+
+	std::vector<int> values(pool.begin(), pool.end());
+	EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), values);
+}
+
+
+TEST(ObjectPool, EraseReusesSlot)
+{
+	ObjectPool<int, 4> pool;
+	auto& first = pool.emplace(1);
+	auto& second = pool.emplace(2);
+	pool.emplace(3);
+
+	pool.erase(&second);
+	EXPECT_EQ(2u, pool.size());
+	EXPECT_FALSE(pool.contains(&second));
+	EXPECT_EQ((std::vector<int>{1, 3}), std::vector<int>(pool.begin(), pool.end()));
+
+	auto& reused = pool.emplace(4);
+	EXPECT_EQ(&second, &reused);
+	EXPECT_EQ(1, first);
+	EXPECT_EQ((std::vector<int>{1, 4, 3}), std::vector<int>(pool.begin(), pool.end()));
+
+	int notInPool = 0;
+	EXPECT_THROW(pool.erase(&notInPool), std::runtime_error);
+}
+
+
+TEST(ObjectPool, DestroysObjects)
+{
+	int liveCount = 0;
+	{
+		ObjectPool<Counted, 2> pool;
+		auto& first = pool.emplace(1, liveCount);
+		pool.emplace(2, liveCount);
+		pool.emplace(3, liveCount);
+		EXPECT_EQ(3, liveCount);
+
+		pool.erase(&first);
+		EXPECT_EQ(2, liveCount);
+
+		pool.clear();
+		EXPECT_EQ(0, liveCount);
+		EXPECT_TRUE(pool.empty());
+		EXPECT_EQ(0u, pool.blockCount());
+
+		pool.emplace(4, liveCount);
+	}
+	EXPECT_EQ(0, liveCount);
+}
@@ -0,0 +1,71 @@
+#include <libOPHD/Profiler.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string_view>
+
+
+TEST(Profiler, NestedScopes)
+{
+	Profiler testProfiler;
+	testProfiler.begin();
+
+	{
+		const ProfileScope outer{testProfiler, "Outer"};
+		{
+			const ProfileScope inner{testProfiler, "Inner"};
+		}
+		const ProfileScope sibling{testProfiler, "Sibling"};
+	}
+	const ProfileScope after{testProfiler, "After"};
+
+	const auto& samples = testProfiler.samples();
+	ASSERT_EQ(4u, samples.size());
+	EXPECT_EQ(std::string_view{"Outer"}, samples[0].name);
+	EXPECT_EQ(0, samples[0].depth);
+	EXPECT_EQ(1, samples[1].depth);
+	EXPECT_EQ(1, samples[2].depth);
+	EXPECT_EQ(0, samples[3].depth);
+
+	EXPECT_GE(samples[0].duration, samples[1].duration);
+	EXPECT_GE(samples[1].start, samples[0].start);
+}
+
+
+TEST(Profiler, Counters)
+{
+	Profiler testProfiler;
+	testProfiler.count("Structures", 3);
+	testProfiler.count("Routes", 1);
+	testProfiler.count("Structures", 4);
+
+	const auto& counters = testProfiler.counters();
+	ASSERT_EQ(2u, counters.size());
+	EXPECT_EQ(7, counters[0].value);
+	EXPECT_EQ(1, counters[1].value);
+
+	testProfiler.begin();
+	EXPECT_TRUE(testProfiler.counters().empty());
+}
+
+
+TEST(Profiler, Output)
+{
+	Profiler testProfiler;
+	testProfiler.begin();
+	{
+		const ProfileScope scope{testProfiler, "Say \"hi\""};
+	}
+	testProfiler.count("Count", 2);
+
+	std::ostringstream csv;
+	testProfiler.writeCsv(csv);
+	EXPECT_EQ(0u, csv.str().find("type,name,depth,start_us,duration_us,value\nscope,\"Say \"\"hi\"\"\",0,"));
+	EXPECT_NE(std::string::npos, csv.str().find("counter,\"Count\",,,,2\n"));
+
+	std::ostringstream trace;
+	testProfiler.writeChromeTrace(trace);
+	EXPECT_NE(std::string::npos, trace.str().find("\"name\":\"Say \\\"hi\\\"\",\"ph\":\"X\""));
+	EXPECT_NE(std::string::npos, trace.str().find("\"ph\":\"C\""));
+}
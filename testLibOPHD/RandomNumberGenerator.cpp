@@ -0,0 +1,95 @@
+#include <libOPHD/RandomNumberGenerator.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+	std::vector<int> drawInts(RandomNumberGenerator& generator, int count)
+	{
+		std::vector<int> values;
+		for (int i = 0; i < count; ++i) { values.push_back(generator.generate(0, 1000)); }
+		return values;
+	}
+}
+
+
+TEST(RandomNumberGenerator, SameSeedSameSequence)
+{
+	RandomNumberGenerator a{1234, 0};
+	RandomNumberGenerator b{1234, 0};
+	EXPECT_EQ(drawInts(a, 100), drawInts(b, 100));
+
+	RandomNumberGenerator c{1235, 0};
+	RandomNumberGenerator d{1234, 1};
+	a = RandomNumberGenerator{1234, 0};
+	const auto expected = drawInts(a, 100);
+	EXPECT_NE(expected, drawInts(c, 100));
+	EXPECT_NE(expected, drawInts(d, 100));
+}
+
+
+TEST(RandomNumberGenerator, Range)
+{
+	RandomNumberGenerator generator{42, 0};
+	for (int i = 0; i < 1000; ++i)
+	{
+		const auto value = generator.generate(-3, 3);
+		EXPECT_GE(value, -3);
+		EXPECT_LE(value, 3);
+
+		const auto real = generator.generate(0.5f, 1.5f);
+		EXPECT_GE(real, 0.5f);
+		EXPECT_LE(real, 1.5f);
+	}
+
+	EXPECT_EQ(7, generator.generate(7, 7));
+	EXPECT_THROW(generator.generate(2, 1), std::runtime_error);
+}
+
+
+TEST(RandomNumberGenerator, RestoreByDrawCount)
+{
+	RandomNumberGenerator generator{99, 3};
+	drawInts(generator, 37);
+	const auto draws = generator.draws();
+	const auto expected = drawInts(generator, 20);
+
+	RandomNumberGenerator restored{99, 3};
+	restored.draws(draws);
+	EXPECT_EQ(draws, restored.draws());
+	EXPECT_EQ(expected, drawInts(restored, 20));
+}
+
+
+TEST(RandomStreams, StreamsAreIndependent)
+{
+	RandomStreams streams;
+	streams.seed(2024);
+	const auto expected = drawInts(streams.stream(RandomStream::CrimeRate), 10);
+
+	streams.seed(2024);
+	drawInts(streams.stream(RandomStream::Population), 50);
+	EXPECT_EQ(expected, drawInts(streams.stream(RandomStream::CrimeRate), 10));
+}
+
+
+TEST(RandomStreams, Restore)
+{
+	RandomStreams streams;
+	streams.seed(77);
+	drawInts(streams.stream(RandomStream::MapGeneration), 15);
+	drawInts(streams.stream(RandomStream::StructureDecay), 4);
+
+	const auto seed = streams.seed();
+	const auto draws = streams.draws();
+	const auto expected = drawInts(streams.stream(RandomStream::StructureDecay), 10);
+
+	RandomStreams restored;
+	restored.restore(seed, draws);
+	EXPECT_EQ(draws, restored.draws());
+	EXPECT_EQ(expected, drawInts(restored.stream(RandomStream::StructureDecay), 10));
+}
@@ -0,0 +1,55 @@
+#include <libOPHD/SlabArena.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+
+TEST(SlabArena, SameSizeIsContiguous)
+{
+	SlabArena arena{4};
+	auto* first = static_cast<std::byte*>(arena.allocate(24));
+	auto* second = static_cast<std::byte*>(arena.allocate(20));
+
+	constexpr auto slotSize = (24 + SlabArena::Granularity - 1) / SlabArena::Granularity * SlabArena::Granularity;
+	EXPECT_EQ(first + slotSize, second);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(first) % SlabArena::Granularity);
+	EXPECT_EQ(2u, arena.liveCount());
+	EXPECT_EQ(1u, arena.slabCount());
+
+	arena.allocate(100);
+	EXPECT_EQ(2u, arena.slabCount());
+}
+
+
+TEST(SlabArena, ReusesFreedSlots)
+{
+	SlabArena arena{2};
+	auto* first = arena.allocate(16);
+	arena.allocate(16);
+	arena.deallocate(first, 16);
+
+	EXPECT_EQ(first, arena.allocate(16));
+	EXPECT_EQ(1u, arena.slabCount());
+
+	arena.allocate(16);
+	EXPECT_EQ(2u, arena.slabCount());
+}
+
+
+TEST(SlabArena, ResetOnlyWhenEmpty)
+{
+	SlabArena arena;
+	auto* first = arena.allocate(48);
+	auto* second = arena.allocate(8);
+
+	EXPECT_FALSE(arena.reset());
+	EXPECT_EQ(2u, arena.slabCount());
+
+	arena.deallocate(first, 48);
+	arena.deallocate(second, 8);
+	EXPECT_TRUE(arena.reset());
+	EXPECT_EQ(0u, arena.slabCount());
+	EXPECT_THROW(arena.deallocate(second, 8), std::runtime_error);
+}
@@ -0,0 +1,113 @@
+#include <OPHD/DeferredSignal.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+	class DeferredSignalTest : public ::testing::Test
+	{
+	protected:
+		DeferredSignalTest()
+		{
+			named.source().connect({this, &DeferredSignalTest::onNamed});
+			counted.source().connect({this, &DeferredSignalTest::onCounted});
+		}
+
+	public:
+		void onNamed(const std::string& name)
+		{
+			received.push_back(name);
+			receivingThreads.push_back(std::this_thread::get_id());
+		}
+
+		void onCounted(int count)
+		{
+			received.push_back(std::to_string(count));
+			receivingThreads.push_back(std::this_thread::get_id());
+		}
+
+		void onCountedEmitNamed(int count)
+		{
+			named("After " + std::to_string(count));
+		}
+
+	protected:
+		SignalQueue queue;
+		DeferredSignal<const std::string&> named{queue};
+		DeferredSignal<int> counted{queue};
+
+		std::vector<std::string> received;
+		std::vector<std::thread::id> receivingThreads;
+	};
+}
+
+
+TEST_F(DeferredSignalTest, EmitsImmediatelyWhenNotHolding)
+{
+	named("Mine");
+	counted(1);
+
+	EXPECT_FALSE(queue.holding());
+	EXPECT_EQ((std::vector<std::string>{"Mine", "1"}), received);
+}
+
+
+TEST_F(DeferredSignalTest, DeliversHeldEmissionsOldestFirst)
+{
+	queue.hold();
+
+	std::string name = "Smelter";
+	named(name);
+	counted(2);
+	name = "Changed";
+	named("Robot");
+
+	EXPECT_TRUE(received.empty());
+
+	queue.deliver();
+
+	EXPECT_FALSE(queue.holding());
+	EXPECT_EQ((std::vector<std::string>{"Smelter", "2", "Robot"}), received);
+
+	// Once delivered, nothing is held or delivered twice
+	queue.deliver();
+	counted(3);
+	EXPECT_EQ((std::vector<std::string>{"Smelter", "2", "Robot", "3"}), received);
+}
+
+
+TEST_F(DeferredSignalTest, WorkerEmissionsDeliveredOnDeliveringThread)
+{
+	queue.hold();
+
+	auto turn = std::async(std::launch::async, [this]() {
+		for (int count = 0; count < 3; ++count) { counted(count); }
+		named("Turn done");
+	});
+	turn.get();
+
+	EXPECT_TRUE(received.empty());
+
+	queue.deliver();
+
+	EXPECT_EQ((std::vector<std::string>{"0", "1", "2", "Turn done"}), received);
+	EXPECT_EQ(std::vector<std::thread::id>(received.size(), std::this_thread::get_id()), receivingThreads);
+}
+
+
+TEST_F(DeferredSignalTest, EmissionsDuringDeliveryAreNotHeld)
+{
+	counted.source().connect({this, &DeferredSignalTest::onCountedEmitNamed});
+
+	queue.hold();
+	counted(4);
+	queue.deliver();
+
+	EXPECT_EQ((std::vector<std::string>{"4", "After 4"}), received);
+}
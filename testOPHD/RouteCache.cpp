@@ -0,0 +1,90 @@
+#include <OPHD/Map/TileMap.h>
+#include <OPHD/States/RouteCache.h>
+
+#include <libOPHD/Map/GridPathFinder.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+
+class MineFacility;
+
+
+namespace
+{
+	constexpr NAS2D::Vector<int> MapSize{8, 3};
+	constexpr NAS2D::Point<int> Start{0, 1};
+	constexpr NAS2D::Point<int> Goal{7, 1};
+
+
+	Route planRoute(TileMap& tileMap)
+	{
+		GridPathFinder pathFinder{tileMap.size(), tileMap.movementCosts()};
+		const auto path = pathFinder.findPath(Start, Goal);
+
+		Route route;
+		route.cost = path.cost;
+		for (const auto point : path.points)
+		{
+			route.path.push_back(&tileMap.getTile({point, 0}));
+		}
+		return route;
+	}
+
+
+	bool passesOver(const Route& route, const Tile& tile)
+	{
+		return std::find(route.path.begin(), route.path.end(), &tile) != route.path.end();
+	}
+
+
+	class RouteCacheTest : public ::testing::Test
+	{
+	protected:
+		RouteCacheTest()
+		{
+			tileMap.tileChanged().connect({&routeCache, &RouteCache::onTileChanged});
+		}
+
+		TileMap tileMap{MapSize, 0, std::vector<TerrainType>(static_cast<std::size_t>(MapSize.x * MapSize.y), TerrainType::Clear)};
+		RouteCache routeCache;
+
+		// The cache only uses mines as keys, so no real mine is needed
+		int mineKey{0};
+		MineFacility* mine{reinterpret_cast<MineFacility*>(&mineKey)};
+	};
+}
+
+
+TEST_F(RouteCacheTest, RouteReplannedWhenTileCostChanges)
+{
+	routeCache.insert(mine, planRoute(tileMap));
+	const auto& blockedTile = tileMap.getTile({{3, 1}, 0});
+	ASSERT_TRUE(passesOver(routeCache.at(mine), blockedTile));
+
+	// Changes off the route, and overlays on it, leave it alone
+	tileMap.getTile({{3, 0}, 0}).index(TerrainType::Difficult);
+	tileMap.getTile({{3, 1}, 0}).overlay(Tile::Overlay::TruckingRoutes);
+	EXPECT_TRUE(routeCache.contains(mine));
+
+	tileMap.getTile({{3, 1}, 0}).index(TerrainType::Impassable);
+	EXPECT_FALSE(routeCache.contains(mine));
+
+	routeCache.insert(mine, planRoute(tileMap));
+	ASSERT_TRUE(routeCache.contains(mine));
+	EXPECT_FALSE(passesOver(routeCache.at(mine), blockedTile));
+	EXPECT_EQ(&tileMap.getTile({Goal, 0}), routeCache.at(mine).path.back());
+}
+
+
+TEST_F(RouteCacheTest, UnchangedTerrainKeepsRoute)
+{
+	routeCache.insert(mine, planRoute(tileMap));
+	const auto revision = routeCache.revision();
+
+	tileMap.getTile({{3, 1}, 0}).index(TerrainType::Clear);
+	EXPECT_TRUE(routeCache.contains(mine));
+	EXPECT_EQ(revision, routeCache.revision());
+}
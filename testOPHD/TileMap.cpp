@@ -0,0 +1,113 @@
+#include <OPHD/Map/TileMap.h>
+#include <OPHD/Savegame.h>
+
+#include <NAS2D/Xml/XmlElement.h>
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	// Wide enough that each level spans more than one chunk
+	constexpr NAS2D::Vector<int> MapSize{40, 40};
+	constexpr int MaxDepth = 2;
+
+
+	std::vector<TerrainType> roughTerrain()
+	{
+		return std::vector<TerrainType>(static_cast<std::size_t>(MapSize.x * MapSize.y), TerrainType::Rough);
+	}
+
+
+	void dig(TileMap& tileMap, const MapCoordinate& position)
+	{
+		auto& tile = tileMap.getTile(position);
+		tile.index(TerrainType::Dozed);
+		tile.excavated(true);
+	}
+}
+
+
+TEST(TileMap, ExcavateUnallocatedTile)
+{
+	TileMap tileMap{MapSize, MaxDepth, roughTerrain()};
+	const MapCoordinate position{{35, 5}, 1};
+	const auto& constTileMap = std::as_const(tileMap);
+
+	EXPECT_FALSE(constTileMap.getTile(position).excavated());
+	const auto revision = tileMap.revision();
+
+	dig(tileMap, position);
+
+	const auto& tile = constTileMap.getTile(position);
+	EXPECT_EQ(&tileMap.getTile(position), &tile);
+	EXPECT_TRUE(tile.excavated());
+	EXPECT_EQ(TerrainType::Dozed, tile.index());
+	EXPECT_EQ(position.xy, tile.xy());
+	EXPECT_EQ(position.z, tile.depth());
+	EXPECT_LT(revision, tileMap.revision());
+
+	// Neighbors in the same chunk and tiles in other chunks are untouched
+	EXPECT_FALSE(constTileMap.getTile({{34, 5}, 1}).excavated());
+	EXPECT_EQ(TerrainType::Rough, constTileMap.getTile({{34, 5}, 1}).index());
+	EXPECT_FALSE(constTileMap.getTile({{5, 5}, 1}).excavated());
+	EXPECT_FALSE(constTileMap.getTile({{35, 5}, 2}).excavated());
+	EXPECT_NE(&tile, &constTileMap.getTile({{5, 5}, 2}));
+}
+
+
+TEST(TileMap, ExcavatedTilesSurviveSaveAndLoad)
+{
+	TileMap tileMap{MapSize, MaxDepth, roughTerrain()};
+	tileMap.getTile({{3, 4}, 0}).index(TerrainType::Dozed);
+	dig(tileMap, {{35, 5}, 1});
+	dig(tileMap, {{36, 38}, 2});
+
+	SavegameWriter writer;
+	writer.writeTileLayer(tileMap.tileLayer());
+	writer.finish();
+
+	SavegameReader savegame{writer.buffer(), "TileMap test"};
+	TileMap loaded{MapSize, MaxDepth, roughTerrain()};
+	NAS2D::Xml::XmlElement mines{"mines"};
+	loaded.deserialize(&mines, savegame.tileLayer());
+
+	const auto& constLoaded = std::as_const(loaded);
+	EXPECT_EQ(TerrainType::Dozed, constLoaded.getTile({{3, 4}, 0}).index());
+	for (const auto& position : {MapCoordinate{{35, 5}, 1}, MapCoordinate{{36, 38}, 2}})
+	{
+		const auto& tile = constLoaded.getTile(position);
+		EXPECT_TRUE(tile.excavated());
+		EXPECT_EQ(TerrainType::Dozed, tile.index());
+	}
+
+	EXPECT_EQ(TerrainType::Rough, constLoaded.getTile({{4, 4}, 0}).index());
+	EXPECT_FALSE(constLoaded.getTile({{36, 5}, 1}).excavated());
+	EXPECT_FALSE(constLoaded.getTile({{35, 5}, 2}).excavated());
+}
+
+
+TEST(TileMap, HandlesCreatedOnDemand)
+{
+	TileMap tileMap{MapSize, MaxDepth, roughTerrain()};
+	const auto& tileStore = tileMap.tileStore();
+	EXPECT_EQ(0u, tileStore.handleCount());
+
+	dig(tileMap, {{7, 9}, 1});
+	EXPECT_EQ(1u, tileStore.handleCount());
+
+	// Bulk readers go through the store and leave no handles behind
+	const auto costs = tileMap.movementCosts();
+	const auto tileLayer = tileMap.tileLayer();
+	EXPECT_EQ(static_cast<std::size_t>(MapSize.x * MapSize.y), costs.size());
+	EXPECT_EQ(1u, tileLayer.filledCells().size());
+	EXPECT_EQ(1u, tileStore.handleCount());
+
+	// Asking again hands back the same handle
+	const auto* tile = &std::as_const(tileMap).getTile({{7, 9}, 1});
+	EXPECT_EQ(tile, &tileMap.getTile({{7, 9}, 1}));
+	EXPECT_EQ(1u, tileStore.handleCount());
+}